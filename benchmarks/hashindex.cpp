@@ -0,0 +1,201 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Benchmark for the lookup speed of our HashIndex template.
+ */
+
+#define SDL_MAIN_HANDLED
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <list>
+#include <map>
+#include <vector>
+
+#include "src/common/fallthrough.h"
+START_IGNORE_IMPLICIT_FALLTHROUGH
+#include <SDL_timer.h>
+STOP_IGNORE_IMPLICIT_FALLTHROUGH
+
+#include "src/common/types.h"
+#include "src/common/ustring.h"
+#include "src/common/error.h"
+#include "src/common/platform.h"
+#include "src/common/strutil.h"
+#include "src/common/hashindex.h"
+
+/** The options given on the command line. */
+struct Options {
+	uint32 count;   ///< Number of entries in the index.
+	uint32 lookups; ///< Number of lookups.
+
+	Options() : count(50000), lookups(2000000) {
+	}
+};
+
+static void printUsage(const char *name) {
+	std::printf("Benchmark for the xoreos HashIndex\n\n");
+	std::printf("Usage: %s [<options>]\n\n", name);
+	std::printf("Looks up a mix of existing and missing keys, both in a HashIndex and in a\n");
+	std::printf("std::map of std::lists, like the ResourceManager used to index resources,\n");
+	std::printf("and prints how long the lookups took.\n\n");
+	std::printf("  -h      --help              Display this text and exit.\n");
+	std::printf("  -c <n>  --count <n>         Put n entries into the index.\n");
+	std::printf("  -l <n>  --lookups <n>       Look up n keys.\n");
+}
+
+static bool parseCommandLine(const std::vector<Common::UString> &args, Options &options, int &returnValue) {
+	returnValue = 1;
+
+	for (size_t i = 1; i < args.size(); i++) {
+		if ((args[i] == "-h") || (args[i] == "--help")) {
+			printUsage(args[0].c_str());
+
+			returnValue = 0;
+			return false;
+		}
+
+		if ((args[i] == "-c") || (args[i] == "--count")) {
+			if (++i >= args.size()) {
+				std::fprintf(stderr, "Missing argument to \"%s\"\n", args[i - 1].c_str());
+				return false;
+			}
+
+			Common::parseString(args[i], options.count);
+			continue;
+		}
+
+		if ((args[i] == "-l") || (args[i] == "--lookups")) {
+			if (++i >= args.size()) {
+				std::fprintf(stderr, "Missing argument to \"%s\"\n", args[i - 1].c_str());
+				return false;
+			}
+
+			Common::parseString(args[i], options.lookups);
+			continue;
+		}
+
+		std::fprintf(stderr, "Unknown option \"%s\"\n\n", args[i].c_str());
+		printUsage(args[0].c_str());
+		return false;
+	}
+
+	if (options.count == 0) {
+		std::fprintf(stderr, "The index needs at least one entry\n");
+		return false;
+	}
+
+	return true;
+}
+
+/** A simple, deterministic key generator, to get well-spread 64-bit keys. */
+static uint64 makeKey(uint64 i) {
+	uint64 key = (i + 1) * UINT64_C(0x9E3779B97F4A7C15);
+
+	return key ^ (key >> 29);
+}
+
+static uint64 getMicroseconds(uint64 start, uint64 end) {
+	return ((end - start) * 1000000) / SDL_GetPerformanceFrequency();
+}
+
+static void printTime(const char *name, uint64 time, uint32 lookups) {
+	std::printf("  %-10s %10.3f s  %9.3f ns/lookup\n", name, time / 1000000.0,
+	            (lookups > 0) ? ((time * 1000.0) / lookups) : 0.0);
+}
+
+static void benchmarkLookup(const Options &options) {
+	std::map<uint64, std::list<size_t> > map;
+	Common::HashIndex<const size_t *> index;
+
+	for (size_t i = 0; i < options.count; i++) {
+		std::list<size_t> &list = map[makeKey(i)];
+
+		list.push_back(i);
+		index[makeKey(i)] = &list.back();
+	}
+
+	// Look up a mix of existing (3/4) and missing (1/4) keys
+	std::vector<uint64> keys(options.lookups);
+	for (size_t i = 0; i < options.lookups; i++)
+		keys[i] = makeKey((i * 7919) % (options.count + options.count / 3));
+
+	size_t mapSum = 0, mapFound = 0;
+
+	uint64 start = SDL_GetPerformanceCounter();
+
+	for (size_t i = 0; i < options.lookups; i++) {
+		std::map<uint64, std::list<size_t> >::const_iterator r = map.find(keys[i]);
+		if ((r != map.end()) && !r->second.empty()) {
+			mapSum += r->second.back();
+			mapFound++;
+		}
+	}
+
+	const uint64 mapTime = getMicroseconds(start, SDL_GetPerformanceCounter());
+
+	size_t indexSum = 0, indexFound = 0;
+
+	start = SDL_GetPerformanceCounter();
+
+	for (size_t i = 0; i < options.lookups; i++) {
+		const size_t * const *r = index.find(keys[i]);
+		if (r) {
+			indexSum += **r;
+			indexFound++;
+		}
+	}
+
+	const uint64 indexTime = getMicroseconds(start, SDL_GetPerformanceCounter());
+
+	// Also makes sure the compiler can't optimize the lookups away
+	if ((indexFound != mapFound) || (indexSum != mapSum))
+		throw Common::Exception("HashIndex and std::map found different entries");
+
+	std::printf("%u lookups in %u entries, %u found\n", options.lookups, options.count, (uint) indexFound);
+
+	printTime("std::map" , mapTime  , options.lookups);
+	printTime("HashIndex", indexTime, options.lookups);
+}
+
+int main(int argc, char **argv) {
+	try {
+		Common::Platform::init();
+
+		std::vector<Common::UString> args;
+		Common::Platform::getParameters(argc, argv, args);
+
+		Options options;
+
+		int returnValue = 1;
+		if (!parseCommandLine(args, options, returnValue))
+			return returnValue;
+
+		benchmarkLookup(options);
+
+	} catch (...) {
+		Common::exceptionDispatcherError();
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,64 @@
+# xoreos - A reimplementation of BioWare's Aurora engine
+#
+# xoreos is the legal property of its developers, whose names
+# can be found in the AUTHORS file distributed with this source
+# distribution.
+#
+# xoreos is free software; you can redistribute it and/or
+# modify it under the terms of the GNU General Public License
+# as published by the Free Software Foundation; either version 3
+# of the License, or (at your option) any later version.
+#
+# xoreos is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+
+# Benchmarks. They're not built by default, only with "make benchmarks".
+
+EXTRA_PROGRAMS                    += benchmarks/hashindex
+benchmarks_hashindex_SOURCES       = benchmarks/hashindex.cpp
+benchmarks_hashindex_LDADD         = \
+    src/common/libcommon.la \
+    src/version/libversion.la \
+    $(LDADD) \
+    $(EMPTY)
+
+EXTRA_PROGRAMS                    += benchmarks/walkmesh
+benchmarks_walkmesh_SOURCES        = benchmarks/walkmesh.cpp
+benchmarks_walkmesh_LDADD          = \
+    src/engines/aurora/libaurora.la \
+    src/common/libcommon.la \
+    src/version/libversion.la \
+    $(LDADD) \
+    $(EMPTY)
+
+EXTRA_PROGRAMS                    += benchmarks/soundupdate
+benchmarks_soundupdate_SOURCES     = benchmarks/soundupdate.cpp
+benchmarks_soundupdate_LDADD       = \
+    src/sound/libsound.la \
+    src/common/libcommon.la \
+    src/version/libversion.la \
+    $(LDADD) \
+    $(EMPTY)
+
+EXTRA_PROGRAMS                    += benchmarks/videodecode
+benchmarks_videodecode_SOURCES     = benchmarks/videodecode.cpp
+# libgraphics and libevents depend on each other
+benchmarks_videodecode_LDADD       = \
+    src/video/libvideo.la \
+    src/events/libevents.la \
+    src/sound/libsound.la \
+    src/graphics/libgraphics.la \
+    src/events/libevents.la \
+    src/aurora/libaurora.la \
+    src/common/libcommon.la \
+    src/version/libversion.la \
+    $(LDADD) \
+    $(EMPTY)
+
+benchmarks: $(EXTRA_PROGRAMS)
+.PHONY: benchmarks
@@ -0,0 +1,201 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Benchmark for the sound thread, updating different numbers of active channels.
+ */
+
+#define SDL_MAIN_HANDLED
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <vector>
+
+#include "src/common/fallthrough.h"
+START_IGNORE_IMPLICIT_FALLTHROUGH
+#include <SDL_timer.h>
+STOP_IGNORE_IMPLICIT_FALLTHROUGH
+
+#include "src/common/types.h"
+#include "src/common/ustring.h"
+#include "src/common/error.h"
+#include "src/common/platform.h"
+#include "src/common/threads.h"
+#include "src/common/strutil.h"
+
+#include "src/sound/sound.h"
+#include "src/sound/audiostream.h"
+
+/** The options given on the command line. */
+struct Options {
+	uint32 updates; ///< Number of updates to measure for each channel count.
+
+	std::vector<uint32> channels; ///< Numbers of active channels to measure.
+
+	Options() : updates(200) {
+	}
+};
+
+static void printUsage(const char *name) {
+	std::printf("Benchmark for the xoreos sound thread\n\n");
+	std::printf("Usage: %s [<options>] [<channels> [<channels> [...]]]\n\n", name);
+	std::printf("Plays silence on the given number of channels, and prints how long\n");
+	std::printf("the sound thread takes to update all of them.\n\n");
+	std::printf("  -h      --help              Display this text and exit.\n");
+	std::printf("  -u <n>  --updates <n>       Measure n updates for each number of channels.\n\n");
+	std::printf("Without any numbers of channels, 0, 32 and 1000 channels are measured.\n");
+	std::printf("Note that OpenAL Soft only allows 256 sources by default. To go beyond,\n");
+	std::printf("raise the \"sources\" setting in its configuration file.\n");
+}
+
+static bool parseCommandLine(const std::vector<Common::UString> &args, Options &options, int &returnValue) {
+	returnValue = 1;
+
+	for (size_t i = 1; i < args.size(); i++) {
+		if ((args[i] == "-h") || (args[i] == "--help")) {
+			printUsage(args[0].c_str());
+
+			returnValue = 0;
+			return false;
+		}
+
+		if ((args[i] == "-u") || (args[i] == "--updates")) {
+			if (++i >= args.size()) {
+				std::fprintf(stderr, "Missing argument to \"%s\"\n", args[i - 1].c_str());
+				return false;
+			}
+
+			Common::parseString(args[i], options.updates);
+			continue;
+		}
+
+		if (args[i].beginsWith("-")) {
+			std::fprintf(stderr, "Unknown option \"%s\"\n\n", args[i].c_str());
+			printUsage(args[0].c_str());
+			return false;
+		}
+
+		uint32 channels = 0;
+		Common::parseString(args[i], channels);
+
+		options.channels.push_back(channels);
+	}
+
+	if (options.channels.empty()) {
+		options.channels.push_back(0);
+		options.channels.push_back(32);
+		options.channels.push_back(1000);
+	}
+
+	return true;
+}
+
+/** A mono stream of endless silence. */
+class SilenceStream : public Sound::AudioStream {
+public:
+	size_t readBuffer(int16 *buffer, const size_t numSamples) {
+		std::memset(buffer, 0, numSamples * sizeof(int16));
+
+		return numSamples;
+	}
+
+	int getChannels() const {
+		return 1;
+	}
+
+	int getRate() const {
+		return 22050;
+	}
+
+	bool endOfData() const {
+		return false;
+	}
+};
+
+static uint64 getMicroseconds(uint64 start, uint64 end) {
+	return ((end - start) * 1000000) / SDL_GetPerformanceFrequency();
+}
+
+static void benchmarkChannels(uint32 channels, const Options &options) {
+	uint32 playing = 0;
+
+	try {
+		for (playing = 0; playing < channels; playing++) {
+			Sound::ChannelHandle handle = SoundMan.playAudioStream(new SilenceStream, Sound::kSoundTypeSFX);
+			SoundMan.startChannel(handle);
+		}
+	} catch (...) {
+		Common::exceptionDispatcherWarning("Could only play %u of %u channels", playing, channels);
+	}
+
+	// Fill the buffers of the new channels first
+	SoundMan.update();
+
+	const uint64 start = SDL_GetPerformanceCounter();
+
+	for (uint32 i = 0; i < options.updates; i++)
+		SoundMan.update();
+
+	const uint64 time = getMicroseconds(start, SDL_GetPerformanceCounter());
+
+	std::printf("%5u channels: %6u updates in %10.3f ms: %10.3f us/update\n", playing, options.updates,
+	            time / 1000.0, (options.updates > 0) ? (((double) time) / options.updates) : 0.0);
+
+	SoundMan.stopAll();
+}
+
+int main(int argc, char **argv) {
+	try {
+		Common::Platform::init();
+		Common::initThreads();
+
+		std::vector<Common::UString> args;
+		Common::Platform::getParameters(argc, argv, args);
+
+		Options options;
+
+		int returnValue = 1;
+		if (!parseCommandLine(args, options, returnValue))
+			return returnValue;
+
+		SoundMan.init();
+
+		// Without a working sound device, there's nothing to measure
+		if (!alcGetCurrentContext())
+			throw Common::Exception("No sound output");
+
+		// Stop the sound thread, so that we can update the channels ourselves
+		if (!SoundMan.destroyThread())
+			throw Common::Exception("Failed to stop the sound thread");
+
+		for (std::vector<uint32>::const_iterator c = options.channels.begin(); c != options.channels.end(); ++c)
+			benchmarkChannels(*c, options);
+
+		SoundMan.deinit();
+
+	} catch (...) {
+		Common::exceptionDispatcherError();
+		return 1;
+	}
+
+	return 0;
+}
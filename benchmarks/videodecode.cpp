@@ -0,0 +1,240 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Benchmark for the video decoders, decoding videos without a window.
+ */
+
+#define SDL_MAIN_HANDLED
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <vector>
+
+#include "src/common/fallthrough.h"
+START_IGNORE_IMPLICIT_FALLTHROUGH
+#include <SDL_timer.h>
+STOP_IGNORE_IMPLICIT_FALLTHROUGH
+
+#include "src/common/types.h"
+#include "src/common/scopedptr.h"
+#include "src/common/ustring.h"
+#include "src/common/error.h"
+#include "src/common/platform.h"
+#include "src/common/threads.h"
+#include "src/common/strutil.h"
+#include "src/common/filepath.h"
+#include "src/common/readfile.h"
+#include "src/common/hash.h"
+
+#include "src/graphics/images/surface.h"
+
+#include "src/video/decoder.h"
+#include "src/video/actimagine.h"
+#include "src/video/bink.h"
+#include "src/video/quicktime.h"
+#include "src/video/xmv.h"
+
+/** The options given on the command line. */
+struct Options {
+	bool checksums;   ///< Print a checksum of every frame?
+	uint32 maxFrames; ///< Stop after this many frames.
+
+	std::vector<Common::UString> files;
+
+	Options() : checksums(false), maxFrames(0xFFFFFFFF) {
+	}
+};
+
+static void printUsage(const char *name) {
+	std::printf("Benchmark for the xoreos video decoders\n\n");
+	std::printf("Usage: %s [<options>] <file> [<file> [...]]\n\n", name);
+	std::printf("Decodes the videos as fast as possible, without a window or sound,\n");
+	std::printf("and prints the decoding speed and the time spent in each stage.\n\n");
+	std::printf("  -h      --help              Display this text and exit.\n");
+	std::printf("  -c      --checksums         Print a CRC32 checksum of every frame.\n");
+	std::printf("  -f <n>  --frames <n>        Only decode the first n frames.\n\n");
+	std::printf("Supported are Bink (.bik), QuickTime (.mov), Xbox Media Video (.xmv)\n");
+	std::printf("and Actimagine (.vx) videos.\n");
+}
+
+static bool parseCommandLine(const std::vector<Common::UString> &args, Options &options, int &returnValue) {
+	returnValue = 1;
+
+	for (size_t i = 1; i < args.size(); i++) {
+		if ((args[i] == "-h") || (args[i] == "--help")) {
+			printUsage(args[0].c_str());
+
+			returnValue = 0;
+			return false;
+		}
+
+		if ((args[i] == "-c") || (args[i] == "--checksums")) {
+			options.checksums = true;
+			continue;
+		}
+
+		if ((args[i] == "-f") || (args[i] == "--frames")) {
+			if (++i >= args.size()) {
+				std::fprintf(stderr, "Missing argument to \"%s\"\n", args[i - 1].c_str());
+				return false;
+			}
+
+			Common::parseString(args[i], options.maxFrames);
+			continue;
+		}
+
+		if (args[i].beginsWith("-")) {
+			std::fprintf(stderr, "Unknown option \"%s\"\n\n", args[i].c_str());
+			printUsage(args[0].c_str());
+			return false;
+		}
+
+		options.files.push_back(args[i]);
+	}
+
+	if (options.files.empty()) {
+		printUsage(args[0].c_str());
+		return false;
+	}
+
+	return true;
+}
+
+/** Open a video, picking the decoder by the file extension. */
+static Video::VideoDecoder *openVideo(const Common::UString &file, Common::UString &codec) {
+	const Common::UString extension = Common::FilePath::getExtension(file).toLower();
+
+	Common::ScopedPtr<Common::SeekableReadStream> stream(new Common::ReadFile(file));
+
+	if (extension == ".bik") {
+		codec = "Bink";
+		return new Video::Bink(stream.release());
+	}
+
+	if (extension == ".mov") {
+		codec = "QuickTime";
+		return new Video::QuickTimeDecoder(stream.release());
+	}
+
+	if (extension == ".xmv") {
+		codec = "XMV";
+		return new Video::XboxMediaVideo(stream.release());
+	}
+
+	if (extension == ".vx") {
+		codec = "Actimagine";
+		return new Video::ActimagineDecoder(stream.release());
+	}
+
+	throw Common::Exception("Unknown video type \"%s\"", extension.c_str());
+}
+
+/** Return a CRC32 checksum of the visible part of a video's current frame. */
+static uint32 getChecksum(const Video::VideoDecoder &video) {
+	uint32 width, height;
+	video.getSize(width, height);
+
+	const Graphics::Surface &surface = video.getSurface();
+
+	uint32 hash = 0xFFFFFFFF;
+	for (uint32 y = 0; y < height; y++) {
+		const byte *row = surface.getData() + y * surface.getWidth() * 4;
+
+		for (uint32 x = 0; x < width * 4; x++)
+			hash = Common::hashCRC32(hash, row[x]);
+	}
+
+	return hash ^ 0xFFFFFFFF;
+}
+
+static uint64 getMicroseconds(uint64 start, uint64 end) {
+	return ((end - start) * 1000000) / SDL_GetPerformanceFrequency();
+}
+
+static void printStage(const char *name, uint64 time, uint32 frames) {
+	std::printf("  %-8s %10.3f s  %9.3f ms/frame\n", name, time / 1000000.0,
+	            (frames > 0) ? ((time / 1000.0) / frames) : 0.0);
+}
+
+static void benchmarkVideo(const Common::UString &file, const Options &options) {
+	Common::UString codec;
+	Common::ScopedPtr<Video::VideoDecoder> video(openVideo(file, codec));
+
+	uint32 width, height;
+	video->getSize(width, height);
+
+	std::printf("%s: %s, %ux%u\n", file.c_str(), codec.c_str(), width, height);
+
+	uint32 frames = 0;
+	uint64 total  = 0;
+
+	while (frames < options.maxFrames) {
+		const uint64 start = SDL_GetPerformanceCounter();
+
+		if (!video->decodeNextFrame())
+			break;
+
+		total += getMicroseconds(start, SDL_GetPerformanceCounter());
+
+		if (options.checksums)
+			std::printf("  frame %6u: %08X\n", frames, getChecksum(*video));
+
+		frames++;
+	}
+
+	const double seconds = total / 1000000.0;
+
+	std::printf("  %u frames in %.3f s: %.2f fps\n", frames, seconds, (total > 0) ? (frames / seconds) : 0.0);
+
+	printStage("audio"  , video->getStageTime(Video::VideoDecoder::kStageAudio)  , frames);
+	printStage("video"  , video->getStageTime(Video::VideoDecoder::kStageVideo)  , frames);
+	printStage("convert", video->getStageTime(Video::VideoDecoder::kStageConvert), frames);
+	printStage("total"  , total, frames);
+}
+
+int main(int argc, char **argv) {
+	try {
+		Common::Platform::init();
+		Common::initThreads();
+
+		std::vector<Common::UString> args;
+		Common::Platform::getParameters(argc, argv, args);
+
+		Options options;
+
+		int returnValue = 1;
+		if (!parseCommandLine(args, options, returnValue))
+			return returnValue;
+
+		// We have neither a window nor a sound device
+		Video::VideoDecoder::setHeadless(true);
+
+		for (std::vector<Common::UString>::const_iterator f = options.files.begin(); f != options.files.end(); ++f)
+			benchmarkVideo(*f, options);
+
+	} catch (...) {
+		Common::exceptionDispatcherError();
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,249 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Benchmark for walkmesh elevation queries, on synthetic walkmeshes.
+ */
+
+#define SDL_MAIN_HANDLED
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <vector>
+
+#include "src/common/fallthrough.h"
+START_IGNORE_IMPLICIT_FALLTHROUGH
+#include <SDL_timer.h>
+STOP_IGNORE_IMPLICIT_FALLTHROUGH
+
+#include "glm/gtc/type_ptr.hpp"
+#include "glm/gtx/intersect.hpp"
+
+#include "src/common/types.h"
+#include "src/common/util.h"
+#include "src/common/maths.h"
+#include "src/common/ustring.h"
+#include "src/common/error.h"
+#include "src/common/platform.h"
+#include "src/common/strutil.h"
+
+#include "src/engines/aurora/walkmesh.h"
+#include "src/engines/aurora/walkeleveval.h"
+
+/** The options given on the command line. */
+struct Options {
+	uint32 queries; ///< Number of elevation queries for each walkmesh.
+
+	std::vector<uint32> sizes; ///< Number of quads along each side of the walkmeshes.
+
+	Options() : queries(100000) {
+	}
+};
+
+static void printUsage(const char *name) {
+	std::printf("Benchmark for the xoreos walkmesh elevation queries\n\n");
+	std::printf("Usage: %s [<options>] [<size> [<size> [...]]]\n\n", name);
+	std::printf("Builds height field walkmeshes of size * size quads, and prints how many\n");
+	std::printf("elevation queries per second can be answered, both with the walkmesh's\n");
+	std::printf("face grid and by looking at every single face.\n\n");
+	std::printf("  -h      --help              Display this text and exit.\n");
+	std::printf("  -q <n>  --queries <n>       Run n queries on each walkmesh.\n\n");
+	std::printf("Without any sizes, walkmeshes of 16, 64 and 256 quads per side are used.\n");
+}
+
+static bool parseCommandLine(const std::vector<Common::UString> &args, Options &options, int &returnValue) {
+	returnValue = 1;
+
+	for (size_t i = 1; i < args.size(); i++) {
+		if ((args[i] == "-h") || (args[i] == "--help")) {
+			printUsage(args[0].c_str());
+
+			returnValue = 0;
+			return false;
+		}
+
+		if ((args[i] == "-q") || (args[i] == "--queries")) {
+			if (++i >= args.size()) {
+				std::fprintf(stderr, "Missing argument to \"%s\"\n", args[i - 1].c_str());
+				return false;
+			}
+
+			Common::parseString(args[i], options.queries);
+			continue;
+		}
+
+		if (args[i].beginsWith("-")) {
+			std::fprintf(stderr, "Unknown option \"%s\"\n\n", args[i].c_str());
+			printUsage(args[0].c_str());
+			return false;
+		}
+
+		uint32 size = 0;
+		Common::parseString(args[i], size);
+
+		if (size == 0) {
+			std::fprintf(stderr, "Invalid walkmesh size \"%s\"\n", args[i].c_str());
+			return false;
+		}
+
+		options.sizes.push_back(size);
+	}
+
+	if (options.sizes.empty()) {
+		options.sizes.push_back(16);
+		options.sizes.push_back(64);
+		options.sizes.push_back(256);
+	}
+
+	return true;
+}
+
+/** A rolling height field of size * size quads, with every seventh face not walkable. */
+class HeightFieldWalkmesh : public Engines::Walkmesh {
+public:
+	HeightFieldWalkmesh(uint32 size) {
+		const uint32 rowSize = size + 1;
+
+		for (uint32 y = 0; y < rowSize; y++) {
+			for (uint32 x = 0; x < rowSize; x++) {
+				_data.vertices.push_back(x);
+				_data.vertices.push_back(y);
+				_data.vertices.push_back(sinf(x * 0.3f) * cosf(y * 0.2f) * 5.0f);
+			}
+		}
+
+		for (uint32 y = 0; y < size; y++) {
+			for (uint32 x = 0; x < size; x++) {
+				const uint32 a = y * rowSize + x;
+
+				addFace(a, a + 1, a + rowSize + 1);
+				addFace(a, a + rowSize + 1, a + rowSize);
+			}
+		}
+
+		refreshIndexGroups();
+	}
+
+private:
+	void addFace(uint32 a, uint32 b, uint32 c) {
+		_data.indices.push_back(a);
+		_data.indices.push_back(b);
+		_data.indices.push_back(c);
+
+		_data.faceWalkableMap.push_back((_data.faceWalkableMap.size() % 7) != 0);
+	}
+};
+
+/** Find the elevation by intersecting with every walkable face, like before the walkmesh had a grid. */
+static float getElevationBruteForce(const Engines::Walkmesh &walkmesh, float x, float y) {
+	const std::vector<float>  &vertices = walkmesh.getData().vertices;
+	const std::vector<uint32> &indices  = walkmesh.getIndicesWalkable();
+
+	for (size_t i = 0; i < indices.size(); i += 3) {
+		glm::vec3 v0 = glm::make_vec3(&vertices[3 * indices[i + 0]]);
+		glm::vec3 v1 = glm::make_vec3(&vertices[3 * indices[i + 1]]);
+		glm::vec3 v2 = glm::make_vec3(&vertices[3 * indices[i + 2]]);
+
+		glm::vec3 intersection;
+		if (glm::intersectRayTriangle(glm::vec3(x, y, 1000), glm::vec3(0, 0, -1), v0, v1, v2, intersection))
+			return (v0 * (1.0f - intersection.x - intersection.y) +
+			        v1 * intersection.x +
+			        v2 * intersection.y).z;
+	}
+
+	return FLT_MIN;
+}
+
+static uint64 getMicroseconds(uint64 start, uint64 end) {
+	return ((end - start) * 1000000) / SDL_GetPerformanceFrequency();
+}
+
+static void printRate(const char *name, uint64 time, uint32 queries) {
+	std::printf("  %-12s %8u queries in %10.3f s: %14.0f queries/s\n", name, queries, time / 1000000.0,
+	            (time > 0) ? (queries / (time / 1000000.0)) : 0.0);
+}
+
+static void benchmarkWalkmesh(uint32 size, const Options &options) {
+	uint64 start = SDL_GetPerformanceCounter();
+
+	HeightFieldWalkmesh walkmesh(size);
+
+	const uint64 build = getMicroseconds(start, SDL_GetPerformanceCounter());
+
+	std::printf("%u * %u quads, %u walkable faces, grid built in %.3f ms\n", size, size,
+	            (uint32) (walkmesh.getIndicesWalkable().size() / 3), build / 1000.0);
+
+	// Spread the query points evenly over the walkmesh and a bit beyond
+	std::vector<float> x(options.queries), y(options.queries), z(options.queries);
+	for (uint32 i = 0; i < options.queries; i++) {
+		x[i] = (fmodf(i * 0.6180340f, 1.0f) * 1.1f - 0.05f) * size;
+		y[i] = (fmodf(i * 0.7548777f, 1.0f) * 1.1f - 0.05f) * size;
+	}
+
+	if (options.queries == 0)
+		return;
+
+	start = SDL_GetPerformanceCounter();
+
+	Engines::WalkmeshElevationEvaluator::getElevationsAt(walkmesh, options.queries, &x[0], &y[0], &z[0]);
+
+	printRate("grid", getMicroseconds(start, SDL_GetPerformanceCounter()), options.queries);
+
+	// Looking at every face is slow, so only do a fraction of the queries on big walkmeshes
+	const uint32 bruteQueries = MAX<uint32>(MIN<uint32>(options.queries, 100000000 / (2 * size * size)), 1);
+
+	uint32 mismatches = 0;
+
+	start = SDL_GetPerformanceCounter();
+
+	for (uint32 i = 0; i < bruteQueries; i++)
+		if (getElevationBruteForce(walkmesh, x[i], y[i]) != z[i])
+			mismatches++;
+
+	printRate("brute force", getMicroseconds(start, SDL_GetPerformanceCounter()), bruteQueries);
+
+	if (mismatches > 0)
+		std::printf("  %u of %u elevations differ between grid and brute force\n", mismatches, bruteQueries);
+}
+
+int main(int argc, char **argv) {
+	try {
+		Common::Platform::init();
+
+		std::vector<Common::UString> args;
+		Common::Platform::getParameters(argc, argv, args);
+
+		Options options;
+
+		int returnValue = 1;
+		if (!parseCommandLine(args, options, returnValue))
+			return returnValue;
+
+		for (std::vector<uint32>::const_iterator s = options.sizes.begin(); s != options.sizes.end(); ++s)
+			benchmarkWalkmesh(*s, options);
+
+	} catch (...) {
+		Common::exceptionDispatcherError();
+		return 1;
+	}
+
+	return 0;
+}
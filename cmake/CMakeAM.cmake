@@ -233,7 +233,7 @@ function(parse_automake AM_FILE_NAME)
 
   # Search for programs, creating CMake targets
   set(AM_PROGRAMS)
-  foreach(AM_FILE ${bin_PROGRAMS} ${check_PROGRAMS})
+  foreach(AM_FILE ${bin_PROGRAMS} ${check_PROGRAMS} ${EXTRA_PROGRAMS})
     string(REPLACE "." "_" AM_NAME "${AM_FILE}")
     string(REPLACE "/" "_" AM_NAME "${AM_NAME}")
     am_add_target(bin ${AM_FOLDER} ${AM_FILE} "${${AM_NAME}_SOURCES}" "${${AM_NAME}_LDADD}")
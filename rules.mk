@@ -122,3 +122,5 @@ include glm/rules.mk
 include src/rules.mk
 
 include tests/rules.mk
+
+include benchmarks/rules.mk
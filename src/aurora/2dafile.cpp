@@ -27,6 +27,8 @@
  */
 
 #include <cassert>
+#include <cstdlib>
+#include <cctype>
 
 #include "src/common/util.h"
 #include "src/common/error.h"
@@ -50,7 +52,7 @@ static const uint32 kVersion2b = MKTAG('V', '2', '.', 'b');
 
 namespace Aurora {
 
-TwoDARow::TwoDARow(TwoDAFile &parent) : _parent(&parent) {
+TwoDARow::TwoDARow(TwoDAFile &parent, size_t row) : _parent(&parent), _row(row) {
 }
 
 TwoDARow::~TwoDARow() {
@@ -65,14 +67,13 @@ const Common::UString &TwoDARow::getString(size_t column) const {
 }
 
 const Common::UString &TwoDARow::getString(const Common::UString &column) const {
-	const Common::UString &cell = getCell(_parent->headerToColumn(column));
-	if (cell.empty() || (cell == "****"))
-		return _parent->_defaultString;
-
-	return cell;
+	return getString(_parent->headerToColumn(column));
 }
 
 int32 TwoDARow::getInt(size_t column) const {
+	if ((column < _parent->_columns.size()) && _parent->_columns[column].numeric && (_row < _parent->_rows.size()))
+		return _parent->_columns[column].ints[_row];
+
 	const Common::UString &cell = getCell(column);
 	if (cell.empty() || (cell == "****"))
 		return _parent->_defaultInt;
@@ -81,14 +82,13 @@ int32 TwoDARow::getInt(size_t column) const {
 }
 
 int32 TwoDARow::getInt(const Common::UString &column) const {
-	const Common::UString &cell = getCell(_parent->headerToColumn(column));
-	if (cell.empty() || (cell == "****"))
-		return _parent->_defaultInt;
-
-	return _parent->parseInt(cell);
+	return getInt(_parent->headerToColumn(column));
 }
 
 float TwoDARow::getFloat(size_t column) const {
+	if ((column < _parent->_columns.size()) && _parent->_columns[column].numeric && (_row < _parent->_rows.size()))
+		return _parent->_columns[column].floats[_row];
+
 	const Common::UString &cell = getCell(column);
 	if (cell.empty() || (cell == "****"))
 		return _parent->_defaultFloat;
@@ -97,11 +97,7 @@ float TwoDARow::getFloat(size_t column) const {
 }
 
 float TwoDARow::getFloat(const Common::UString &column) const {
-	const Common::UString &cell = getCell(_parent->headerToColumn(column));
-	if (cell.empty() || (cell == "****"))
-		return _parent->_defaultFloat;
-
-	return _parent->parseFloat(cell);
+	return getFloat(_parent->headerToColumn(column));
 }
 
 bool TwoDARow::empty(size_t column) const {
@@ -116,23 +112,23 @@ bool TwoDARow::empty(const Common::UString &column) const {
 	return empty(_parent->headerToColumn(column));
 }
 
-static const Common::UString kEmpty;
 const Common::UString &TwoDARow::getCell(size_t n) const {
-	if (n >= _data.size())
-		return kEmpty;
+	return _parent->getCell(_row, n);
+}
+
 
-	return _data[n];
+TwoDAFile::Column::Column() : numeric(false) {
 }
 
 
 TwoDAFile::TwoDAFile(Common::SeekableReadStream &twoda) :
-	_defaultInt(0), _defaultFloat(0.0f), _emptyRow(*this) {
+	_defaultInt(0), _defaultFloat(0.0f), _emptyRow(*this, SIZE_MAX) {
 
 	load(twoda);
 }
 
 TwoDAFile::TwoDAFile(const GDAFile &gda) :
-	_defaultInt(0), _defaultFloat(0.0f), _emptyRow(*this) {
+	_defaultInt(0), _defaultFloat(0.0f), _emptyRow(*this, SIZE_MAX) {
 
 	load(gda);
 }
@@ -162,6 +158,9 @@ void TwoDAFile::load(Common::SeekableReadStream &twoda) {
 		// Create the map to quickly translate headers to column indices
 		createHeaderMap();
 
+		// Parse the numerical columns
+		parseColumns();
+
 	} catch (Common::Exception &e) {
 		e.add("Failed reading 2DA file");
 		throw;
@@ -231,9 +230,12 @@ void TwoDAFile::readRows2a(Common::SeekableReadStream &twoda,
 
 	const size_t columnCount = _headers.size();
 
-	while (!twoda.eos()) {
-		Common::ScopedPtr<TwoDARow> row(new TwoDARow(*this));
+	_columns.resize(columnCount);
+
+	size_t rowCount = 0;
+	std::vector<Common::UString> cells;
 
+	while (!twoda.eos()) {
 		/* Skip the first token, which is the row index, possibly indented.
 		 * The row index is implicit in the data and its use in the 2DA
 		 * file is only meant as a guideline for people editing the file by
@@ -242,7 +244,7 @@ void TwoDAFile::readRows2a(Common::SeekableReadStream &twoda,
 		tokenize.skipToken(twoda);
 
 		// Read all the cells in the row
-		size_t count = tokenize.getTokens(twoda, row->_data, columnCount, columnCount, "****");
+		size_t count = tokenize.getTokens(twoda, cells, columnCount, columnCount, "****");
 
 		// And move to the next line
 		tokenize.nextChunk(twoda);
@@ -251,8 +253,13 @@ void TwoDAFile::readRows2a(Common::SeekableReadStream &twoda,
 		if (count == 0)
 			continue;
 
-		_rows.push_back(row.release());
+		for (size_t i = 0; i < columnCount; i++)
+			_columns[i].cells.push_back(cells[i]);
+
+		rowCount++;
 	}
+
+	createRows(rowCount);
 }
 
 void TwoDAFile::readHeaders2b(Common::SeekableReadStream &twoda) {
@@ -280,7 +287,7 @@ void TwoDAFile::skipRowNames2b(Common::SeekableReadStream &twoda) {
 	 */
 
 	const uint32 rowCount = twoda.readUint32LE();
-	_rows.resize(rowCount, 0);
+	createRows(rowCount);
 
 	Common::StreamTokenizer tokenize(Common::StreamTokenizer::kRuleHeed);
 
@@ -317,22 +324,30 @@ void TwoDAFile::readRows2b(Common::SeekableReadStream &twoda) {
 	const size_t dataOffset = twoda.pos();
 
 	for (size_t i = 0; i < rowCount; i++) {
-		_rows[i] = new TwoDARow(*this);
-
-		_rows[i]->_data.resize(columnCount);
-
 		for (size_t j = 0; j < columnCount; j++) {
 			const size_t offset = dataOffset + offsets[i * columnCount + j];
 
 			twoda.seek(offset);
 
-			_rows[i]->_data[j] = tokenize.getToken(twoda);
-			if (_rows[i]->_data[j].empty())
-				_rows[i]->_data[j] = "****";
+			Common::UString &cell = _columns[j].cells[i];
+
+			cell = tokenize.getToken(twoda);
+			if (cell.empty())
+				cell = "****";
 		}
 	}
 }
 
+void TwoDAFile::createRows(size_t rowCount) {
+	_columns.resize(_headers.size());
+	for (std::vector<Column>::iterator c = _columns.begin(); c != _columns.end(); ++c)
+		c->cells.resize(rowCount);
+
+	_rows.reserve(rowCount);
+	for (size_t i = 0; i < rowCount; i++)
+		_rows.push_back(new TwoDARow(*this, i));
+}
+
 void TwoDAFile::createHeaderMap() {
 	for (size_t i = 0; i < _headers.size(); i++)
 		_headerMap.insert(std::make_pair(_headers[i], i));
@@ -351,31 +366,31 @@ void TwoDAFile::load(const GDAFile &gda) {
 			_headers[i] = headerString ? headerString : Common::UString::format("[%u]", headers[i].hash);
 		}
 
-		_rows.resize(gda.getRowCount(), 0);
+		createRows(gda.getRowCount());
+
 		for (size_t i = 0; i < gda.getRowCount(); i++) {
 			const GFF4Struct *row = gda.getRow(i);
 
-			_rows[i] = new TwoDARow(*this);
-			_rows[i]->_data.resize(gda.getColumnCount());
-
 			for (size_t j = 0; j < gda.getColumnCount(); j++) {
+				Common::UString &cell = _columns[j].cells[i];
+
 				if (row) {
 					switch (headers[j].type) {
 						case GDAFile::kTypeString:
 						case GDAFile::kTypeResource:
-							_rows[i]->_data[j] = row->getString(headers[j].field);
+							cell = row->getString(headers[j].field);
 							break;
 
 						case GDAFile::kTypeInt:
-							_rows[i]->_data[j] = Common::UString::format("%d", (int) row->getSint(headers[j].field));
+							cell = Common::UString::format("%d", (int) row->getSint(headers[j].field));
 							break;
 
 						case GDAFile::kTypeFloat:
-							_rows[i]->_data[j] = Common::UString::format("%f", row->getDouble(headers[j].field));
+							cell = Common::UString::format("%f", row->getDouble(headers[j].field));
 							break;
 
 						case GDAFile::kTypeBool:
-							_rows[i]->_data[j] = Common::UString::format("%u", (uint) row->getUint(headers[j].field));
+							cell = Common::UString::format("%u", (uint) row->getUint(headers[j].field));
 							break;
 
 						default:
@@ -383,8 +398,8 @@ void TwoDAFile::load(const GDAFile &gda) {
 					}
 				}
 
-				if (_rows[i]->_data[j].empty())
-					_rows[i]->_data[j] = "****";
+				if (cell.empty())
+					cell = "****";
 
 			}
 		}
@@ -395,6 +410,41 @@ void TwoDAFile::load(const GDAFile &gda) {
 	}
 
 	createHeaderMap();
+	parseColumns();
+}
+
+void TwoDAFile::parseColumns() {
+	const size_t rowCount = _rows.size();
+
+	for (std::vector<Column>::iterator c = _columns.begin(); c != _columns.end(); ++c) {
+		c->numeric = true;
+
+		for (std::vector<Common::UString>::const_iterator cell = c->cells.begin(); cell != c->cells.end(); ++cell) {
+			if (!cell->empty() && (*cell != "****") && !isNumber(*cell)) {
+				c->numeric = false;
+				break;
+			}
+		}
+
+		if (!c->numeric)
+			continue;
+
+		c->ints.resize(rowCount);
+		c->floats.resize(rowCount);
+
+		for (size_t i = 0; i < rowCount; i++) {
+			const Common::UString &cell = c->cells[i];
+
+			if (cell.empty() || (cell == "****")) {
+				c->ints  [i] = _defaultInt;
+				c->floats[i] = _defaultFloat;
+				continue;
+			}
+
+			c->ints  [i] = parseInt  (cell);
+			c->floats[i] = parseFloat(cell);
+		}
+	}
 }
 
 size_t TwoDAFile::getRowCount() const {
@@ -431,13 +481,62 @@ const TwoDARow &TwoDAFile::getRow(const Common::UString &header, const Common::U
 	if (columnIndex == kFieldIDInvalid)
 		return _emptyRow;
 
-	for (std::vector<TwoDARow *>::const_iterator row = _rows.begin(); row != _rows.end(); ++row) {
-		if ((*row)->getString(columnIndex).equalsIgnoreCase(value))
-			return **row;
-	}
+	const RowIndex &index = getRowIndex(columnIndex);
+
+	RowIndex::const_iterator row = index.find(value);
+	if (row == index.end())
+		// No such row
+		return _emptyRow;
+
+	return *_rows[row->second];
+}
+
+const TwoDAFile::RowIndex &TwoDAFile::getRowIndex(size_t column) const {
+	Common::StackLock lock(_rowIndexMutex);
+
+	RowIndices::iterator index = _rowIndices.find(column);
+	if (index != _rowIndices.end())
+		return index->second;
+
+	index = _rowIndices.insert(std::make_pair(column, RowIndex())).first;
+
+	// Map each value onto the first row that has it
+	for (size_t i = 0; i < _rows.size(); i++)
+		index->second.insert(std::make_pair(_rows[i]->getString(column), i));
+
+	return index->second;
+}
+
+const Common::UString &TwoDAFile::getCell(size_t row, size_t column) const {
+	static const Common::UString kEmpty;
+
+	if ((column >= _columns.size()) || (row >= _columns[column].cells.size()))
+		return kEmpty;
+
+	return _columns[column].cells[row];
+}
+
+bool TwoDAFile::isNumericColumn(size_t column) const {
+	if (column >= _columns.size())
+		return false;
+
+	return _columns[column].numeric;
+}
+
+static const std::vector<int32> kEmptyIntColumn;
+const std::vector<int32> &TwoDAFile::getIntColumn(size_t column) const {
+	if (!isNumericColumn(column))
+		return kEmptyIntColumn;
+
+	return _columns[column].ints;
+}
+
+static const std::vector<float> kEmptyFloatColumn;
+const std::vector<float> &TwoDAFile::getFloatColumn(size_t column) const {
+	if (!isNumericColumn(column))
+		return kEmptyFloatColumn;
 
-	// No such row
-	return _emptyRow;
+	return _columns[column].floats;
 }
 
 void TwoDAFile::writeASCII(Common::WriteStream &out) const {
@@ -460,9 +559,11 @@ void TwoDAFile::writeASCII(Common::WriteStream &out) const {
 		colLength[i + 1] = _headers[i].size();
 
 	for (size_t i = 0; i < _rows.size(); i++) {
-		for (size_t j = 0; j < _rows[i]->_data.size(); j++) {
-			const bool   needQuote = _rows[i]->_data[j].contains(' ');
-			const size_t length    = needQuote ? _rows[i]->_data[j].size() + 2 : _rows[i]->_data[j].size();
+		for (size_t j = 0; j < _columns.size(); j++) {
+			const Common::UString &cell = _columns[j].cells[i];
+
+			const bool   needQuote = cell.contains(' ');
+			const size_t length    = needQuote ? cell.size() + 2 : cell.size();
 
 			colLength[j + 1] = MAX<size_t>(colLength[j + 1], length);
 		}
@@ -482,14 +583,16 @@ void TwoDAFile::writeASCII(Common::WriteStream &out) const {
 	for (size_t i = 0; i < _rows.size(); i++) {
 		out.writeString(Common::UString::format("%*u", (int)colLength[0], (uint)i));
 
-		for (size_t j = 0; j < _rows[i]->_data.size(); j++) {
-			const bool needQuote = _rows[i]->_data[j].contains(' ');
+		for (size_t j = 0; j < _columns.size(); j++) {
+			const Common::UString &cell = _columns[j].cells[i];
+
+			const bool needQuote = cell.contains(' ');
 
 			Common::UString cellString;
 			if (needQuote)
-				cellString = Common::UString::format("\"%s\"", _rows[i]->_data[j].c_str());
+				cellString = Common::UString::format("\"%s\"", cell.c_str());
 			else
-				cellString = _rows[i]->_data[j];
+				cellString = cell;
 
 			out.writeString(Common::UString::format(" %-*s", (int)colLength[j + 1], cellString.c_str()));
 
@@ -641,19 +744,21 @@ void TwoDAFile::writeCSV(Common::WriteStream &out) const {
 	// Write array
 
 	for (size_t i = 0; i < _rows.size(); i++) {
-		for (size_t j = 0; j < _rows[i]->_data.size(); j++) {
-			const bool needQuote = _rows[i]->_data[j].contains(',');
+		for (size_t j = 0; j < _columns.size(); j++) {
+			const Common::UString &cell = _columns[j].cells[i];
+
+			const bool needQuote = cell.contains(',');
 
 			if (needQuote)
 				out.writeByte('"');
 
-			if (_rows[i]->_data[j] != "****")
-				out.writeString(_rows[i]->_data[j]);
+			if (cell != "****")
+				out.writeString(cell);
 
 			if (needQuote)
 				out.writeByte('"');
 
-			if (j < (_rows[i]->_data.size() - 1))
+			if (j < (_columns.size() - 1))
 				out.writeByte(',');
 		}
 
@@ -674,8 +779,42 @@ bool TwoDAFile::writeCSV(const Common::UString &fileName) const {
 	return true;
 }
 
+/** Does this string look like something parseString() will accept?
+ *
+ *  This mirrors parseString()'s own syntax check, so that the common
+ *  case of a non-numerical cell doesn't need to go through an exception.
+ */
+static bool isParseable(const Common::UString &str, bool integer) {
+	const char *nptr = str.c_str();
+	char *endptr = 0;
+
+	if (integer)
+		strtol(nptr, &endptr, 0);
+	else
+		strtod(nptr, &endptr);
+
+	while (endptr && isspace(*endptr))
+		endptr++;
+
+	return !endptr || (*endptr == '\0');
+}
+
+bool TwoDAFile::isNumber(const Common::UString &str) {
+	if (str.empty() || !isParseable(str, false))
+		return false;
+
+	try {
+		double v;
+		Common::parseString(str, v);
+	} catch (...) {
+		return false;
+	}
+
+	return true;
+}
+
 int32 TwoDAFile::parseInt(const Common::UString &str) {
-	if (str.empty())
+	if (str.empty() || !isParseable(str, true))
 		return 0;
 
 	int32 v = 0;
@@ -689,7 +828,7 @@ int32 TwoDAFile::parseInt(const Common::UString &str) {
 }
 
 float TwoDAFile::parseFloat(const Common::UString &str) {
-	if (str.empty())
+	if (str.empty() || !isParseable(str, false))
 		return 0;
 
 	float v = 0.0f;
@@ -29,10 +29,12 @@
 #include <map>
 
 #include <boost/noncopyable.hpp>
+#include <boost/unordered/unordered_map.hpp>
 
 #include "src/common/types.h"
 #include "src/common/ustring.h"
 #include "src/common/ptrvector.h"
+#include "src/common/mutex.h"
 
 #include "src/aurora/aurorafile.h"
 
@@ -82,10 +84,9 @@ public:
 
 private:
 	TwoDAFile *_parent; ///< The parent 2DA.
+	size_t     _row;    ///< The index of this row within the parent 2DA.
 
-	std::vector<Common::UString> _data;
-
-	TwoDARow(TwoDAFile &parent);
+	TwoDARow(TwoDAFile &parent, size_t row);
 	~TwoDARow();
 
 	const Common::UString &getCell(size_t n) const;
@@ -142,9 +143,31 @@ public:
 	/** Get a row. */
 	const TwoDARow &getRow(size_t row) const;
 
-	/** Get a row whose value in the column named header is the given string value. */
+	/** Get a row whose value in the column named header is the given string value.
+	 *
+	 *  The first time a column is searched this way, a hash index of its values is
+	 *  created, so further searches in the same column are fast.
+	 */
 	const TwoDARow &getRow(const Common::UString &header, const Common::UString &value) const;
 
+	// .--- Typed column access
+	/** Are all non-empty cells in this column valid numbers? */
+	bool isNumericColumn(size_t column) const;
+
+	/** Return the cells of this column, as parsed by TwoDARow::getInt(), for all rows.
+	 *
+	 *  Numerical columns are parsed once, when loading the 2DA. For a column
+	 *  that's not numerical, an empty array is returned.
+	 */
+	const std::vector<int32> &getIntColumn(size_t column) const;
+	/** Return the cells of this column, as parsed by TwoDARow::getFloat(), for all rows.
+	 *
+	 *  Numerical columns are parsed once, when loading the 2DA. For a column
+	 *  that's not numerical, an empty array is returned.
+	 */
+	const std::vector<float> &getFloatColumn(size_t column) const;
+	// '---
+
 	// .--- 2DA file writers
 	/** Write the 2DA data into an V2.0 ASCII 2DA. */
 	void writeASCII(Common::WriteStream &out) const;
@@ -163,7 +186,25 @@ public:
 	// '---
 
 private:
-	typedef std::map<Common::UString, size_t, Common::UString::iless> HeaderMap;
+	/** A column of the 2DA. We store the cells column by column. */
+	struct Column {
+		std::vector<Common::UString> cells; ///< The raw cell strings, for all rows.
+
+		bool numeric; ///< Are all non-empty cells valid numbers?
+
+		std::vector<int32> ints;   ///< All cells parsed as ints. Only for numeric columns.
+		std::vector<float> floats; ///< All cells parsed as floats. Only for numeric columns.
+
+		Column();
+	};
+
+	typedef boost::unordered_map<Common::UString, size_t,
+	        Common::hashUStringCaseInsensitive, Common::equalsUStringCaseInsensitive> HeaderMap;
+
+	/** An index from the cell values of a column onto the first row with that value. */
+	typedef boost::unordered_map<Common::UString, size_t,
+	        Common::hashUStringCaseInsensitive, Common::equalsUStringCaseInsensitive> RowIndex;
+	typedef std::map<size_t, RowIndex> RowIndices;
 
 	Common::UString _defaultString; ///< The default string to return should a cell not exist.
 	int32           _defaultInt;    ///< The default int to return should a cell not exist.
@@ -172,9 +213,14 @@ private:
 	std::vector<Common::UString> _headers;
 	HeaderMap _headerMap;
 
+	std::vector<Column> _columns;
+
 	TwoDARow _emptyRow;
 	Common::PtrVector<TwoDARow> _rows;
 
+	mutable RowIndices    _rowIndices;     ///< Indices for getRow(header, value), created on demand.
+	mutable Common::Mutex _rowIndexMutex;
+
 	// Loading helpers
 	void load(Common::SeekableReadStream &twoda);
 	void read2a(Common::SeekableReadStream &twoda);
@@ -193,7 +239,16 @@ private:
 	// GDA loading/conversion helpers
 	void load(const GDAFile &gda);
 
+	/** Create this many rows, and make room for their cells in all columns. */
+	void createRows(size_t rowCount);
 	void createHeaderMap();
+	void parseColumns();
+
+	const Common::UString &getCell(size_t row, size_t column) const;
+	const RowIndex &getRowIndex(size_t column) const;
+
+	/** Is this string a valid number, i.e. would parseFloat() succeed on it? */
+	static bool isNumber(const Common::UString &str);
 
 	static int32 parseInt(const Common::UString &str);
 	static float parseFloat(const Common::UString &str);
@@ -28,6 +28,9 @@
 
 #include <cassert>
 
+#include <algorithm>
+
+#include "src/common/util.h"
 #include "src/common/error.h"
 #include "src/common/memreadstream.h"
 #include "src/common/encoding.h"
@@ -44,6 +47,8 @@ static const uint32 kVersion33 = MKTAG('V', '3', '.', '3'); // Found in The Witc
 
 namespace Aurora {
 
+const GFF3File::LabelID GFF3File::kLabelNone;
+
 GFF3File::Header::Header() {
 }
 
@@ -98,6 +103,7 @@ void GFF3File::load(uint32 id) {
 	try {
 
 		loadHeader(id);
+		loadLabels();
 		loadStructs();
 		loadLists();
 
@@ -180,6 +186,29 @@ void GFF3File::loadHeader(uint32 id) {
 		throw Common::Exception("GFF3 header broken: section offset points outside stream");
 }
 
+void GFF3File::loadLabels() {
+	/* Intern all field labels: every distinct label gets a small numerical ID,
+	 * which is all a struct needs to store for each of its fields. */
+
+	static const uint32 kLabelSize = 16;
+
+	// Only read as many labels as actually fit. Fields using the others will fail to load
+	const uint32 labelCount = MIN<uint64>(_header.labelCount, (_stream->size() - _header.labelOffset) / kLabelSize);
+
+	_stream->seek(_header.labelOffset);
+
+	_labelIDs.reserve(labelCount);
+	for (uint32 i = 0; i < labelCount; i++) {
+		const Common::UString label = Common::readStringFixed(*_stream, Common::kEncodingASCII, kLabelSize);
+
+		std::pair<LabelMap::iterator, bool> result = _labelMap.insert(std::make_pair(label, (LabelID) _labels.size()));
+		if (result.second)
+			_labels.push_back(label);
+
+		_labelIDs.push_back(result.first->second);
+	}
+}
+
 void GFF3File::loadStructs() {
 	static const uint32 kStructSize = 12;
 
@@ -272,6 +301,28 @@ const GFF3List &GFF3File::getList(uint32 i) const {
 	return _lists[listIndex];
 }
 
+GFF3File::LabelID GFF3File::getLabelIDFromTable(uint32 i) const {
+	if (i >= _labelIDs.size())
+		throw Common::Exception("GFF3: Label index out of range (%u >= %u)", i, (uint) _labelIDs.size());
+
+	return _labelIDs[i];
+}
+
+GFF3File::LabelID GFF3File::getLabelID(const Common::UString &label) const {
+	LabelMap::const_iterator id = _labelMap.find(label);
+	if (id == _labelMap.end())
+		return kLabelNone;
+
+	return id->second;
+}
+
+const Common::UString &GFF3File::getLabel(LabelID id) const {
+	if (id >= _labels.size())
+		throw Common::Exception("GFF3: Label ID out of range (%u >= %u)", id, (uint) _labels.size());
+
+	return _labels[id];
+}
+
 Common::SeekableReadStream &GFF3File::getStream(uint32 offset) const {
 	_stream->seek(offset);
 
@@ -283,10 +334,12 @@ Common::SeekableReadStream &GFF3File::getFieldData() const {
 }
 
 
-GFF3Struct::Field::Field() : type(kFieldTypeNone), data(0), extended(false) {
+GFF3Struct::Field::Field() : label(GFF3File::kLabelNone), type(kFieldTypeNone), data(0), index(0), extended(false) {
 }
 
-GFF3Struct::Field::Field(FieldType t, uint32 d) : type(t), data(d) {
+GFF3Struct::Field::Field(GFF3File::LabelID l, FieldType t, uint32 d, uint32 i) :
+	label(l), type(t), data(d), index(i) {
+
 	// These field types need extended field data
 	extended = (type == kFieldTypeUint64     ) ||
 	           (type == kFieldTypeSint64     ) ||
@@ -300,6 +353,10 @@ GFF3Struct::Field::Field(FieldType t, uint32 d) : type(t), data(d) {
 	           (type == kFieldTypeStrRef     );
 }
 
+bool GFF3Struct::Field::operator<(const Field &right) const {
+	return label < right.label;
+}
+
 
 GFF3Struct::GFF3Struct(const GFF3File &parent, uint32 offset) : _parent(&parent) {
 	load(offset);
@@ -326,6 +383,8 @@ void GFF3Struct::load(uint32 offset) {
 		readField (data, _fieldIndex);
 	else if (_fieldCount > 1)
 		readFields(data, _fieldIndex, _fieldCount);
+
+	sortFields();
 }
 
 void GFF3Struct::readField(Common::SeekableReadStream &data, uint32 index) {
@@ -342,13 +401,9 @@ void GFF3Struct::readField(Common::SeekableReadStream &data, uint32 index) {
 	const uint32 fieldLabel = data.readUint32LE();
 	const uint32 fieldData  = data.readUint32LE();
 
-	// Read the name
-	Common::UString fieldName = readLabel(data, fieldLabel);
-
-	// And add the field to the map and name list
-	_fields[fieldName] = Field((FieldType) fieldType, fieldData);
-
-	_fieldNames.push_back(fieldName);
+	// And add the field, with its label ID
+	_fields.push_back(Field(_parent->getLabelIDFromTable(fieldLabel), (FieldType) fieldType,
+	                        fieldData, _fields.size()));
 }
 
 void GFF3Struct::readFields(Common::SeekableReadStream &data, uint32 index, uint32 count) {
@@ -365,6 +420,7 @@ void GFF3Struct::readFields(Common::SeekableReadStream &data, uint32 index, uint
 	readIndices(data, indices, count);
 
 	// Read the fields
+	_fields.reserve(indices.size());
 	for (std::vector<uint32>::const_iterator i = indices.begin(); i != indices.end(); ++i)
 		readField(data, *i);
 }
@@ -376,10 +432,19 @@ void GFF3Struct::readIndices(Common::SeekableReadStream &data,
 		indices.push_back(data.readUint32LE());
 }
 
-Common::UString GFF3Struct::readLabel(Common::SeekableReadStream &data, uint32 index) const {
-	data.seek(_parent->_header.labelOffset + index * 16);
+void GFF3Struct::sortFields() {
+	std::stable_sort(_fields.begin(), _fields.end());
+
+	// When the same label appears several times, the last one wins
+	FieldArray::iterator last = _fields.begin();
+	for (FieldArray::iterator f = _fields.begin(); f != _fields.end(); ++f) {
+		if ((f != _fields.begin()) && (f->label == (last - 1)->label))
+			--last;
+
+		*last++ = *f;
+	}
 
-	return Common::readStringFixed(data, Common::kEncodingASCII, 16);
+	_fields.erase(last, _fields.end());
 }
 
 Common::SeekableReadStream &GFF3Struct::getData(const Field &field) const {
@@ -398,14 +463,38 @@ size_t GFF3Struct::getFieldCount() const {
 }
 
 bool GFF3Struct::hasField(const Common::UString &field) const {
+	return hasField(_parent->getLabelID(field));
+}
+
+bool GFF3Struct::hasField(GFF3File::LabelID field) const {
 	return getField(field) != 0;
 }
 
-const std::vector<Common::UString> &GFF3Struct::getFieldNames() const {
-	return _fieldNames;
+std::vector<Common::UString> GFF3Struct::getFieldNames() const {
+	// Restore the order the fields were found in the file
+
+	std::vector<std::pair<uint32, GFF3File::LabelID> > fields;
+	fields.reserve(_fields.size());
+
+	for (FieldArray::const_iterator f = _fields.begin(); f != _fields.end(); ++f)
+		fields.push_back(std::make_pair(f->index, f->label));
+
+	std::sort(fields.begin(), fields.end());
+
+	std::vector<Common::UString> fieldNames;
+	fieldNames.reserve(fields.size());
+
+	for (size_t i = 0; i < fields.size(); i++)
+		fieldNames.push_back(_parent->getLabel(fields[i].second));
+
+	return fieldNames;
 }
 
 GFF3Struct::FieldType GFF3Struct::getFieldType(const Common::UString &field) const {
+	return getFieldType(_parent->getLabelID(field));
+}
+
+GFF3Struct::FieldType GFF3Struct::getFieldType(GFF3File::LabelID field) const {
 	const Field *f = getField(field);
 	if (!f)
 		return kFieldTypeNone;
@@ -415,15 +504,24 @@ GFF3Struct::FieldType GFF3Struct::getFieldType(const Common::UString &field) con
 
 // --- Field value reader helpers ---
 
-const GFF3Struct::Field *GFF3Struct::getField(const Common::UString &name) const {
-	FieldMap::const_iterator field = _fields.find(name);
-	if (field == _fields.end())
+const GFF3Struct::Field *GFF3Struct::getField(GFF3File::LabelID label) const {
+	if (label == GFF3File::kLabelNone)
 		return 0;
 
-	return &field->second;
+	const Field key(label, kFieldTypeNone, 0, 0);
+
+	FieldArray::const_iterator field = std::lower_bound(_fields.begin(), _fields.end(), key);
+	if ((field == _fields.end()) || (field->label != label))
+		return 0;
+
+	return &*field;
 }
 
 char GFF3Struct::getChar(const Common::UString &field, char def) const {
+	return getChar(_parent->getLabelID(field), def);
+}
+
+char GFF3Struct::getChar(GFF3File::LabelID field, char def) const {
 	const Field *f = getField(field);
 	if (!f)
 		return def;
@@ -434,6 +532,10 @@ char GFF3Struct::getChar(const Common::UString &field, char def) const {
 }
 
 uint64 GFF3Struct::getUint(const Common::UString &field, uint64 def) const {
+	return getUint(_parent->getLabelID(field), def);
+}
+
+uint64 GFF3Struct::getUint(GFF3File::LabelID field, uint64 def) const {
 	const Field *f = getField(field);
 	if (!f)
 		return def;
@@ -471,6 +573,10 @@ uint64 GFF3Struct::getUint(const Common::UString &field, uint64 def) const {
 }
 
 int64 GFF3Struct::getSint(const Common::UString &field, int64 def) const {
+	return getSint(_parent->getLabelID(field), def);
+}
+
+int64 GFF3Struct::getSint(GFF3File::LabelID field, int64 def) const {
 	const Field *f = getField(field);
 	if (!f)
 		return def;
@@ -508,10 +614,18 @@ int64 GFF3Struct::getSint(const Common::UString &field, int64 def) const {
 }
 
 bool GFF3Struct::getBool(const Common::UString &field, bool def) const {
+	return getBool(_parent->getLabelID(field), def);
+}
+
+bool GFF3Struct::getBool(GFF3File::LabelID field, bool def) const {
 	return getUint(field, def) != 0;
 }
 
 double GFF3Struct::getDouble(const Common::UString &field, double def) const {
+	return getDouble(_parent->getLabelID(field), def);
+}
+
+double GFF3Struct::getDouble(GFF3File::LabelID field, double def) const {
 	const Field *f = getField(field);
 	if (!f)
 		return def;
@@ -526,6 +640,11 @@ double GFF3Struct::getDouble(const Common::UString &field, double def) const {
 
 Common::UString GFF3Struct::getString(const Common::UString &field,
                                       const Common::UString &def) const {
+	return getString(_parent->getLabelID(field), def);
+}
+
+Common::UString GFF3Struct::getString(GFF3File::LabelID field,
+                                      const Common::UString &def) const {
 
 	const Field *f = getField(field);
 	if (!f)
@@ -612,6 +731,10 @@ Common::UString GFF3Struct::getString(const Common::UString &field,
 }
 
 bool GFF3Struct::getLocString(const Common::UString &field, LocString &str) const {
+	return getLocString(_parent->getLabelID(field), str);
+}
+
+bool GFF3Struct::getLocString(GFF3File::LabelID field, LocString &str) const {
 	const Field *f = getField(field);
 	if (!f || (f->type != kFieldTypeLocString))
 		return false;
@@ -636,6 +759,10 @@ bool GFF3Struct::getLocString(const Common::UString &field, LocString &str) cons
 }
 
 Common::SeekableReadStream *GFF3Struct::getData(const Common::UString &field) const {
+	return getData(_parent->getLabelID(field));
+}
+
+Common::SeekableReadStream *GFF3Struct::getData(GFF3File::LabelID field) const {
 	const Field *f = getField(field);
 	if (!f)
 		return 0;
@@ -659,6 +786,11 @@ Common::SeekableReadStream *GFF3Struct::getData(const Common::UString &field) co
 
 void GFF3Struct::getVector(const Common::UString &field,
                            float &x, float &y, float &z) const {
+	getVector(_parent->getLabelID(field), x, y, z);
+}
+
+void GFF3Struct::getVector(GFF3File::LabelID field,
+                           float &x, float &y, float &z) const {
 
 	const Field *f = getField(field);
 	if (!f)
@@ -675,6 +807,11 @@ void GFF3Struct::getVector(const Common::UString &field,
 
 void GFF3Struct::getOrientation(const Common::UString &field,
                                 float &a, float &b, float &c, float &d) const {
+	getOrientation(_parent->getLabelID(field), a, b, c, d);
+}
+
+void GFF3Struct::getOrientation(GFF3File::LabelID field,
+                                float &a, float &b, float &c, float &d) const {
 
 	const Field *f = getField(field);
 	if (!f)
@@ -692,6 +829,11 @@ void GFF3Struct::getOrientation(const Common::UString &field,
 
 void GFF3Struct::getVector(const Common::UString &field,
                            double &x, double &y, double &z) const {
+	getVector(_parent->getLabelID(field), x, y, z);
+}
+
+void GFF3Struct::getVector(GFF3File::LabelID field,
+                           double &x, double &y, double &z) const {
 
 	const Field *f = getField(field);
 	if (!f)
@@ -708,6 +850,11 @@ void GFF3Struct::getVector(const Common::UString &field,
 
 void GFF3Struct::getOrientation(const Common::UString &field,
                                 double &a, double &b, double &c, double &d) const {
+	getOrientation(_parent->getLabelID(field), a, b, c, d);
+}
+
+void GFF3Struct::getOrientation(GFF3File::LabelID field,
+                                double &a, double &b, double &c, double &d) const {
 
 	const Field *f = getField(field);
 	if (!f)
@@ -726,6 +873,10 @@ void GFF3Struct::getOrientation(const Common::UString &field,
 // --- Struct reader ---
 
 const GFF3Struct &GFF3Struct::getStruct(const Common::UString &field) const {
+	return getStruct(_parent->getLabelID(field));
+}
+
+const GFF3Struct &GFF3Struct::getStruct(GFF3File::LabelID field) const {
 	const Field *f = getField(field);
 	if (!f)
 		throw Common::Exception("GFF3: No such field");
@@ -739,6 +890,10 @@ const GFF3Struct &GFF3Struct::getStruct(const Common::UString &field) const {
 // --- Struct list reader ---
 
 const GFF3List &GFF3Struct::getList(const Common::UString &field) const {
+	return getList(_parent->getLabelID(field));
+}
+
+const GFF3List &GFF3Struct::getList(GFF3File::LabelID field) const {
 	const Field *f = getField(field);
 	if (!f)
 		throw Common::Exception("GFF3: No such field");
@@ -26,9 +26,9 @@
 #define AURORA_GFF3FILE_H
 
 #include <vector>
-#include <map>
 
 #include <boost/noncopyable.hpp>
+#include <boost/unordered/unordered_map.hpp>
 
 #include "src/common/types.h"
 #include "src/common/scopedptr.h"
@@ -97,6 +97,17 @@ public:
 	const GFF3Struct &getTopLevel() const;
 
 
+	/** A field label, interned into a number unique within this GFF3. */
+	typedef uint32 LabelID;
+
+	static const LabelID kLabelNone = 0xFFFFFFFF;
+
+	/** Return the ID of this field label, or kLabelNone if there's no such label in this GFF3. */
+	LabelID getLabelID(const Common::UString &label) const;
+	/** Return the field label with this ID. */
+	const Common::UString &getLabel(LabelID id) const;
+
+
 private:
 	/** A GFF3 header. */
 	struct Header {
@@ -121,6 +132,8 @@ private:
 	typedef Common::PtrVector<GFF3Struct> StructArray;
 	typedef std::vector<GFF3List> ListArray;
 
+	typedef boost::unordered_map<Common::UString, LabelID, Common::hashUStringCaseSensitive> LabelMap;
+
 
 	Common::ScopedPtr<Common::SeekableReadStream> _stream;
 
@@ -134,6 +147,10 @@ private:
 	StructArray _structs; ///< Our structs.
 	ListArray   _lists;   ///< Our lists.
 
+	std::vector<Common::UString> _labels; ///< All distinct field labels, indexed by their ID.
+	std::vector<LabelID> _labelIDs;       ///< The label ID of each entry in the GFF3's label table.
+	LabelMap _labelMap;                   ///< Field labels to label IDs.
+
 	/** To convert list offsets found in GFF3 to real indices. */
 	std::vector<uint32> _listOffsetToIndex;
 
@@ -141,6 +158,7 @@ private:
 	// .--- Loading helpers
 	void load(uint32 id);
 	void loadHeader(uint32 id);
+	void loadLabels();
 	void loadStructs();
 	void loadLists();
 	// '---
@@ -155,6 +173,9 @@ private:
 	const GFF3Struct &getStruct(uint32 i) const;
 	/** Return a list within the GFF3. */
 	const GFF3List   &getList  (uint32 i) const;
+
+	/** Return the label ID of this entry in the label table. */
+	LabelID getLabelIDFromTable(uint32 i) const;
 	// '---
 
 	friend class GFF3Struct;
@@ -203,8 +224,12 @@ public:
 	/** Does this specific field exist? */
 	bool hasField(const Common::UString &field) const;
 
-	/** Return a list of all field names in this struct. */
-	const std::vector<Common::UString> &getFieldNames() const;
+	/** Return a list of all field names in this struct, in the order they appear in the file.
+	 *
+	 *  A label that appears several times in the same struct is only listed
+	 *  once, where its last field is. That's also the field the getters return.
+	 */
+	std::vector<Common::UString> getFieldNames() const;
 
 	/** Return the type of this field, or kFieldTypeNone if such a field doesn't exist. */
 	FieldType getFieldType(const Common::UString &field) const;
@@ -241,18 +266,59 @@ public:
 	const GFF3List   &getList  (const Common::UString &field) const;
 	// '---
 
+	/* The same accessors, but taking the label ID of a field instead of its
+	 * name. Looking up the ID of a label with GFF3File::getLabelID() once is
+	 * faster than having every call look up the label name again. */
+
+	// .--- Field properties by label ID
+	bool hasField(GFF3File::LabelID field) const;
+	FieldType getFieldType(GFF3File::LabelID field) const;
+	// '---
+
+	// .--- Read field values by label ID
+	char   getChar(GFF3File::LabelID field, char   def = '\0' ) const;
+	uint64 getUint(GFF3File::LabelID field, uint64 def = 0    ) const;
+	 int64 getSint(GFF3File::LabelID field,  int64 def = 0    ) const;
+	bool   getBool(GFF3File::LabelID field, bool   def = false) const;
+
+	double getDouble(GFF3File::LabelID field, double def = 0.0) const;
+
+	Common::UString getString(GFF3File::LabelID field, const Common::UString &def = "") const;
+
+	bool getLocString(GFF3File::LabelID field, LocString &str) const;
+
+	void getVector     (GFF3File::LabelID field, float &x, float &y, float &z          ) const;
+	void getOrientation(GFF3File::LabelID field, float &a, float &b, float &c, float &d) const;
+
+	void getVector     (GFF3File::LabelID field, double &x, double &y, double &z           ) const;
+	void getOrientation(GFF3File::LabelID field, double &a, double &b, double &c, double &d) const;
+
+	Common::SeekableReadStream *getData(GFF3File::LabelID field) const;
+	// '---
+
+	// .--- Structs and lists of structs by label ID
+	const GFF3Struct &getStruct(GFF3File::LabelID field) const;
+	const GFF3List   &getList  (GFF3File::LabelID field) const;
+	// '---
+
 private:
 	/** A field in the GFF3 struct. */
 	struct Field {
+		GFF3File::LabelID label; ///< The field's label.
+
 		FieldType type;     ///< Type of the field.
 		uint32    data;     ///< Data of the field.
+		uint32    index;    ///< Position of the field within the struct, as found in the file.
 		bool      extended; ///< Does this field need extended data?
 
 		Field();
-		Field(FieldType t, uint32 d);
+		Field(GFF3File::LabelID l, FieldType t, uint32 d, uint32 i);
+
+		bool operator<(const Field &right) const;
 	};
 
-	typedef std::map<Common::UString, Field> FieldMap;
+	/** The fields, sorted by their label ID. */
+	typedef std::vector<Field> FieldArray;
 
 
 	const GFF3File *_parent; ///< The parent GFF3.
@@ -261,10 +327,7 @@ private:
 	uint32 _fieldIndex; ///< Field / Field indices index.
 	uint32 _fieldCount; ///< Field count.
 
-	FieldMap _fields; ///< The fields, indexed by their label.
-
-	/** The names of all fields in this struct. */
-	std::vector<Common::UString> _fieldNames;
+	FieldArray _fields; ///< The fields, sorted by their label ID.
 
 
 	// .--- Loader
@@ -278,12 +341,13 @@ private:
 	void readIndices(Common::SeekableReadStream &data,
 	                 std::vector<uint32> &indices, uint32 count) const;
 
-	Common::UString readLabel(Common::SeekableReadStream &data, uint32 index) const;
+	/** Sort the fields by label, dropping all but the last of fields with the same label. */
+	void sortFields();
 	// '---
 
 	// .--- Field and field data accessors
-	/** Returns the field with this tag. */
-	const Field *getField(const Common::UString &name) const;
+	/** Returns the field with this label ID. */
+	const Field *getField(GFF3File::LabelID label) const;
 	/** Returns the extended field data for this field. */
 	Common::SeekableReadStream &getData(const Field &field) const;
 	// '---
@@ -160,11 +160,9 @@ Common::SeekableReadStream *HERFFile::getResource(uint32 index, bool tryNoCopy)
 	const IResource &res = getIResource(index);
 
 	if (tryNoCopy)
-		return new Common::SeekableSubReadStream(_herf.get(), res.offset, res.offset + res.size);
+		return new Common::ConcurrentSubReadStream(_herf.get(), res.offset, res.offset + res.size);
 
-	_herf->seek(res.offset);
-
-	return _herf->readStream(res.size);
+	return _herf->readStreamAt(res.offset, res.size);
 }
 
 Common::HashAlgo HERFFile::getNameHashAlgo() const {
@@ -31,6 +31,7 @@
 #include "src/common/types.h"
 #include "src/common/scopedptr.h"
 #include "src/common/ustring.h"
+#include "src/common/mutex.h"
 
 #include "src/aurora/types.h"
 #include "src/aurora/archive.h"
@@ -118,6 +119,9 @@ private:
 	/** The name of the NSBTX file. */
 	Common::ScopedPtr<Common::SeekableSubReadStreamEndian> _nsbtx;
 
+	/** Serializes reading textures, which seeks around in the NSBTX stream. */
+	mutable Common::Mutex _mutex;
+
 	/** External list of resource names and types. */
 	ResourceList _resources;
 
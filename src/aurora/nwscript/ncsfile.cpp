@@ -28,6 +28,8 @@
  * a mirror (<https://github.com/xoreos/xoreos-docs>).
  */
 
+#include <map>
+
 #include <boost/make_shared.hpp>
 
 #include "src/common/util.h"
@@ -37,6 +39,9 @@
 #include "src/common/readstream.h"
 #include "src/common/encoding.h"
 #include "src/common/debug.h"
+#include "src/common/debugman.h"
+#include "src/common/mutex.h"
+#include "src/common/scopedptr.h"
 
 #include "src/aurora/resman.h"
 
@@ -49,6 +54,9 @@ using Common::kDebugScripts;
 static const uint32 kNCSTag    = MKTAG('N', 'C', 'S', ' ');
 static const uint32 kVersion10 = MKTAG('V', '1', '.', '0');
 
+/** Marks an instruction cut off by the end of the file. */
+static const uint8 kOpcodeTruncated = 0xFF;
+
 static const uint32 kScriptObjectSelf        = 0x00000000;
 static const uint32 kScriptObjectInvalid     = 0x00000001;
 static const uint32 kScriptObjectInvalid2    = 0xFFFFFFFF;
@@ -188,104 +196,295 @@ void NCSStack::print() const {
 }
 
 
-#define OPCODE(x) { &NCSFile::x, #x }
-#define OPCODE0() { 0, "" }
+#define OPCODE(x, a) { &NCSFile::x, #x, a }
+#define OPCODE0() { &NCSFile::o_illegal, "", kArgsIllegal }
 
-void NCSFile::setupOpcodes() {
+const NCSFile::Opcode *NCSFile::getOpcodes(size_t &count) {
 	static const Opcode opcodes[] = {
 		// 0x00
-		OPCODE(o_nop), // Doesn't exist
-		OPCODE(o_cpdownsp),
-		OPCODE(o_rsadd),
-		OPCODE(o_cptopsp),
+		OPCODE(o_nop          , kArgsNone      ), // Doesn't exist
+		OPCODE(o_cpdownsp     , kArgsOffsetSize),
+		OPCODE(o_rsadd        , kArgsNone      ),
+		OPCODE(o_cptopsp      , kArgsOffsetSize),
 		// 0x04
-		OPCODE(o_const),
-		OPCODE(o_action),
-		OPCODE(o_logand),
-		OPCODE(o_logor),
+		OPCODE(o_const        , kArgsConst     ),
+		OPCODE(o_action       , kArgsAction    ),
+		OPCODE(o_logand       , kArgsNone      ),
+		OPCODE(o_logor        , kArgsNone      ),
 		// 0x08
-		OPCODE(o_incor),
-		OPCODE(o_excor),
-		OPCODE(o_booland),
-		OPCODE(o_eq),
+		OPCODE(o_incor        , kArgsNone      ),
+		OPCODE(o_excor        , kArgsNone      ),
+		OPCODE(o_booland      , kArgsNone      ),
+		OPCODE(o_eq           , kArgsStructSize),
 		// 0x0C
-		OPCODE(o_neq),
-		OPCODE(o_geq),
-		OPCODE(o_gt),
-		OPCODE(o_lt),
+		OPCODE(o_neq          , kArgsStructSize),
+		OPCODE(o_geq          , kArgsNone      ),
+		OPCODE(o_gt           , kArgsNone      ),
+		OPCODE(o_lt           , kArgsNone      ),
 		// 0x10
-		OPCODE(o_leq),
-		OPCODE(o_shleft),
-		OPCODE(o_shright),
-		OPCODE(o_ushright),
+		OPCODE(o_leq          , kArgsNone      ),
+		OPCODE(o_shleft       , kArgsNone      ),
+		OPCODE(o_shright      , kArgsNone      ),
+		OPCODE(o_ushright     , kArgsNone      ),
 		// 0x14
-		OPCODE(o_add),
-		OPCODE(o_sub),
-		OPCODE(o_mul),
-		OPCODE(o_div),
+		OPCODE(o_add          , kArgsNone      ),
+		OPCODE(o_sub          , kArgsNone      ),
+		OPCODE(o_mul          , kArgsNone      ),
+		OPCODE(o_div          , kArgsNone      ),
 		// 0x18
-		OPCODE(o_mod),
-		OPCODE(o_neg),
-		OPCODE(o_comp),
-		OPCODE(o_movsp),
+		OPCODE(o_mod          , kArgsNone      ),
+		OPCODE(o_neg          , kArgsNone      ),
+		OPCODE(o_comp         , kArgsNone      ),
+		OPCODE(o_movsp        , kArgsOffset    ),
 		// 0x1C
-		OPCODE(o_storestateall),
-		OPCODE(o_jmp),
-		OPCODE(o_jsr),
-		OPCODE(o_jz),
+		OPCODE(o_storestateall, kArgsNone      ),
+		OPCODE(o_jmp          , kArgsJump      ),
+		OPCODE(o_jsr          , kArgsJump      ),
+		OPCODE(o_jz           , kArgsJump      ),
 		// 0x20
-		OPCODE(o_retn),
-		OPCODE(o_destruct),
-		OPCODE(o_not),
-		OPCODE(o_decsp),
+		OPCODE(o_retn         , kArgsNone      ),
+		OPCODE(o_destruct     , kArgsDestruct  ),
+		OPCODE(o_not          , kArgsNone      ),
+		OPCODE(o_decsp        , kArgsOffset    ),
 		// 0x24
-		OPCODE(o_incsp),
-		OPCODE(o_jnz),
-		OPCODE(o_cpdownbp),
-		OPCODE(o_cptopbp),
+		OPCODE(o_incsp        , kArgsOffset    ),
+		OPCODE(o_jnz          , kArgsJump      ),
+		OPCODE(o_cpdownbp     , kArgsOffsetSize),
+		OPCODE(o_cptopbp      , kArgsOffsetSize),
 		// 0x28
-		OPCODE(o_decbp),
-		OPCODE(o_incbp),
-		OPCODE(o_savebp),
-		OPCODE(o_restorebp),
+		OPCODE(o_decbp        , kArgsOffset    ),
+		OPCODE(o_incbp        , kArgsOffset    ),
+		OPCODE(o_savebp       , kArgsNone      ),
+		OPCODE(o_restorebp    , kArgsNone      ),
 		// 0x2C
-		OPCODE(o_storestate),
-		OPCODE(o_nop),
+		OPCODE(o_storestate   , kArgsStoreState),
+		OPCODE(o_nop          , kArgsNone      ),
 		OPCODE0(),
 		OPCODE0(),
 		// 0x30
-		OPCODE(o_writearray),
+		OPCODE(o_writearray   , kArgsOffsetSize),
 		OPCODE0(),
-		OPCODE(o_readarray),
+		OPCODE(o_readarray    , kArgsOffsetSize),
 		OPCODE0(),
 		// 0x34
 		OPCODE0(),
 		OPCODE0(),
 		OPCODE0(),
-		OPCODE(o_getref),
+		OPCODE(o_getref       , kArgsOffsetSize),
 		// 0x38
 		OPCODE0(),
-		OPCODE(o_getrefarray)
+		OPCODE(o_getrefarray  , kArgsOffsetSize)
 	};
 
-	_opcodes = opcodes;
-	_opcodeListSize = ARRAYSIZE(opcodes);
+	count = ARRAYSIZE(opcodes);
+	return opcodes;
 }
 
 #undef OPCODE
+#undef OPCODE0
+
+size_t NCSFile::Program::findInstruction(uint32 address) const {
+	size_t low = 0, high = instructions.size();
+
+	while (low < high) {
+		const size_t mid = low + (high - low) / 2;
+
+		if (instructions[mid].address < address)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	if ((low < instructions.size()) && (instructions[low].address == address))
+		return low;
+
+	// Jumping right to the end of the script is a valid way to stop it
+	if (address == size)
+		return instructions.size();
+
+	return SIZE_MAX;
+}
+
+NCSFile::ProgramPtr NCSFile::decode(Common::SeekableReadStream &ncs) {
+	size_t opcodeCount;
+	const Opcode *opcodes = getOpcodes(opcodeCount);
+
+	boost::shared_ptr<Program> program = boost::make_shared<Program>();
+
+	readHeader(ncs, program->id, program->version, program->utf16le);
+
+	if (program->id != kNCSTag)
+		throw Common::Exception("Try to load non-NCS file");
+
+	if (program->version != kVersion10)
+		throw Common::Exception("Unsupported NCS file version %08X", program->version);
+
+	byte lengthOpcode = ncs.readByte();
+	if (lengthOpcode != 0x42)
+		throw Common::Exception("Script size opcode != 0x42 (0x%02X)", lengthOpcode);
+
+	uint32 length = ncs.readUint32BE();
+	if (length > ((uint32) ncs.size()))
+		throw Common::Exception("Script size %u > stream size %u", length, (uint)ncs.size());
+	if (length < ((uint32) ncs.size()))
+		warning("TODO: NCSFile::decode(): Script size %u < stream size %u", length, (uint)ncs.size());
+
+	program->size = ncs.size();
+
+	// Everything after an illegal or truncated instruction is garbage to us
+	bool garbage = false;
+
+	// We need at least the opcode and the type to have an instruction
+	while (!garbage && ((ncs.size() - ncs.pos()) >= 2)) {
+		Instruction instr;
+
+		instr.address    = ncs.pos();
+		instr.opcode     = ncs.readByte();
+		instr.proc       = &NCSFile::o_illegal;
+		instr.jumpTarget = SIZE_MAX;
+
+		instr.args[0] = instr.args[1] = instr.args[2] = 0;
+
+		instr.type       = (InstructionType) ncs.readByte();
+
+		const Opcode *opcode = (instr.opcode < opcodeCount) ? &opcodes[instr.opcode] : 0;
+
+		try {
+			switch (opcode ? opcode->args : kArgsIllegal) {
+				case kArgsNone:
+					break;
+
+				case kArgsOffset:
+				case kArgsJump:
+					instr.args[0] = ncs.readSint32BE();
+					break;
+
+				case kArgsOffsetSize:
+					instr.args[0] = ncs.readSint32BE();
+					instr.args[1] = ncs.readSint16BE();
+					break;
+
+				case kArgsConst:
+					instr.args[0] = program->constants.size();
+
+					if      (instr.type == kInstTypeInt)
+						program->constants.push_back(Variable(ncs.readSint32BE()));
+					else if (instr.type == kInstTypeFloat)
+						program->constants.push_back(Variable(ncs.readIEEEFloatBE()));
+					else if ((instr.type == kInstTypeString) || (instr.type == kInstTypeResource))
+						program->constants.push_back(Variable(Common::readStringFixed(ncs,
+								Common::kEncodingASCII, ncs.readUint16BE())));
+					else if (instr.type == kInstTypeObject)
+						instr.args[0] = ncs.readUint32BE();
+
+					break;
+
+				case kArgsAction:
+					instr.args[0] = ncs.readUint16BE();
+					instr.args[1] = ncs.readByte();
+					break;
+
+				case kArgsStructSize:
+					if (instr.type == kInstTypeStructStruct)
+						instr.args[0] = ncs.readUint16BE();
+					break;
+
+				case kArgsDestruct:
+					instr.args[0] = ncs.readSint16BE();
+					instr.args[1] = ncs.readSint16BE();
+					instr.args[2] = ncs.readSint16BE();
+					break;
+
+				case kArgsStoreState:
+					instr.args[0] = ncs.readUint32BE();
+					instr.args[1] = ncs.readUint32BE();
+					break;
+
+				case kArgsIllegal:
+					garbage = true;
+					break;
+			}
+
+		} catch (...) {
+			// A truncated instruction. It'll throw when the script tries to execute it
+			instr.opcode = kOpcodeTruncated;
+			garbage = true;
+		}
+
+		if (!garbage)
+			instr.proc = opcode->proc;
+
+		program->instructions.push_back(instr);
+	}
+
+	// Resolve the jump offsets into instruction indices
+	for (std::vector<Instruction>::iterator i = program->instructions.begin();
+	     i != program->instructions.end(); ++i) {
+
+		const Opcode *opcode = (i->opcode < opcodeCount) ? &opcodes[i->opcode] : 0;
+		if (!opcode || (opcode->args != kArgsJump))
+			continue;
+
+		i->jumpTarget = program->findInstruction(i->address + i->args[0]);
+	}
+
+	return program;
+}
+
+/** All scripts we've already decoded. */
+struct NCSFile::ProgramCache {
+	Common::Mutex mutex;
+
+	/** The resource manager revision the cached scripts were found in. */
+	uint32 revision;
+
+	std::map<Common::UString, ProgramPtr> programs;
+
+	ProgramCache() : revision(0) {
+	}
 
-NCSFile::NCSFile(Common::SeekableReadStream *ncs) : _script(ncs), _owner(0), _triggerer(0) {
-	assert(_script);
+	static ProgramCache &get() {
+		static ProgramCache cache;
 
-	load();
+		return cache;
+	}
+};
+
+NCSFile::ProgramPtr NCSFile::getProgram(const Common::UString &name) {
+	ProgramCache &cache = ProgramCache::get();
+
+	Common::StackLock lock(cache.mutex);
+
+	// A changed set of resources might have given us a different script of the same name
+	if (cache.revision != ResMan.getRevision()) {
+		cache.programs.clear();
+		cache.revision = ResMan.getRevision();
+	}
+
+	std::map<Common::UString, ProgramPtr>::const_iterator p = cache.programs.find(name);
+	if (p != cache.programs.end())
+		return p->second;
+
+	Common::ScopedPtr<Common::SeekableReadStream> ncs(ResMan.getResource(name, kFileTypeNCS));
+	if (!ncs)
+		throw Common::Exception("No such NCS \"%s\"", name.c_str());
+
+	ProgramPtr program = decode(*ncs);
+
+	cache.programs[name] = program;
+	return program;
 }
 
-NCSFile::NCSFile(const Common::UString &ncs) : _name(ncs), _owner(0), _triggerer(0) {
-	_script.reset(ResMan.getResource(ncs, kFileTypeNCS));
-	if (!_script)
-		throw Common::Exception("No such NCS \"%s\"", ncs.c_str());
+NCSFile::NCSFile(Common::SeekableReadStream *ncs) : _pc(0), _owner(0), _triggerer(0) {
+	assert(ncs);
+
+	Common::ScopedPtr<Common::SeekableReadStream> script(ncs);
 
-	load();
+	load(decode(*script));
+}
+
+NCSFile::NCSFile(const Common::UString &ncs) : _name(ncs), _pc(0), _owner(0), _triggerer(0) {
+	load(getProgram(ncs));
 }
 
 NCSFile::~NCSFile() {
@@ -311,26 +510,12 @@ ScriptState NCSFile::getEmptyState() {
 	return state;
 }
 
-void NCSFile::load() {
-	readHeader(*_script);
-
-	if (_id != kNCSTag)
-		throw Common::Exception("Try to load non-NCS file");
-
-	if (_version != kVersion10)
-		throw Common::Exception("Unsupported NCS file version %08X", _version);
-
-	byte lengthOpcode = _script->readByte();
-	if (lengthOpcode != 0x42)
-		throw Common::Exception("Script size opcode != 0x42 (0x%02X)", lengthOpcode);
-
-	uint32 length = _script->readUint32BE();
-	if (length > ((uint32) _script->size()))
-		throw Common::Exception("Script size %u > stream size %u", length, (uint)_script->size());
-	if (length < ((uint32) _script->size()))
-		warning("TODO: NCSFile::load(): Script size %u < stream size %u", length, (uint)_script->size());
+void NCSFile::load(const ProgramPtr &program) {
+	_program = program;
 
-	setupOpcodes();
+	_id      = _program->id;
+	_version = _program->version;
+	_utf16le = _program->utf16le;
 
 	reset();
 }
@@ -344,7 +529,7 @@ void NCSFile::reset() {
 	_storedState.setType(kTypeVoid);
 	_return.setType(kTypeVoid);
 
-	_script->seek(13); // 8 byte header + 5 byte program size dummy op
+	_pc = 0;
 }
 
 const Variable &NCSFile::run(Object *owner, Object *triggerer) {
@@ -357,7 +542,9 @@ const Variable &NCSFile::run(const ScriptState &state, Object *owner, Object *tr
 
 	reset();
 
-	_script->seek(state.offset);
+	_pc = _program->findInstruction(state.offset);
+	if (_pc == SIZE_MAX)
+		throw Common::Exception("NCSFile::run(): No instruction at offset %u", state.offset);
 
 	// Push global variables
 	std::vector<class Variable>::const_reverse_iterator var;
@@ -394,43 +581,41 @@ const Variable &NCSFile::execute(Object *owner, Object *triggerer) {
 }
 
 bool NCSFile::executeStep() {
-	byte opcode, type;
-
-	try {
-		opcode = _script->readByte();
-		type   = _script->readByte();
-	} catch (...) {
+	if (_pc >= _program->instructions.size())
 		return false;
-	}
 
-	if ((opcode >= _opcodeListSize) || (!_opcodes[opcode].proc))
-		throw Common::Exception("NCSFile::executeStep(): Illegal instruction 0x%02x", opcode);
+	const Instruction &instr = _program->instructions[_pc++];
 
-	debugC(kDebugScripts, 1, "NWScript opcode %s [0x%02X]", _opcodes[opcode].desc, opcode);
+	if (DebugMan.isEnabled(kDebugScripts, 1)) {
+		size_t opcodeCount;
+		const Opcode *opcodes = getOpcodes(opcodeCount);
+
+		debugC(kDebugScripts, 1, "NWScript opcode %s [0x%02X]",
+		       (instr.opcode < opcodeCount) ? opcodes[instr.opcode].desc : "", instr.opcode);
+	}
 
-	(this->*(_opcodes[opcode].proc))((InstructionType)type);
+	// The handler was already bound to the instruction when decoding the script
+	(this->*instr.proc)(instr);
 
 	_stack.print();
 	debugC(kDebugScripts, 2, "[RETURN: %d]",
-	       _returnOffsets.empty() ? -1 : _returnOffsets.top());
+	       _returnOffsets.empty() ? -1 : (int)_returnOffsets.top());
 
 	return true;
 }
 
-void NCSFile::decompile() {
-	uint32 oldScriptPos = _script->pos();
-	_script->seek(13); // 8 byte header + 5 byte program size dummy op
+void NCSFile::jump(size_t target) {
+	if (target == SIZE_MAX)
+		throw Common::Exception("NCSFile::jump(): Jump into the middle of an instruction");
 
-	// TODO
-
-	_script->seek(oldScriptPos);
+	_pc = target;
 }
 
 // OPCODES!
 
 /** RSADD: push an empty variable onto the stack. */
-void NCSFile::o_rsadd(InstructionType type) {
-	switch (type) {
+void NCSFile::o_rsadd(const Instruction &instr) {
+	switch (instr.type) {
 		case kInstTypeInt:
 			_stack.push(kTypeInt);
 			break;
@@ -466,26 +651,20 @@ void NCSFile::o_rsadd(InstructionType type) {
 			_stack.push(kTypeArray);
 			break;
 		default:
-			throw Common::Exception("NCSFile::o_rsadd(): Illegal type %d", type);
+			throw Common::Exception("NCSFile::o_rsadd(): Illegal type %d", instr.type);
 	}
 }
 
 /** CONST: push a constant (predetermined value) variable onto the stack. */
-void NCSFile::o_const(InstructionType type) {
-	switch (type) {
+void NCSFile::o_const(const Instruction &instr) {
+	switch (instr.type) {
 		case kInstTypeInt:
-			_stack.push(_script->readSint32BE());
-			break;
-
 		case kInstTypeFloat:
-			_stack.push(_script->readIEEEFloatBE());
-			break;
-
 		case kInstTypeString:
-		case kInstTypeResource: {
-			_stack.push(Common::readStringFixed(*_script, Common::kEncodingASCII, _script->readUint16BE()));
+		case kInstTypeResource:
+			// Decoded into the constant pool when loading the script
+			_stack.push(_program->constants[instr.args[0]]);
 			break;
-		}
 
 		case kInstTypeObject: {
 			/* The scripts only know of two constant objects:
@@ -496,7 +675,7 @@ void NCSFile::o_const(InstructionType type) {
 			 * magic values. They *should* all have the same effect, though.
 			 */
 
-			uint32 objectID = _script->readUint32BE();
+			uint32 objectID = instr.args[0];
 
 			if      (objectID == kScriptObjectSelf)
 				_stack.push(_owner);
@@ -513,7 +692,7 @@ void NCSFile::o_const(InstructionType type) {
 		}
 
 		default:
-			throw Common::Exception("NCSFile::o_const(): Illegal type %d", type);
+			throw Common::Exception("NCSFile::o_const(): Illegal type %d", instr.type);
 	}
 }
 
@@ -614,12 +793,12 @@ void NCSFile::callEngine(Aurora::NWScript::FunctionContext &ctx,
 }
 
 /** ACTION: call a game-specific engine function. */
-void NCSFile::o_action(InstructionType type) {
-	if (type != kInstTypeNone)
-		throw Common::Exception("NCSFile::o_action(): Illegal type %d", type);
+void NCSFile::o_action(const Instruction &instr) {
+	if (instr.type != kInstTypeNone)
+		throw Common::Exception("NCSFile::o_action(): Illegal type %d", instr.type);
 
-	uint16 routineNumber = _script->readUint16BE();
-	uint8  argCount      = _script->readByte();
+	uint16 routineNumber = instr.args[0];
+	uint8  argCount      = instr.args[1];
 
 	Aurora::NWScript::FunctionContext ctx = FunctionMan.createContext(routineNumber);
 
@@ -633,9 +812,9 @@ void NCSFile::o_action(InstructionType type) {
 }
 
 /** LOGAND: perform a logical boolean AND (&&). */
-void NCSFile::o_logand(InstructionType type) {
-	if (type != kInstTypeIntInt)
-		throw Common::Exception("NCSFile::o_logand(): Illegal type %d", type);
+void NCSFile::o_logand(const Instruction &instr) {
+	if (instr.type != kInstTypeIntInt)
+		throw Common::Exception("NCSFile::o_logand(): Illegal type %d", instr.type);
 
 	int32 arg1 = _stack.pop().getInt();
 	int32 arg2 = _stack.pop().getInt();
@@ -643,9 +822,9 @@ void NCSFile::o_logand(InstructionType type) {
 }
 
 /** LOGOR: perform a logical boolean OR (||). */
-void NCSFile::o_logor(InstructionType type) {
-	if (type != kInstTypeIntInt)
-		throw Common::Exception("NCSFile::o_logor(): Illegal type %d", type);
+void NCSFile::o_logor(const Instruction &instr) {
+	if (instr.type != kInstTypeIntInt)
+		throw Common::Exception("NCSFile::o_logor(): Illegal type %d", instr.type);
 
 	int32 arg1 = _stack.pop().getInt();
 	int32 arg2 = _stack.pop().getInt();
@@ -653,9 +832,9 @@ void NCSFile::o_logor(InstructionType type) {
 }
 
 /** INCOR: perform a bit-wise inclusive OR (|). */
-void NCSFile::o_incor(InstructionType type) {
-	if (type != kInstTypeIntInt)
-		throw Common::Exception("NCSFile::o_incor(): Illegal type %d", type);
+void NCSFile::o_incor(const Instruction &instr) {
+	if (instr.type != kInstTypeIntInt)
+		throw Common::Exception("NCSFile::o_incor(): Illegal type %d", instr.type);
 
 	int32 arg1 = _stack.pop().getInt();
 	int32 arg2 = _stack.pop().getInt();
@@ -663,9 +842,9 @@ void NCSFile::o_incor(InstructionType type) {
 }
 
 /** EXCOR: perform a bit-wise exclusive OR (^). */
-void NCSFile::o_excor(InstructionType type) {
-	if (type != kInstTypeIntInt)
-		throw Common::Exception("NCSFile::o_excor(): Illegal type %d", type);
+void NCSFile::o_excor(const Instruction &instr) {
+	if (instr.type != kInstTypeIntInt)
+		throw Common::Exception("NCSFile::o_excor(): Illegal type %d", instr.type);
 
 	int32 arg1 = _stack.pop().getInt();
 	int32 arg2 = _stack.pop().getInt();
@@ -673,9 +852,9 @@ void NCSFile::o_excor(InstructionType type) {
 }
 
 /** BOOLAND: perform a bit-wise AND (&). */
-void NCSFile::o_booland(InstructionType type) {
-	if (type != kInstTypeIntInt)
-		throw Common::Exception("NCSFile::o_booland(): Illegal type %d", type);
+void NCSFile::o_booland(const Instruction &instr) {
+	if (instr.type != kInstTypeIntInt)
+		throw Common::Exception("NCSFile::o_booland(): Illegal type %d", instr.type);
 
 	int32 arg1 = _stack.pop().getInt();
 	int32 arg2 = _stack.pop().getInt();
@@ -683,13 +862,13 @@ void NCSFile::o_booland(InstructionType type) {
 }
 
 /** EQ: compare the top-most stack elements for equality (==). */
-void NCSFile::o_eq(InstructionType type) {
+void NCSFile::o_eq(const Instruction &instr) {
 	size_t n = 1;
 
-	if (type == kInstTypeStructStruct) {
+	if (instr.type == kInstTypeStructStruct) {
 		// Comparisons between two structs (or two vectors) come with the size of the type
 
-		const size_t size = _script->readUint16BE();
+		const size_t size = instr.args[0];
 
 		if ((size % 4) != 0)
 			throw Common::Exception("NCSFile::o_eq(): size %% 4 != 0");
@@ -712,13 +891,13 @@ void NCSFile::o_eq(InstructionType type) {
 }
 
 /** NEQ: compare the top-most stack elements for inequality (!=). */
-void NCSFile::o_neq(InstructionType type) {
+void NCSFile::o_neq(const Instruction &instr) {
 	size_t n = 1;
 
-	if (type == kInstTypeStructStruct) {
+	if (instr.type == kInstTypeStructStruct) {
 		// Comparisons between two structs (or two vectors) come with the size of the type
 
-		const size_t size = _script->readUint16BE();
+		const size_t size = instr.args[0];
 
 		if ((size % 4) != 0)
 			throw Common::Exception("NCSFile::o_neq(): size %% 4 != 0");
@@ -741,8 +920,8 @@ void NCSFile::o_neq(InstructionType type) {
 }
 
 /** GEQ: compare the top-most stack elements, greater-or-equal (>=). */
-void NCSFile::o_geq(InstructionType type) {
-	switch (type) {
+void NCSFile::o_geq(const Instruction &instr) {
+	switch (instr.type) {
 		case kInstTypeIntInt:
 			{
 				int32 arg1 = _stack.pop().getInt();
@@ -760,13 +939,13 @@ void NCSFile::o_geq(InstructionType type) {
 			break;
 
 		default:
-			throw Common::Exception("NCSFile::o_geq(): Illegal type %d", type);
+			throw Common::Exception("NCSFile::o_geq(): Illegal type %d", instr.type);
 	}
 }
 
 /** GT: compare the top-most stack elements, greater (>). */
-void NCSFile::o_gt(InstructionType type) {
-	switch (type) {
+void NCSFile::o_gt(const Instruction &instr) {
+	switch (instr.type) {
 		case kInstTypeIntInt:
 			{
 				int32 arg1 = _stack.pop().getInt();
@@ -784,13 +963,13 @@ void NCSFile::o_gt(InstructionType type) {
 			break;
 
 		default:
-			throw Common::Exception("NCSFile::o_gt(): Illegal type %d", type);
+			throw Common::Exception("NCSFile::o_gt(): Illegal type %d", instr.type);
 	}
 }
 
 /** LT: compare the top-most stack elements, less (<). */
-void NCSFile::o_lt(InstructionType type) {
-	switch (type) {
+void NCSFile::o_lt(const Instruction &instr) {
+	switch (instr.type) {
 		case kInstTypeIntInt:
 			{
 				int32 arg1 = _stack.pop().getInt();
@@ -808,13 +987,13 @@ void NCSFile::o_lt(InstructionType type) {
 			break;
 
 		default:
-			throw Common::Exception("NCSFile::o_lt(): Illegal type %d", type);
+			throw Common::Exception("NCSFile::o_lt(): Illegal type %d", instr.type);
 	}
 }
 
 /** LEQ: compare the top-most stack elements, less-or-equal (<=). */
-void NCSFile::o_leq(InstructionType type) {
-	switch (type) {
+void NCSFile::o_leq(const Instruction &instr) {
+	switch (instr.type) {
 		case kInstTypeIntInt:
 			{
 				int32 arg1 = _stack.pop().getInt();
@@ -832,14 +1011,14 @@ void NCSFile::o_leq(InstructionType type) {
 			break;
 
 		default:
-			throw Common::Exception("NCSFile::o_leq(): Illegal type %d", type);
+			throw Common::Exception("NCSFile::o_leq(): Illegal type %d", instr.type);
 	}
 }
 
 /** SHLEFT: shift the top-most stack element to the left (<<). */
-void NCSFile::o_shleft(InstructionType type) {
-	if (type != kInstTypeIntInt)
-		throw Common::Exception("NCSFile::o_shleft(): Illegal type %d", type);
+void NCSFile::o_shleft(const Instruction &instr) {
+	if (instr.type != kInstTypeIntInt)
+		throw Common::Exception("NCSFile::o_shleft(): Illegal type %d", instr.type);
 
 	int32 arg1 = _stack.pop().getInt();
 	int32 arg2 = _stack.pop().getInt();
@@ -847,15 +1026,15 @@ void NCSFile::o_shleft(InstructionType type) {
 }
 
 /** SHRIGHT: signed-shift the top-most stack element to the right (>>>). */
-void NCSFile::o_shright(InstructionType type) {
+void NCSFile::o_shright(const Instruction &instr) {
 	/* According to Skywing's NWNScriptLib
 	 * (<https://github.com/SkywingvL/nwn2dev-public/blob/master/NWNScriptLib/NWScriptVM.cpp#L2233>):
 	 * "The operation implemented here is actually a complex sequence that, if
 	 *  the amount to be shifted is negative, involves both a front-loaded and
 	 *  end-loaded negate built on top of a signed shift." */
 
-	if (type != kInstTypeIntInt)
-		throw Common::Exception("NCSFile::o_shright(): Illegal type %d", type);
+	if (instr.type != kInstTypeIntInt)
+		throw Common::Exception("NCSFile::o_shright(): Illegal type %d", instr.type);
 
 	int32 arg1 = _stack.pop().getInt();
 	int32 arg2 = _stack.pop().getInt();
@@ -868,14 +1047,14 @@ void NCSFile::o_shright(InstructionType type) {
 }
 
 /** USHRIGHT: shift the top-most stack element to the right (>>). */
-void NCSFile::o_ushright(InstructionType type) {
+void NCSFile::o_ushright(const Instruction &instr) {
 	/* According to Skywing's NWNScriptLib
 	 * (<https://github.com/SkywingvL/nwn2dev-public/blob/master/NWNScriptLib/NWScriptVM.cpp#L2272>):
 	 * "While this operator may have originally been intended to implement
 	 *  an unsigned shift, it actually performs an arithmetic (signed) shift." */
 
-	if (type != kInstTypeIntInt)
-		throw Common::Exception("NCSFile::o_ushright(): Illegal type %d", type);
+	if (instr.type != kInstTypeIntInt)
+		throw Common::Exception("NCSFile::o_ushright(): Illegal type %d", instr.type);
 
 	int32 arg1 = _stack.pop().getInt();
 	int32 arg2 = _stack.pop().getInt();
@@ -883,9 +1062,9 @@ void NCSFile::o_ushright(InstructionType type) {
 }
 
 /** MOD: calculate the remainder (modulo) of an integer division (%). */
-void NCSFile::o_mod(InstructionType type) {
-	if (type != kInstTypeIntInt)
-		throw Common::Exception("NCSFile::o_mod(): Illegal type %d", type);
+void NCSFile::o_mod(const Instruction &instr) {
+	if (instr.type != kInstTypeIntInt)
+		throw Common::Exception("NCSFile::o_mod(): Illegal type %d", instr.type);
 
 	int32 arg1 = _stack.pop().getInt();
 	int32 arg2 = _stack.pop().getInt();
@@ -899,8 +1078,8 @@ void NCSFile::o_mod(InstructionType type) {
 }
 
 /** NEQ: negate the top-most stack element (unary -). */
-void NCSFile::o_neg(InstructionType type) {
-	switch (type) {
+void NCSFile::o_neg(const Instruction &instr) {
+	switch (instr.type) {
 		case kInstTypeInt:
 			_stack.push(-_stack.pop().getInt());
 			break;
@@ -910,101 +1089,96 @@ void NCSFile::o_neg(InstructionType type) {
 			break;
 
 		default:
-			throw Common::Exception("NCSFile::o_neg(): Illegal type %d", type);
+			throw Common::Exception("NCSFile::o_neg(): Illegal type %d", instr.type);
 	}
 }
 
 /** COMP: calculate the 1-complement of the top-most stack element (~). */
-void NCSFile::o_comp(InstructionType type) {
-	if (type != kInstTypeInt)
-		throw Common::Exception("NCSFile::o_comp(): Illegal type %d", type);
+void NCSFile::o_comp(const Instruction &instr) {
+	if (instr.type != kInstTypeInt)
+		throw Common::Exception("NCSFile::o_comp(): Illegal type %d", instr.type);
 
 	_stack.push(~_stack.pop().getInt());
 }
 
 /** MOVSP: pop elements off the stack. */
-void NCSFile::o_movsp(InstructionType type) {
-	if (type != kInstTypeNone)
-		throw Common::Exception("NCSFile::o_movsp(): Illegal type %d", type);
+void NCSFile::o_movsp(const Instruction &instr) {
+	if (instr.type != kInstTypeNone)
+		throw Common::Exception("NCSFile::o_movsp(): Illegal type %d", instr.type);
 
-	_stack.setStackPtr(_stack.getStackPtr() - _script->readSint32BE());
+	_stack.setStackPtr(_stack.getStackPtr() - instr.args[0]);
 }
 
 /** JMP: jump directly to a different script offset. */
-void NCSFile::o_jmp(InstructionType type) {
-	if (type != kInstTypeNone)
-		throw Common::Exception("NCSFile::o_jmp(): Illegal type %d", type);
+void NCSFile::o_jmp(const Instruction &instr) {
+	if (instr.type != kInstTypeNone)
+		throw Common::Exception("NCSFile::o_jmp(): Illegal type %d", instr.type);
 
-	int32 offset = _script->readSint32BE();
-	_script->skip(offset - 6);
+	jump(instr.jumpTarget);
 }
 
 /** JZ: jump conditionally if the top-most stack element is 0. */
-void NCSFile::o_jz(InstructionType type) {
-	if (type != kInstTypeNone)
-		throw Common::Exception("NCSFile::o_jz(): Illegal type %d", type);
-
-	int32 offset = _script->readSint32BE();
+void NCSFile::o_jz(const Instruction &instr) {
+	if (instr.type != kInstTypeNone)
+		throw Common::Exception("NCSFile::o_jz(): Illegal type %d", instr.type);
 
 	if (!_stack.pop().getInt())
-		_script->skip(offset - 6);
+		jump(instr.jumpTarget);
 }
 
 /** NOT: boolean-negate the top-most stack element (!). */
-void NCSFile::o_not(InstructionType type) {
-	if (type != kInstTypeInt)
-		throw Common::Exception("NCSFile::o_not(): Illegal type %d", type);
+void NCSFile::o_not(const Instruction &instr) {
+	if (instr.type != kInstTypeInt)
+		throw Common::Exception("NCSFile::o_not(): Illegal type %d", instr.type);
 
 	_stack.push(!_stack.pop().getInt());
 }
 
 /** DECSP: decrement the value of a stack element (--). */
-void NCSFile::o_decsp(InstructionType type) {
-	if (type != kInstTypeInt)
-		throw Common::Exception("NCSFile::o_decsp(): Illegal type %d", type);
+void NCSFile::o_decsp(const Instruction &instr) {
+	if (instr.type != kInstTypeInt)
+		throw Common::Exception("NCSFile::o_decsp(): Illegal type %d", instr.type);
 
-	int32 offset = _script->readSint32BE();
+	int32 offset = instr.args[0];
 
 	_stack.setRelSP(offset, _stack.getRelSP(offset).getInt() - 1);
 }
 
 /** INCSP: increment the value of a stack element (++). */
-void NCSFile::o_incsp(InstructionType type) {
-	if (type != kInstTypeInt)
-		throw Common::Exception("NCSFile::o_incsp(): Illegal type %d", type);
+void NCSFile::o_incsp(const Instruction &instr) {
+	if (instr.type != kInstTypeInt)
+		throw Common::Exception("NCSFile::o_incsp(): Illegal type %d", instr.type);
 
-	int32 offset = _script->readSint32BE();
+	int32 offset = instr.args[0];
 
 	_stack.setRelSP(offset, _stack.getRelSP(offset).getInt() + 1);
 }
 
 /** JNZ: jump conditionally if the top-most stack element is not 0. */
-void NCSFile::o_jnz(InstructionType type) {
-	if (type != kInstTypeNone)
-		throw Common::Exception("NCSFile::o_jnz(): Illegal type %d", type);
-
-	int32 offset = _script->readSint32BE();
+void NCSFile::o_jnz(const Instruction &instr) {
+	if (instr.type != kInstTypeNone)
+		throw Common::Exception("NCSFile::o_jnz(): Illegal type %d", instr.type);
 
 	if (_stack.pop().getInt())
-		_script->skip(offset - 6);
+		jump(instr.jumpTarget);
 }
 
 /** DECBP: decrement the value of a base-pointer stack element (--). */
-void NCSFile::o_decbp(InstructionType type) {
-	if (type != kInstTypeInt)
-		throw Common::Exception("NCSFile::o_decbp(): Illegal type %d", type);
+void NCSFile::o_decbp(const Instruction &instr) {
+	if (instr.type != kInstTypeInt)
+		throw Common::Exception("NCSFile::o_decbp(): Illegal type %d", instr.type);
 
-	int32 offset = _script->readSint32BE();
+	int32 offset = instr.args[0];
 
 	_stack.setRelBP(offset, _stack.getRelBP(offset).getInt() - 1);
 }
 
 /** INCBP: increment the value of a base-pointer stack element (++). */
-void NCSFile::o_incbp(InstructionType type) {
-	if (type != kInstTypeInt)
-		throw Common::Exception("NCSFile::o_incbp(): Illegal type %d", type);
+void NCSFile::o_incbp(const Instruction &instr) {
+	if (instr.type != kInstTypeInt)
+		throw Common::Exception("NCSFile::o_incbp(): Illegal type %d", instr.type);
 
-	int32 offset = _script->readSint32BE();
+	int32 offset = instr.args[0];
 
 	_stack.setRelBP(offset, _stack.getRelBP(offset).getInt() + 1);
 }
@@ -1013,9 +1187,9 @@ void NCSFile::o_incbp(InstructionType type) {
  *
  *  Used to create an anchor point to access global variables.
  */
-void NCSFile::o_savebp(InstructionType type) {
-	if (type != kInstTypeNone)
-		throw Common::Exception("NCSFile::o_savebp(): Illegal type %d", type);
+void NCSFile::o_savebp(const Instruction &instr) {
+	if (instr.type != kInstTypeNone)
+		throw Common::Exception("NCSFile::o_savebp(): Illegal type %d", instr.type);
 
 	_stack.push(_stack.getBasePtr());
 	_stack.setBasePtr(_stack.getStackPtr());
@@ -1025,25 +1199,25 @@ void NCSFile::o_savebp(InstructionType type) {
  *
  *  Destroy the global variables anchor point after use.
  */
-void NCSFile::o_restorebp(InstructionType type) {
-	if (type != kInstTypeNone)
-		throw Common::Exception("NCSFile::o_restorebp(): Illegal type %d", type);
+void NCSFile::o_restorebp(const Instruction &instr) {
+	if (instr.type != kInstTypeNone)
+		throw Common::Exception("NCSFile::o_restorebp(): Illegal type %d", instr.type);
 
 	_stack.setBasePtr(_stack.pop().getInt());
 }
 
 /** NOP: no operation. */
-void NCSFile::o_nop(InstructionType UNUSED(type)) {
+void NCSFile::o_nop(const Instruction &UNUSED(instr)) {
 	// Nothing! Yay!
 }
 
 /** CPDOWNSP: copy a value into an existing stack element. */
-void NCSFile::o_cpdownsp(InstructionType type) {
-	if (type != kInstTypeDirect)
-		throw Common::Exception("NCSFile::o_cpdownsp(): Illegal type %d", type);
+void NCSFile::o_cpdownsp(const Instruction &instr) {
+	if (instr.type != kInstTypeDirect)
+		throw Common::Exception("NCSFile::o_cpdownsp(): Illegal type %d", instr.type);
 
-	int32 offset = _script->readSint32BE();
-	int16 size   = _script->readSint16BE();
+	int32 offset = instr.args[0];
+	int16 size   = instr.args[1];
 
 	if ((size % 4) != 0)
 		throw Common::Exception("NCSFile::o_cpdownsp(): Illegal size %d", size);
@@ -1059,12 +1233,12 @@ void NCSFile::o_cpdownsp(InstructionType type) {
 }
 
 /** CPTOPSP: push a copy of a stack element on top of the stack. */
-void NCSFile::o_cptopsp(InstructionType type) {
-	if (type != kInstTypeDirect)
-		throw Common::Exception("NCSFile::o_cptopsp(): Illegal type %d", type);
+void NCSFile::o_cptopsp(const Instruction &instr) {
+	if (instr.type != kInstTypeDirect)
+		throw Common::Exception("NCSFile::o_cptopsp(): Illegal type %d", instr.type);
 
-	int32 offset = _script->readSint32BE();
-	int16 size   = _script->readSint16BE();
+	int32 offset = instr.args[0];
+	int16 size   = instr.args[1];
 
 	if ((size % 4) != 0)
 		throw Common::Exception("NCSFile::o_cptopsp(): Illegal size %d", size);
@@ -1077,8 +1251,8 @@ void NCSFile::o_cptopsp(InstructionType type) {
 }
 
 /** ADD: add the top-most stack elements (+). */
-void NCSFile::o_add(InstructionType type) {
-	switch (type) {
+void NCSFile::o_add(const Instruction &instr) {
+	switch (instr.type) {
 		case kInstTypeIntInt: {
 			Variable op2 = _stack.pop();
 			Variable op1 = _stack.pop();
@@ -1134,13 +1308,13 @@ void NCSFile::o_add(InstructionType type) {
 		}
 
 		default:
-			throw Common::Exception("NCSFile::o_add(): Illegal type %d", type);
+			throw Common::Exception("NCSFile::o_add(): Illegal type %d", instr.type);
 	}
 }
 
 /** SUB: subtract the top-most stack elements (-). */
-void NCSFile::o_sub(InstructionType type) {
-	switch (type) {
+void NCSFile::o_sub(const Instruction &instr) {
+	switch (instr.type) {
 		case kInstTypeIntInt: {
 			Variable op2 = _stack.pop();
 			Variable op1 = _stack.pop();
@@ -1188,13 +1362,13 @@ void NCSFile::o_sub(InstructionType type) {
 		}
 
 		default:
-			throw Common::Exception("NCSFile::o_sub(): Illegal type %d", type);
+			throw Common::Exception("NCSFile::o_sub(): Illegal type %d", instr.type);
 	}
 }
 
 /** MUL: multiply the top-most stack elements (*). */
-void NCSFile::o_mul(InstructionType type) {
-	switch (type) {
+void NCSFile::o_mul(const Instruction &instr) {
+	switch (instr.type) {
 		case kInstTypeIntInt: {
 			Variable op2 = _stack.pop();
 			Variable op1 = _stack.pop();
@@ -1252,13 +1426,13 @@ void NCSFile::o_mul(InstructionType type) {
 		}
 
 		default:
-			throw Common::Exception("NCSFile::o_mul(): Illegal type %d", type);
+			throw Common::Exception("NCSFile::o_mul(): Illegal type %d", instr.type);
 	}
 }
 
 /** DIV: divide the top-most stack elements (/). */
-void NCSFile::o_div(InstructionType type) {
-	switch (type) {
+void NCSFile::o_div(const Instruction &instr) {
+	switch (instr.type) {
 		case kInstTypeIntInt: {
 			Variable op2 = _stack.pop();
 			Variable op1 = _stack.pop();
@@ -1337,13 +1511,13 @@ void NCSFile::o_div(InstructionType type) {
 		}
 
 		default:
-			throw Common::Exception("NCSFile::o_div(): Illegal type %d", type);
+			throw Common::Exception("NCSFile::o_div(): Illegal type %d", instr.type);
 	}
 }
 
 /** STORESTATEALL: unused, obsolete opcode. Hopefully. */
-void NCSFile::o_storestateall(InstructionType type) {
-	uint8  offset = (uint8) type;
+void NCSFile::o_storestateall(const Instruction &instr) {
+	uint8  offset = (uint8) instr.type;
 
 	// TODO: NCSFile::o_storestateall(): See o_storestate.
 	//       Supposedly obsolete. Whether it's used anywhere remains to be seen.
@@ -1351,37 +1525,35 @@ void NCSFile::o_storestateall(InstructionType type) {
 }
 
 /** JSR: call a subroutine. */
-void NCSFile::o_jsr(InstructionType type) {
-	if (type != kInstTypeNone)
-		throw Common::Exception("NCSFile::o_jsr(): Illegal type %d", type);
+void NCSFile::o_jsr(const Instruction &instr) {
+	if (instr.type != kInstTypeNone)
+		throw Common::Exception("NCSFile::o_jsr(): Illegal type %d", instr.type);
 
-	int32 offset = _script->readSint32BE();
+	// Push the index of the instruction following this one
+	_returnOffsets.push(_pc);
 
-	// Push the current script position
-	_returnOffsets.push(_script->pos());
-
-	_script->skip(offset - 6);
+	jump(instr.jumpTarget);
 }
 
 /** RETN: return from a subroutine call. */
-void NCSFile::o_retn(InstructionType UNUSED(type)) {
-	uint32 returnAddress = _script->size();
+void NCSFile::o_retn(const Instruction &UNUSED(instr)) {
+	size_t returnAddress = _program->instructions.size();
 	if (!_returnOffsets.empty()) {
 		returnAddress = _returnOffsets.top();
 		_returnOffsets.pop();
 	}
 
-	_script->seek(returnAddress);
+	_pc = returnAddress;
 }
 
 /** DESTRUCT: remove elements from the stack.
  *
  *  Used to isolate struct elements.
  */
-void NCSFile::o_destruct(InstructionType UNUSED(type)) {
-	int16 stackSize        = _script->readSint16BE();
-	int16 dontRemoveOffset = _script->readSint16BE();
-	int16 dontRemoveSize   = _script->readSint16BE();
+void NCSFile::o_destruct(const Instruction &instr) {
+	int16 stackSize        = instr.args[0];
+	int16 dontRemoveOffset = instr.args[1];
+	int16 dontRemoveSize   = instr.args[2];
 
 	if ((stackSize % 4) != 0)
 		throw Common::Exception("NCSFile::o_destruct(): Illegal stack size %d", stackSize);
@@ -1412,12 +1584,12 @@ void NCSFile::o_destruct(InstructionType UNUSED(type)) {
  *
  *  Used to write into a global variable.
  */
-void NCSFile::o_cpdownbp(InstructionType type) {
-	if (type != kInstTypeDirect)
-		throw Common::Exception("NCSFile::o_cpdownbp(): Illegal type %d", type);
+void NCSFile::o_cpdownbp(const Instruction &instr) {
+	if (instr.type != kInstTypeDirect)
+		throw Common::Exception("NCSFile::o_cpdownbp(): Illegal type %d", instr.type);
 
-	int32 offset = _script->readSint32BE() - 4;
-	int16 size   = _script->readSint16BE();
+	int32 offset = instr.args[0] - 4;
+	int16 size   = instr.args[1];
 
 	if ((size % 4) != 0)
 		throw Common::Exception("NCSFile::o_cpdownbp(): Illegal size %d", size);
@@ -1436,12 +1608,12 @@ void NCSFile::o_cpdownbp(InstructionType type) {
  *
  *  Used to read from a global variable.
  */
-void NCSFile::o_cptopbp(InstructionType type) {
-	if (type != kInstTypeDirect)
-		throw Common::Exception("NCSFile::o_cptopbp(): Illegal type %d", type);
+void NCSFile::o_cptopbp(const Instruction &instr) {
+	if (instr.type != kInstTypeDirect)
+		throw Common::Exception("NCSFile::o_cptopbp(): Illegal type %d", instr.type);
 
-	int32 offset = _script->readSint32BE() - 4;
-	int16 size   = _script->readSint16BE();
+	int32 offset = instr.args[0] - 4;
+	int16 size   = instr.args[1];
 
 	if ((size % 4) != 0)
 		throw Common::Exception("NCSFile::o_cptopbp(): Illegal size %d", size);
@@ -1459,10 +1631,10 @@ void NCSFile::o_cptopbp(InstructionType type) {
  *  Used to create the "action" variables when calling an engine function that
  *  assigns a function to an object, or delays a function, or similar.
  */
-void NCSFile::o_storestate(InstructionType type) {
-	uint8  offset = (uint8) type;
-	uint32 sizeBP = _script->readUint32BE();
-	uint32 sizeSP = _script->readUint32BE();
+void NCSFile::o_storestate(const Instruction &instr) {
+	uint8  offset = (uint8) instr.type;
+	uint32 sizeBP = instr.args[0];
+	uint32 sizeSP = instr.args[1];
 
 	if ((sizeBP % 4) != 0)
 		throw Common::Exception("NCSFile::o_storestate(): Illegal BP size %d", sizeBP);
@@ -1472,7 +1644,7 @@ void NCSFile::o_storestate(InstructionType type) {
 	_storedState.setType(kTypeScriptState);
 	ScriptState &state = _storedState.getScriptState();
 
-	state.offset = _script->pos() - 10 + offset;
+	state.offset = instr.address + offset;
 
 	sizeBP /= 4;
 	sizeSP /= 4;
@@ -1495,12 +1667,12 @@ void NCSFile::o_storestate(InstructionType type) {
  *
  *  The index is popped off the stack, but the value written remains.
  */
-void NCSFile::o_writearray(InstructionType type) {
-	if (type != kInstTypeDirect)
-		throw Common::Exception("NCSFile::o_writearray(): Illegal type %d", type);
+void NCSFile::o_writearray(const Instruction &instr) {
+	if (instr.type != kInstTypeDirect)
+		throw Common::Exception("NCSFile::o_writearray(): Illegal type %d", instr.type);
 
-	int32 offset = _script->readSint32BE();
-	int16 size   = _script->readSint16BE();
+	int32 offset = instr.args[0];
+	int16 size   = instr.args[1];
 
 	if (size != 4)
 		throw Common::Exception("NCSFile::o_writearray(): Invalid size %d", size);
@@ -1530,12 +1702,12 @@ void NCSFile::o_writearray(InstructionType type) {
  *  The index is popped off the stack, and the value read out of the
  *  array is pushed on top.
  */
-void NCSFile::o_readarray(InstructionType type) {
-	if (type != kInstTypeDirect)
-		throw Common::Exception("NCSFile::o_readarray(): Illegal type %d", type);
+void NCSFile::o_readarray(const Instruction &instr) {
+	if (instr.type != kInstTypeDirect)
+		throw Common::Exception("NCSFile::o_readarray(): Illegal type %d", instr.type);
 
-	int32 offset = _script->readSint32BE();
-	int16 size   = _script->readSint16BE();
+	int32 offset = instr.args[0];
+	int16 size   = instr.args[1];
 
 	if (size != 4)
 		throw Common::Exception("NCSFile::o_readarray(): Invalid size %d", size);
@@ -1562,12 +1734,12 @@ void NCSFile::o_readarray(InstructionType type) {
  *  The offset to the variable to create a reference to is passed
  *  as a direct argument to the instruction.
  */
-void NCSFile::o_getref(InstructionType type) {
-	if (type != kInstTypeDirect)
-		throw Common::Exception("NCSFile::o_getref(): Illegal type %d", type);
+void NCSFile::o_getref(const Instruction &instr) {
+	if (instr.type != kInstTypeDirect)
+		throw Common::Exception("NCSFile::o_getref(): Illegal type %d", instr.type);
 
-	int32 offset = _script->readSint32BE();
-	int16 size   = _script->readSint16BE();
+	int32 offset = instr.args[0];
+	int16 size   = instr.args[1];
 
 	if (size != 4)
 		throw Common::Exception("NCSFile::o_getref(): Invalid size %d", size);
@@ -1593,12 +1765,12 @@ void NCSFile::o_getref(InstructionType type) {
  *  The index is popped off the stack, and the reference to the
  *  variable inside the array is pushed on top.
  */
-void NCSFile::o_getrefarray(InstructionType type) {
-	if (type != kInstTypeDirect)
-		throw Common::Exception("NCSFile::o_getrefarray(): Illegal type %d", type);
+void NCSFile::o_getrefarray(const Instruction &instr) {
+	if (instr.type != kInstTypeDirect)
+		throw Common::Exception("NCSFile::o_getrefarray(): Illegal type %d", instr.type);
 
-	int32 offset = _script->readSint32BE();
-	int16 size   = _script->readSint16BE();
+	int32 offset = instr.args[0];
+	int16 size   = instr.args[1];
 
 	if (size != 4)
 		throw Common::Exception("NCSFile::o_getrefarray(): Invalid size %d", size);
@@ -1616,6 +1788,14 @@ void NCSFile::o_getrefarray(InstructionType type) {
 	_stack.top().setReference(&*array[index]);
 }
 
+/** An invalid or truncated instruction. */
+void NCSFile::o_illegal(const Instruction &instr) {
+	if (instr.opcode == kOpcodeTruncated)
+		throw Common::Exception("NCSFile::o_illegal(): Truncated instruction at offset %u", instr.address);
+
+	throw Common::Exception("NCSFile::executeStep(): Illegal instruction 0x%02x", instr.opcode);
+}
+
 } // End of namespace NWScript
 
 } // End of namespace Aurora
@@ -28,8 +28,9 @@
 #include <vector>
 #include <stack>
 
+#include <boost/shared_ptr.hpp>
+
 #include "src/common/types.h"
-#include "src/common/scopedptr.h"
 
 #include "src/aurora/types.h"
 #include "src/aurora/aurorafile.h"
@@ -79,7 +80,7 @@ private:
 	int32 _basePtr;
 };
 
-#define DECLARE_OPCODE(x) void x(InstructionType type)
+#define DECLARE_OPCODE(x) void x(const Instruction &instr)
 
 /** An NCS, BioWare's NWN Compile Script. */
 class NCSFile : public AuroraFile {
@@ -158,10 +159,73 @@ private:
 		kInstTypeFloatVector            = 60
 	};
 
+	/** The layout of an instruction's direct arguments in the bytecode. */
+	enum ArgumentFormat {
+		kArgsNone,        ///< No arguments.
+		kArgsOffset,      ///< int32 stack offset.
+		kArgsOffsetSize,  ///< int32 stack offset, int16 size.
+		kArgsConst,       ///< A constant, depending on the instruction type.
+		kArgsAction,      ///< uint16 engine function, uint8 argument count.
+		kArgsStructSize,  ///< uint16 size, only for struct/struct comparisons.
+		kArgsJump,        ///< int32 relative jump offset.
+		kArgsDestruct,    ///< 3 * int16 sizes and offset.
+		kArgsStoreState,  ///< uint32 BP size, uint32 SP size.
+		kArgsIllegal      ///< Not a valid instruction.
+	};
+
+	struct Instruction;
+
+	typedef void (NCSFile::*OpcodeProc)(const Instruction &instr);
+	struct Opcode {
+		OpcodeProc proc;
+		const char *desc;
+		ArgumentFormat args;
+	};
+
+	/** A single, fully decoded instruction. */
+	struct Instruction {
+		uint32 address; ///< The offset of this instruction within the NCS file.
+
+		uint8 opcode;
+		InstructionType type;
+
+		/** The handler executing this instruction. */
+		OpcodeProc proc;
+
+		/** The direct arguments, or the index into the constant pool for CONST. */
+		int32 args[3];
+
+		/** The index of the instruction a jump lands on. */
+		size_t jumpTarget;
+	};
+
+	/** A decoded script, shared by all NCSFile instances running it. */
+	struct Program {
+		uint32 id;      ///< The file's ID.
+		uint32 version; ///< The file's version.
+		bool   utf16le; ///< The file's ID and version are in little-endian UTF-16.
+
+		uint32 size; ///< The size of the original NCS file.
+
+		std::vector<Instruction> instructions;
+		std::vector<Variable> constants;
+
+		/** Find the index of the instruction at this NCS file offset. */
+		size_t findInstruction(uint32 address) const;
+	};
+
+	typedef boost::shared_ptr<const Program> ProgramPtr;
+
+	struct ProgramCache;
+
 	Common::UString _name;
 
 	NCSStack _stack;
-	Common::ScopedPtr<Common::SeekableReadStream> _script;
+
+	ProgramPtr _program;
+
+	/** The index of the next instruction to execute. */
+	size_t _pc;
 
 	Variable _return;
 
@@ -170,20 +234,18 @@ private:
 
 	VariableContainer _env;
 
-	std::stack<uint32> _returnOffsets;
+	std::stack<size_t> _returnOffsets;
 
 	Variable _storedState;
 
-	typedef void (NCSFile::*OpcodeProc)(InstructionType type);
-	struct Opcode {
-		OpcodeProc proc;
-		const char *desc;
-	};
-	const Opcode *_opcodes;
-	size_t _opcodeListSize;
-	void setupOpcodes();
+	static const Opcode *getOpcodes(size_t &count);
+
+	/** Read and decode a complete NCS file. */
+	static ProgramPtr decode(Common::SeekableReadStream &ncs);
+	/** Return the decoded script of this name, from the cache if possible. */
+	static ProgramPtr getProgram(const Common::UString &name);
 
-	void load();
+	void load(const ProgramPtr &program);
 
 	/** Reset the script for another execution. */
 	void reset();
@@ -193,7 +255,8 @@ private:
 	/** Execute one script step. */
 	bool executeStep();
 
-	void decompile(); // TODO
+	/** Jump to this instruction index. */
+	void jump(size_t target);
 
 	void callEngine(Aurora::NWScript::FunctionContext &ctx, uint32 function, uint8 argCount);
 
@@ -247,6 +310,7 @@ private:
 	DECLARE_OPCODE(o_readarray);
 	DECLARE_OPCODE(o_getref);
 	DECLARE_OPCODE(o_getrefarray);
+	DECLARE_OPCODE(o_illegal);
 };
 
 #undef DECLARE_OPCODE
@@ -34,6 +34,23 @@ namespace Aurora {
 
 namespace NWScript {
 
+/** Objects with IDs below this are kept in a vector indexed by their ID.
+ *
+ *  The engines number their objects with small, increasing IDs, so this
+ *  covers almost all of them. The few objects with IDs read from the game
+ *  data, which might be anywhere, go into a map instead.
+ */
+static const uint32 kMaxDenseID = 0x100000;
+
+
+ObjectSearch::ObjectSearch() {
+	static const ObjectList kEmptyObjectList;
+
+	_current = kEmptyObjectList.begin();
+	_end     = kEmptyObjectList.end();
+}
+
+
 ObjectContainer::ObjectContainer() {
 }
 
@@ -45,6 +62,7 @@ void ObjectContainer::clearObjects() {
 
 	_objects.clear();
 	_objectsByID.clear();
+	_objectsByLargeID.clear();
 	_objectsByTag.clear();
 }
 
@@ -54,53 +72,79 @@ void ObjectContainer::addObject(Object &object) {
 	assert(std::find(_objects.begin(), _objects.end(), &object) == _objects.end());
 
 	_objects.push_back(&object);
-	_objectsByID.insert(std::make_pair(object.getID(), &object));
-	_objectsByTag.insert(std::make_pair(object.getTag(), &object));
+	_objectsByTag[object.getTag()].push_back(&object);
+
+	// If several objects share an ID, the first one wins
+	const uint32 id = object.getID();
+	if (id < kMaxDenseID) {
+		if (id >= _objectsByID.size())
+			_objectsByID.resize(id + 1, 0);
+
+		if (!_objectsByID[id])
+			_objectsByID[id] = &object;
+
+	} else
+		_objectsByLargeID.insert(std::make_pair(id, &object));
 }
 
 void ObjectContainer::removeObject(Object &object) {
 	Common::StackLock stackLock(_mutex);
 
-	_objects.remove(&object);
-	_objectsByID.erase(object.getID());
+	_objects.erase(std::remove(_objects.begin(), _objects.end(), &object), _objects.end());
+
+	ObjectTagMap::iterator tag = _objectsByTag.find(object.getTag());
+	if (tag != _objectsByTag.end()) {
+		tag->second.erase(std::remove(tag->second.begin(), tag->second.end(), &object), tag->second.end());
+
+		if (tag->second.empty())
+			_objectsByTag.erase(tag);
+	}
 
-	std::pair<ObjectTagMap::iterator, ObjectTagMap::iterator> tag =
-		_objectsByTag.equal_range(object.getTag());
+	const uint32 id = object.getID();
+	if (id < kMaxDenseID) {
+		if ((id < _objectsByID.size()) && (_objectsByID[id] == &object))
+			_objectsByID[id] = 0;
 
-	for (ObjectTagMap::iterator o = tag.first; o != tag.second; ++o) {
-		if (o->second == &object) {
-			_objectsByTag.erase(o);
-			break;
-		}
+	} else {
+		ObjectIDMap::iterator o = _objectsByLargeID.find(id);
+		if ((o != _objectsByLargeID.end()) && (o->second == &object))
+			_objectsByLargeID.erase(o);
 	}
 }
 
 Object *ObjectContainer::getObjectByID(uint32 id) const {
-	ObjectIDMap::const_iterator o = _objectsByID.find(id);
-	if (o != _objectsByID.end())
+	if (id < kMaxDenseID)
+		return (id < _objectsByID.size()) ? _objectsByID[id] : 0;
+
+	ObjectIDMap::const_iterator o = _objectsByLargeID.find(id);
+	if (o != _objectsByLargeID.end())
 		return o->second;
 
 	return 0;
 }
 
 Object *ObjectContainer::getFirstObject() const {
-	SearchList ctx(_objects);
-
-	return ctx.get();
+	return _objects.empty() ? 0 : _objects.front();
 }
 
 Object *ObjectContainer::getFirstObjectByTag(const Common::UString &tag) const {
-	SearchTagMap ctx(_objectsByTag, tag);
+	ObjectTagMap::const_iterator objects = _objectsByTag.find(tag);
+	if (objects == _objectsByTag.end())
+		return 0;
 
-	return ctx.get();
+	return objects->second.front();
 }
 
-ObjectSearch *ObjectContainer::findObjects() const {
-	return new SearchList(_objects);
+ObjectSearch ObjectContainer::findObjects() const {
+	return ObjectSearch(_objects);
 }
 
-ObjectSearch *ObjectContainer::findObjectsByTag(const Common::UString &tag) const {
-	return new SearchTagMap(_objectsByTag, tag);
+ObjectSearch ObjectContainer::findObjectsByTag(const Common::UString &tag) const {
+	ObjectTagMap::const_iterator objects = _objectsByTag.find(tag);
+	if (objects == _objectsByTag.end())
+		return ObjectSearch();
+
+	return ObjectSearch(objects->second);
 }
 
 void ObjectContainer::lock() {
@@ -25,9 +25,13 @@
 #ifndef AURORA_NWSCRIPT_OBJECTCONTAINER_H
 #define AURORA_NWSCRIPT_OBJECTCONTAINER_H
 
-#include <list>
+#include <vector>
 #include <map>
 
+#include <boost/unordered/unordered_map.hpp>
+
+#include "src/common/types.h"
+#include "src/common/ustring.h"
 #include "src/common/mutex.h"
 
 #include "src/aurora/nwscript/object.h"
@@ -36,65 +40,40 @@ namespace Aurora {
 
 namespace NWScript {
 
+/** A search context iterating over a range of objects.
+ *
+ *  The search is a small value meant to live on the stack. It stays valid
+ *  only as long as no objects are added to or removed from the container
+ *  it came from.
+ */
 class ObjectSearch {
 public:
-	ObjectSearch() { }
-	virtual ~ObjectSearch() { }
+	typedef std::vector<Object *> ObjectList;
 
-	/** Return the current object in the search context. */
-	virtual Object *get()  = 0;
-	/** Move to the next object in the search context and return the previous one. */
-	virtual Object *next() = 0;
-};
+	/** Create an empty search context. */
+	ObjectSearch();
+	/** Create a search context iterating over these objects. */
+	ObjectSearch(const ObjectList &objects) : _current(objects.begin()), _end(objects.end()) { }
 
-template<typename T> class SearchRange : public ObjectSearch {
-public:
-	typedef T type;
-	typedef typename T::const_iterator iterator;
-	typedef std::pair<iterator, iterator> range;
-
-	SearchRange(const range &r) : _range(r) { }
-	~SearchRange() { }
-
-	Object *get() {
-		if (_range.first == _range.second)
+	/** Return the current object in the search context. */
+	Object *get() const {
+		if (_current == _end)
 			return 0;
 
-		return getObject(_range.first);
+		return *_current;
 	}
 
+	/** Move to the next object in the search context and return the previous one. */
 	Object *next() {
-		if (_range.first == _range.second)
+		if (_current == _end)
 			return 0;
 
-		Object *object = getObject(_range.first);
-
-		++_range.first;
-
-		return object;
+		return *_current++;
 	}
 
-protected:
-	virtual Object *getObject(const iterator &t) = 0;
-
 private:
-	range _range;
-};
-
-class SearchList : public SearchRange< std::list<Object *> > {
-public:
-	SearchList(const type &l) : SearchRange<type>(std::make_pair(l.begin(), l.end())) { }
-	~SearchList() { }
-
-	Object *getObject(const iterator &t) { return *t; }
-};
-
-class SearchTagMap : public SearchRange< std::multimap<Common::UString, Object *> > {
-public:
-	SearchTagMap(const type &m, const Common::UString &tag) : SearchRange<type>(m.equal_range(tag)) { }
-	~SearchTagMap() { }
-
-	Object *getObject(const iterator &t) { return t->second; };
+	ObjectList::const_iterator _current;
+	ObjectList::const_iterator _end;
 };
 
 class ObjectContainer {
@@ -118,9 +97,9 @@ public:
 	Object *getFirstObjectByTag(const Common::UString &tag) const;
 
 	/** Return a search context to iterate over all objects. */
-	ObjectSearch *findObjects() const;
+	ObjectSearch findObjects() const;
 	/** Return a search context to iterate over all objects with this tag. */
-	ObjectSearch *findObjectsByTag(const Common::UString &tag) const;
+	ObjectSearch findObjectsByTag(const Common::UString &tag) const;
 
 
 protected:
@@ -129,15 +108,20 @@ protected:
 
 
 private:
+	typedef ObjectSearch::ObjectList ObjectList;
 	typedef std::map<uint32, Object *> ObjectIDMap;
-	typedef SearchList::type ObjectList;
-	typedef SearchTagMap::type ObjectTagMap;
+	typedef boost::unordered_map<Common::UString, ObjectList, Common::hashUStringCaseSensitive> ObjectTagMap;
 
 	Common::Mutex _mutex;
 
-	ObjectList   _objects;
-	ObjectIDMap  _objectsByID;
-	ObjectTagMap _objectsByTag;
+	ObjectList _objects; ///< All objects, in the order they were added.
+
+	/** All objects with small IDs, indexed by their ID. Empty slots are 0. */
+	ObjectList  _objectsByID;
+	/** All objects with IDs too large for _objectsByID. */
+	ObjectIDMap _objectsByLargeID;
+
+	ObjectTagMap _objectsByTag; ///< All objects, grouped by tag.
 };
 
 } // End of namespace NWScript
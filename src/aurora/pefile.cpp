@@ -51,6 +51,8 @@ Common::SeekableReadStream *PEFile::getResource(uint32 index, bool UNUSED(tryNoC
 	// Convert from the PE cursor group/cursor format to the standalone
 	// cursor format.
 
+	Common::StackLock lock(_mutex);
+
 	Common::ScopedPtr<Common::SeekableReadStream>
 		cursorGroup(_peFile->getResource(Common::kPEGroupCursor, index));
 
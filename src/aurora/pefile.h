@@ -30,6 +30,7 @@
 #include "src/common/types.h"
 #include "src/common/scopedptr.h"
 #include "src/common/ustring.h"
+#include "src/common/mutex.h"
 
 #include "src/aurora/types.h"
 #include "src/aurora/archive.h"
@@ -58,6 +59,9 @@ private:
 	/** The actual exe. */
 	Common::ScopedPtr<Common::PEResources> _peFile;
 
+	/** Serializes reading resources, which seeks around in the exe stream. */
+	mutable Common::Mutex _mutex;
+
 	/** External list of resource names and types. */
 	ResourceList _resources;
 
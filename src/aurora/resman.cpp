@@ -30,8 +30,11 @@
 #include "src/common/scopedptr.h"
 #include "src/common/error.h"
 #include "src/common/readstream.h"
+#include "src/common/memreadstream.h"
+#include "src/common/threadpool.h"
 #include "src/common/filepath.h"
 #include "src/common/readfile.h"
+#include "src/common/mappedfile.h"
 #include "src/common/writefile.h"
 
 #include "src/aurora/resman.h"
@@ -93,8 +96,9 @@ void ResourceManager::OpenedArchive::set(KnownArchive &kA, Archive &a) {
 }
 
 
-ResourceManager::Resource::Resource() : type(kFileTypeNone), isSmall(false), priority(0),
-		source(kSourceNone), archive(0), archiveIndex(0xFFFFFFFF) {
+ResourceManager::Resource::Resource() : name(Common::StringPool::kEmptyString), type(kFileTypeNone),
+		isSmall(false), priority(0), source(kSourceNone), path(Common::StringPool::kEmptyString),
+		archive(0), archiveIndex(0xFFFFFFFF) {
 
 	selfArchive.first = 0;
 }
@@ -104,8 +108,37 @@ bool ResourceManager::Resource::operator<(const Resource &right) const {
 }
 
 
+ResourceManager::PrefetchedResource::PrefetchedResource(const Resource &res) :
+	resource(&res), state(kPrefetchQueued), stream(0) {
+
+}
+
+
+/** A job reading one resource for the prefetch cache. */
+class ResourceManager::PrefetchJob : public Common::ThreadPool::Job {
+public:
+	PrefetchJob(ResourceManager &resMan, const Resource &res) : _resMan(&resMan), _res(&res) {
+	}
+
+	void run() {
+		_resMan->runPrefetch(*_res);
+	}
+
+private:
+	ResourceManager *_resMan;
+	const Resource  *_res;
+};
+
+
+/** By default, keep up to 64MB of prefetched resources around. */
+static const size_t kPrefetchCacheSize = 64 * 1024 * 1024;
+
+/** Reading resources is mostly I/O bound, so a few prefetch threads are enough. */
+static const size_t kPrefetchThreadCount = 4;
+
 ResourceManager::ResourceManager() : _hasSmall(false),
-	_hashAlgo(Common::kHashFNV64) {
+	_hashAlgo(Common::kHashFNV64), _mapArchives(false), _revision(0),
+	_prefetchSize(0), _prefetchCacheSize(kPrefetchCacheSize), _prefetchDone(_prefetchMutex) {
 
 	// These file types are archives
 
@@ -177,11 +210,15 @@ void ResourceManager::clear() {
 	_hasSmall = false;
 	_hashAlgo = Common::kHashFNV64;
 
+	_mapArchives = false;
+
 	setRIMsAreERFs(false);
 	clearResources();
 }
 
 void ResourceManager::clearResources() {
+	cancelPrefetch();
+
 	_cursorRemap.clear();
 
 	_baseDir.clear();
@@ -194,9 +231,15 @@ void ResourceManager::clearResources() {
 		delete a->archive;
 	_openedArchives.clear();
 
+	for (ResourceMap::iterator r = _resources.begin(); r != _resources.end(); ++r)
+		delete r.value().resources;
 	_resources.clear();
 
+	_strings.clear();
+
 	_changes.clear();
+
+	_revision++;
 }
 
 void ResourceManager::setRIMsAreERFs(bool rimsAreERFs) {
@@ -227,6 +270,10 @@ void ResourceManager::setHashAlgo(Common::HashAlgo algo) {
 	_hashAlgo = algo;
 }
 
+void ResourceManager::setMapArchives(bool mapArchives) {
+	_mapArchives = mapArchives && Common::MappedFile::isSupported();
+}
+
 void ResourceManager::setCursorRemap(const std::vector<Common::UString> &remap) {
 	_cursorRemap = remap;
 }
@@ -288,12 +335,26 @@ Common::SeekableReadStream *ResourceManager::openArchiveStream(const KnownArchiv
 	if (!archive.resource)
 		throw Common::Exception("Archive without resource reference");
 
-	return getResource(*archive.resource, true);
+	const Resource &res = *archive.resource;
+
+	/* Map archive files directly into memory, if we're allowed to. Uncompressed
+	 * resources are then read straight out of the mapping, without copying. */
+	if (_mapArchives && (res.source == kSourceFile) && !res.isSmall) {
+		try {
+			return new Common::MappedFile(_strings.get(res.path));
+		} catch (Common::Exception &) {
+			warning("Failed to map archive \"%s\", reading it normally instead", _strings.get(res.path).c_str());
+		}
+	}
+
+	return getResource(res, true);
 }
 
 void ResourceManager::indexArchive(const Common::UString &file, uint32 priority,
                                    const std::vector<byte> &password, Common::ChangeID *changeID) {
 
+	cancelPrefetch();
+
 	KnownArchive *knownArchive = findArchive(file);
 	if (!knownArchive)
 		throw Common::Exception("No such archive file \"%s\"", file.c_str());
@@ -433,25 +494,28 @@ void ResourceManager::indexArchive(KnownArchive &knownArchive, Archive *archive,
 		res.source       = kSourceArchive;
 		res.archive      = &_openedArchives.back();
 		res.archiveIndex = resource->index;
-		res.name         = resource->name;
 		res.type         = resource->type;
 
+		Common::UString name = resource->name;
+
 		// Get the hash or calculate if we have to
-		uint64 hash = (hashAlgo == Common::kHashNone) ? getHash(res.name, res.type) : resource->hash;
+		uint64 hash = (hashAlgo == Common::kHashNone) ? getHash(name, res.type) : resource->hash;
 
 		// Normalize the file types if we can and recalculate the hash
-		if ((res.name != "") && (res.type != kFileTypeNone))
+		if ((name != "") && (res.type != kFileTypeNone))
 			if (normalizeType(res))
-				hash = getHash(res.name, res.type);
+				hash = getHash(name, res.type);
 
 		// Handle "small" files
 		if (_hasSmall && (res.type == kFileTypeSMALL)) {
 			res.isSmall = true;
 
-			res.name = Common::FilePath::getStem(resource->name);
+			name     = Common::FilePath::getStem(resource->name);
 			res.type = TypeMan.getFileType(resource->name);
 		}
 
+		res.name = _strings.add(name);
+
 		// And add it to our list
 		addResource(res, hash, change);
 	}
@@ -467,6 +531,8 @@ bool ResourceManager::hasResourceDir(const Common::UString &dir) {
 void ResourceManager::indexResourceFile(const Common::UString &file, uint32 priority,
                                         Common::ChangeID *changeID) {
 
+	cancelPrefetch();
+
 	Common::UString path;
 	path = _baseDir.empty() ? file : (_baseDir + "/" + file);
 	path = Common::FilePath::normalize(path, false);
@@ -483,6 +549,8 @@ void ResourceManager::indexResourceFile(const Common::UString &file, uint32 prio
 
 void ResourceManager::indexResourceDir(const Common::UString &dir, const char *glob, int depth,
                                        uint32 priority, Common::ChangeID *changeID) {
+	cancelPrefetch();
+
 	if (_baseDir.empty())
 		throw Common::Exception("No base data directory set");
 
@@ -518,6 +586,8 @@ void ResourceManager::undo(Common::ChangeID &changeID) {
 	if (!change || (change->_change == _changes.end()))
 		return;
 
+	cancelPrefetch();
+
 	// Removing all changes in the opened archives list
 	for (OpenedArchiveChanges::iterator oaChange = change->_change->openedArchives.begin();
 	     oaChange != change->_change->openedArchives.end(); ++oaChange) {
@@ -578,51 +648,73 @@ void ResourceManager::undo(Common::ChangeID &changeID) {
 			resChange->resIt->selfArchive.first->erase(resChange->resIt->selfArchive.second);
 		}
 
-		// Remove the resource, and the name list too if it's empty
-		resChange->hashIt->second.erase(resChange->resIt);
+		ResourceEntry *entry = _resources.find(resChange->hash);
+		assert(entry && entry->resources);
 
-		if (resChange->hashIt->second.empty())
-			_resources.erase(resChange->hashIt);
+		// Remove the resource, and the whole entry too if it's empty
+		entry->resources->erase(resChange->resIt);
+
+		if (entry->resources->empty()) {
+			delete entry->resources;
+			_resources.erase(resChange->hash);
+		} else
+			updateBest(*entry);
 	}
 
 	// Now we can remove the change set from our list of change sets
 	_changes.erase(change->_change);
 
+	_revision++;
+
 	// And finally set the change ID to a defined empty state
 	changeID.clear();
 }
 
 void ResourceManager::addTypeAlias(FileType alias, FileType realType) {
 	_typeAliases[alias] = realType;
+
+	_revision++;
 }
 
 void ResourceManager::blacklist(const Common::UString &name, FileType type) {
-	ResourceMap::iterator resList = _resources.find(getHash(name, type));
-	if (resList == _resources.end())
+	ResourceEntry *entry = _resources.find(getHash(name, type));
+	if (!entry)
 		return;
 
-	for (ResourceList::iterator res = resList->second.begin(); res != resList->second.end(); ++res)
+	for (ResourceList::iterator res = entry->resources->begin(); res != entry->resources->end(); ++res)
 		res->priority = 0;
+
+	updateBest(*entry);
+
+	_revision++;
+}
+
+uint32 ResourceManager::getRevision() const {
+	return _revision;
 }
 
 void ResourceManager::declareResource(const Common::UString &name, FileType type) {
 	bool isSmall = false;
 
-	ResourceMap::iterator resList = _resources.find(getHash(name, type));
-	if (resList == _resources.end()) {
+	ResourceEntry *entry = _resources.find(getHash(name, type));
+	if (!entry) {
 		if (_hasSmall) {
 			Common::UString smallName = TypeMan.addFileType(TypeMan.setFileType(name, type), kFileTypeSMALL);
 
-			resList = _resources.find(getHash(smallName));
+			entry   = _resources.find(getHash(smallName));
 			isSmall = true;
 		}
 
-		if (resList == _resources.end())
+		if (!entry)
 			return;
 	}
 
-	for (ResourceList::iterator r = resList->second.begin(); r != resList->second.end(); ++r) {
-		r->name    = name;
+	cancelPrefetch();
+
+	const Common::StringPool::StringID nameID = _strings.add(name);
+
+	for (ResourceList::iterator r = entry->resources->begin(); r != entry->resources->end(); ++r) {
+		r->name    = nameID;
 		r->type    = type;
 		r->isSmall = isSmall;
 
@@ -682,7 +774,7 @@ Common::UString ResourceManager::findResourceFile(const Common::UString &name,
                                                   const std::vector<FileType> &types) const {
 	const Resource *res = getRes(name, types);
 	if (res && (res->source == kSourceFile))
-		return res->path;
+		return _strings.get(res->path);
 
 	return "";
 }
@@ -696,7 +788,7 @@ uint32 ResourceManager::getResourceSize(const Resource &res) const {
 	}
 
 	if (res.source == kSourceFile)
-		return Common::FilePath::getFileSize(res.path);
+		return Common::FilePath::getFileSize(_strings.get(res.path));
 
 	return 0xFFFFFFFF;
 }
@@ -747,11 +839,21 @@ Common::SeekableReadStream *ResourceManager::getResource(uint64 hash, FileType *
 }
 
 Common::SeekableReadStream *ResourceManager::getResource(const Resource &res, bool tryNoCopy) const {
+	if (!tryNoCopy) {
+		Common::SeekableReadStream *stream = takePrefetched(res);
+		if (stream)
+			return stream;
+	}
+
+	return readResource(res, tryNoCopy);
+}
+
+Common::SeekableReadStream *ResourceManager::readResource(const Resource &res, bool tryNoCopy) const {
 	Common::SeekableReadStream *stream = 0;
 
 	switch (res.source) {
 		case kSourceFile:
-			stream = new Common::ReadFile(res.path);
+			stream = new Common::ReadFile(_strings.get(res.path));
 			break;
 
 		case kSourceArchive:
@@ -760,7 +862,7 @@ Common::SeekableReadStream *ResourceManager::getResource(const Resource &res, bo
 
 		default:
 			throw Common::Exception("Invalid source for resource \"%s\": (%d)",
-			                        TypeMan.setFileType(res.name, res.type).c_str(), res.source);
+			                        TypeMan.setFileType(_strings.get(res.name), res.type).c_str(), res.source);
 	}
 
 	// Transparently decompress "small" files
@@ -784,16 +886,176 @@ Common::SeekableReadStream *ResourceManager::getResource(ResourceType resType,
 	return 0;
 }
 
+void ResourceManager::prefetch(const Common::UString &name, FileType type) {
+	const Resource *res = getRes(name, type);
+	if (res)
+		prefetch(*res);
+}
+
+void ResourceManager::prefetch(const Common::UString &name, ResourceType type) {
+	assert((type >= 0) && (type < kResourceMAX));
+
+	const Resource *res = getRes(name, _resourceTypeTypes[type]);
+	if (res)
+		prefetch(*res);
+}
+
+void ResourceManager::prefetch(const std::vector<Common::UString> &names, ResourceType type) {
+	for (std::vector<Common::UString>::const_iterator n = names.begin(); n != names.end(); ++n)
+		prefetch(*n, type);
+}
+
+void ResourceManager::prefetch(const Resource &res) {
+	Common::StackLock lock(_prefetchMutex);
+
+	PrefetchMap::iterator p = _prefetchMap.find(&res);
+	if (p != _prefetchMap.end()) {
+		// Already prefetching this resource. Just mark it as recently requested
+		_prefetchList.splice(_prefetchList.end(), _prefetchList, p->second);
+		return;
+	}
+
+	if (!_prefetchPool)
+		_prefetchPool.reset(new Common::ThreadPool(MIN(Common::ThreadPool::getDefaultThreadCount(), kPrefetchThreadCount),
+		                                           "ResManPrefetch"));
+
+	_prefetchList.push_back(PrefetchedResource(res));
+	_prefetchMap[&res] = --_prefetchList.end();
+
+	_prefetchPool->addJob(new PrefetchJob(*this, res));
+}
+
+void ResourceManager::runPrefetch(const Resource &res) {
+	{
+		Common::StackLock lock(_prefetchMutex);
+
+		// Was the resource already taken or dropped while it was waiting in the queue?
+		PrefetchMap::iterator p = _prefetchMap.find(&res);
+		if ((p == _prefetchMap.end()) || (p->second->state != kPrefetchQueued))
+			return;
+
+		p->second->state = kPrefetchReading;
+	}
+
+	Common::SeekableReadStream *stream = 0;
+	try {
+		Common::ScopedPtr<Common::SeekableReadStream> resStream(readResource(res, false));
+
+		// Make sure the whole resource is in memory, and we're not holding onto a file
+		if (dynamic_cast<Common::MemoryReadStream *>(resStream.get()))
+			stream = resStream.release();
+		else
+			stream = resStream->readStream(resStream->size());
+
+	} catch (...) {
+		Common::exceptionDispatcherWarning("Failed prefetching resource \"%s\"",
+		                                   TypeMan.setFileType(_strings.get(res.name), res.type).c_str());
+	}
+
+	Common::StackLock lock(_prefetchMutex);
+
+	PrefetchMap::iterator p = _prefetchMap.find(&res);
+	assert((p != _prefetchMap.end()) && (p->second->state == kPrefetchReading));
+
+	if (stream) {
+		p->second->state  = kPrefetchDone;
+		p->second->stream = stream;
+
+		_prefetchSize += stream->size();
+		trimPrefetched();
+
+	} else {
+		// Reading failed. Let getResource() try again and throw the error where it belongs
+		_prefetchList.erase(p->second);
+		_prefetchMap.erase(p);
+	}
+
+	_prefetchDone.broadcast();
+}
+
+Common::SeekableReadStream *ResourceManager::takePrefetched(const Resource &res) const {
+	Common::StackLock lock(_prefetchMutex);
+
+	PrefetchMap::iterator p = _prefetchMap.find(&res);
+	if (p == _prefetchMap.end())
+		return 0;
+
+	// A worker thread is reading this resource right now, so wait for it
+	while ((p != _prefetchMap.end()) && (p->second->state == kPrefetchReading)) {
+		_prefetchDone.wait();
+
+		p = _prefetchMap.find(&res);
+	}
+
+	if (p == _prefetchMap.end())
+		return 0;
+
+	// If the resource is still queued, removing it here makes the worker skip it
+
+	Common::SeekableReadStream *stream = p->second->stream;
+	if (stream)
+		_prefetchSize -= stream->size();
+
+	_prefetchList.erase(p->second);
+	_prefetchMap.erase(p);
+
+	return stream;
+}
+
+void ResourceManager::trimPrefetched() const {
+	// Drop the finished resources requested the longest time ago, until we're within the limit
+	PrefetchList::iterator p = _prefetchList.begin();
+	while ((_prefetchSize > _prefetchCacheSize) && (p != _prefetchList.end())) {
+		if (p->state != kPrefetchDone) {
+			++p;
+			continue;
+		}
+
+		_prefetchSize -= p->stream->size();
+		delete p->stream;
+
+		_prefetchMap.erase(p->resource);
+		p = _prefetchList.erase(p);
+	}
+}
+
+void ResourceManager::cancelPrefetch() {
+	if (!_prefetchPool)
+		return;
+
+	// Drop all jobs not yet started, and wait for the running ones
+	_prefetchPool->cancel();
+
+	Common::StackLock lock(_prefetchMutex);
+
+	for (PrefetchList::iterator p = _prefetchList.begin(); p != _prefetchList.end(); ++p)
+		delete p->stream;
+
+	_prefetchList.clear();
+	_prefetchMap.clear();
+
+	_prefetchSize = 0;
+}
+
+void ResourceManager::setPrefetchCacheSize(size_t size) {
+	Common::StackLock lock(_prefetchMutex);
+
+	_prefetchCacheSize = size;
+	trimPrefetched();
+}
+
 void ResourceManager::getAvailableResources(FileType type,
 		std::list<ResourceID> &list) const {
 
 	for (ResourceMap::const_iterator r = _resources.begin(); r != _resources.end(); ++r) {
-		if (!r->second.empty() && (r->second.front().type == type)) {
+		const ResourceList &resources = *r.value().resources;
+
+		if (!resources.empty() && (resources.front().type == type)) {
 			list.push_back(ResourceID());
 
-			list.back().name = r->second.front().name;
-			list.back().type = r->second.front().type;
-			list.back().hash = r->first;
+			list.back().name = _strings.get(resources.front().name);
+			list.back().type = resources.front().type;
+			list.back().hash = r.key();
 		}
 	}
 }
@@ -802,13 +1064,15 @@ void ResourceManager::getAvailableResources(const std::vector<FileType> &types,
 		std::list<ResourceID> &list) const {
 
 	for (ResourceMap::const_iterator r = _resources.begin(); r != _resources.end(); ++r) {
+		const ResourceList &resources = *r.value().resources;
+
 		for (std::vector<FileType>::const_iterator t = types.begin(); t != types.end(); ++t) {
-			if (!r->second.empty() && (r->second.front().type == *t)) {
+			if (!resources.empty() && (resources.front().type == *t)) {
 				list.push_back(ResourceID());
 
-				list.back().name = r->second.front().name;
-				list.back().type = r->second.front().type;
-				list.back().hash = r->first;
+				list.back().name = _strings.get(resources.front().name);
+				list.back().type = resources.front().type;
+				list.back().hash = r.key();
 			}
 		}
 
@@ -836,17 +1100,17 @@ ArchiveType ResourceManager::getArchiveType(const Common::UString &name) const {
 Common::UString ResourceManager::getArchiveName(const Resource &resource) const {
 	switch (resource.source) {
 		case kSourceFile:
-			return resource.path;
+			return _strings.get(resource.path);
 
 		case kSourceArchive:
-			return "/" + TypeMan.addFileType(resource.name, resource.type);
+			return "/" + TypeMan.addFileType(_strings.get(resource.name), resource.type);
 
 		default:
 			break;
 	}
 
 	throw Common::Exception("Invalid source for resource \"%s\": (%d)",
-	                        TypeMan.addFileType(resource.name, resource.type).c_str(),
+	                        TypeMan.addFileType(_strings.get(resource.name), resource.type).c_str(),
 	                        resource.source);
 }
 
@@ -887,17 +1151,21 @@ inline uint64 ResourceManager::getHash(const Common::UString &name) const {
 	return Common::hashString(name.toLower(), _hashAlgo);
 }
 
-void ResourceManager::checkHashCollision(const Resource &resource, ResourceMap::const_iterator resList) {
-	if (resource.name.empty() || resList->second.empty())
+void ResourceManager::checkHashCollision(const Resource &resource, const ResourceList &resList) {
+	if (_strings.isEmpty(resource.name) || resList.empty())
 		return;
 
-	Common::UString newName = TypeMan.setFileType(resource.name, resource.type).toLower();
+	Common::UString newName = TypeMan.setFileType(_strings.get(resource.name), resource.type).toLower();
+
+	for (ResourceList::const_iterator r = resList.begin(); r != resList.end(); ++r) {
+		if (_strings.isEmpty(r->name))
+			continue;
 
-	for (ResourceList::const_iterator r = resList->second.begin(); r != resList->second.end(); ++r) {
-		if (r->name.empty())
+		// Interned names that are identical can't collide
+		if ((r->name == resource.name) && (r->type == resource.type))
 			continue;
 
-		Common::UString oldName = TypeMan.setFileType(r->name, r->type).toLower();
+		Common::UString oldName = TypeMan.setFileType(_strings.get(r->name), r->type).toLower();
 		if (oldName != newName) {
 			warning("ResourceManager: Found hash collision: %s (\"%s\" and \"%s\")",
 					Common::formatHash(getHash(oldName)).c_str(), oldName.c_str(), newName.c_str());
@@ -907,7 +1175,7 @@ void ResourceManager::checkHashCollision(const Resource &resource, ResourceMap::
 }
 
 bool ResourceManager::checkResourceIsArchive(Resource &resource, Change *change) {
-	if ((resource.source == kSourceNone) || resource.name.empty())
+	if ((resource.source == kSourceNone) || _strings.isEmpty(resource.name))
 		return false;
 
 	ArchiveType type = getArchiveType(resource.type);
@@ -938,59 +1206,62 @@ bool ResourceManager::checkResourceIsArchive(Resource &resource, Change *change)
 }
 
 void ResourceManager::addResource(Resource &resource, uint64 hash, Change *change) {
-	ResourceMap::iterator resList = _resources.find(hash);
-	if (resList == _resources.end()) {
+	ResourceEntry &entry = _resources[hash];
+	if (!entry.resources) {
 		// We don't have a resource with this name yet, create a new resource list for it
-
-		std::pair<ResourceMap::iterator, bool> result;
-
-		result = _resources.insert(std::make_pair(hash, ResourceList()));
-
-		resList = result.first;
+		entry.resources = new ResourceList;
 	}
 
+	ResourceList &resList = *entry.resources;
+
 #ifdef CHECK_HASH_COLLISION
 	checkHashCollision(resource, resList);
 #endif
 
 	// Add the resource to the list
-	resList->second.push_back(resource);
-	Resource *res = &resList->second.back();
+	resList.push_back(resource);
+	Resource *res = &resList.back();
 
 	checkResourceIsArchive(*res, change);
 
 	// Remember the resource in the change set
 	if (change) {
 		change->_change->resources.push_back(ResourceChange());
-		change->_change->resources.back().hashIt = resList;
-		change->_change->resources.back().resIt  = --resList->second.end();
+		change->_change->resources.back().hash  = hash;
+		change->_change->resources.back().resIt = --resList.end();
 	}
 
-	// Resort the list by priority
-	resList->second.sort();
+	// Resort the list by priority, and remember which resource wins
+	resList.sort();
+	updateBest(entry);
+
+	_revision++;
 }
 
 void ResourceManager::addResource(const Common::UString &path, Change *change, uint32 priority) {
 	Resource res;
 	res.priority = priority;
 	res.source   = kSourceFile;
-	res.path     = path;
-	res.name     = Common::FilePath::getStem(path);
+	res.path     = _strings.add(path);
 	res.type     = TypeMan.getFileType(path);
 
+	Common::UString name = Common::FilePath::getStem(path);
+
 	// Handle "small" files
 	if (_hasSmall && (res.type == kFileTypeSMALL)) {
-		const Common::UString name = res.name;
+		const Common::UString smallName = name;
 
 		res.isSmall = true;
 
-		res.name = Common::FilePath::getStem(name);
-		res.type = TypeMan.getFileType(name);
+		name     = Common::FilePath::getStem(smallName);
+		res.type = TypeMan.getFileType(smallName);
 	}
 
-	uint64 hash = getHash(res.name, res.type);
+	uint64 hash = getHash(name, res.type);
 	if (normalizeType(res))
-		hash = getHash(res.name, res.type);
+		hash = getHash(name, res.type);
+
+	res.name = _strings.add(name);
 
 	addResource(res, hash, change);
 }
@@ -1001,11 +1272,18 @@ void ResourceManager::addResources(const Common::FileList &files, Change *change
 }
 
 const ResourceManager::Resource *ResourceManager::getRes(uint64 hash) const {
-	ResourceMap::const_iterator r = _resources.find(hash);
-	if ((r == _resources.end()) || r->second.empty() || (r->second.back().priority == 0))
+	const ResourceEntry *entry = _resources.find(hash);
+	if (!entry)
 		return 0;
 
-	return &r->second.back();
+	return entry->best;
+}
+
+void ResourceManager::updateBest(ResourceEntry &entry) {
+	entry.best = 0;
+
+	if (!entry.resources->empty() && (entry.resources->back().priority != 0))
+		entry.best = &entry.resources->back();
 }
 
 const ResourceManager::Resource *ResourceManager::getRes(const Common::UString &name,
@@ -1045,13 +1323,16 @@ void ResourceManager::dumpResourcesList(const Common::UString &fileName) const {
 	file.writeString("                Name                 |        Hash        |     Size    \n");
 	file.writeString("-------------------------------------|--------------------|-------------\n");
 
-	for (ResourceMap::const_iterator r = _resources.begin(); r != _resources.end(); ++r) {
-		if (r->second.empty())
-			continue;
+	// Sort the list by hash, to get a stable order
+	std::map<uint64, const Resource *> resources;
+	for (ResourceMap::const_iterator r = _resources.begin(); r != _resources.end(); ++r)
+		if (!r.value().resources->empty())
+			resources.insert(std::make_pair(r.key(), &r.value().resources->back()));
 
-		const Resource &res = r->second.back();
+	for (std::map<uint64, const Resource *>::const_iterator r = resources.begin(); r != resources.end(); ++r) {
+		const Resource &res = *r->second;
 
-		const Common::UString &name = res.name;
+		const Common::UString  name = _strings.get(res.name);
 		const Common::UString   ext = TypeMan.setFileType("", res.type);
 		const uint64           hash = r->first;
 		const uint32           size = getResourceSize(res);
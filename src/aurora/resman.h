@@ -35,12 +35,17 @@
 #include "src/common/singleton.h"
 #include "src/common/filelist.h"
 #include "src/common/hash.h"
+#include "src/common/scopedptr.h"
+#include "src/common/hashindex.h"
+#include "src/common/stringpool.h"
 #include "src/common/changeid.h"
+#include "src/common/mutex.h"
 
 #include "src/aurora/types.h"
 
 namespace Common {
 	class SeekableReadStream;
+	class ThreadPool;
 }
 
 namespace Aurora {
@@ -51,6 +56,11 @@ class BIFFile;
 
 /** A resource manager holding information about and handling all request for all
  *  resources usable by the game.
+ *
+ *  The const methods finding and reading resources (hasResource(), getResource(),
+ *  ...) can be called from several threads at once. Changing the set of known
+ *  resources (indexing, undoing, blacklisting, ...) must not happen concurrently
+ *  with anything else.
  */
 class ResourceManager : public Common::Singleton<ResourceManager> {
 public:
@@ -76,6 +86,15 @@ public:
 	/** With which hash algorithm are/should the names be hashed? */
 	void setHashAlgo(Common::HashAlgo algo);
 
+	/** Should archive files be mapped into memory instead of being read?
+	 *
+	 *  Resources stored uncompressed within a mapped archive are returned as
+	 *  streams pointing directly into the mapping, without being copied.
+	 *  This only affects archives indexed afterwards, and is silently ignored
+	 *  on platforms that can't map files.
+	 */
+	void setMapArchives(bool mapArchives);
+
 	/** Set the array used to map cursor ID to cursor names. */
 	void setCursorRemap(const std::vector<Common::UString> &remap);
 
@@ -201,6 +220,14 @@ public:
 	 *  @param name The name (with extension) of the resource.
 	 */
 	void declareResource(const Common::UString &name);
+
+	/** Return the current revision of the resource index.
+	 *
+	 *  The revision changes whenever resources are added, removed or otherwise
+	 *  altered, so that anything caching resource contents can tell when it
+	 *  needs to throw away its cache.
+	 */
+	uint32 getRevision() const;
 	// '---
 
 	// .--- Resources
@@ -335,6 +362,50 @@ public:
 	void getAvailableResources(ResourceType type, std::list<ResourceID> &list) const;
 	// '---
 
+	// .--- Prefetching resources
+	/** Start reading a resource in the background, ahead of time.
+	 *
+	 *  The resource is read, and decompressed or decrypted if necessary, by
+	 *  a pool of worker threads. The result is kept in a cache of limited
+	 *  size, until the next getResource() call for that resource takes it
+	 *  out again. When the cache is full, the resources that were requested
+	 *  the longest time ago are dropped first.
+	 *
+	 *  Changing the set of known resources (indexing, undoing, declaring)
+	 *  cancels all pending prefetches and empties the cache.
+	 *
+	 *  Resources that don't exist are silently ignored.
+	 *
+	 *  @param name The name (ResRef) of the resource.
+	 *  @param type The resource's type.
+	 */
+	void prefetch(const Common::UString &name, FileType type);
+
+	/** Start reading a resource of a specific type in the background.
+	 *
+	 *  @see prefetch(const Common::UString &, FileType)
+	 *
+	 *  @param name The name (ResRef) of the resource.
+	 *  @param type The type of the resource.
+	 */
+	void prefetch(const Common::UString &name, ResourceType type);
+
+	/** Start reading several resources of a specific type in the background.
+	 *
+	 *  @see prefetch(const Common::UString &, FileType)
+	 *
+	 *  @param names The names (ResRefs) of the resources.
+	 *  @param type The type of the resources.
+	 */
+	void prefetch(const std::vector<Common::UString> &names, ResourceType type);
+
+	/** Cancel all pending prefetches and drop all prefetched resources. */
+	void cancelPrefetch();
+
+	/** Set the maximum number of bytes all unused prefetched resources may take up. */
+	void setPrefetchCacheSize(size_t size);
+	// '---
+
 	/** Dump a list of all resources into a file. */
 	void dumpResourcesList(const Common::UString &fileName) const;
 
@@ -394,8 +465,8 @@ private:
 
 	/** A resource. */
 	struct Resource {
-		Common::UString name; ///< The resource's name.
-		FileType        type; ///< The resource's type.
+		Common::StringPool::StringID name; ///< The resource's name, in the string pool.
+		FileType                     type; ///< The resource's type.
 
 		/** Is this a "small" (compressed Nintendo DS) file? */
 		bool isSmall;
@@ -410,7 +481,7 @@ private:
 		Source source;
 
 		// For kSourceFile
-		Common::UString path; ///< The file's path.
+		Common::StringPool::StringID path; ///< The file's path, in the string pool.
 
 		// For kSourceArchive
 		OpenedArchive *archive;      ///< Pointer to the opened archive.
@@ -423,8 +494,17 @@ private:
 
 	/** List of resources, sorted by priority. */
 	typedef std::list<Resource> ResourceList;
-	/** Map over resources, indexed by their hashed name. */
-	typedef std::map<uint64, ResourceList> ResourceMap;
+
+	/** All resources sharing the same hashed name. */
+	struct ResourceEntry {
+		/** The resources, sorted by priority. Owned by the entry. */
+		ResourceList *resources;
+		/** The resource with the highest priority, or 0 if that one is blacklisted. */
+		const Resource *best;
+	};
+
+	/** Index over resources, by their hashed name. */
+	typedef Common::HashIndex<ResourceEntry> ResourceMap;
 	// '---
 
 	// .--- Changes
@@ -434,7 +514,7 @@ private:
 	typedef OpenedArchives::iterator OpenedArchiveChange;
 	/** A change produced by indexing archive resources. */
 	struct ResourceChange {
-		ResourceMap::iterator  hashIt;
+		uint64                 hash;
 		ResourceList::iterator resIt;
 	};
 
@@ -473,6 +553,9 @@ private:
 	/** With which hash algorithm are/should the names be hashed? */
 	Common::HashAlgo _hashAlgo;
 
+	/** Map archive files into memory? */
+	bool _mapArchives;
+
 	/** Cursor ID -> cursor name. */
 	std::vector<Common::UString> _cursorRemap;
 
@@ -487,8 +570,46 @@ private:
 	/** The current type aliases, changing one type to another. */
 	std::map<FileType, FileType> _typeAliases;
 
-	ResourceMap   _resources; ///< All currently known resources.
-	ChangeSetList _changes;   ///< Changes produced by indexing the currently known resources.
+	ResourceMap        _resources; ///< All currently known resources.
+	Common::StringPool _strings;   ///< Names and paths of all currently known resources.
+	ChangeSetList      _changes;   ///< Changes produced by indexing the currently known resources.
+
+	uint32 _revision; ///< Changes whenever the known resources change.
+
+	// .--- Prefetching resources
+	/** The state of a prefetched resource. */
+	enum PrefetchState {
+		kPrefetchQueued , ///< Waiting for a worker thread.
+		kPrefetchReading, ///< Currently being read by a worker thread.
+		kPrefetchDone     ///< Read and waiting to be used.
+	};
+
+	/** A resource read ahead of time. */
+	struct PrefetchedResource {
+		const Resource *resource;
+		PrefetchState   state;
+
+		Common::SeekableReadStream *stream; ///< The read resource, once it's done.
+
+		PrefetchedResource(const Resource &res);
+	};
+
+	/** Prefetched resources, in the order they were last requested. */
+	typedef std::list<PrefetchedResource> PrefetchList;
+	/** Prefetched resources, by the resource they are. */
+	typedef std::map<const Resource *, PrefetchList::iterator> PrefetchMap;
+
+	mutable PrefetchList _prefetchList;
+	mutable PrefetchMap  _prefetchMap;
+
+	mutable size_t _prefetchSize; ///< Combined size of all finished prefetched resources.
+	size_t _prefetchCacheSize;    ///< Maximum of _prefetchSize.
+
+	mutable Common::Mutex     _prefetchMutex;
+	mutable Common::Condition _prefetchDone; ///< Signals that a prefetched resource was read.
+
+	Common::ScopedPtr<Common::ThreadPool> _prefetchPool;
+	// '---
 
 	FileTypeSet  _archiveTypeTypes [kArchiveMAX];  ///< All valid archive types file types.
 	FileTypeList _resourceTypeTypes[kResourceMAX]; ///< All valid resource type file types.
@@ -528,6 +649,7 @@ private:
 	const Resource *getRes(const Common::UString &name, FileType type) const;
 
 	Common::SeekableReadStream *getResource(const Resource &res, bool tryNoCopy = false) const;
+	Common::SeekableReadStream *readResource(const Resource &res, bool tryNoCopy) const;
 
 	Common::SeekableReadStream *getArchiveResource(const Resource &res, bool tryNoCopy = false) const;
 
@@ -544,11 +666,24 @@ private:
 	inline uint64 getHash(const Common::UString &name, FileType type) const;
 	inline uint64 getHash(const Common::UString &name) const;
 
-	void checkHashCollision(const Resource &resource, ResourceMap::const_iterator resList);
+	void checkHashCollision(const Resource &resource, const ResourceList &resList);
+
+	/** Update the cached highest-priority resource of an index entry. */
+	static void updateBest(ResourceEntry &entry);
 
 	Change *newChangeSet(Common::ChangeID &changeID);
 	// '---
 
+	// .--- Prefetching resources
+	class PrefetchJob;
+
+	void prefetch(const Resource &res);
+	void runPrefetch(const Resource &res);
+
+	Common::SeekableReadStream *takePrefetched(const Resource &res) const;
+	void trimPrefetched() const;
+	// '---
+
 };
 
 } // End of namespace Aurora
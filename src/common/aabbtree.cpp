@@ -0,0 +1,489 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A dynamic bounding volume hierarchy of axis-aligned boxes.
+ */
+
+/* The tree structure and the balancing rotations follow the dynamic
+ * AABB tree used by Erin Catto's Box2D. */
+
+#include <cassert>
+
+#include "src/common/aabbtree.h"
+#include "src/common/boundingbox.h"
+#include "src/common/util.h"
+
+namespace Common {
+
+const AABBTree::ProxyID AABBTree::kProxyNone;
+
+static const size_t kNodeNone = SIZE_MAX;
+
+
+bool AABBTree::Node::isLeaf() const {
+	return child1 == kNodeNone;
+}
+
+
+AABBTree::AABBTree(float margin) : _margin(margin), _root(kNodeNone), _freeList(kNodeNone), _leafCount(0) {
+}
+
+AABBTree::~AABBTree() {
+}
+
+void AABBTree::clear() {
+	_nodes.clear();
+
+	_root      = kNodeNone;
+	_freeList  = kNodeNone;
+	_leafCount = 0;
+}
+
+size_t AABBTree::size() const {
+	return _leafCount;
+}
+
+bool AABBTree::empty() const {
+	return _leafCount == 0;
+}
+
+size_t AABBTree::getHeight() const {
+	if (_root == kNodeNone)
+		return 0;
+
+	return _nodes[_root].height + 1;
+}
+
+AABBTree::ProxyID AABBTree::insert(const BoundingBox &box, void *data) {
+	const size_t leaf = allocateNode();
+
+	setBox(leaf, box);
+	_nodes[leaf].data   = data;
+	_nodes[leaf].height = 0;
+
+	insertLeaf(leaf);
+
+	_leafCount++;
+	return leaf;
+}
+
+void AABBTree::remove(ProxyID proxy) {
+	assert((proxy < _nodes.size()) && _nodes[proxy].isLeaf() && (_nodes[proxy].height == 0));
+
+	removeLeaf(proxy);
+	freeNode(proxy);
+
+	_leafCount--;
+}
+
+bool AABBTree::move(ProxyID proxy, const BoundingBox &box) {
+	assert((proxy < _nodes.size()) && _nodes[proxy].isLeaf() && (_nodes[proxy].height == 0));
+
+	float min[3], max[3];
+	box.getMin(min[0], min[1], min[2]);
+	box.getMax(max[0], max[1], max[2]);
+
+	// Still within the enlarged box => nothing to do
+	if (contains(_nodes[proxy], min, max))
+		return false;
+
+	removeLeaf(proxy);
+	setBox(proxy, box);
+	insertLeaf(proxy);
+
+	return true;
+}
+
+void *AABBTree::getData(ProxyID proxy) const {
+	assert(proxy < _nodes.size());
+
+	return _nodes[proxy].data;
+}
+
+void *AABBTree::findClosest(float x1, float y1, float z1, float x2, float y2, float z2,
+                            RayCallback &callback, float &distance) const {
+
+	if (_root == kNodeNone)
+		return 0;
+
+	const float from[3] = { x1, y1, z1 };
+	const float dir [3] = { x2 - x1, y2 - y1, z2 - z1 };
+
+	void *closest = 0;
+	float closestDistance = 2.0f;
+
+	std::vector<size_t> stack;
+	stack.reserve(2 * getHeight());
+
+	stack.push_back(_root);
+	while (!stack.empty()) {
+		const Node &node = _nodes[stack.back()];
+		stack.pop_back();
+
+		// Skip subtrees that are either missed entirely or only hit behind the closest hit so far
+		float nodeDistance;
+		if (!intersect(node, from, dir, nodeDistance) || (nodeDistance >= closestDistance))
+			continue;
+
+		if (!node.isLeaf()) {
+			stack.push_back(node.child1);
+			stack.push_back(node.child2);
+			continue;
+		}
+
+		float hitDistance;
+		if (callback.intersect(node.data, hitDistance) && (hitDistance < closestDistance)) {
+			closest         = node.data;
+			closestDistance = hitDistance;
+		}
+	}
+
+	if (closest)
+		distance = closestDistance;
+
+	return closest;
+}
+
+size_t AABBTree::allocateNode() {
+	size_t node = _freeList;
+
+	if (node != kNodeNone) {
+		_freeList = _nodes[node].parent;
+	} else {
+		node = _nodes.size();
+		_nodes.push_back(Node());
+	}
+
+	Node &n = _nodes[node];
+
+	n.parent = kNodeNone;
+	n.child1 = kNodeNone;
+	n.child2 = kNodeNone;
+	n.height = 0;
+	n.data   = 0;
+
+	return node;
+}
+
+void AABBTree::freeNode(size_t node) {
+	_nodes[node].parent = _freeList;
+	_nodes[node].height = -1;
+
+	_freeList = node;
+}
+
+void AABBTree::insertLeaf(size_t leaf) {
+	if (_root == kNodeNone) {
+		_root = leaf;
+		_nodes[_root].parent = kNodeNone;
+		return;
+	}
+
+	/* Find the best sibling for the new leaf: walk down the tree, always
+	 * choosing the child for which the total increase in surface area is
+	 * smallest, and stop when making the leaf a sibling of the current
+	 * node is cheaper than going further down. */
+
+	const Node &leafNode = _nodes[leaf];
+
+	size_t index = _root;
+	while (!_nodes[index].isLeaf()) {
+		const Node &node   = _nodes[index];
+		const Node &child1 = _nodes[node.child1];
+		const Node &child2 = _nodes[node.child2];
+
+		const float area         = getArea(node.min, node.max);
+		const float combinedArea = getCombinedArea(node, leafNode);
+
+		// Cost of creating a new parent for this node and the new leaf
+		const float cost = 2.0f * combinedArea;
+		// Minimum cost of pushing the leaf further down the tree
+		const float inheritanceCost = 2.0f * (combinedArea - area);
+
+		float cost1 = getCombinedArea(child1, leafNode) + inheritanceCost;
+		if (!child1.isLeaf())
+			cost1 -= getArea(child1.min, child1.max);
+
+		float cost2 = getCombinedArea(child2, leafNode) + inheritanceCost;
+		if (!child2.isLeaf())
+			cost2 -= getArea(child2.min, child2.max);
+
+		if ((cost < cost1) && (cost < cost2))
+			break;
+
+		index = (cost1 < cost2) ? node.child1 : node.child2;
+	}
+
+	const size_t sibling = index;
+
+	// Create a new parent for the sibling and the new leaf
+
+	const size_t oldParent = _nodes[sibling].parent;
+	const size_t newParent = allocateNode();
+
+	_nodes[newParent].parent = oldParent;
+	_nodes[newParent].height = _nodes[sibling].height + 1;
+	combine(newParent, sibling, leaf);
+
+	if (oldParent != kNodeNone) {
+		if (_nodes[oldParent].child1 == sibling)
+			_nodes[oldParent].child1 = newParent;
+		else
+			_nodes[oldParent].child2 = newParent;
+	} else
+		_root = newParent;
+
+	_nodes[newParent].child1 = sibling;
+	_nodes[newParent].child2 = leaf;
+	_nodes[sibling].parent   = newParent;
+	_nodes[leaf].parent      = newParent;
+
+	refit(_nodes[leaf].parent);
+}
+
+void AABBTree::removeLeaf(size_t leaf) {
+	if (leaf == _root) {
+		_root = kNodeNone;
+		return;
+	}
+
+	const size_t parent      = _nodes[leaf].parent;
+	const size_t grandParent = _nodes[parent].parent;
+	const size_t sibling     = (_nodes[parent].child1 == leaf) ? _nodes[parent].child2 : _nodes[parent].child1;
+
+	// Replace the parent with the sibling
+
+	if (grandParent != kNodeNone) {
+		if (_nodes[grandParent].child1 == parent)
+			_nodes[grandParent].child1 = sibling;
+		else
+			_nodes[grandParent].child2 = sibling;
+
+		_nodes[sibling].parent = grandParent;
+		freeNode(parent);
+
+		refit(grandParent);
+	} else {
+		_root = sibling;
+		_nodes[sibling].parent = kNodeNone;
+
+		freeNode(parent);
+	}
+}
+
+void AABBTree::refit(size_t node) {
+	while (node != kNodeNone) {
+		node = balance(node);
+
+		Node &n = _nodes[node];
+
+		n.height = 1 + MAX(_nodes[n.child1].height, _nodes[n.child2].height);
+		combine(node, n.child1, n.child2);
+
+		node = n.parent;
+	}
+}
+
+size_t AABBTree::balance(size_t iA) {
+	Node &a = _nodes[iA];
+	if (a.isLeaf() || (a.height < 2))
+		return iA;
+
+	const size_t iB = a.child1;
+	const size_t iC = a.child2;
+
+	Node &b = _nodes[iB];
+	Node &c = _nodes[iC];
+
+	const int balance = c.height - b.height;
+
+	if (balance > 1) {
+		// Rotate C up
+
+		const size_t iF = c.child1;
+		const size_t iG = c.child2;
+
+		Node &f = _nodes[iF];
+		Node &g = _nodes[iG];
+
+		c.child1 = iA;
+		c.parent = a.parent;
+		a.parent = iC;
+
+		if (c.parent != kNodeNone) {
+			if (_nodes[c.parent].child1 == iA)
+				_nodes[c.parent].child1 = iC;
+			else
+				_nodes[c.parent].child2 = iC;
+		} else
+			_root = iC;
+
+		if (f.height > g.height) {
+			c.child2 = iF;
+			a.child2 = iG;
+			g.parent = iA;
+
+			combine(iA, iB, iG);
+			combine(iC, iA, iF);
+
+			a.height = 1 + MAX(b.height, g.height);
+			c.height = 1 + MAX(a.height, f.height);
+		} else {
+			c.child2 = iG;
+			a.child2 = iF;
+			f.parent = iA;
+
+			combine(iA, iB, iF);
+			combine(iC, iA, iG);
+
+			a.height = 1 + MAX(b.height, f.height);
+			c.height = 1 + MAX(a.height, g.height);
+		}
+
+		return iC;
+	}
+
+	if (balance < -1) {
+		// Rotate B up
+
+		const size_t iD = b.child1;
+		const size_t iE = b.child2;
+
+		Node &d = _nodes[iD];
+		Node &e = _nodes[iE];
+
+		b.child1 = iA;
+		b.parent = a.parent;
+		a.parent = iB;
+
+		if (b.parent != kNodeNone) {
+			if (_nodes[b.parent].child1 == iA)
+				_nodes[b.parent].child1 = iB;
+			else
+				_nodes[b.parent].child2 = iB;
+		} else
+			_root = iB;
+
+		if (d.height > e.height) {
+			b.child2 = iD;
+			a.child1 = iE;
+			e.parent = iA;
+
+			combine(iA, iC, iE);
+			combine(iB, iA, iD);
+
+			a.height = 1 + MAX(c.height, e.height);
+			b.height = 1 + MAX(a.height, d.height);
+		} else {
+			b.child2 = iE;
+			a.child1 = iD;
+			d.parent = iA;
+
+			combine(iA, iC, iD);
+			combine(iB, iA, iE);
+
+			a.height = 1 + MAX(c.height, d.height);
+			b.height = 1 + MAX(a.height, e.height);
+		}
+
+		return iB;
+	}
+
+	return iA;
+}
+
+void AABBTree::setBox(size_t node, const BoundingBox &box) {
+	Node &n = _nodes[node];
+
+	box.getMin(n.min[0], n.min[1], n.min[2]);
+	box.getMax(n.max[0], n.max[1], n.max[2]);
+
+	for (int i = 0; i < 3; i++) {
+		n.min[i] -= _margin;
+		n.max[i] += _margin;
+	}
+}
+
+void AABBTree::combine(size_t node, size_t child1, size_t child2) {
+	Node &n = _nodes[node];
+	const Node &c1 = _nodes[child1];
+	const Node &c2 = _nodes[child2];
+
+	for (int i = 0; i < 3; i++) {
+		n.min[i] = MIN(c1.min[i], c2.min[i]);
+		n.max[i] = MAX(c1.max[i], c2.max[i]);
+	}
+}
+
+float AABBTree::getArea(const float *min, const float *max) {
+	const float x = max[0] - min[0];
+	const float y = max[1] - min[1];
+	const float z = max[2] - min[2];
+
+	return 2.0f * (x * y + y * z + z * x);
+}
+
+float AABBTree::getCombinedArea(const Node &node1, const Node &node2) {
+	float min[3], max[3];
+	for (int i = 0; i < 3; i++) {
+		min[i] = MIN(node1.min[i], node2.min[i]);
+		max[i] = MAX(node1.max[i], node2.max[i]);
+	}
+
+	return getArea(min, max);
+}
+
+bool AABBTree::contains(const Node &node, const float *min, const float *max) {
+	for (int i = 0; i < 3; i++)
+		if ((min[i] < node.min[i]) || (max[i] > node.max[i]))
+			return false;
+
+	return true;
+}
+
+bool AABBTree::intersect(const Node &node, const float *from, const float *dir, float &distance) {
+	float tMin = 0.0f, tMax = 1.0f;
+
+	for (int i = 0; i < 3; i++) {
+		if (dir[i] == 0.0f) {
+			if ((from[i] < node.min[i]) || (from[i] > node.max[i]))
+				return false;
+
+			continue;
+		}
+
+		float t1 = (node.min[i] - from[i]) / dir[i];
+		float t2 = (node.max[i] - from[i]) / dir[i];
+		if (t1 > t2)
+			SWAP(t1, t2);
+
+		tMin = MAX(tMin, t1);
+		tMax = MIN(tMax, t2);
+
+		if (tMin > tMax)
+			return false;
+	}
+
+	distance = tMin;
+	return true;
+}
+
+} // End of namespace Common
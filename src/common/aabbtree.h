@@ -0,0 +1,158 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A dynamic bounding volume hierarchy of axis-aligned boxes.
+ */
+
+#ifndef COMMON_AABBTREE_H
+#define COMMON_AABBTREE_H
+
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/types.h"
+
+namespace Common {
+
+class BoundingBox;
+
+/** A dynamic bounding volume hierarchy of axis-aligned boxes.
+ *
+ *  Each object in the tree is a leaf with a box that's slightly larger
+ *  than the object's own bounding box. Moving an object only changes the
+ *  tree when the object's bounding box leaves that enlarged box. The tree
+ *  is kept balanced by rotating nodes while inserting and removing
+ *  leaves, so its height stays logarithmic in the number of objects.
+ *
+ *  The tree itself is not thread-safe.
+ */
+class AABBTree : boost::noncopyable {
+public:
+	/** A handle to an object in the tree. */
+	typedef size_t ProxyID;
+
+	static const ProxyID kProxyNone = SIZE_MAX;
+
+	/** Decides whether, and where, a line segment hits an object in the tree. */
+	class RayCallback {
+	public:
+		virtual ~RayCallback() { }
+
+		/** Does the line segment hit this object?
+		 *
+		 *  @param data The object's user data.
+		 *  @param distance If hit, set to the position along the line segment
+		 *                  where it hits the object, from 0.0f to 1.0f.
+		 */
+		virtual bool intersect(void *data, float &distance) = 0;
+	};
+
+	/** Create a tree, enlarging the boxes of objects by margin on all sides. */
+	AABBTree(float margin = 0.1f);
+	~AABBTree();
+
+	/** Remove all objects. */
+	void clear();
+
+	/** Return the number of objects in the tree. */
+	size_t size() const;
+	bool empty() const;
+
+	/** Return the height of the tree. An empty tree has a height of 0. */
+	size_t getHeight() const;
+
+	/** Add an object with this bounding box to the tree. The box must not be empty. */
+	ProxyID insert(const BoundingBox &box, void *data);
+	/** Remove an object from the tree. */
+	void remove(ProxyID proxy);
+
+	/** Update the bounding box of an object. The box must not be empty.
+	 *
+	 *  @return true if the tree had to be changed.
+	 */
+	bool move(ProxyID proxy, const BoundingBox &box);
+
+	/** Return the user data of an object. */
+	void *getData(ProxyID proxy) const;
+
+	/** Find the object closest to x1.y1.z1 hit by the line segment from x1.y1.z1 to x2.y2.z2.
+	 *
+	 *  Only objects whose enlarged boxes are hit by the line segment are
+	 *  passed to the callback, in no particular order.
+	 *
+	 *  @param callback Decides whether and where the line segment hits an object.
+	 *  @param distance If an object was hit, set to the distance reported
+	 *                  by the callback for that object.
+	 *  @return The user data of the closest hit object, or 0 if none was hit.
+	 */
+	void *findClosest(float x1, float y1, float z1, float x2, float y2, float z2,
+	                  RayCallback &callback, float &distance) const;
+
+private:
+	struct Node {
+		float min[3];
+		float max[3];
+
+		size_t parent; ///< The parent node, or the next free node if this node is free.
+		size_t child1;
+		size_t child2;
+
+		/** The height of the node's subtree: 0 for a leaf, -1 for a free node. */
+		int height;
+
+		void *data;
+
+		bool isLeaf() const;
+	};
+
+	float _margin;
+
+	std::vector<Node> _nodes;
+
+	size_t _root;
+	size_t _freeList;
+	size_t _leafCount;
+
+	size_t allocateNode();
+	void freeNode(size_t node);
+
+	void insertLeaf(size_t leaf);
+	void removeLeaf(size_t leaf);
+
+	/** Walk up the tree from this node, rebalancing and refitting the boxes of all nodes. */
+	void refit(size_t node);
+	/** Rotate the subtree at this node, if it's unbalanced. Returns the new subtree root. */
+	size_t balance(size_t node);
+
+	void setBox(size_t node, const BoundingBox &box);
+	void combine(size_t node, size_t child1, size_t child2);
+
+	static float getArea(const float *min, const float *max);
+	static float getCombinedArea(const Node &node1, const Node &node2);
+	static bool contains(const Node &node, const float *min, const float *max);
+
+	static bool intersect(const Node &node, const float *from, const float *dir, float &distance);
+};
+
+} // End of namespace Common
+
+#endif // COMMON_AABBTREE_H
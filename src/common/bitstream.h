@@ -30,6 +30,7 @@
 #include <boost/noncopyable.hpp>
 
 #include "src/common/types.h"
+#include "src/common/endianness.h"
 #include "src/common/disposableptr.h"
 #include "src/common/error.h"
 #include "src/common/readstream.h"
@@ -63,6 +64,20 @@ public:
 	/** Read a multi-bit value from the bit stream. */
 	virtual uint32 getBits(size_t n) = 0;
 
+	/** Return the next n bits, without moving the stream position.
+	 *
+	 *  Past the end of the stream, the missing bits are filled in with 0.
+	 */
+	virtual uint32 peekBits(size_t n) = 0;
+
+	/** Skip the specified amount of bits. Same as skip(), for symmetry with peekBits(). */
+	void skipBits(size_t n) {
+		skip(n);
+	}
+
+	/** Are the bits read in the order of MSB to LSB of the values? */
+	virtual bool isMSBFirst() const = 0;
+
 	/** Add a bit to the n-bit value x, making it an (n+1)-bit value. */
 	virtual void addBit(uint32 &x, size_t n) = 0;
 
@@ -80,70 +95,159 @@ protected:
  * For example, a bit stream with the layout parameters 32, true, false
  * for valueBits, isLE and isMSB2LSB, reads 32bit little-endian values
  * from the data stream and hands out the bits in the order of LSB to MSB.
+ *
+ * The data is read from the stream in blocks of kBufferSize bytes, and the
+ * bits are handed out from a 64-bit cache that's refilled from that block.
+ * So reading multiple bits at once is only a few shifts and masks, without
+ * a call into the data stream for every value.
  */
 template<int valueBits, bool isLE, bool isMSB2LSB>
 class BitStreamImpl : boost::noncopyable, public BitStream {
 private:
+	/** Size of the block buffer in bytes. Must be a multiple of 8. */
+	static const size_t kBufferSize = 256;
+
+	/** The cache is refilled in chunks of this many bits.
+	 *
+	 *  A 64-bit value is split into two 32-bit halves, so that a whole chunk
+	 *  always fits into the cache after a read of up to 32 bits.
+	 */
+	static const size_t kChunkBits = (valueBits > 32) ? 32 : valueBits;
+
 	DisposablePtr<SeekableReadStream> _stream; ///< The input stream.
 
-	uint64 _value;   ///< Current value.
-	uint8  _inValue; ///< Position within the current value.
-
-	/** Read a data value. */
-	inline uint64 readData() {
-		if (isLE) {
-			if (valueBits ==  8)
-				return _stream->readByte();
-			if (valueBits == 16)
-				return _stream->readUint16LE();
-			if (valueBits == 32)
-				return _stream->readUint32LE();
-			if (valueBits == 64)
-				return _stream->readUint64LE();
-		} else {
-			if (valueBits ==  8)
-				return _stream->readByte();
-			if (valueBits == 16)
-				return _stream->readUint16BE();
-			if (valueBits == 32)
-				return _stream->readUint32BE();
-			if (valueBits == 64)
-				return _stream->readUint64BE();
+	size_t _size; ///< The size of the stream in bits, rounded down to whole values.
+
+	byte   _buffer[kBufferSize]; ///< The current block of data from the stream.
+	size_t _bufferPos;           ///< Position of the next unread chunk in the buffer.
+	size_t _bufferSize;          ///< Number of valid bytes in the buffer.
+
+	/** The cached bits.
+	 *
+	 *  When reading MSB to LSB, the next bit is the MSB of the cache.
+	 *  Otherwise, the next bit is the LSB of the cache. Unused bits are 0.
+	 */
+	uint64 _cache;
+	size_t _cacheBits; ///< Number of bits in the cache.
+
+	size_t _readBits; ///< Position in bits of the first bit not yet moved into the cache.
+
+	/** Read the next block of values from the stream into the buffer. */
+	bool fillBuffer() {
+		const size_t valueBytes = valueBits / 8;
+
+		// Only read whole values
+		const size_t remaining = (_size > _readBits) ? (((_size - _readBits) / valueBits) * valueBytes) : 0;
+
+		size_t toRead = remaining;
+		if (toRead > kBufferSize)
+			toRead = kBufferSize;
+
+		_bufferPos  = 0;
+		_bufferSize = 0;
+
+		if (toRead == 0)
+			return false;
+
+		if (_stream->read(_buffer, toRead) != toRead)
+			throw Exception(kReadError);
+
+		_bufferSize = toRead;
+		return true;
+	}
+
+	/** Read the next chunk of data out of the buffer. */
+	inline uint32 readChunk() {
+		const byte *data = _buffer + _bufferPos;
+
+		if (valueBits == 64) {
+			/* The first half of the value holds the bits handed out first.
+			 * That's the upper half when reading a little-endian value MSB
+			 * to LSB, or a big-endian value LSB to MSB. */
+			const size_t firstHalf = (isLE == isMSB2LSB) ? 4 : 0;
+
+			data = _buffer + (_bufferPos & ~((size_t) 7)) + (((_bufferPos & 4) == 0) ? firstHalf : (4 - firstHalf));
 		}
 
-		assert(false);
-		return 0;
+		_bufferPos += kChunkBits / 8;
+
+		if (kChunkBits == 8)
+			return *data;
+
+		if (kChunkBits == 16)
+			return isLE ? READ_LE_UINT16(data) : READ_BE_UINT16(data);
+
+		return isLE ? READ_LE_UINT32(data) : READ_BE_UINT32(data);
 	}
 
-	/** Read the next data value. */
-	inline void readValue() {
-		if ((size() - pos()) < valueBits)
-			throw Exception("BitStream::readValue(): End of bit stream reached");
+	/** Move as many chunks into the cache as there is space for. */
+	inline void refill() {
+		while (_cacheBits <= (64 - kChunkBits)) {
+			if ((_bufferPos >= _bufferSize) && !fillBuffer())
+				break;
 
-		_value = readData();
+			const uint64 chunk = readChunk();
 
-		// If we're reading the bits MSB first, we need to shift the value to that position
-		if (isMSB2LSB)
-			_value <<= 64 - valueBits;
+			if (isMSB2LSB)
+				_cache |= chunk << (64 - kChunkBits - _cacheBits);
+			else
+				_cache |= chunk << _cacheBits;
+
+			_cacheBits += kChunkBits;
+			_readBits  += kChunkBits;
 		}
+	}
+
+	/** Remove n bits from the front of the cache. */
+	inline void dropBits(size_t n) {
+		if (n >= 64)
+			_cache = 0;
+		else if (isMSB2LSB)
+			_cache <<= n;
+		else
+			_cache >>= n;
+
+		_cacheBits -= n;
+	}
+
+	/** Return the first n bits of the cache, 0 < n <= 32. */
+	inline uint32 cacheBits(size_t n) const {
+		if (isMSB2LSB)
+			return (uint32) (_cache >> (64 - n));
+
+		return (uint32) (_cache & (0xFFFFFFFFULL >> (32 - n)));
+	}
+
+	void init() {
+		if ((valueBits != 8) && (valueBits != 16) && (valueBits != 32) && (valueBits != 64))
+			throw Exception("BitStream: Invalid memory layout %d, %d, %d", valueBits, isLE, isMSB2LSB);
+
+		_size = (_stream->size() & ~((size_t) ((valueBits >> 3) - 1))) * 8;
+
+		_bufferPos  = 0;
+		_bufferSize = 0;
+
+		_cache     = 0;
+		_cacheBits = 0;
+
+		_readBits = _stream->pos() * 8;
+	}
 
 public:
 	/** Create a bit stream using this input data stream and optionally delete it on destruction. */
 	BitStreamImpl(SeekableReadStream *stream, bool disposeAfterUse = false) :
-		_stream(stream, disposeAfterUse), _value(0), _inValue(0) {
+		_stream(stream, disposeAfterUse) {
 
 		assert(_stream);
 
-		if ((valueBits != 8) && (valueBits != 16) && (valueBits != 32) && (valueBits != 64))
-			throw Exception("BitStream: Invalid memory layout %d, %d, %d", valueBits, isLE, isMSB2LSB);
+		init();
 	}
 
 	/** Create a bit stream using this input data stream. */
 	BitStreamImpl(SeekableReadStream &stream) :
-		_stream(&stream, false), _value(0), _inValue(0) {
+		_stream(&stream, false) {
 
-		if ((valueBits != 8) && (valueBits != 16) && (valueBits != 32) && (valueBits != 64))
-			throw Exception("BitStream: Invalid memory layout %d, %d, %d", valueBits, isLE, isMSB2LSB);
+		init();
 	}
 
 	~BitStreamImpl() {
@@ -151,25 +255,16 @@ public:
 
 	/** Read a bit from the bit stream. */
 	uint32 getBit() {
-		// Check if we need the next value
-		if (_inValue == 0)
-			readValue();
+		if (_cacheBits == 0) {
+			refill();
 
-		// Get the current bit
-		int b = 0;
-		if (isMSB2LSB)
-			b = ((_value & 0x8000000000000000ULL) == 0) ? 0 : 1;
-		else
-			b = ((_value & 1) == 0) ? 0 : 1;
+			if (_cacheBits == 0)
+				throw Exception("BitStream::getBit(): End of bit stream reached");
+		}
 
-		// Shift to the next bit
-		if (isMSB2LSB)
-			_value <<= 1;
-		else
-			_value >>= 1;
+		const uint32 b = cacheBits(1);
 
-		// Increase the position within the current value
-		_inValue = (_inValue + 1) % valueBits;
+		dropBits(1);
 
 		return b;
 	}
@@ -182,22 +277,34 @@ public:
 		if (n > 32)
 			throw Exception("Too many bits requested to be read");
 
-		// Read the number of bits
-		uint32 v = 0;
+		if (_cacheBits < n) {
+			refill();
 
-		if (isMSB2LSB) {
-			while (n-- > 0)
-				v = (v << 1) | getBit();
-		} else {
-			for (uint32 i = 0; i < n; i++)
-				v = (v >> 1) | (((uint32) getBit()) << 31);
-
-			v >>= (32 - n);
+			if (_cacheBits < n)
+				throw Exception("BitStream::getBits(): End of bit stream reached");
 		}
 
+		const uint32 v = cacheBits(n);
+
+		dropBits(n);
+
 		return v;
 	}
 
+	/** Return the next n bits, without moving the stream position. */
+	uint32 peekBits(size_t n) {
+		if (n == 0)
+			return 0;
+
+		if (n > 32)
+			throw Exception("Too many bits requested to be read");
+
+		if (_cacheBits < n)
+			refill();
+
+		return cacheBits(n);
+	}
+
 	/** Add a bit to the n-bit value x, making it an (n+1)-bit value. */
 	void addBit(uint32 &x, size_t n) {
 		if (n >= 32)
@@ -209,39 +316,74 @@ public:
 			x = (x & ~(1 << n)) | (getBit() << n);
 	}
 
+	/** Are the bits read in the order of MSB to LSB of the values? */
+	bool isMSBFirst() const {
+		return isMSB2LSB;
+	}
+
 	/** Rewind the bit stream back to the start. */
 	void rewind() {
 		_stream->seek(0);
 
-		_value   = 0;
-		_inValue = 0;
+		_bufferPos  = 0;
+		_bufferSize = 0;
+
+		_cache     = 0;
+		_cacheBits = 0;
+
+		_readBits = 0;
 	}
 
 	/** Skip the specified amount of bits. */
 	void skip(size_t n) {
-		while (n-- > 0)
-			getBit();
+		if (n <= _cacheBits) {
+			dropBits(n);
+			return;
+		}
+
+		const size_t target = pos() + n;
+		if (target > _size)
+			throw Exception("BitStream::skip(): End of bit stream reached");
+
+		_cache     = 0;
+		_cacheBits = 0;
+
+		// Go to the start of the value the target position is in
+		const size_t valueStart = (target / valueBits) * valueBits;
+		const size_t bufferEnd  = _readBits + (_bufferSize - _bufferPos) * 8;
+
+		if ((valueStart >= _readBits) && (valueStart < bufferEnd)) {
+			_bufferPos += (valueStart - _readBits) / 8;
+		} else {
+			_stream->seek(valueStart / 8);
+
+			_bufferPos  = 0;
+			_bufferSize = 0;
+		}
+
+		_readBits = valueStart;
+
+		// And skip the remaining bits within that value
+		refill();
+		dropBits(target - valueStart);
 	}
 
 	/** Return the stream position in bits. */
 	size_t pos() const {
-		if (_stream->pos() == 0)
-			return 0;
-
-		size_t p = (_inValue == 0) ? _stream->pos() : ((_stream->pos() - 1) & ~((size_t) ((valueBits >> 3) - 1)));
-		return p * 8 + _inValue;
+		return _readBits - _cacheBits;
 	}
 
 	/** Return the stream size in bits. */
 	size_t size() const {
-		return (_stream->size() & ~((size_t) ((valueBits >> 3) - 1))) * 8;
+		return _size;
 	}
 
 	bool eos() const {
-		return _stream->eos() || (pos() >= size());
+		return pos() >= size();
 	}
 };
 
+
 // typedefs for various memory layouts.
 
 /** 8-bit data, MSB to LSB. */
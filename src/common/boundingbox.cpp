@@ -227,6 +227,46 @@ bool BoundingBox::isIn(float x1, float y1, float z1, float x2, float y2, float z
 	return false;
 }
 
+bool BoundingBox::isIn(float x1, float y1, float z1, float x2, float y2, float z2,
+                       float &distance) const {
+
+	if (_empty)
+		return false;
+
+	float min[3], max[3];
+	getMin(min[0], min[1], min[2]);
+	getMax(max[0], max[1], max[2]);
+
+	const float from[3] = { x1, y1, z1 };
+	const float dir [3] = { x2 - x1, y2 - y1, z2 - z1 };
+
+	// Clip the segment against the three pairs of planes ("slabs") of the box
+
+	float tMin = 0.0f, tMax = 1.0f;
+	for (int i = 0; i < 3; i++) {
+		if (dir[i] == 0.0f) {
+			if ((from[i] < min[i]) || (from[i] > max[i]))
+				return false;
+
+			continue;
+		}
+
+		float t1 = (min[i] - from[i]) / dir[i];
+		float t2 = (max[i] - from[i]) / dir[i];
+		if (t1 > t2)
+			SWAP(t1, t2);
+
+		tMin = MAX(tMin, t1);
+		tMax = MIN(tMax, t2);
+
+		if (tMin > tMax)
+			return false;
+	}
+
+	distance = tMin;
+	return true;
+}
+
 void BoundingBox::add(float x, float y, float z) {
 	_coords[0][0] = MIN(_coords[0][0], x); _coords[0][1] = MIN(_coords[0][1], y); _coords[0][2] = MIN(_coords[0][2], z);
 	_coords[1][0] = MIN(_coords[1][0], x); _coords[1][1] = MIN(_coords[1][1], y); _coords[1][2] = MAX(_coords[1][2], z);
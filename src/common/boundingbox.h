@@ -53,6 +53,13 @@ public:
 
 	bool isIn(float x1, float y1, float z1, float x2, float y2, float z2) const;
 
+	/** Does the line segment from x1.y1.z1 to x2.y2.z2 intersect with the box?
+	 *
+	 *  If it does, distance is set to the position along the segment where it
+	 *  enters the box, from 0.0f (at x1.y1.z1) to 1.0f (at x2.y2.z2).
+	 */
+	bool isIn(float x1, float y1, float z1, float x2, float y2, float z2, float &distance) const;
+
 	void add(float x, float y, float z);
 	void add(const BoundingBox &box);
 
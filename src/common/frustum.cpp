@@ -0,0 +1,123 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A view frustum.
+ */
+
+#include "glm/geometric.hpp"
+#include "glm/matrix.hpp"
+
+#include "src/common/frustum.h"
+#include "src/common/boundingbox.h"
+#include "src/common/util.h"
+
+namespace Common {
+
+Frustum::Frustum() : _eye(0.0f, 0.0f, 0.0f) {
+	for (int i = 0; i < 6; i++)
+		_planes[i] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+Frustum::Frustum(const glm::mat4 &projection, const glm::mat4 &modelview) {
+	set(projection, modelview);
+}
+
+Frustum::~Frustum() {
+}
+
+void Frustum::set(const glm::mat4 &projection, const glm::mat4 &modelview) {
+	/* Extract the clipping planes directly from the combined matrix, as
+	 * described by Gribb and Hartmann in "Fast Extraction of Viewing
+	 * Frustum Planes from the World-View-Projection Matrix". A point p is
+	 * inside the frustum if -w <= x, y, z <= w for (x, y, z, w) = m * p. */
+
+	const glm::mat4 m = projection * modelview;
+
+	const glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+	const glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+	const glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+	const glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+	_planes[0] = row3 + row0; // Left
+	_planes[1] = row3 - row0; // Right
+	_planes[2] = row3 + row1; // Bottom
+	_planes[3] = row3 - row1; // Top
+	_planes[4] = row3 + row2; // Near
+	_planes[5] = row3 - row2; // Far
+
+	for (int i = 0; i < 6; i++) {
+		const float length = glm::length(glm::vec3(_planes[i]));
+		if (length > 0.0f)
+			_planes[i] /= length;
+	}
+
+	_eye = glm::vec3(glm::inverse(modelview)[3]);
+}
+
+const glm::vec3 &Frustum::getEye() const {
+	return _eye;
+}
+
+bool Frustum::isIn(const BoundingBox &box) const {
+	if (box.empty())
+		return false;
+
+	float min[3], max[3];
+	box.getMin(min[0], min[1], min[2]);
+	box.getMax(max[0], max[1], max[2]);
+
+	/* For each plane, look at the corner of the box furthest along the
+	 * plane's normal. If even that corner is behind the plane, the whole
+	 * box is outside the frustum. */
+
+	for (int i = 0; i < 6; i++) {
+		const glm::vec4 &plane = _planes[i];
+
+		const float x = (plane.x >= 0.0f) ? max[0] : min[0];
+		const float y = (plane.y >= 0.0f) ? max[1] : min[1];
+		const float z = (plane.z >= 0.0f) ? max[2] : min[2];
+
+		if ((plane.x * x + plane.y * y + plane.z * z + plane.w) < 0.0f)
+			return false;
+	}
+
+	return true;
+}
+
+bool Frustum::isIn(const BoundingBox &box, float maxDistance) const {
+	if (!isIn(box))
+		return false;
+
+	float min[3], max[3];
+	box.getMin(min[0], min[1], min[2]);
+	box.getMax(max[0], max[1], max[2]);
+
+	// Distance from the viewer to the closest point of the box
+	const glm::vec3 closest(CLIP(_eye.x, min[0], max[0]),
+	                        CLIP(_eye.y, min[1], max[1]),
+	                        CLIP(_eye.z, min[2], max[2]));
+
+	const glm::vec3 delta = closest - _eye;
+
+	return glm::dot(delta, delta) <= (maxDistance * maxDistance);
+}
+
+} // End of namespace Common
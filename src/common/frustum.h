@@ -0,0 +1,75 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A view frustum.
+ */
+
+#ifndef COMMON_FRUSTUM_H
+#define COMMON_FRUSTUM_H
+
+#include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
+#include "glm/mat4x4.hpp"
+
+namespace Common {
+
+class BoundingBox;
+
+/** The view frustum of a camera, for culling objects that can't be seen.
+ *
+ *  The frustum is described by the six clipping planes of a projection
+ *  and modelview matrix pair, as used by OpenGL.
+ */
+class Frustum {
+public:
+	/** Create a frustum that contains everything. */
+	Frustum();
+	/** Create the frustum of this projection and modelview matrix. */
+	Frustum(const glm::mat4 &projection, const glm::mat4 &modelview);
+	~Frustum();
+
+	/** Set the frustum to that of this projection and modelview matrix. */
+	void set(const glm::mat4 &projection, const glm::mat4 &modelview);
+
+	/** Return the position of the viewer. */
+	const glm::vec3 &getEye() const;
+
+	/** Is any part of the box inside the frustum?
+	 *
+	 *  This test is conservative: a box close to a corner of the frustum
+	 *  might be reported as inside even though it isn't. Empty boxes are
+	 *  never inside the frustum.
+	 */
+	bool isIn(const BoundingBox &box) const;
+
+	/** Is any part of the box inside the frustum, and no further away from the viewer than maxDistance? */
+	bool isIn(const BoundingBox &box, float maxDistance) const;
+
+private:
+	/** The left, right, bottom, top, near and far planes, with their normals pointing inwards. */
+	glm::vec4 _planes[6];
+
+	glm::vec3 _eye;
+};
+
+} // End of namespace Common
+
+#endif // COMMON_FRUSTUM_H
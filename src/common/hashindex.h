@@ -0,0 +1,312 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A flat, sharded hash table indexed by 64-bit hashes.
+ */
+
+#ifndef COMMON_HASHINDEX_H
+#define COMMON_HASHINDEX_H
+
+#include <vector>
+
+#include "src/common/types.h"
+
+namespace Common {
+
+/** A flat hash table, mapping already hashed 64-bit keys onto values.
+ *
+ *  The table is split into a fixed number of shards, each of which is an
+ *  open-addressing array with linear probing. A lookup only touches one
+ *  contiguous run of slots, and growing the table only ever rehashes a
+ *  single shard at a time.
+ *
+ *  Values are moved around when a shard grows or when an entry is
+ *  removed, so neither pointers to values nor iterators stay valid over
+ *  an insertion or removal. T should therefore be small and cheap to
+ *  copy; large or address-sensitive data should be stored indirectly.
+ */
+template<typename T>
+class HashIndex {
+private:
+	struct Slot {
+		uint64 key;
+		T value;
+		bool used;
+
+		Slot() : key(0), value(), used(false) { }
+	};
+
+	typedef std::vector<Slot> Slots;
+
+	struct Shard {
+		Slots  slots;
+		size_t used;
+
+		Shard() : used(0) { }
+	};
+
+	static const size_t kShardBits  = 4;
+	static const size_t kShardCount = 1 << kShardBits;
+
+	/** The minimum number of slots in a non-empty shard. Must be a power of 2. */
+	static const size_t kMinShardSize = 16;
+
+public:
+	template<typename Index, typename Value>
+	class IteratorBase {
+	public:
+		IteratorBase() : _index(0), _shard(0), _slot(0) { }
+
+		/** Convert an iterator into a const_iterator. */
+		template<typename I, typename V>
+		IteratorBase(const IteratorBase<I, V> &it) : _index(it._index), _shard(it._shard), _slot(it._slot) { }
+
+		uint64 key() const {
+			return _index->_shards[_shard].slots[_slot].key;
+		}
+
+		Value &value() const {
+			return _index->_shards[_shard].slots[_slot].value;
+		}
+
+		IteratorBase &operator++() {
+			_slot++;
+			skipEmpty();
+
+			return *this;
+		}
+
+		bool operator==(const IteratorBase &it) const {
+			return (_index == it._index) && (_shard == it._shard) && (_slot == it._slot);
+		}
+
+		bool operator!=(const IteratorBase &it) const {
+			return !(*this == it);
+		}
+
+	private:
+		Index *_index;
+
+		size_t _shard;
+		size_t _slot;
+
+		IteratorBase(Index &index, size_t shard) : _index(&index), _shard(shard), _slot(0) {
+			skipEmpty();
+		}
+
+		void skipEmpty() {
+			while (_shard < kShardCount) {
+				const Slots &slots = _index->_shards[_shard].slots;
+
+				while ((_slot < slots.size()) && !slots[_slot].used)
+					_slot++;
+
+				if (_slot < slots.size())
+					break;
+
+				_shard++;
+				_slot = 0;
+			}
+		}
+
+		template<typename I, typename V> friend class IteratorBase;
+		friend class HashIndex;
+	};
+
+	typedef IteratorBase<HashIndex, T> iterator;
+	typedef IteratorBase<const HashIndex, const T> const_iterator;
+
+	HashIndex() : _size(0) {
+	}
+
+	iterator begin() {
+		return iterator(*this, 0);
+	}
+
+	iterator end() {
+		return iterator(*this, kShardCount);
+	}
+
+	const_iterator begin() const {
+		return const_iterator(*this, 0);
+	}
+
+	const_iterator end() const {
+		return const_iterator(*this, kShardCount);
+	}
+
+	/** Return the number of entries in the table. */
+	size_t size() const {
+		return _size;
+	}
+
+	bool empty() const {
+		return _size == 0;
+	}
+
+	/** Remove all entries and free the memory used by the table. */
+	void clear() {
+		for (size_t i = 0; i < kShardCount; i++) {
+			Slots().swap(_shards[i].slots);
+			_shards[i].used = 0;
+		}
+
+		_size = 0;
+	}
+
+	/** Find the value for this key. Returns 0 if there is no such entry. */
+	T *find(uint64 key) {
+		Slot *slot = findSlot(key);
+
+		return slot ? &slot->value : 0;
+	}
+
+	/** Find the value for this key. Returns 0 if there is no such entry. */
+	const T *find(uint64 key) const {
+		const Slot *slot = const_cast<HashIndex *>(this)->findSlot(key);
+
+		return slot ? &slot->value : 0;
+	}
+
+	/** Find the value for this key, creating a default-constructed one if necessary. */
+	T &operator[](uint64 key) {
+		Slot *slot = findSlot(key);
+		if (slot)
+			return slot->value;
+
+		const uint64 hash  = mix(key);
+		Shard       &shard = _shards[getShard(hash)];
+
+		// Keep the load factor at or below 3/4
+		if (((shard.slots.size() * 3) / 4) <= shard.used)
+			grow(shard.slots);
+
+		slot = &insertSlot(shard.slots, hash);
+
+		slot->key   = key;
+		slot->value = T();
+		slot->used  = true;
+
+		shard.used++;
+		_size++;
+
+		return slot->value;
+	}
+
+	/** Remove the entry with this key. Returns false if there was no such entry. */
+	bool erase(uint64 key) {
+		const uint64 hash  = mix(key);
+		Shard       &shard = _shards[getShard(hash)];
+		Slots       &slots = shard.slots;
+
+		if (slots.empty())
+			return false;
+
+		const size_t mask = slots.size() - 1;
+
+		size_t i = hash & mask;
+		while (slots[i].used && (slots[i].key != key))
+			i = (i + 1) & mask;
+
+		if (!slots[i].used)
+			return false;
+
+		/* Backward-shift deletion: move every following entry of the probe
+		 * run that would still be reachable from its home slot into the
+		 * hole, so that we never need tombstones. */
+
+		for (size_t j = (i + 1) & mask; slots[j].used; j = (j + 1) & mask) {
+			const size_t home = mix(slots[j].key) & mask;
+
+			const bool reachable = (i <= j) ? ((home <= i) || (home > j)) : ((home <= i) && (home > j));
+			if (!reachable)
+				continue;
+
+			slots[i] = slots[j];
+			i = j;
+		}
+
+		slots[i] = Slot();
+
+		shard.used--;
+		_size--;
+		return true;
+	}
+
+private:
+	Shard  _shards[kShardCount];
+	size_t _size;
+
+	/** Scramble the key, so that even 32-bit hashes spread over all shards and slots. */
+	static uint64 mix(uint64 key) {
+		key ^= key >> 33;
+		key *= UINT64_C(0xFF51AFD7ED558CCD);
+		key ^= key >> 33;
+		key *= UINT64_C(0xC4CEB9FE1A85EC53);
+		key ^= key >> 33;
+
+		return key;
+	}
+
+	static size_t getShard(uint64 hash) {
+		return (size_t) (hash >> (64 - kShardBits));
+	}
+
+	Slot *findSlot(uint64 key) {
+		const uint64 hash  = mix(key);
+		Slots       &slots = _shards[getShard(hash)].slots;
+
+		if (slots.empty())
+			return 0;
+
+		const size_t mask = slots.size() - 1;
+
+		for (size_t i = hash & mask; slots[i].used; i = (i + 1) & mask)
+			if (slots[i].key == key)
+				return &slots[i];
+
+		return 0;
+	}
+
+	static Slot &insertSlot(Slots &slots, uint64 hash) {
+		const size_t mask = slots.size() - 1;
+
+		size_t i = hash & mask;
+		while (slots[i].used)
+			i = (i + 1) & mask;
+
+		return slots[i];
+	}
+
+	static void grow(Slots &slots) {
+		Slots newSlots(slots.empty() ? kMinShardSize : (slots.size() * 2));
+
+		for (typename Slots::const_iterator s = slots.begin(); s != slots.end(); ++s)
+			if (s->used)
+				insertSlot(newSlots, mix(s->key)) = *s;
+
+		slots.swap(newSlots);
+	}
+};
+
+} // End of namespace Common
+
+#endif // COMMON_HASHINDEX_H
@@ -31,7 +31,21 @@
 
 namespace Common {
 
-Huffman::Symbol::Symbol(uint32 c, uint32 s) : code(c), symbol(s) {
+/** The number of bits indexing one level of the lookup tables. */
+static const size_t kLookupBits = 9;
+
+/** Reverse the order of the lowest n bits of x. */
+static uint32 reverseBits(uint32 x, size_t n) {
+	uint32 r = 0;
+
+	for (size_t i = 0; i < n; i++, x >>= 1)
+		r = (r << 1) | (x & 1);
+
+	return r;
+}
+
+
+Huffman::LookupEntry::LookupEntry() : value(0), length(0) {
 }
 
 
@@ -59,38 +73,138 @@ void Huffman::init(uint8 maxLength, size_t codeCount, const uint32 *codes,
 
 	assert(maxLength <= 32);
 
-	_codes.resize(maxLength);
 	_symbols.resize(codeCount);
+	setSymbols(symbols);
 
-	for (size_t i = 0; i < codeCount; i++) {
-		// The symbol. If none were specified, just assume it's identical to the code index
-		uint32 symbol = symbols ? symbols[i] : i;
+	_lookupBits = MIN<size_t>(maxLength, kLookupBits);
 
-		// Put the code and symbol into the correct list
-		_codes[lengths[i] - 1].push_back(Symbol(codes[i], symbol));
+	/* A stream reading MSB to LSB builds the codes with the first bit on top.
+	 * A stream reading LSB to MSB builds them with the first bit at the bottom. */
+	std::vector<uint32> sequences(codeCount);
 
-		// And put the pointer to the symbol/code struct into the symbol list.
-		_symbols[i] = &_codes[lengths[i] - 1].back();
-	}
+	for (size_t i = 0; i < codeCount; i++)
+		sequences[i] = codes[i];
+
+	createLookup(_lookupMSB, maxLength, sequences, lengths, false);
+
+	for (size_t i = 0; i < codeCount; i++)
+		sequences[i] = reverseBits(codes[i], lengths[i]);
+
+	createLookup(_lookupLSB, maxLength, sequences, lengths, true);
 }
 
 Huffman::~Huffman() {
 }
 
+void Huffman::createLookup(LookupTable &table, uint8 maxLength, const std::vector<uint32> &sequences,
+                           const uint8 *lengths, bool lsb) {
+
+	std::vector<size_t> indices;
+	indices.reserve(sequences.size());
+
+	for (size_t i = 0; i < sequences.size(); i++)
+		if ((lengths[i] > 0) && (lengths[i] <= maxLength))
+			indices.push_back(i);
+
+	const size_t width = MIN<size_t>(maxLength, kLookupBits);
+
+	table.clear();
+	table.resize(1 << width);
+
+	fillLookup(table, 0, width, 0, indices, sequences, lengths, lsb);
+}
+
+void Huffman::fillLookup(LookupTable &table, size_t offset, size_t width,
+                         size_t prefixLength, const std::vector<size_t> &indices,
+                         const std::vector<uint32> &sequences, const uint8 *lengths, bool lsb) {
+
+	// Codes too long for this table go into next level's tables, grouped by their next bits
+	std::vector< std::vector<size_t> > longCodes;
+
+	for (std::vector<size_t>::const_iterator i = indices.begin(); i != indices.end(); ++i) {
+		const size_t length = lengths[*i] - prefixLength;
+		if (length <= width)
+			continue;
+
+		const uint32 bits = (sequences[*i] >> (length - width)) & ((1 << width) - 1);
+
+		if (longCodes.empty())
+			longCodes.resize(1 << width);
+
+		longCodes[bits].push_back(*i);
+	}
+
+	for (size_t bits = 0; bits < longCodes.size(); bits++) {
+		if (longCodes[bits].empty())
+			continue;
+
+		size_t maxLength = 0;
+		for (std::vector<size_t>::const_iterator i = longCodes[bits].begin(); i != longCodes[bits].end(); ++i)
+			maxLength = MAX<size_t>(maxLength, lengths[*i] - prefixLength - width);
+
+		const size_t subWidth  = MIN<size_t>(maxLength, kLookupBits);
+		const size_t subOffset = table.size();
+
+		table.resize(subOffset + (1 << subWidth));
+
+		LookupEntry &entry = table[offset + (lsb ? reverseBits(bits, width) : bits)];
+
+		entry.value  = subOffset;
+		entry.length = -((int8) subWidth);
+
+		fillLookup(table, subOffset, subWidth, prefixLength + width,
+		           longCodes[bits], sequences, lengths, lsb);
+	}
+
+	/* Now fill in the codes that end within this table. If codes aren't
+	 * prefix-free, the shortest and then the first one wins, so we fill
+	 * the longest and last ones in first and let them be overwritten. */
+	for (size_t length = width; length > 0; length--) {
+		for (std::vector<size_t>::const_reverse_iterator i = indices.rbegin(); i != indices.rend(); ++i) {
+			if ((lengths[*i] - prefixLength) != length)
+				continue;
+
+			const uint32 code  = sequences[*i] & ((1 << length) - 1);
+			const uint32 first = code << (width - length);
+			const uint32 count = 1 << (width - length);
+
+			for (uint32 bits = first; bits < (first + count); bits++) {
+				LookupEntry &entry = table[offset + (lsb ? reverseBits(bits, width) : bits)];
+
+				entry.value  = *i;
+				entry.length = (int8) length;
+			}
+		}
+	}
+}
+
 void Huffman::setSymbols(const uint32 *symbols) {
 	for (size_t i = 0; i < _symbols.size(); i++)
-		_symbols[i]->symbol = symbols ? *symbols++ : i;
+		_symbols[i] = symbols ? *symbols++ : i;
 }
 
 uint32 Huffman::getSymbol(BitStream &bits) const {
-	uint32 code = 0;
+	const LookupTable &table = bits.isMSBFirst() ? _lookupMSB : _lookupLSB;
+
+	size_t offset = 0;
+	size_t width  = _lookupBits;
+
+	while (true) {
+		const LookupEntry &entry = table[offset + bits.peekBits(width)];
+
+		if (entry.length > 0) {
+			bits.skip(entry.length);
+			return _symbols[entry.value];
+		}
+
+		if (entry.length == 0)
+			break;
 
-	for (size_t i = 0; i < _codes.size(); i++) {
-		bits.addBit(code, i);
+		// Go down into the next level
+		bits.skip(width);
 
-		for (CodeList::const_iterator cCode = _codes[i].begin(); cCode != _codes[i].end(); ++cCode)
-			if (code == cCode->code)
-				return cCode->symbol;
+		offset = entry.value;
+		width  = -entry.length;
 	}
 
 	throw Exception("Unknown Huffman code");
@@ -26,7 +26,6 @@
 #define COMMON_HUFFMAN_H
 
 #include <vector>
-#include <list>
 
 #include "src/common/types.h"
 
@@ -43,7 +42,12 @@ struct HuffmanTable {
 	const uint32 *symbols; ///< The symbols, 0 if identical to the codes.
 };
 
-/** Decode a Huffman'd bitstream. */
+/** Decode a Huffman'd bitstream.
+ *
+ *  Symbols are looked up in multi-level tables indexed by the next few
+ *  bits of the stream, instead of reading the code bit by bit. Each level
+ *  resolves up to 9 bits of a code.
+ */
 class Huffman {
 public:
 	/** Construct a Huffman decoder.
@@ -66,25 +70,52 @@ public:
 	uint32 getSymbol(BitStream &bits) const;
 
 private:
-	struct Symbol {
-		uint32 code;
-		uint32 symbol;
-
-		Symbol(uint32 c, uint32 s);
+	/** An entry in a lookup table. */
+	struct LookupEntry {
+		/** The index of the code, or the offset of the next level's table. */
+		uint32 value;
+		/** The number of bits to consume for the code.
+		 *
+		 *  If 0, there's no code with these bits. If negative, the entry points
+		 *  to the next level's table, and its absolute value is that table's
+		 *  index width in bits.
+		 */
+		int8 length;
+
+		LookupEntry();
 	};
 
-	typedef std::list<Symbol>     CodeList;
-	typedef std::vector<CodeList> CodeLists;
-	typedef std::vector<Symbol *> SymbolList;
+	typedef std::vector<LookupEntry> LookupTable;
 
-	/** Lists of codes and their symbols, sorted by code length. */
-	CodeLists _codes;
+	/** The symbols of all codes, by code index. */
+	std::vector<uint32> _symbols;
 
-	/** Sorted list of pointers to the symbols. */
-	SymbolList _symbols;
+	/** The number of bits indexing the first level of the lookup tables. */
+	size_t _lookupBits;
+
+	/** The lookup tables for streams that read bits MSB to LSB. */
+	LookupTable _lookupMSB;
+	/** The lookup tables for streams that read bits LSB to MSB. */
+	LookupTable _lookupLSB;
 
 	void init(uint8 maxLength, size_t codeCount, const uint32 *codes,
 	          const uint8 *lengths, const uint32 *symbols);
+
+	/** Create the lookup tables for codes whose bits appear in the stream in this order.
+	 *
+	 *  @param table The lookup tables to create.
+	 *  @param maxLength Maximal code length.
+	 *  @param sequences The codes, with the bit read first in the highest position.
+	 *  @param lengths Lengths of the individual codes.
+	 *  @param lsb Will the tables be indexed by bits read LSB to MSB?
+	 */
+	static void createLookup(LookupTable &table, uint8 maxLength, const std::vector<uint32> &sequences,
+	                         const uint8 *lengths, bool lsb);
+
+	/** Fill in the table at this offset with these codes, whose first prefixLength bits are already consumed. */
+	static void fillLookup(LookupTable &table, size_t offset, size_t width,
+	                       size_t prefixLength, const std::vector<size_t> &indices,
+	                       const std::vector<uint32> &sequences, const uint8 *lengths, bool lsb);
 };
 
 } // End of namespace Common
@@ -0,0 +1,155 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A file mapped read-only into memory.
+ */
+
+#include <cassert>
+#include <cstring>
+
+#include "src/common/mappedfile.h"
+#include "src/common/memreadstream.h"
+#include "src/common/platform.h"
+#include "src/common/ustring.h"
+#include "src/common/error.h"
+#include "src/common/util.h"
+
+namespace Common {
+
+/** The actual mapping, unmapped when the last user lets go of it. */
+class MappedFile::Mapping : boost::noncopyable {
+public:
+	Mapping(const byte *data, size_t size) : _data(data), _size(size) {
+	}
+
+	~Mapping() {
+		Platform::unmapFile(_data, _size);
+	}
+
+private:
+	const byte *_data;
+	size_t _size;
+};
+
+/** A MemoryReadStream pointing into a mapping, keeping the mapping alive. */
+class MappedFile::View : public MemoryReadStream {
+public:
+	View(const boost::shared_ptr<Mapping> &mapping, const byte *data, size_t size) :
+		MemoryReadStream(data, size, false), _mapping(mapping) {
+
+	}
+
+	~View() {
+	}
+
+	MemoryReadStream *readStreamAt(size_t offset, size_t dataSize) {
+		if ((offset > size()) || (dataSize > (size() - offset)))
+			throw Exception(kReadError);
+
+		return new View(_mapping, getData() + offset, dataSize);
+	}
+
+private:
+	boost::shared_ptr<Mapping> _mapping;
+};
+
+
+MappedFile::MappedFile(const UString &fileName) : _data(0), _size(0), _pos(0), _eos(false) {
+	_data = Platform::mapFile(fileName, _size);
+	if (!_data)
+		throw Exception("Can't map file \"%s\"", fileName.c_str());
+
+	_mapping.reset(new Mapping(_data, _size));
+}
+
+MappedFile::~MappedFile() {
+}
+
+bool MappedFile::isSupported() {
+#if defined(UNIX) || defined(WIN32)
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool MappedFile::eos() const {
+	return _eos;
+}
+
+size_t MappedFile::pos() const {
+	return _pos;
+}
+
+size_t MappedFile::size() const {
+	return _size;
+}
+
+size_t MappedFile::seek(ptrdiff_t offset, Origin whence) {
+	const size_t oldPos = _pos;
+	const size_t newPos = evalSeek(offset, whence, _pos, 0, size());
+	if (newPos > _size)
+		throw Exception(kSeekError);
+
+	_pos = newPos;
+	_eos = false; // reset eos on successful seek
+
+	return oldPos;
+}
+
+size_t MappedFile::read(void *dataPtr, size_t dataSize) {
+	assert(dataPtr);
+
+	if (dataSize > (_size - _pos)) {
+		dataSize = _size - _pos;
+		_eos = true;
+	}
+
+	std::memcpy(dataPtr, _data + _pos, dataSize);
+	_pos += dataSize;
+
+	return dataSize;
+}
+
+size_t MappedFile::readAt(size_t offset, void *dataPtr, size_t dataSize) {
+	assert(dataPtr);
+
+	if (offset >= _size)
+		return 0;
+
+	dataSize = MIN(dataSize, _size - offset);
+	std::memcpy(dataPtr, _data + offset, dataSize);
+
+	return dataSize;
+}
+
+MemoryReadStream *MappedFile::readStreamAt(size_t offset, size_t dataSize) {
+	if ((offset > _size) || (dataSize > (_size - offset)))
+		throw Exception(kReadError);
+
+	return new View(_mapping, _data + offset, dataSize);
+}
+
+const byte *MappedFile::getData() const {
+	return _data;
+}
+
+} // End of namespace Common
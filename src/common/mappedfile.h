@@ -0,0 +1,88 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A file mapped read-only into memory.
+ */
+
+#ifndef COMMON_MAPPEDFILE_H
+#define COMMON_MAPPEDFILE_H
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include "src/common/types.h"
+#include "src/common/readstream.h"
+
+namespace Common {
+
+class UString;
+
+/** A file mapped read-only into memory, as a seekable stream.
+ *
+ *  Reading from a MappedFile copies straight out of the mapping, without any
+ *  system calls. Moreover, readStreamAt() returns a MemoryReadStream that
+ *  points directly into the mapping, so whole resources can be read out of
+ *  an archive without copying them at all. These streams share ownership of
+ *  the mapping and stay valid even after the MappedFile has been destroyed.
+ *
+ *  readAt() and readStreamAt() can safely be called from several threads.
+ *
+ *  The file must not be modified while it is mapped.
+ */
+class MappedFile : boost::noncopyable, public SeekableReadStream {
+public:
+	/** Map this file. Throws an exception if the file can't be mapped. */
+	MappedFile(const UString &fileName);
+	~MappedFile();
+
+	bool eos() const;
+
+	size_t pos() const;
+	size_t size() const;
+
+	size_t seek(ptrdiff_t offset, Origin whence = kOriginBegin);
+	size_t read(void *dataPtr, size_t dataSize);
+
+	size_t readAt(size_t offset, void *dataPtr, size_t dataSize);
+	MemoryReadStream *readStreamAt(size_t offset, size_t dataSize);
+
+	/** Return the whole mapped file data. */
+	const byte *getData() const;
+
+	/** Is mapping files supported on this platform at all? */
+	static bool isSupported();
+
+private:
+	class Mapping;
+	class View;
+
+	boost::shared_ptr<Mapping> _mapping;
+
+	const byte *_data;
+	size_t _size;
+	size_t _pos;
+
+	bool _eos;
+};
+
+} // End of namespace Common
+
+#endif // COMMON_MAPPEDFILE_H
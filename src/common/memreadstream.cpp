@@ -89,6 +89,18 @@ size_t MemoryReadStream::seek(ptrdiff_t offset, Origin whence) {
 	return oldPos;
 }
 
+size_t MemoryReadStream::readAt(size_t offset, void *dataPtr, size_t dataSize) {
+	assert(dataPtr);
+
+	if (offset >= _size)
+		return 0;
+
+	dataSize = MIN(dataSize, _size - offset);
+	std::memcpy(dataPtr, _ptrOrig.get() + offset, dataSize);
+
+	return dataSize;
+}
+
 bool MemoryReadStream::eos() const {
 	return _eos;
 }
@@ -100,6 +100,8 @@ public:
 
 	size_t seek(ptrdiff_t offset, Origin whence = kOriginBegin);
 
+	size_t readAt(size_t offset, void *dataPtr, size_t dataSize);
+
 	const byte *getData() const;
 
 private:
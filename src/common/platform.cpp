@@ -34,10 +34,14 @@
 #if defined(UNIX)
 	#include <pwd.h>
 	#include <unistd.h>
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
 #endif
 
 #include <cassert>
 #include <cstdlib>
+#include <cerrno>
 
 #include <boost/locale.hpp>
 #include <boost/filesystem/path.hpp>
@@ -118,6 +122,130 @@ std::FILE *Platform::openFile(const UString &fileName, FileMode mode) {
 }
 // '--- openFile() ---'
 
+// .--- readFileAt() ---.
+#if defined(UNIX)
+
+bool Platform::readFileAt(std::FILE *file, size_t offset, void *dataPtr, size_t dataSize, size_t &bytesRead) {
+	assert(file && dataPtr);
+
+	const int fd = fileno(file);
+
+	bytesRead = 0;
+	while (bytesRead < dataSize) {
+		const ssize_t n = pread(fd, reinterpret_cast<byte *>(dataPtr) + bytesRead,
+		                        dataSize - bytesRead, offset + bytesRead);
+
+		if ((n < 0) && (errno == EINTR))
+			continue;
+		if (n <= 0)
+			break;
+
+		bytesRead += n;
+	}
+
+	return true;
+}
+
+#else
+
+bool Platform::readFileAt(std::FILE *UNUSED(file), size_t UNUSED(offset), void *UNUSED(dataPtr),
+                          size_t UNUSED(dataSize), size_t &bytesRead) {
+
+	bytesRead = 0;
+	return false;
+}
+
+#endif
+// '--- readFileAt() ---'
+
+// .--- mapFile() ---.
+#if defined(UNIX)
+
+const byte *Platform::mapFile(const UString &fileName, size_t &size) {
+	size = 0;
+
+	const int fd = ::open(boost::filesystem::path(fileName.c_str()).c_str(), O_RDONLY);
+	if (fd < 0)
+		return 0;
+
+	struct stat fileStat;
+	if ((fstat(fd, &fileStat) != 0) || !S_ISREG(fileStat.st_mode) || (fileStat.st_size <= 0) ||
+	    ((uint64) fileStat.st_size > (uint64) 0x7FFFFFFFULL)) {
+
+		::close(fd);
+		return 0;
+	}
+
+	void *data = mmap(0, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+	// The mapping stays valid after the file descriptor has been closed
+	::close(fd);
+
+	if (data == MAP_FAILED)
+		return 0;
+
+	size = fileStat.st_size;
+	return reinterpret_cast<const byte *>(data);
+}
+
+void Platform::unmapFile(const byte *data, size_t size) {
+	if (data)
+		munmap(const_cast<byte *>(data), size);
+}
+
+#elif defined(WIN32)
+
+const byte *Platform::mapFile(const UString &fileName, size_t &size) {
+	size = 0;
+
+	HANDLE file = CreateFileW(boost::filesystem::path(fileName.c_str()).c_str(), GENERIC_READ,
+	                          FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+	if (file == INVALID_HANDLE_VALUE)
+		return 0;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || (fileSize.QuadPart <= 0) ||
+	    ((uint64) fileSize.QuadPart > (uint64) 0x7FFFFFFFULL)) {
+
+		CloseHandle(file);
+		return 0;
+	}
+
+	HANDLE mapping = CreateFileMappingW(file, 0, PAGE_READONLY, 0, 0, 0);
+	CloseHandle(file);
+
+	if (!mapping)
+		return 0;
+
+	// The view keeps the mapping object alive
+	const void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+
+	if (!data)
+		return 0;
+
+	size = (size_t) fileSize.QuadPart;
+	return reinterpret_cast<const byte *>(data);
+}
+
+void Platform::unmapFile(const byte *data, size_t UNUSED(size)) {
+	if (data)
+		UnmapViewOfFile(data);
+}
+
+#else
+
+const byte *Platform::mapFile(const UString &UNUSED(fileName), size_t &size) {
+	size = 0;
+	return 0;
+}
+
+void Platform::unmapFile(const byte *UNUSED(data), size_t UNUSED(size)) {
+}
+
+#endif
+// '--- mapFile() ---'
+
 // .--- Windows utility functions ---.
 #if defined(WIN32)
 
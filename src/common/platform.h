@@ -29,6 +29,7 @@
 
 #include <vector>
 
+#include "src/common/types.h"
 #include "src/common/ustring.h"
 
 namespace Common {
@@ -51,6 +52,31 @@ public:
 	/** Open a file with an UTF-8 encoded name. */
 	static std::FILE *openFile(const UString &fileName, FileMode mode);
 
+	/** Read from a specific position in a file, without changing the file's position.
+	 *
+	 *  This is safe to be called on the same file from several threads at once.
+	 *
+	 *  @param  file The file to read from.
+	 *  @param  offset The position in the file to start reading at.
+	 *  @param  dataPtr The buffer to read into.
+	 *  @param  dataSize The number of bytes to read.
+	 *  @param  bytesRead The number of bytes that were actually read.
+	 *  @return false if positional reads are not supported on this platform.
+	 */
+	static bool readFileAt(std::FILE *file, size_t offset, void *dataPtr, size_t dataSize, size_t &bytesRead);
+
+	/** Map a whole file read-only into memory.
+	 *
+	 *  @param  fileName The name of the file to map.
+	 *  @param  size The size of the mapped file.
+	 *  @return The mapped file data, or 0 if the file could not be mapped.
+	 *          Empty files and platforms without memory mapping always fail.
+	 */
+	static const byte *mapFile(const UString &fileName, size_t &size);
+
+	/** Unmap a file previously mapped with mapFile(). */
+	static void unmapFile(const byte *data, size_t size);
+
 	/** Return the OS-specific path of the user's home directory. */
 	static UString getHomeDirectory();
 	/** Return the OS-specific path of the config directory. */
@@ -0,0 +1,323 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A uniform grid of points, for nearest-neighbor and radius queries.
+ */
+
+#include <cassert>
+#include <cmath>
+#include <cfloat>
+
+#include <algorithm>
+
+#include "src/common/pointgrid.h"
+#include "src/common/util.h"
+
+namespace Common {
+
+const PointGrid::PointID PointGrid::kPointNone;
+
+static const size_t kCellNone = SIZE_MAX;
+
+/** The maximum number of cells along each axis. */
+static const int kMaxCells = 512;
+
+
+PointGrid::PointGrid(float minX, float minY, float maxX, float maxY, float cellSize) :
+	_minX(minX), _minY(minY), _cellSize(cellSize), _freeList(kPointNone), _pointCount(0) {
+
+	const float width  = MAX(maxX - minX, 0.0f);
+	const float height = MAX(maxY - minY, 0.0f);
+
+	if (!(_cellSize > 0.0f))
+		_cellSize = MAX(MAX(width, height), 1.0f);
+
+	_cellSize = MAX(_cellSize, MAX(width, height) / kMaxCells);
+
+	_cellsX = CLIP<int>((int) ceilf(width  / _cellSize), 1, kMaxCells);
+	_cellsY = CLIP<int>((int) ceilf(height / _cellSize), 1, kMaxCells);
+
+	_cells.resize(_cellsX * _cellsY);
+}
+
+PointGrid::~PointGrid() {
+}
+
+void PointGrid::clear() {
+	_points.clear();
+
+	for (std::vector< std::vector<PointID> >::iterator c = _cells.begin(); c != _cells.end(); ++c)
+		c->clear();
+
+	_freeList   = kPointNone;
+	_pointCount = 0;
+}
+
+size_t PointGrid::size() const {
+	return _pointCount;
+}
+
+bool PointGrid::empty() const {
+	return _pointCount == 0;
+}
+
+PointGrid::PointID PointGrid::insert(float x, float y, float z, void *data) {
+	PointID point = _freeList;
+
+	if (point != kPointNone) {
+		_freeList = _points[point].cellIndex;
+	} else {
+		point = _points.size();
+		_points.push_back(Point());
+	}
+
+	_points[point].position[0] = x;
+	_points[point].position[1] = y;
+	_points[point].position[2] = z;
+	_points[point].data        = data;
+
+	int cellX, cellY;
+	getCell(x, y, cellX, cellY);
+
+	addToCell(point, cellY * _cellsX + cellX);
+
+	_pointCount++;
+
+	return point;
+}
+
+void PointGrid::remove(PointID point) {
+	assert((point < _points.size()) && (_points[point].cell != kCellNone));
+
+	removeFromCell(point);
+
+	_points[point].cellIndex = _freeList;
+	_points[point].data      = 0;
+
+	_freeList = point;
+
+	_pointCount--;
+}
+
+void PointGrid::move(PointID point, float x, float y, float z) {
+	assert((point < _points.size()) && (_points[point].cell != kCellNone));
+
+	_points[point].position[0] = x;
+	_points[point].position[1] = y;
+	_points[point].position[2] = z;
+
+	int cellX, cellY;
+	getCell(x, y, cellX, cellY);
+
+	const size_t cell = cellY * _cellsX + cellX;
+	if (cell == _points[point].cell)
+		return;
+
+	removeFromCell(point);
+	addToCell(point, cell);
+}
+
+void *PointGrid::getData(PointID point) const {
+	assert((point < _points.size()) && (_points[point].cell != kCellNone));
+
+	return _points[point].data;
+}
+
+void PointGrid::getData(std::vector<void *> &data) const {
+	data.clear();
+	data.reserve(_pointCount);
+
+	for (std::vector<Point>::const_iterator p = _points.begin(); p != _points.end(); ++p)
+		if (p->cell != kCellNone)
+			data.push_back(p->data);
+}
+
+void PointGrid::findNearest(float x, float y, float z, size_t count,
+                            std::vector<void *> &result, Filter *filter) const {
+
+	result.clear();
+	if ((count == 0) || (_pointCount == 0))
+		return;
+
+	const float position[3] = { x, y, z };
+
+	int cellX, cellY;
+	getCell(x, y, cellX, cellY);
+
+	const int maxRing = MAX(MAX(cellX, _cellsX - 1 - cellX), MAX(cellY, _cellsY - 1 - cellY));
+
+	// A max-heap of the nearest points found so far, the farthest one on top
+	std::vector<Candidate> candidates;
+	candidates.reserve(MIN(count, _pointCount) + 1);
+
+	/* Search the cells in growing square rings around the cell holding the
+	 * position, until the rings can't hold anything nearer than the points
+	 * already found. */
+	for (int ring = 0; ring <= maxRing; ring++) {
+		const int x1 = cellX - ring, x2 = cellX + ring;
+		const int y1 = cellY - ring, y2 = cellY + ring;
+
+		for (int cY = MAX(y1, 0); cY <= MIN(y2, _cellsY - 1); cY++) {
+			if ((cY == y1) || (cY == y2)) {
+				for (int cX = MAX(x1, 0); cX <= MIN(x2, _cellsX - 1); cX++)
+					checkCell(cX, cY, position, count, candidates, filter);
+
+				continue;
+			}
+
+			if (x1 >= 0)
+				checkCell(x1, cY, position, count, candidates, filter);
+			if ((x2 < _cellsX) && (x2 != x1))
+				checkCell(x2, cY, position, count, candidates, filter);
+		}
+
+		if (candidates.size() < count)
+			continue;
+
+		/* The distance to the nearest cell outside the rings searched so far.
+		 * Points outside the grid rectangle sit in the border cells, which
+		 * only makes them farther away than this. */
+		float bound = FLT_MAX;
+
+		if (x1 > 0)
+			bound = MIN(bound, x - (_minX + x1 * _cellSize));
+		if (x2 < (_cellsX - 1))
+			bound = MIN(bound, (_minX + (x2 + 1) * _cellSize) - x);
+		if (y1 > 0)
+			bound = MIN(bound, y - (_minY + y1 * _cellSize));
+		if (y2 < (_cellsY - 1))
+			bound = MIN(bound, (_minY + (y2 + 1) * _cellSize) - y);
+
+		if (candidates.front().first < (bound * bound))
+			break;
+	}
+
+	getResult(candidates, result);
+}
+
+void PointGrid::findInRadius(float x, float y, float z, float radius,
+                             std::vector<void *> &result, Filter *filter) const {
+
+	result.clear();
+	if ((_pointCount == 0) || !(radius >= 0.0f))
+		return;
+
+	const float position[3] = { x, y, z };
+	const float radiusSquared = radius * radius;
+
+	int x1, y1, x2, y2;
+	getCell(x - radius, y - radius, x1, y1);
+	getCell(x + radius, y + radius, x2, y2);
+
+	std::vector<Candidate> candidates;
+
+	for (int cY = y1; cY <= y2; cY++) {
+		for (int cX = x1; cX <= x2; cX++) {
+			const std::vector<PointID> &cell = _cells[cY * _cellsX + cX];
+
+			for (std::vector<PointID>::const_iterator p = cell.begin(); p != cell.end(); ++p) {
+				const float distance = getDistanceSquared(_points[*p], position);
+				if (!(distance <= radiusSquared))
+					continue;
+
+				if (filter && !filter->accept(_points[*p].data))
+					continue;
+
+				candidates.push_back(Candidate(distance, *p));
+			}
+		}
+	}
+
+	std::make_heap(candidates.begin(), candidates.end());
+	getResult(candidates, result);
+}
+
+void PointGrid::getCell(float x, float y, int &cellX, int &cellY) const {
+	const float fX = (x - _minX) / _cellSize;
+	const float fY = (y - _minY) / _cellSize;
+
+	// Written so that NaNs end up in the first cell
+	cellX = (fX >= 1.0f) ? MIN<int>((int) MIN<float>(fX, kMaxCells), _cellsX - 1) : 0;
+	cellY = (fY >= 1.0f) ? MIN<int>((int) MIN<float>(fY, kMaxCells), _cellsY - 1) : 0;
+}
+
+void PointGrid::addToCell(PointID point, size_t cell) {
+	_points[point].cell      = cell;
+	_points[point].cellIndex = _cells[cell].size();
+
+	_cells[cell].push_back(point);
+}
+
+void PointGrid::removeFromCell(PointID point) {
+	std::vector<PointID> &cell = _cells[_points[point].cell];
+	const size_t index = _points[point].cellIndex;
+
+	// Move the last point of the cell into the gap
+	cell[index] = cell.back();
+	_points[cell[index]].cellIndex = index;
+
+	cell.pop_back();
+
+	_points[point].cell = kCellNone;
+}
+
+void PointGrid::checkCell(int cellX, int cellY, const float *position, size_t count,
+                          std::vector<Candidate> &candidates, Filter *filter) const {
+
+	const std::vector<PointID> &cell = _cells[cellY * _cellsX + cellX];
+
+	for (std::vector<PointID>::const_iterator p = cell.begin(); p != cell.end(); ++p) {
+		const Candidate candidate(getDistanceSquared(_points[*p], position), *p);
+
+		// Not nearer than the farthest point we already have?
+		if ((candidates.size() >= count) && !(candidate < candidates.front()))
+			continue;
+
+		if (filter && !filter->accept(_points[*p].data))
+			continue;
+
+		candidates.push_back(candidate);
+		std::push_heap(candidates.begin(), candidates.end());
+
+		if (candidates.size() > count) {
+			std::pop_heap(candidates.begin(), candidates.end());
+			candidates.pop_back();
+		}
+	}
+}
+
+float PointGrid::getDistanceSquared(const Point &point, const float *position) const {
+	const float x = point.position[0] - position[0];
+	const float y = point.position[1] - position[1];
+	const float z = point.position[2] - position[2];
+
+	return x * x + y * y + z * z;
+}
+
+void PointGrid::getResult(std::vector<Candidate> &candidates, std::vector<void *> &result) const {
+	std::sort_heap(candidates.begin(), candidates.end());
+
+	result.reserve(candidates.size());
+	for (std::vector<Candidate>::const_iterator c = candidates.begin(); c != candidates.end(); ++c)
+		result.push_back(_points[c->second].data);
+}
+
+} // End of namespace Common
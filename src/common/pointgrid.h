@@ -0,0 +1,151 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A uniform grid of points, for nearest-neighbor and radius queries.
+ */
+
+#ifndef COMMON_POINTGRID_H
+#define COMMON_POINTGRID_H
+
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/types.h"
+
+namespace Common {
+
+/** A uniform grid of points, for nearest-neighbor and radius queries.
+ *
+ *  The grid divides a rectangle on the XY plane into square cells, each
+ *  holding the points that lie within. The Z coordinate only enters the
+ *  distance calculations. Points outside the rectangle are kept in the
+ *  closest cell on its border, so they are still found, just less quickly.
+ *
+ *  Distances are Euclidean. Points at the same distance are ordered by
+ *  their PointID, so the results of a query don't depend on the order in
+ *  which the cells are searched.
+ *
+ *  The grid itself is not thread-safe.
+ */
+class PointGrid : boost::noncopyable {
+public:
+	/** A handle to a point in the grid. */
+	typedef size_t PointID;
+
+	static const PointID kPointNone = SIZE_MAX;
+
+	/** Decides whether a point should be included in the result of a query. */
+	class Filter {
+	public:
+		virtual ~Filter() { }
+
+		/** Should the point with this user data be included? */
+		virtual bool accept(void *data) = 0;
+	};
+
+	/** Create a grid covering the rectangle from minX.minY to maxX.maxY, with cells of this size.
+	 *
+	 *  If the rectangle would need too many cells, the cells are made larger.
+	 */
+	PointGrid(float minX, float minY, float maxX, float maxY, float cellSize);
+	~PointGrid();
+
+	/** Remove all points. */
+	void clear();
+
+	/** Return the number of points in the grid. */
+	size_t size() const;
+	bool empty() const;
+
+	/** Add a point with this user data to the grid. */
+	PointID insert(float x, float y, float z, void *data);
+	/** Remove a point from the grid. */
+	void remove(PointID point);
+	/** Move a point to a new position. */
+	void move(PointID point, float x, float y, float z);
+
+	/** Return the user data of a point. */
+	void *getData(PointID point) const;
+	/** Return the user data of all points in the grid, in no particular order. */
+	void getData(std::vector<void *> &data) const;
+
+	/** Find the points nearest to x.y.z.
+	 *
+	 *  @param count The maximum number of points to find.
+	 *  @param result Filled with the user data of the found points, nearest first.
+	 *  @param filter If given, only points accepted by the filter are found.
+	 */
+	void findNearest(float x, float y, float z, size_t count,
+	                 std::vector<void *> &result, Filter *filter = 0) const;
+
+	/** Find all points within radius of x.y.z.
+	 *
+	 *  @param result Filled with the user data of the found points, nearest first.
+	 *  @param filter If given, only points accepted by the filter are found.
+	 */
+	void findInRadius(float x, float y, float z, float radius,
+	                  std::vector<void *> &result, Filter *filter = 0) const;
+
+private:
+	struct Point {
+		float position[3];
+
+		size_t cell;      ///< The cell holding the point, or kCellNone if this point is free.
+		size_t cellIndex; ///< The index within the cell, or the next free point if this point is free.
+
+		void *data;
+	};
+
+	/** A found point: its squared distance and its ID. */
+	typedef std::pair<float, PointID> Candidate;
+
+	float _minX;
+	float _minY;
+	float _cellSize;
+
+	int _cellsX;
+	int _cellsY;
+
+	std::vector<Point> _points;
+	std::vector< std::vector<PointID> > _cells;
+
+	size_t _freeList;
+	size_t _pointCount;
+
+	/** Return the cell coordinates holding this position. */
+	void getCell(float x, float y, int &cellX, int &cellY) const;
+
+	void addToCell(PointID point, size_t cell);
+	void removeFromCell(PointID point);
+
+	/** Check all points in this cell against the current k nearest candidates. */
+	void checkCell(int cellX, int cellY, const float *position, size_t count,
+	               std::vector<Candidate> &candidates, Filter *filter) const;
+
+	float getDistanceSquared(const Point &point, const float *position) const;
+
+	void getResult(std::vector<Candidate> &candidates, std::vector<void *> &result) const;
+};
+
+} // End of namespace Common
+
+#endif // COMMON_POINTGRID_H
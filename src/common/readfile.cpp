@@ -28,6 +28,7 @@
 #include "src/common/error.h"
 #include "src/common/ustring.h"
 #include "src/common/platform.h"
+#include "src/common/util.h"
 
 namespace Common {
 
@@ -139,4 +140,18 @@ size_t ReadFile::read(void *dataPtr, size_t dataSize) {
 	return std::fread(dataPtr, 1, dataSize, _handle);
 }
 
+size_t ReadFile::readAt(size_t offset, void *dataPtr, size_t dataSize) {
+	if (!_handle || (offset >= _size))
+		return 0;
+
+	assert(dataPtr);
+
+	size_t bytesRead = 0;
+	if (Platform::readFileAt(_handle, offset, dataPtr, MIN(dataSize, _size - offset), bytesRead))
+		return bytesRead;
+
+	// No positional reads on this platform, fall back to seeking
+	return SeekableReadStream::readAt(offset, dataPtr, dataSize);
+}
+
 } // End of namespace Common
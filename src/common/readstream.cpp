@@ -53,9 +53,13 @@
 #include "src/common/memreadstream.h"
 #include "src/common/error.h"
 #include "src/common/scopedptr.h"
+#include "src/common/mutex.h"
 
 namespace Common {
 
+/** Serializes all readAt() calls that have to fall back to seeking. */
+static Mutex readAtMutex;
+
 const uint32 ReadStream::kEOF;
 
 ReadStream::ReadStream() {
@@ -80,6 +84,27 @@ SeekableReadStream::SeekableReadStream() {
 SeekableReadStream::~SeekableReadStream() {
 }
 
+size_t SeekableReadStream::readAt(size_t offset, void *dataPtr, size_t dataSize) {
+	StackLock lock(readAtMutex);
+
+	const size_t oldPos = pos();
+
+	seek(offset);
+	const size_t bytesRead = read(dataPtr, dataSize);
+	seek(oldPos);
+
+	return bytesRead;
+}
+
+MemoryReadStream *SeekableReadStream::readStreamAt(size_t offset, size_t dataSize) {
+	ScopedArray<byte> buf(new byte[dataSize]);
+
+	if (readAt(offset, buf.get(), dataSize) != dataSize)
+		throw Exception(kReadError);
+
+	return new MemoryReadStream(buf.release(), dataSize, true);
+}
+
 size_t SeekableReadStream::evalSeek(ptrdiff_t offset, Origin whence, size_t pos, size_t begin, size_t size) {
 	switch (whence) {
 		case kOriginEnd:
@@ -162,6 +187,84 @@ size_t SeekableSubReadStream::seek(ptrdiff_t offset, Origin whence) {
 	return oldPos;
 }
 
+size_t SeekableSubReadStream::readAt(size_t offset, void *dataPtr, size_t dataSize) {
+	if (offset >= size())
+		return 0;
+
+	return _parentStream->readAt(_begin + offset, dataPtr, MIN(dataSize, size() - offset));
+}
+
+MemoryReadStream *SeekableSubReadStream::readStreamAt(size_t offset, size_t dataSize) {
+	if ((offset > size()) || (dataSize > (size() - offset)))
+		throw Exception(kReadError);
+
+	return _parentStream->readStreamAt(_begin + offset, dataSize);
+}
+
+
+ConcurrentSubReadStream::ConcurrentSubReadStream(SeekableReadStream *parentStream,
+		size_t begin, size_t end) : _parentStream(parentStream), _begin(begin), _end(end), _pos(0), _eos(false) {
+
+	assert(_parentStream);
+	assert(_begin <= _end);
+}
+
+ConcurrentSubReadStream::~ConcurrentSubReadStream() {
+}
+
+bool ConcurrentSubReadStream::eos() const {
+	return _eos;
+}
+
+size_t ConcurrentSubReadStream::read(void *dataPtr, size_t dataSize) {
+	if (dataSize > (size() - _pos)) {
+		dataSize = size() - _pos;
+		_eos = true;
+	}
+
+	const size_t bytesRead = _parentStream->readAt(_begin + _pos, dataPtr, dataSize);
+	if (bytesRead != dataSize)
+		_eos = true;
+
+	_pos += bytesRead;
+
+	return bytesRead;
+}
+
+size_t ConcurrentSubReadStream::pos() const {
+	return _pos;
+}
+
+size_t ConcurrentSubReadStream::size() const {
+	return _end - _begin;
+}
+
+size_t ConcurrentSubReadStream::seek(ptrdiff_t offset, Origin whence) {
+	const size_t oldPos = _pos;
+	const size_t newPos = evalSeek(offset, whence, _pos, 0, size());
+	if (newPos > size())
+		throw Exception(kSeekError);
+
+	_pos = newPos;
+	_eos = false; // reset eos on successful seek
+
+	return oldPos;
+}
+
+size_t ConcurrentSubReadStream::readAt(size_t offset, void *dataPtr, size_t dataSize) {
+	if (offset >= size())
+		return 0;
+
+	return _parentStream->readAt(_begin + offset, dataPtr, MIN(dataSize, size() - offset));
+}
+
+MemoryReadStream *ConcurrentSubReadStream::readStreamAt(size_t offset, size_t dataSize) {
+	if ((offset > size()) || (dataSize > (size() - offset)))
+		throw Exception(kReadError);
+
+	return _parentStream->readStreamAt(_begin + offset, dataSize);
+}
+
 
 SeekableSubReadStreamEndian::SeekableSubReadStreamEndian(SeekableReadStream *parentStream,
 		size_t begin, size_t end, bool bigEndian, bool disposeParentStream) :
@@ -50,6 +50,8 @@
 #ifndef COMMON_READSTREAM_H
 #define COMMON_READSTREAM_H
 
+#include <boost/noncopyable.hpp>
+
 #include "src/common/types.h"
 #include "src/common/endianness.h"
 #include "src/common/disposableptr.h"
@@ -318,6 +320,36 @@ public:
 		return seek(offset, kOriginCurrent);
 	}
 
+	/** Read data from a specific position in the stream, without using or
+	 *  changing the stream's position indicator.
+	 *
+	 *  readAt() may be called from several threads at once, as long as no
+	 *  other method of the stream is called at the same time. Streams that
+	 *  can read from an arbitrary position without touching shared state
+	 *  override this. The default implementation seeks, reads and seeks back
+	 *  under a global lock, so it serializes with all other default readAt()
+	 *  calls.
+	 *
+	 *  @param  offset the position in the stream to read from.
+	 *  @param  dataPtr pointer to a buffer into which the data is read.
+	 *  @param  dataSize number of bytes to be read.
+	 *  @return the number of bytes which were actually read.
+	 */
+	virtual size_t readAt(size_t offset, void *dataPtr, size_t dataSize);
+
+	/** Read the specified amount of data from the specified position into a
+	 *  new[]'ed buffer which then is wrapped into a MemoryReadStream.
+	 *
+	 *  Just like readAt(), this does not change the stream's position
+	 *  indicator. When reading fails, a kReadError exception is thrown.
+	 *
+	 *  Streams that already hold their data in memory may override this to
+	 *  return a MemoryReadStream that points directly into that memory,
+	 *  without copying. Such a stream stays valid on its own, even after
+	 *  this stream has been destroyed.
+	 */
+	virtual MemoryReadStream *readStreamAt(size_t offset, size_t dataSize);
+
 	/** Evaluate the seek offset relative to whence into a position from the beginning. */
 	static size_t evalSeek(ptrdiff_t offset, Origin whence, size_t pos, size_t begin, size_t size);
 };
@@ -367,6 +399,9 @@ public:
 
 	size_t seek(ptrdiff_t offset, Origin whence = kOriginBegin);
 
+	size_t readAt(size_t offset, void *dataPtr, size_t dataSize);
+	MemoryReadStream *readStreamAt(size_t offset, size_t dataSize);
+
 protected:
 	SeekableReadStream *_parentStream;
 
@@ -374,6 +409,42 @@ protected:
 };
 
 
+/** ConcurrentSubReadStream provides access to a SeekableReadStream restricted
+ *  to the range [begin, end), reading through the parent's readAt().
+ *
+ *  Unlike SeekableSubReadStream, this neither uses nor modifies the position
+ *  indicator of the parent stream. Several ConcurrentSubReadStreams on the
+ *  same parent stream can therefore be read independently, even from
+ *  different threads if the parent stream's readAt() allows that.
+ */
+class ConcurrentSubReadStream : boost::noncopyable, public SeekableReadStream {
+public:
+	ConcurrentSubReadStream(SeekableReadStream *parentStream, size_t begin, size_t end);
+	~ConcurrentSubReadStream();
+
+	bool eos() const;
+
+	size_t read(void *dataPtr, size_t dataSize);
+
+	size_t pos() const;
+	size_t size() const;
+
+	size_t seek(ptrdiff_t offset, Origin whence = kOriginBegin);
+
+	size_t readAt(size_t offset, void *dataPtr, size_t dataSize);
+	MemoryReadStream *readStreamAt(size_t offset, size_t dataSize);
+
+private:
+	SeekableReadStream *_parentStream;
+
+	size_t _begin;
+	size_t _end;
+	size_t _pos;
+
+	bool _eos;
+};
+
+
 /** This is a wrapper around SeekableSubReadStream, but it adds non-endian
  *  read methods whose endianness is set on the stream creation.
  *
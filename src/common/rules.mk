@@ -45,6 +45,7 @@ src_common_libcommon_la_SOURCES += \
     src/common/mdct.h \
     src/common/threads.h \
     src/common/thread.h \
+    src/common/threadpool.h \
     src/common/mutex.h \
     src/common/ustring.h \
     src/common/hash.h \
@@ -68,8 +69,11 @@ src_common_libcommon_la_SOURCES += \
     src/common/memwritestream.h \
     src/common/streamtokenizer.h \
     src/common/stringmap.h \
+    src/common/hashindex.h \
+    src/common/stringpool.h \
     src/common/readline.h \
     src/common/readfile.h \
+    src/common/mappedfile.h \
     src/common/writefile.h \
     src/common/filepath.h \
     src/common/filelist.h \
@@ -77,6 +81,9 @@ src_common_libcommon_la_SOURCES += \
     src/common/bitstream.h \
     src/common/huffman.h \
     src/common/boundingbox.h \
+    src/common/aabbtree.h \
+    src/common/pointgrid.h \
+    src/common/frustum.h \
     src/common/configfile.h \
     src/common/configman.h \
     src/common/foxpro.h \
@@ -98,6 +105,7 @@ src_common_libcommon_la_SOURCES += \
     src/common/mdct.cpp \
     src/common/threads.cpp \
     src/common/thread.cpp \
+    src/common/threadpool.cpp \
     src/common/mutex.cpp \
     src/common/ustring.cpp \
     src/common/md5.cpp \
@@ -119,13 +127,18 @@ src_common_libcommon_la_SOURCES += \
     src/common/memwritestream.cpp \
     src/common/streamtokenizer.cpp \
     src/common/stringmap.cpp \
+    src/common/stringpool.cpp \
     src/common/readline.cpp \
     src/common/readfile.cpp \
+    src/common/mappedfile.cpp \
     src/common/writefile.cpp \
     src/common/filepath.cpp \
     src/common/filelist.cpp \
     src/common/huffman.cpp \
     src/common/boundingbox.cpp \
+    src/common/aabbtree.cpp \
+    src/common/pointgrid.cpp \
+    src/common/frustum.cpp \
     src/common/configfile.cpp \
     src/common/configman.cpp \
     src/common/foxpro.cpp \
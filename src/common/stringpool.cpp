@@ -0,0 +1,102 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A compact pool of interned strings.
+ */
+
+#include <cassert>
+#include <cstring>
+
+#include "src/common/stringpool.h"
+#include "src/common/hash.h"
+#include "src/common/error.h"
+
+namespace Common {
+
+const StringPool::StringID StringPool::kEmptyString;
+
+StringPool::StringPool() {
+	clear();
+}
+
+StringPool::StringID StringPool::add(const UString &str) {
+	const char  *cStr   = str.c_str();
+	const size_t length = std::strlen(cStr);
+
+	if (length == 0)
+		return kEmptyString;
+
+	/* Look for the string in the pool. On a hash collision between two
+	 * different strings, the second one is simply stored again without
+	 * being interned. */
+
+	const uint64 strHash = hash(cStr, length);
+
+	StringID *known = _index.find(strHash);
+	if (known && !std::strcmp(&_data[*known], cStr))
+		return *known;
+
+	if ((_data.size() + length + 1) > 0xFFFFFFFF)
+		throw Exception("StringPool::add(): Pool exhausted");
+
+	const StringID id = _data.size();
+
+	_data.insert(_data.end(), cStr, cStr + length + 1);
+
+	if (!known)
+		_index[strHash] = id;
+
+	return id;
+}
+
+UString StringPool::get(StringID id) const {
+	assert(id < _data.size());
+
+	return UString(&_data[id]);
+}
+
+bool StringPool::isEmpty(StringID id) const {
+	assert(id < _data.size());
+
+	return _data[id] == '\0';
+}
+
+size_t StringPool::getSize() const {
+	return _data.size();
+}
+
+void StringPool::clear() {
+	_index.clear();
+
+	// ID 0 is the empty string
+	std::vector<char>(1, '\0').swap(_data);
+}
+
+uint64 StringPool::hash(const char *str, size_t length) {
+	uint64 strHash = 0xCBF29CE484222325LL;
+
+	for (size_t i = 0; i < length; i++)
+		strHash = hashFNV64(strHash, (byte) str[i]);
+
+	return strHash;
+}
+
+} // End of namespace Common
@@ -0,0 +1,79 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A compact pool of interned strings.
+ */
+
+#ifndef COMMON_STRINGPOOL_H
+#define COMMON_STRINGPOOL_H
+
+#include <vector>
+
+#include "src/common/types.h"
+#include "src/common/ustring.h"
+#include "src/common/hashindex.h"
+
+namespace Common {
+
+/** A compact pool of interned strings.
+ *
+ *  All strings are stored back to back in one contiguous buffer and are
+ *  referenced by their 32-bit offset into it. Adding a string that is
+ *  already in the pool returns the existing offset instead of storing the
+ *  string again. Strings can't be removed individually; they only ever
+ *  go away when the whole pool is cleared.
+ */
+class StringPool {
+public:
+	/** An offset of a string within the pool. */
+	typedef uint32 StringID;
+
+	/** The ID of the empty string, which is always available. */
+	static const StringID kEmptyString = 0;
+
+	StringPool();
+
+	/** Add a string to the pool and return its ID. */
+	StringID add(const UString &str);
+
+	/** Return the string with this ID. */
+	UString get(StringID id) const;
+	/** Is the string with this ID empty? */
+	bool isEmpty(StringID id) const;
+
+	/** Return the number of bytes used by all strings in the pool. */
+	size_t getSize() const;
+
+	/** Remove all strings from the pool. */
+	void clear();
+
+private:
+	std::vector<char> _data;
+
+	/** Hash of a string's bytes -> ID of the first string with that hash. */
+	HashIndex<StringID> _index;
+
+	static uint64 hash(const char *str, size_t length);
+};
+
+} // End of namespace Common
+
+#endif // COMMON_STRINGPOOL_H
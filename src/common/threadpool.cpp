@@ -0,0 +1,149 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A pool of worker threads running queued jobs.
+ */
+
+#include <cassert>
+
+#include "src/common/fallthrough.h"
+START_IGNORE_IMPLICIT_FALLTHROUGH
+#include <SDL_cpuinfo.h>
+STOP_IGNORE_IMPLICIT_FALLTHROUGH
+
+#include "src/common/threadpool.h"
+#include "src/common/error.h"
+
+namespace Common {
+
+ThreadPool::ThreadPool(size_t threadCount, const UString &name) : _runningJobs(0), _quit(false),
+	_jobAdded(_mutex), _jobFinished(_mutex) {
+
+	if (threadCount == 0)
+		threadCount = getDefaultThreadCount();
+
+	_threads.reserve(threadCount);
+	for (size_t i = 0; i < threadCount; i++) {
+		SDL_Thread *thread = SDL_CreateThread(threadHelper, name.empty() ? 0 : name.c_str(), static_cast<void *>(this));
+		if (!thread)
+			break;
+
+		_threads.push_back(thread);
+	}
+
+	if (_threads.empty())
+		throw Exception("Failed to create any threads for thread pool \"%s\"", name.c_str());
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		StackLock lock(_mutex);
+
+		clearJobs();
+
+		_quit = true;
+		_jobAdded.broadcast();
+	}
+
+	for (std::vector<SDL_Thread *>::iterator t = _threads.begin(); t != _threads.end(); ++t)
+		SDL_WaitThread(*t, 0);
+}
+
+size_t ThreadPool::getThreadCount() const {
+	return _threads.size();
+}
+
+size_t ThreadPool::getDefaultThreadCount() {
+	const int cpuCount = SDL_GetCPUCount();
+
+	return (cpuCount > 2) ? (size_t) (cpuCount - 1) : 1;
+}
+
+void ThreadPool::addJob(Job *job) {
+	assert(job);
+
+	StackLock lock(_mutex);
+
+	_jobs.push_back(job);
+	_jobAdded.signal();
+}
+
+void ThreadPool::cancel() {
+	StackLock lock(_mutex);
+
+	clearJobs();
+
+	while (_runningJobs > 0)
+		_jobFinished.wait();
+}
+
+void ThreadPool::wait() {
+	StackLock lock(_mutex);
+
+	while (!_jobs.empty() || (_runningJobs > 0))
+		_jobFinished.wait();
+}
+
+void ThreadPool::clearJobs() {
+	for (JobQueue::iterator j = _jobs.begin(); j != _jobs.end(); ++j)
+		delete *j;
+
+	_jobs.clear();
+}
+
+void ThreadPool::threadMethod() {
+	StackLock lock(_mutex);
+
+	while (true) {
+		while (_jobs.empty() && !_quit)
+			_jobAdded.wait();
+
+		if (_quit)
+			break;
+
+		Job *job = _jobs.front();
+		_jobs.pop_front();
+
+		_runningJobs++;
+		_mutex.unlock();
+
+		try {
+			job->run();
+		} catch (...) {
+			exceptionDispatcherWarning();
+		}
+
+		delete job;
+
+		_mutex.lock();
+		_runningJobs--;
+
+		_jobFinished.broadcast();
+	}
+}
+
+int ThreadPool::threadHelper(void *obj) {
+	static_cast<ThreadPool *>(obj)->threadMethod();
+
+	return 0;
+}
+
+} // End of namespace Common
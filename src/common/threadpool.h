@@ -0,0 +1,108 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A pool of worker threads running queued jobs.
+ */
+
+#ifndef COMMON_THREADPOOL_H
+#define COMMON_THREADPOOL_H
+
+#include <list>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/fallthrough.h"
+START_IGNORE_IMPLICIT_FALLTHROUGH
+#include <SDL_thread.h>
+STOP_IGNORE_IMPLICIT_FALLTHROUGH
+
+#include "src/common/types.h"
+#include "src/common/ustring.h"
+#include "src/common/mutex.h"
+
+namespace Common {
+
+/** A fixed number of worker threads, running jobs from a shared queue.
+ *
+ *  Jobs are run in the order they were added, as soon as a thread becomes
+ *  free. All methods may be called from any thread except the pool's own.
+ */
+class ThreadPool : boost::noncopyable {
+public:
+	/** A job that can be run by a ThreadPool. */
+	class Job {
+	public:
+		virtual ~Job() { }
+
+		/** Do the actual work. Exceptions thrown here are printed and otherwise ignored. */
+		virtual void run() = 0;
+	};
+
+	/** Create a pool with that many threads.
+	 *
+	 *  @param threadCount The number of threads. 0 means getDefaultThreadCount().
+	 *  @param name A name for the threads, for debugging purposes.
+	 */
+	ThreadPool(size_t threadCount = 0, const UString &name = "");
+	/** Cancel all queued jobs, wait for the running ones and end the threads. */
+	~ThreadPool();
+
+	/** Return the number of threads in this pool. */
+	size_t getThreadCount() const;
+
+	/** Queue a job. The pool takes over the job and deletes it after it ran or was cancelled. */
+	void addJob(Job *job);
+
+	/** Remove all jobs that haven't started yet, and wait for the running jobs to finish. */
+	void cancel();
+
+	/** Wait until all queued and running jobs have finished. */
+	void wait();
+
+	/** Return a sensible number of threads for CPU-bound work: one less than
+	 *  the number of CPU cores, leaving one for the main thread, but at least 1. */
+	static size_t getDefaultThreadCount();
+
+private:
+	typedef std::list<Job *> JobQueue;
+
+	JobQueue _jobs;
+	size_t _runningJobs;
+
+	bool _quit;
+
+	std::vector<SDL_Thread *> _threads;
+
+	Mutex _mutex;
+	Condition _jobAdded;    ///< Signals that a job was added, or that the threads should quit.
+	Condition _jobFinished; ///< Signals that a job finished.
+
+	void clearJobs();
+
+	void threadMethod();
+
+	static int threadHelper(void *obj);
+};
+
+} // End of namespace Common
+
+#endif // COMMON_THREADPOOL_H
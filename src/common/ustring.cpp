@@ -24,6 +24,7 @@
 
 #include <cstdarg>
 #include <cstdio>
+#include <cstring>
 #include <cctype>
 
 #include <boost/algorithm/string/replace.hpp>
@@ -34,6 +35,17 @@
 
 namespace Common {
 
+/** Lowercase an ASCII character, leaving all other bytes alone. */
+static inline byte toLowerASCII(byte c) {
+	return ((c >= 'A') && (c <= 'Z')) ? (c + ('a' - 'A')) : c;
+}
+
+/** Uppercase an ASCII character, leaving all other bytes alone. */
+static inline byte toUpperASCII(byte c) {
+	return ((c >= 'a') && (c <= 'z')) ? (c - ('a' - 'A')) : c;
+}
+
+
 UString::UString() : _size(0) {
 }
 
@@ -88,11 +100,11 @@ UString &UString::operator=(const char *str) {
 }
 
 bool UString::operator==(const UString &str) const {
-	return strcmp(str) == 0;
+	return equals(str);
 }
 
 bool UString::operator!=(const UString &str) const {
-	return strcmp(str) != 0;
+	return !equals(str);
 }
 
 bool UString::operator<(const UString &str) const {
@@ -167,55 +179,52 @@ UString &UString::operator+=(uint32 c) {
 	return *this;
 }
 
+/* Since UTF-8 sorts the same as the code points it encodes, we can compare
+ * strings byte by byte, without decoding them. The same holds for comparing
+ * them case-insensitively: we only lowercase ASCII characters, and bytes
+ * that look like ASCII are never part of a multi-byte UTF-8 sequence. */
+
 int UString::strcmp(const UString &str) const {
-	UString::iterator it1 = begin();
-	UString::iterator it2 = str.begin();
-	for (; (it1 != end()) && (it2 != str.end()); ++it1, ++it2) {
-		uint32 c1 = *it1;
-		uint32 c2 = *it2;
-
-		if (c1 < c2)
-			return -1;
-		if (c1 > c2)
-			return  1;
-	}
+	const size_t size = MIN(_string.size(), str._string.size());
 
-	if ((it1 == end()) && (it2 == str.end()))
-		return 0;
+	const int result = std::memcmp(_string.c_str(), str._string.c_str(), size);
+	if (result != 0)
+		return (result < 0) ? -1 : 1;
 
-	if (it1 == end())
-		return -1;
+	if (_string.size() == str._string.size())
+		return 0;
 
-	return 1;
+	return (_string.size() < str._string.size()) ? -1 : 1;
 }
 
 int UString::stricmp(const UString &str) const {
-	UString::iterator it1 = begin();
-	UString::iterator it2 = str.begin();
-	for (; (it1 != end()) && (it2 != str.end()); ++it1, ++it2) {
-		uint32 c1 = toLower(*it1);
-		uint32 c2 = toLower(*it2);
-
-		if (c1 < c2)
-			return -1;
-		if (c1 > c2)
-			return  1;
+	const size_t size = MIN(_string.size(), str._string.size());
+
+	const byte *str1 = reinterpret_cast<const byte *>(_string.c_str());
+	const byte *str2 = reinterpret_cast<const byte *>(str._string.c_str());
+
+	for (size_t i = 0; i < size; i++) {
+		const byte c1 = toLowerASCII(str1[i]);
+		const byte c2 = toLowerASCII(str2[i]);
+
+		if (c1 != c2)
+			return (c1 < c2) ? -1 : 1;
 	}
 
-	if ((it1 == end()) && (it2 == str.end()))
+	if (_string.size() == str._string.size())
 		return 0;
 
-	if (it1 == end())
-		return -1;
-
-	return 1;
+	return (_string.size() < str._string.size()) ? -1 : 1;
 }
 
 bool UString::equals(const UString &str) const {
-	return strcmp(str) == 0;
+	return _string == str._string;
 }
 
 bool UString::equalsIgnoreCase(const UString &str) const {
+	if (_string.size() != str._string.size())
+		return false;
+
 	return stricmp(str) == 0;
 }
 
@@ -479,21 +488,20 @@ void UString::makeUpper() {
 }
 
 UString UString::toLower() const {
-	UString str;
+	// Only ASCII characters change, so we can work on the bytes directly
+	UString str(*this);
 
-	str._string.reserve(_string.size());
-	for (iterator it = begin(); it != end(); ++it)
-		str += toLower(*it);
+	for (std::string::iterator c = str._string.begin(); c != str._string.end(); ++c)
+		*c = (char) toLowerASCII((byte) *c);
 
 	return str;
 }
 
 UString UString::toUpper() const {
-	UString str;
+	UString str(*this);
 
-	str._string.reserve(_string.size());
-	for (iterator it = begin(); it != end(); ++it)
-		str += toUpper(*it);
+	for (std::string::iterator c = str._string.begin(); c != str._string.end(); ++c)
+		*c = (char) toUpperASCII((byte) *c);
 
 	return str;
 }
@@ -771,7 +779,7 @@ uint32 UString::toLower(uint32 c) {
 		// We don't know how to lowercase that
 		return c;
 
-	return std::tolower(c);
+	return toLowerASCII(c);
 }
 
 uint32 UString::toUpper(uint32 c) {
@@ -779,7 +787,7 @@ uint32 UString::toUpper(uint32 c) {
 		// We don't know how to uppercase that
 		return c;
 
-	return std::toupper(c);
+	return toUpperASCII(c);
 }
 
 bool UString::isASCII(uint32 c) {
@@ -819,4 +827,21 @@ uint32 UString::fromUTF16(uint16 c) {
 	return *iterator(utf8result.begin(), utf8result.begin(), utf8result.end());
 }
 
+
+size_t hashUStringCaseSensitive::operator()(const UString &str) const {
+	const std::string &string = str._string;
+
+	return boost::hash_range(string.begin(), string.end());
+}
+
+size_t hashUStringCaseInsensitive::operator()(const UString &str) const {
+	const std::string &string = str._string;
+
+	size_t seed = 0;
+	for (std::string::const_iterator c = string.begin(); c != string.end(); ++c)
+		boost::hash_combine<byte>(seed, toLowerASCII((byte) *c));
+
+	return seed;
+}
+
 } // End of namespace Common
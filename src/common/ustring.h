@@ -205,6 +205,9 @@ private:
 	size_t _size;
 
 	void recalculateSize();
+
+	friend struct hashUStringCaseSensitive;
+	friend struct hashUStringCaseInsensitive;
 };
 
 
@@ -221,24 +224,18 @@ static inline UString operator+(const char *left, const UString &right) {
 // Hash functions
 
 struct hashUStringCaseSensitive {
-	size_t operator()(const UString &str) const {
-		size_t seed = 0;
-
-		for (UString::iterator it = str.begin(); it != str.end(); ++it)
-			boost::hash_combine<uint32>(seed, *it);
-
-		return seed;
-	}
+	size_t operator()(const UString &str) const;
 };
 
+/** Case-insensitive string hash. Only ASCII characters are folded, like in UString::toLower(). */
 struct hashUStringCaseInsensitive {
-	size_t operator()(const UString &str) const {
-		size_t seed = 0;
-
-		for (UString::iterator it = str.begin(); it != str.end(); ++it)
-			boost::hash_combine<uint32>(seed, UString::toLower(*it));
+	size_t operator()(const UString &str) const;
+};
 
-		return seed;
+/** Case-insensitive string equality, to go with hashUStringCaseInsensitive. */
+struct equalsUStringCaseInsensitive {
+	bool operator()(const UString &str1, const UString &str2) const {
+		return str1.equalsIgnoreCase(str2);
 	}
 };
 
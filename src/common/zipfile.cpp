@@ -126,29 +126,33 @@ const ZipFile::IFile &ZipFile::getIFile(uint32 index) const {
 	return _iFiles[index];
 }
 
-void ZipFile::getFileProperties(SeekableReadStream &zip, const IFile &file,
-		uint16 &compMethod, uint32 &compSize, uint32 &realSize) const {
+void ZipFile::getFileProperties(SeekableReadStream &zip, const IFile &file, uint16 &compMethod,
+		uint32 &compSize, uint32 &realSize, size_t &dataOffset) const {
 
-	zip.seek(file.offset);
+	/* Read the local file header with a positional read, so that files
+	 * can be read from several threads at once. */
 
-	uint32 tag = zip.readUint32LE();
+	static const size_t kLocalHeaderSize = 30;
+
+	ScopedPtr<MemoryReadStream> header(zip.readStreamAt(file.offset, kLocalHeaderSize));
+
+	uint32 tag = header->readUint32LE();
 	if (tag != 0x04034B50)
 		throw Exception("Unknown ZIP record %08X", tag);
 
-	zip.skip(4);
+	header->skip(4);
 
-	compMethod = zip.readUint16LE();
+	compMethod = header->readUint16LE();
 
-	zip.skip(8);
+	header->skip(8);
 
-	compSize = zip.readUint32LE();
-	realSize = zip.readUint32LE();
+	compSize = header->readUint32LE();
+	realSize = header->readUint32LE();
 
-	uint16 nameLength  = zip.readUint16LE();
-	uint16 extraLength = zip.readUint16LE();
+	uint16 nameLength  = header->readUint16LE();
+	uint16 extraLength = header->readUint16LE();
 
-	zip.skip(nameLength);
-	zip.skip(extraLength);
+	dataOffset = file.offset + kLocalHeaderSize + nameLength + extraLength;
 }
 
 size_t ZipFile::getFileSize(uint32 index) const {
@@ -161,28 +165,31 @@ SeekableReadStream *ZipFile::getFile(uint32 index, bool tryNoCopy) const {
 	uint16 compMethod;
 	uint32 compSize;
 	uint32 realSize;
+	size_t dataOffset;
 
-	getFileProperties(*_zip, file, compMethod, compSize, realSize);
+	getFileProperties(*_zip, file, compMethod, compSize, realSize, dataOffset);
 
 	if (tryNoCopy && (compMethod == 0))
-		return new SeekableSubReadStream(_zip.get(), _zip->pos(), _zip->pos() + compSize);
+		return new ConcurrentSubReadStream(_zip.get(), dataOffset, dataOffset + compSize);
 
-	return decompressFile(*_zip, compMethod, compSize, realSize);
+	return decompressFile(_zip->readStreamAt(dataOffset, compSize), compMethod, compSize, realSize);
 }
 
-SeekableReadStream *ZipFile::decompressFile(SeekableReadStream &zip, uint32 method,
+SeekableReadStream *ZipFile::decompressFile(MemoryReadStream *packed, uint32 method,
 		uint32 compSize, uint32 realSize) {
 
+	ScopedPtr<MemoryReadStream> stream(packed);
+
 	if (method == 0) {
 		// Uncompressed
 
-		return zip.readStream(compSize);
+		return stream.release();
 	}
 
 	if (method != 8)
 		throw Exception("Unhandled Zip compression %d", method);
 
-	return decompressDeflate(zip, compSize, realSize, kWindowBitsMaxRaw);
+	return decompressDeflate(*stream, compSize, realSize, kWindowBitsMaxRaw);
 }
 
 #define BUFREADCOMMENT (0x400)
@@ -37,6 +37,7 @@
 namespace Common {
 
 class SeekableReadStream;
+class MemoryReadStream;
 
 /** A class encapsulating ZIP file access. */
 class ZipFile : boost::noncopyable {
@@ -81,12 +82,12 @@ private:
 	void load(SeekableReadStream &zip);
 	size_t findCentralDirectoryEnd(SeekableReadStream &zip);
 
-	static SeekableReadStream *decompressFile(SeekableReadStream &zip, uint32 method,
+	static SeekableReadStream *decompressFile(MemoryReadStream *packed, uint32 method,
 			uint32 compSize, uint32 realSize);
 
 	const IFile &getIFile(uint32 index) const;
-	void getFileProperties(SeekableReadStream &zip, const IFile &file,
-			uint16 &compMethod, uint32 &compSize, uint32 &realSize) const;
+	void getFileProperties(SeekableReadStream &zip, const IFile &file, uint16 &compMethod,
+			uint32 &compSize, uint32 &realSize, size_t &dataOffset) const;
 };
 
 } // End of namespace Common
@@ -30,6 +30,7 @@
 #include "src/common/writefile.h"
 #include "src/common/configman.h"
 #include "src/common/debug.h"
+#include "src/common/mutex.h"
 
 #include "src/aurora/util.h"
 #include "src/aurora/resman.h"
@@ -78,6 +79,40 @@ void playVideo(const Common::UString &video) {
 	SoundMan.setTypeGain(Sound::kSoundTypeVoice, ConfigMan.getDouble("volume_voice", 1.0));
 }
 
+/** The resource manager revision the sample cache was filled in. */
+struct SampleCacheRevision {
+	Common::Mutex mutex;
+
+	uint32 revision;
+
+	SampleCacheRevision() : revision(0) {
+	}
+
+	static SampleCacheRevision &get() {
+		static SampleCacheRevision cache;
+
+		return cache;
+	}
+};
+
+/** Drop all cached samples if the known resources changed since they were cached. */
+static void checkSampleCacheRevision() {
+	SampleCacheRevision &cache = SampleCacheRevision::get();
+
+	Common::StackLock lock(cache.mutex);
+
+	// A changed set of resources might have given us a different sound of the same name
+	if (cache.revision != ResMan.getRevision()) {
+		SoundMan.clearSampleCache();
+		cache.revision = ResMan.getRevision();
+	}
+}
+
+/** Return the name the decoded samples of this sound resource are cached under. */
+static Common::UString getSampleCacheName(const Common::UString &sound, Aurora::ResourceType resType) {
+	return Common::UString::format("%s#%d", sound.c_str(), (int) resType);
+}
+
 Sound::ChannelHandle playSound(const Common::UString &sound, Sound::SoundType soundType,
 		bool loop, float volume, bool pitchVariance) {
 
@@ -87,11 +122,27 @@ Sound::ChannelHandle playSound(const Common::UString &sound, Sound::SoundType so
 	Sound::ChannelHandle channel;
 
 	try {
-		Common::SeekableReadStream *soundStream = ResMan.getResource(resType, sound);
-		if (!soundStream)
-			return channel;
+		// Music is too long to be worth caching, but other sounds are often replayed
+		const bool cache = soundType != Sound::kSoundTypeMusic;
+
+		const Common::UString cacheName = cache ? getSampleCacheName(sound, resType) : "";
 
-		channel = SoundMan.playSoundFile(soundStream, soundType, loop);
+		if (cache) {
+			checkSampleCacheRevision();
+
+			channel = SoundMan.playCachedSoundFile(cacheName, soundType, loop);
+		}
+
+		if (!SoundMan.isValidChannel(channel)) {
+			Common::SeekableReadStream *soundStream = ResMan.getResource(resType, sound);
+			if (!soundStream)
+				return channel;
+
+			if (cache)
+				channel = SoundMan.playSoundFile(cacheName, soundStream, soundType, loop);
+			else
+				channel = SoundMan.playSoundFile(soundStream, soundType, loop);
+		}
 
 		debugC(Common::kDebugEngineSound, 1, "Playing sound \"%s\" in %s",
 		       sound.c_str(), SoundMan.formatChannel(channel).c_str());
@@ -32,34 +32,63 @@
 
 namespace Engines {
 
+/** Intersect a vertical ray at (x, y) with one walkable face, and return the elevation. */
+static bool intersectFace(const float *vertices, const uint32 *indices, uint32 face,
+                          float x, float y, float &z) {
+
+	const uint32 *index = indices + 3 * face;
+
+	glm::vec3 v0 = glm::make_vec3(vertices + 3 * index[0]);
+	glm::vec3 v1 = glm::make_vec3(vertices + 3 * index[1]);
+	glm::vec3 v2 = glm::make_vec3(vertices + 3 * index[2]);
+
+	glm::vec3 intersection;
+	if (!glm::intersectRayTriangle(glm::vec3(x, y, 1000), glm::vec3(0, 0, -1), v0, v1, v2, intersection))
+		return false;
+
+	z = (v0 * (1.0f - intersection.x - intersection.y) +
+	     v1 * intersection.x +
+	     v2 * intersection.y).z;
+
+	return true;
+}
+
 float WalkmeshElevationEvaluator::getElevationAt(const Walkmesh &w,
 		float x,
 		float y,
 		uint32 &faceIndex) {
-	glm::vec3 orig = glm::vec3(x, y, 1000);
+
+	float z;
+	getElevationsAt(w, 1, &x, &y, &z, &faceIndex);
+
+	return z;
+}
+
+void WalkmeshElevationEvaluator::getElevationsAt(const Walkmesh &w, size_t count,
+		const float *x, const float *y, float *z, uint32 *faceIndices) {
 
 	const std::vector<uint32> &indicesWalkable = w.getIndicesWalkable();
-	size_t faceCount = indicesWalkable.size() / 3;
 	const WalkmeshData &walkmeshData = w.getData();
-	const float *vertices = walkmeshData.vertices.data();
-	uint32 index = 0;
-
-	for (size_t i = 0; i < faceCount; ++i) {
-		glm::vec3 v0 = glm::make_vec3(vertices + 3 * indicesWalkable[index + 0]);
-		glm::vec3 v1 = glm::make_vec3(vertices + 3 * indicesWalkable[index + 1]);
-		glm::vec3 v2 = glm::make_vec3(vertices + 3 * indicesWalkable[index + 2]);
-		index += 3;
-
-		glm::vec3 intersection;
-		if (glm::intersectRayTriangle(orig, glm::vec3(0, 0, -1), v0, v1, v2, intersection)) {
-			faceIndex = i;
-			return (v0 * (1.0f - intersection.x - intersection.y) +
-			        v1 * intersection.x +
-			        v2 * intersection.y).z;
+
+	const float  *vertices = walkmeshData.vertices.data();
+	const uint32 *indices  = indicesWalkable.data();
+
+	for (size_t i = 0; i < count; i++) {
+		z[i] = FLT_MIN;
+
+		// Only look at the faces the walkmesh's grid says might be here
+		const uint32 *faces;
+		size_t faceCount;
+		w.getWalkableFacesAt(x[i], y[i], faces, faceCount);
+
+		for (size_t j = 0; j < faceCount; j++) {
+			if (intersectFace(vertices, indices, faces[j], x[i], y[i], z[i])) {
+				if (faceIndices)
+					faceIndices[i] = faces[j];
+				break;
+			}
 		}
 	}
-
-	return FLT_MIN;
 }
 
 } // End of namespace Engines
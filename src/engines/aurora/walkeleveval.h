@@ -37,6 +37,17 @@ public:
 	 *  @param faceIndex Index of the intersected walkmesh face
 	 */
 	static float getElevationAt(const Walkmesh &w, float x, float y, uint32 &faceIndex);
+
+	/** Evaluate the elevation at many coordinates at once.
+	 *
+	 *  For each point i, z[i] is set to the elevation at (x[i], y[i]), or
+	 *  FLT_MIN if can't walk there.
+	 *
+	 *  @param faceIndices If not 0, set to the indices of the intersected
+	 *                     walkmesh faces. Undefined where z[i] is FLT_MIN.
+	 */
+	static void getElevationsAt(const Walkmesh &w, size_t count, const float *x, const float *y,
+	                            float *z, uint32 *faceIndices = 0);
 };
 
 } // End of namespace Engines
@@ -22,16 +22,36 @@
  *  Generic walkmesh.
  */
 
+#include "src/common/util.h"
+#include "src/common/maths.h"
+
 #include "src/engines/aurora/walkmesh.h"
 
 namespace Engines {
 
+/** Grow the bounding boxes of faces by this much when sorting them into the
+ *  grid, so that rounding errors can't make us miss a face at its edges. */
+static const float kGridFaceMargin = 0.001f;
+
+/** On average, a face may be listed in this many grid cells. If faces spanning
+ *  lots of cells push the grid over this, the grid is made coarser. */
+static const uint64 kMaxGridCellsPerFace = 16;
+
+const uint32 Walkmesh::kMaxGridSize;
+
+Walkmesh::Walkmesh() : _gridX(0.0f), _gridY(0.0f), _gridScaleX(0.0f), _gridScaleY(0.0f),
+	_gridWidth(0), _gridHeight(0) {
+
+}
+
 void Walkmesh::clear() {
 	_data.vertices.clear();
 	_data.indices.clear();
 	_data.faceWalkableMap.clear();
 	_indicesWalkable.clear();
 	_indicesNonWalkable.clear();
+
+	clearGrid();
 }
 
 void Walkmesh::refreshIndexGroups() {
@@ -58,6 +78,163 @@ void Walkmesh::refreshIndexGroups() {
 
 		index += 3;
 	}
+
+	createGrid();
+}
+
+void Walkmesh::clearGrid() {
+	_gridX = _gridY = 0.0f;
+	_gridScaleX = _gridScaleY = 0.0f;
+	_gridWidth = _gridHeight = 0;
+
+	_gridCells.clear();
+	_gridFaces.clear();
+}
+
+void Walkmesh::createGrid() {
+	clearGrid();
+
+	const size_t faceCount = _indicesWalkable.size() / 3;
+	if (faceCount == 0)
+		return;
+
+	// Find the bounding box of each face, and of the whole walkable area
+
+	std::vector<float> bounds(4 * faceCount);
+
+	float minX =  FLT_MAX, minY =  FLT_MAX;
+	float maxX = -FLT_MAX, maxY = -FLT_MAX;
+
+	for (size_t i = 0; i < faceCount; i++) {
+		float *box = &bounds[4 * i];
+
+		box[0] = box[1] =  FLT_MAX;
+		box[2] = box[3] = -FLT_MAX;
+
+		for (size_t j = 0; j < 3; j++) {
+			const float *v = &_data.vertices[3 * _indicesWalkable[3 * i + j]];
+
+			box[0] = MIN(box[0], v[0] - kGridFaceMargin);
+			box[1] = MIN(box[1], v[1] - kGridFaceMargin);
+			box[2] = MAX(box[2], v[0] + kGridFaceMargin);
+			box[3] = MAX(box[3], v[1] + kGridFaceMargin);
+		}
+
+		minX = MIN(minX, box[0]);
+		minY = MIN(minY, box[1]);
+		maxX = MAX(maxX, box[2]);
+		maxY = MAX(maxY, box[3]);
+	}
+
+	/* Aim for about one face per cell. The margin makes sure that
+	 * the area is never empty, even for degenerate walkmeshes. */
+
+	const float width  = maxX - minX;
+	const float height = maxY - minY;
+
+	const float cellSize = sqrtf((width * height) / faceCount);
+
+	_gridX = minX;
+	_gridY = minY;
+
+	// Written so that NaNs and infinities end up with a single cell
+	const float cellsX = width  / cellSize;
+	const float cellsY = height / cellSize;
+
+	_gridWidth  = (cellsX >= 1.0f) ? (uint32) MIN<float>(cellsX, kMaxGridSize) : 1;
+	_gridHeight = (cellsY >= 1.0f) ? (uint32) MIN<float>(cellsY, kMaxGridSize) : 1;
+
+	/* Find the cells the bounding box of each face overlaps. A few faces
+	 * spanning the whole walkmesh would be listed in every single cell,
+	 * so we halve the grid until the lists stay reasonably short. */
+
+	std::vector<uint32> cellX(2 * faceCount), cellY(2 * faceCount);
+
+	while (true) {
+		_gridScaleX = _gridWidth  / width;
+		_gridScaleY = _gridHeight / height;
+
+		uint64 entries = 0;
+		for (size_t i = 0; i < faceCount; i++) {
+			const float *box = &bounds[4 * i];
+
+			cellX[2 * i + 0] = getGridColumn(box[0]);
+			cellX[2 * i + 1] = getGridColumn(box[2]);
+			cellY[2 * i + 0] = getGridRow   (box[1]);
+			cellY[2 * i + 1] = getGridRow   (box[3]);
+
+			entries += (uint64) (cellX[2 * i + 1] - cellX[2 * i + 0] + 1) *
+			                    (cellY[2 * i + 1] - cellY[2 * i + 0] + 1);
+		}
+
+		if ((entries <= kMaxGridCellsPerFace * faceCount) || ((_gridWidth == 1) && (_gridHeight == 1)))
+			break;
+
+		_gridWidth  = MAX<uint32>(_gridWidth  / 2, 1);
+		_gridHeight = MAX<uint32>(_gridHeight / 2, 1);
+	}
+
+	/* Sort the faces into the cells their bounding boxes overlap. We go
+	 * over the faces in order, so the faces in each cell stay sorted. */
+
+	// Count the faces in each cell
+	_gridCells.resize(_gridWidth * _gridHeight + 1, 0);
+	for (size_t i = 0; i < faceCount; i++) {
+		for (uint32 y = cellY[2 * i + 0]; y <= cellY[2 * i + 1]; y++)
+			for (uint32 x = cellX[2 * i + 0]; x <= cellX[2 * i + 1]; x++)
+				_gridCells[y * _gridWidth + x]++;
+	}
+
+	// Turn the counts into offsets
+	uint32 offset = 0;
+	for (size_t i = 0; i < _gridCells.size(); i++) {
+		const uint32 count = _gridCells[i];
+
+		_gridCells[i] = offset;
+		offset += count;
+	}
+
+	// And fill in the faces
+	_gridFaces.resize(offset);
+
+	std::vector<uint32> fill(_gridCells.begin(), _gridCells.end() - 1);
+	for (size_t i = 0; i < faceCount; i++)
+		for (uint32 y = cellY[2 * i + 0]; y <= cellY[2 * i + 1]; y++)
+			for (uint32 x = cellX[2 * i + 0]; x <= cellX[2 * i + 1]; x++)
+				_gridFaces[fill[y * _gridWidth + x]++] = i;
+}
+
+uint32 Walkmesh::getGridColumn(float x) const {
+	const float f = (x - _gridX) * _gridScaleX;
+
+	// Written so that NaNs end up in the first cell
+	return (f >= 1.0f) ? (uint32) MIN<float>(f, _gridWidth - 1) : 0;
+}
+
+uint32 Walkmesh::getGridRow(float y) const {
+	const float f = (y - _gridY) * _gridScaleY;
+
+	// Written so that NaNs end up in the first cell
+	return (f >= 1.0f) ? (uint32) MIN<float>(f, _gridHeight - 1) : 0;
+}
+
+void Walkmesh::getWalkableFacesAt(float x, float y, const uint32 *&faces, size_t &count) const {
+	faces = 0;
+	count = 0;
+
+	if (_gridCells.empty())
+		return;
+
+	// Outside the grid, there's no walkable face. Written so that NaNs are outside as well
+	if (!((x >= _gridX) && (y >= _gridY) &&
+	      (x <= (_gridX + _gridWidth / _gridScaleX)) && (y <= (_gridY + _gridHeight / _gridScaleY))))
+		return;
+
+	const uint32 cell = getGridRow(y) * _gridWidth + getGridColumn(x);
+
+	count = _gridCells[cell + 1] - _gridCells[cell];
+	if (count > 0)
+		faces = &_gridFaces[_gridCells[cell]];
 }
 
 const WalkmeshData &Walkmesh::getData() const {
@@ -39,14 +39,57 @@ struct WalkmeshData {
 
 class Walkmesh {
 public:
+	Walkmesh();
+
 	void clear();
 	void refreshIndexGroups();
 	const WalkmeshData &getData() const;
 	const std::vector<uint32> &getIndicesWalkable() const;
+
+	/** Find all walkable faces that might contain the point (x, y).
+	 *
+	 *  The faces are returned as indices into the walkable faces (i.e. into
+	 *  getIndicesWalkable() / 3), in ascending order. Faces that don't
+	 *  contain the point might be included, but no face that does contain
+	 *  it is ever left out.
+	 *
+	 *  @param faces Set to the first face index. Only valid until the walkmesh changes.
+	 *  @param count Set to the number of face indices.
+	 */
+	void getWalkableFacesAt(float x, float y, const uint32 *&faces, size_t &count) const;
+
 protected:
 	WalkmeshData _data;
 	std::vector<uint32> _indicesWalkable;
 	std::vector<uint32> _indicesNonWalkable;
+
+private:
+	/** The maximum number of cells along each axis of the face grid. */
+	static const uint32 kMaxGridSize = 512;
+
+	/* A uniform grid in the xy plane, over the bounding boxes of all walkable
+	 * faces. Each cell lists the faces overlapping it, so a point query only
+	 * needs to look at a handful of faces instead of all of them. */
+
+	float _gridX; ///< The smallest x coordinate covered by the grid.
+	float _gridY; ///< The smallest y coordinate covered by the grid.
+
+	float _gridScaleX; ///< Grid cells per unit along the x axis.
+	float _gridScaleY; ///< Grid cells per unit along the y axis.
+
+	uint32 _gridWidth;  ///< Number of grid cells along the x axis.
+	uint32 _gridHeight; ///< Number of grid cells along the y axis.
+
+	/** For each grid cell, the offset of its first face in _gridFaces. One extra entry marks the end. */
+	std::vector<uint32> _gridCells;
+	/** The walkable faces in each grid cell. */
+	std::vector<uint32> _gridFaces;
+
+	void createGrid();
+	void clearGrid();
+
+	uint32 getGridColumn(float x) const;
+	uint32 getGridRow(float y) const;
 };
 
 } // End of namespace Engines
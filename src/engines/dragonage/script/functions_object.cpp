@@ -24,7 +24,6 @@
 
 #include <boost/make_shared.hpp>
 
-#include "src/common/scopedptr.h"
 #include "src/common/util.h"
 
 #include "src/aurora/nwscript/functioncontext.h"
@@ -286,11 +285,11 @@ void Functions::getObjectByTag(Aurora::NWScript::FunctionContext &ctx) {
 
 	int nth = ctx.getParams()[1].getInt();
 
-	Common::ScopedPtr<Aurora::NWScript::ObjectSearch> search(campaign->findObjectsByTag(tag));
+	Aurora::NWScript::ObjectSearch search(campaign->findObjectsByTag(tag));
 	while (nth-- > 0)
-		search->next();
+		search.next();
 
-	ctx.getReturn() = search->get();
+	ctx.getReturn() = search.get();
 }
 
 void Functions::getNearestObject(Aurora::NWScript::FunctionContext &ctx) {
@@ -324,11 +323,11 @@ void Functions::getNearestObject(Aurora::NWScript::FunctionContext &ctx) {
 	if (count == 0)
 		return;
 
-	Common::ScopedPtr<Aurora::NWScript::ObjectSearch> search(campaign->findObjects());
+	Aurora::NWScript::ObjectSearch search(campaign->findObjects());
 	Aurora::NWScript::Object *object = 0;
 
 	std::list<Object *> objects;
-	while ((object = search->next())) {
+	while ((object = search.next())) {
 		// Needs to be a valid object and not the target
 		DragonAge::Object *daObject = DragonAge::ObjectContainer::toObject(object);
 		if (!daObject || (daObject == target))
@@ -384,11 +383,11 @@ void Functions::getNearestObjectByTag(Aurora::NWScript::FunctionContext &ctx) {
 	if (count == 0)
 		return;
 
-	Common::ScopedPtr<Aurora::NWScript::ObjectSearch> search(campaign->findObjectsByTag(tag));
+	Aurora::NWScript::ObjectSearch search(campaign->findObjectsByTag(tag));
 	Aurora::NWScript::Object       *object = 0;
 
 	std::list<Object *> objects;
-	while ((object = search->next())) {
+	while ((object = search.next())) {
 		// Needs to be a valid object and not the target
 		DragonAge::Object *daObject = DragonAge::ObjectContainer::toObject(object);
 		if (!daObject || (daObject == target))
@@ -430,11 +429,11 @@ void Functions::UT_getNearestObjectByTag(Aurora::NWScript::FunctionContext &ctx)
 		return;
 	}
 
-	Common::ScopedPtr<Aurora::NWScript::ObjectSearch> search(campaign->findObjectsByTag(tag));
+	Aurora::NWScript::ObjectSearch search(campaign->findObjectsByTag(tag));
 	Aurora::NWScript::Object *object = 0;
 
 	std::list<Object *> objects;
-	while ((object = search->next())) {
+	while ((object = search.next())) {
 		// Needs to be a valid object and not the target
 		DragonAge::Object *daObject = DragonAge::ObjectContainer::toObject(object);
 		if (!daObject || (daObject == target))
@@ -219,6 +219,8 @@ void GameInstanceEngine::listLanguages() {
 void GameInstanceEngine::run() {
 	createEngine();
 
+	ResMan.setMapArchives(ConfigMan.getBool("maparchives", false));
+
 	_engine->start(_probe->getGameID(), _target, _probe->getPlatform());
 
 	destroyEngine();
@@ -22,6 +22,8 @@
  *  A container of Jade Empire objects.
  */
 
+#include <algorithm>
+
 #include "src/common/types.h"
 #include "src/common/util.h"
 
@@ -55,16 +57,6 @@ float ObjectDistanceSort::getDistance(Jade::Object &a) {
 }
 
 
-class SearchType : public ::Aurora::NWScript::SearchRange< std::list<Jade::Object *> > {
-public:
-	SearchType(const iterator &a, const iterator &b) : ::Aurora::NWScript::SearchRange<type>(std::make_pair(a, b)) { }
-	SearchType(const type &l) : ::Aurora::NWScript::SearchRange<type>(std::make_pair(l.begin(), l.end())) { }
-	~SearchType() { }
-
-	::Aurora::NWScript::Object *getObject(const iterator &t) { return *t; }
-};
-
-
 ObjectContainer::ObjectContainer() {
 }
 
@@ -98,8 +90,10 @@ void ObjectContainer::removeObject(Jade::Object &object) {
 	lock();
 
 	ObjectType type = object.getType();
-	if (((uint) type) < kObjectTypeMAX)
-		_objects[type].remove(&object);
+	if (((uint) type) < kObjectTypeMAX) {
+		ObjectList &objects = _objects[type];
+		objects.erase(std::remove(objects.begin(), objects.end(), &object), objects.end());
+	}
 
 	::Aurora::NWScript::ObjectContainer::removeObject(object);
 
@@ -110,16 +104,14 @@ void ObjectContainer::removeObject(Jade::Object &object) {
 	if (((uint) type) >= kObjectTypeMAX)
 		return 0;
 
-	SearchType ctx(_objects[type]);
-
-	return ctx.get();
+	return _objects[type].empty() ? 0 : _objects[type].front();
 }
 
-::Aurora::NWScript::ObjectSearch *ObjectContainer::findObjectsByType(ObjectType type) const {
+::Aurora::NWScript::ObjectSearch ObjectContainer::findObjectsByType(ObjectType type) const {
 	if (((uint) type) >= kObjectTypeMAX)
-		return new SearchType(_objects[0].end(), _objects[0].end());
+		return ::Aurora::NWScript::ObjectSearch();
 
-	return new SearchType(_objects[type]);
+	return ::Aurora::NWScript::ObjectSearch(_objects[type]);
 }
 
 Jade::Object *ObjectContainer::toObject(::Aurora::NWScript::Object *object) {
@@ -25,7 +25,6 @@
 #ifndef ENGINES_JADE_OBJECTCONTAINER_H
 #define ENGINES_JADE_OBJECTCONTAINER_H
 
-#include <list>
 
 #include "src/common/types.h"
 
@@ -75,7 +74,7 @@ public:
 	::Aurora::NWScript::Object *getFirstObjectByType(ObjectType type) const;
 
 	/** Return a search context to iterate over all objects of this type. */
-	::Aurora::NWScript::ObjectSearch *findObjectsByType(ObjectType type) const;
+	::Aurora::NWScript::ObjectSearch findObjectsByType(ObjectType type) const;
 
 	static Jade::Object *toObject(::Aurora::NWScript::Object *object);
 
@@ -89,7 +88,7 @@ public:
 	static Event    *toEvent   (Aurora::NWScript::EngineType *engineType);
 
 private:
-	typedef std::list<Jade::Object *> ObjectList;
+	typedef ::Aurora::NWScript::ObjectSearch::ObjectList ObjectList;
 
 	ObjectList _objects[kObjectTypeMAX];
 };
@@ -383,6 +383,13 @@ void Area::loadProperties(const Aurora::GFF3Struct &props) {
 
 void Area::loadRooms() {
 	const Aurora::LYTFile::RoomArray &rooms = _lyt.getRooms();
+
+	// Start reading all room models in the background
+	for (Aurora::LYTFile::RoomArray::const_iterator r = rooms.begin(); r != rooms.end(); ++r) {
+		ResMan.prefetch(r->model, Aurora::kFileTypeMDL);
+		ResMan.prefetch(r->model, Aurora::kFileTypeMDX);
+	}
+
 	for (Aurora::LYTFile::RoomArray::const_iterator r = rooms.begin(); r != rooms.end(); ++r) {
 		_rooms.push_back(new Room(r->model, r->x, r->y, r->z));
 	}
@@ -22,6 +22,8 @@
  *  A container of Star Wars: Knights of the Old Republic objects.
  */
 
+#include <algorithm>
+
 #include "src/common/types.h"
 #include "src/common/util.h"
 
@@ -55,16 +57,6 @@ float ObjectDistanceSort::getDistance(KotOR::Object &a) {
 }
 
 
-class SearchType : public ::Aurora::NWScript::SearchRange< std::list<KotOR::Object *> > {
-public:
-	SearchType(const iterator &a, const iterator &b) : ::Aurora::NWScript::SearchRange<type>(std::make_pair(a, b)) { }
-	SearchType(const type &l) : ::Aurora::NWScript::SearchRange<type>(std::make_pair(l.begin(), l.end())) { }
-	~SearchType() { }
-
-	::Aurora::NWScript::Object *getObject(const iterator &t) { return *t; }
-};
-
-
 ObjectContainer::ObjectContainer() {
 }
 
@@ -94,7 +86,8 @@ void ObjectContainer::addObject(KotOR::Object &object) {
 void ObjectContainer::removeObject(KotOR::Object &object) {
 	lock();
 
-	_objects[object.getType()].remove(&object);
+	ObjectList &objects = _objects[object.getType()];
+	objects.erase(std::remove(objects.begin(), objects.end(), &object), objects.end());
 
 	::Aurora::NWScript::ObjectContainer::removeObject(object);
 
@@ -106,19 +99,15 @@ void ObjectContainer::removeObject(KotOR::Object &object) {
 	if (l == _objects.end())
 		return 0;
 
-	SearchType ctx(l->second);
-
-	return ctx.get();
+	return l->second.empty() ? 0 : l->second.front();
 }
 
-::Aurora::NWScript::ObjectSearch *ObjectContainer::findObjectsByType(ObjectType type) const {
-	static const ObjectList kEmptyObjectList;
-
+::Aurora::NWScript::ObjectSearch ObjectContainer::findObjectsByType(ObjectType type) const {
 	ObjectMap::const_iterator l = _objects.find(type);
 	if (l == _objects.end())
-		return new SearchType(kEmptyObjectList.begin(), kEmptyObjectList.end());
+		return ::Aurora::NWScript::ObjectSearch();
 
-	return new SearchType(l->second);
+	return ::Aurora::NWScript::ObjectSearch(l->second);
 }
 
 KotOR::Object *ObjectContainer::toObject(::Aurora::NWScript::Object *object) {
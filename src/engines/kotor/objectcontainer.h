@@ -25,7 +25,6 @@
 #ifndef ENGINES_KOTOR_OBJECTCONTAINER_H
 #define ENGINES_KOTOR_OBJECTCONTAINER_H
 
-#include <list>
 #include <map>
 
 #include "src/common/types.h"
@@ -76,7 +75,7 @@ public:
 	::Aurora::NWScript::Object *getFirstObjectByType(ObjectType type) const;
 
 	/** Return a search context to iterate over all objects of this type. */
-	::Aurora::NWScript::ObjectSearch *findObjectsByType(ObjectType type) const;
+	::Aurora::NWScript::ObjectSearch findObjectsByType(ObjectType type) const;
 
 	static KotOR::Object *toObject(::Aurora::NWScript::Object *object);
 
@@ -91,7 +90,7 @@ public:
 	static Creature  *toPartyMember(Aurora::NWScript::Object *object);
 
 private:
-	typedef std::list<KotOR::Object *> ObjectList;
+	typedef ::Aurora::NWScript::ObjectSearch::ObjectList ObjectList;
 	typedef std::map<ObjectType, ObjectList> ObjectMap;
 
 	ObjectMap _objects;
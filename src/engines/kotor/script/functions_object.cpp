@@ -25,7 +25,6 @@
 // TODO: check what happens on using invalid objects.
 
 #include "src/common/util.h"
-#include "src/common/scopedptr.h"
 
 #include "src/aurora/nwscript/functioncontext.h"
 
@@ -67,12 +66,12 @@ void Functions::getObjectByTag(Aurora::NWScript::FunctionContext &ctx) {
 	Common::UString name = ctx.getParams()[0].getString();
 	int nth = ctx.getParams()[1].getInt();
 
-	Common::ScopedPtr<Aurora::NWScript::ObjectSearch> search(_game->getModule().findObjectsByTag(name));
+	Aurora::NWScript::ObjectSearch search(_game->getModule().findObjectsByTag(name));
 	for (int i = 0; i < nth; ++i) {
-		search->next();
+		search.next();
 	}
 
-	ctx.getReturn() = search->get();
+	ctx.getReturn() = search.get();
 }
 
 void Functions::getMinOneHP(Aurora::NWScript::FunctionContext &ctx) {
@@ -61,6 +61,10 @@ float Walkmesh::getElevationAt(float x, float y, uint32 &faceIndex) const {
 	return WalkmeshElevationEvaluator::getElevationAt(*this, x, y, faceIndex);
 }
 
+void Walkmesh::getElevationsAt(size_t count, const float *x, const float *y, float *z, uint32 *faceIndices) const {
+	WalkmeshElevationEvaluator::getElevationsAt(*this, count, x, y, z, faceIndices);
+}
+
 void Walkmesh::highlightFace(uint32 index) {
 	_highlightFaceIndex = index;
 }
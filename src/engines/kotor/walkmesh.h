@@ -44,6 +44,8 @@ public:
 	Walkmesh();
 	void load(const Common::UString &resRef);
 	float getElevationAt(float x, float y, uint32 &faceIndex) const;
+	/** Evaluate the elevation at many coordinates at once, see WalkmeshElevationEvaluator. */
+	void getElevationsAt(size_t count, const float *x, const float *y, float *z, uint32 *faceIndices = 0) const;
 
 	/** Highlight face with specified index.
 	 *
@@ -22,7 +22,6 @@
  *  The context needed to run a Star Wars: Knights of the Old Republic II - The Sith Lords module.
  */
 
-#include "src/common/scopedptr.h"
 #include "src/common/util.h"
 #include "src/common/maths.h"
 #include "src/common/error.h"
@@ -367,12 +366,12 @@ bool Module::getObjectLocation(const Common::UString &object, ObjectType locatio
 	if (object.empty())
 		return false;
 
-	Common::ScopedPtr<Aurora::NWScript::ObjectSearch> search(findObjectsByTag(object));
+	Aurora::NWScript::ObjectSearch search(findObjectsByTag(object));
 
 
 	KotOR2::Object *kotorObject = 0;
-	while (!kotorObject && search->get()) {
-		kotorObject = KotOR2::ObjectContainer::toObject(search->next());
+	while (!kotorObject && search.get()) {
+		kotorObject = KotOR2::ObjectContainer::toObject(search.next());
 		if (!kotorObject || !(kotorObject->getType() & location))
 			kotorObject = 0;
 	}
@@ -27,6 +27,7 @@
 #include "src/common/util.h"
 #include "src/common/error.h"
 
+#include "src/aurora/resman.h"
 #include "src/aurora/gff3file.h"
 #include "src/aurora/2dafile.h"
 #include "src/aurora/2dareg.h"
@@ -52,6 +53,37 @@ namespace Engines {
 
 namespace NWN {
 
+/** The size of a tile, in world units. */
+static const float kTileSize = 10.0f;
+
+/** Only accept objects of certain types and with a certain tag. */
+class ObjectGridFilter : public Common::PointGrid::Filter {
+public:
+	ObjectGridFilter(uint32 typeMask, const Common::UString &tag, const NWN::Object *exclude = 0) :
+		_typeMask(typeMask), _tag(&tag), _exclude(exclude) {
+
+	}
+
+	bool accept(void *data) {
+		const NWN::Object *object = static_cast<const NWN::Object *>(data);
+		if (object == _exclude)
+			return false;
+
+		// Ignore invalid object types
+		const uint32 type = (uint32) object->getType();
+		if ((type >= kObjectTypeMAX) || !(type & _typeMask))
+			return false;
+
+		return _tag->empty() || (object->getTag() == *_tag);
+	}
+
+private:
+	uint32 _typeMask;
+	const Common::UString *_tag;
+	const NWN::Object *_exclude;
+};
+
+
 Area::Area(Module &module, const Common::UString &resRef) : Object(kObjectTypeArea),
 	_module(&module), _resRef(resRef), _visible(false),
 	_activeObject(0), _highlightAll(false) {
@@ -92,6 +124,15 @@ void Area::clear() {
 
 	_objects.clear();
 
+	// Objects we don't own, like the PC, must not keep pointing to us
+	if (_objectGrid) {
+		std::vector<void *> objects;
+		_objectGrid->getData(objects);
+
+		for (std::vector<void *>::iterator o = objects.begin(); o != objects.end(); ++o)
+			static_cast<NWN::Object *>(*o)->setArea(0);
+	}
+
 	// Delete tiles and tileset
 	for (std::vector<Tile>::iterator t = _tiles.begin(); t != _tiles.end(); ++t)
 		delete t->model;
@@ -290,6 +331,9 @@ void Area::loadARE(const Aurora::GFF3Struct &are) {
 
 	_tiles.resize(_width * _height);
 
+	// Index the object positions in a grid with one cell per tile
+	_objectGrid.reset(new Common::PointGrid(0.0f, 0.0f, _width * kTileSize, _height * kTileSize, kTileSize));
+
 	loadTiles(are.getList("Tile_List"));
 
 	// Scripts
@@ -442,6 +486,10 @@ void Area::unloadTileset() {
 }
 
 void Area::loadTiles() {
+	// Start reading all tile models in the background
+	for (std::vector<Tile>::const_iterator t = _tiles.begin(); t != _tiles.end(); ++t)
+		ResMan.prefetch(_tileset->getTile(t->tileID).model, Aurora::kFileTypeMDL);
+
 	for (uint32 y = 0; y < _height; y++) {
 		for (uint32 x = 0; x < _width; x++) {
 			uint32 n = y * _width + x;
@@ -618,6 +666,63 @@ void Area::removeFocus() {
 	_activeObject = 0;
 }
 
+Common::PointGrid::PointID Area::addObjectPosition(NWN::Object &object) {
+	if (!_objectGrid)
+		return Common::PointGrid::kPointNone;
+
+	float x, y, z;
+	object.getPosition(x, y, z);
+
+	return _objectGrid->insert(x, y, z, &object);
+}
+
+void Area::removeObjectPosition(Common::PointGrid::PointID point) {
+	if (_objectGrid && (point != Common::PointGrid::kPointNone))
+		_objectGrid->remove(point);
+}
+
+void Area::moveObjectPosition(Common::PointGrid::PointID point, float x, float y, float z) {
+	if (_objectGrid && (point != Common::PointGrid::kPointNone))
+		_objectGrid->move(point, x, y, z);
+}
+
+void Area::findNearestObjects(const NWN::Object &target, size_t count, uint32 typeMask,
+                              const Common::UString &tag, std::vector<NWN::Object *> &objects) const {
+
+	objects.clear();
+	if (!_objectGrid)
+		return;
+
+	float x, y, z;
+	target.getPosition(x, y, z);
+
+	ObjectGridFilter filter(typeMask, tag, &target);
+
+	std::vector<void *> found;
+	_objectGrid->findNearest(x, y, z, count, found, &filter);
+
+	objects.reserve(found.size());
+	for (std::vector<void *>::const_iterator o = found.begin(); o != found.end(); ++o)
+		objects.push_back(static_cast<NWN::Object *>(*o));
+}
+
+void Area::findObjectsInRadius(float x, float y, float z, float radius, uint32 typeMask,
+                               const Common::UString &tag, std::vector<NWN::Object *> &objects) const {
+
+	objects.clear();
+	if (!_objectGrid)
+		return;
+
+	ObjectGridFilter filter(typeMask, tag);
+
+	std::vector<void *> found;
+	_objectGrid->findInRadius(x, y, z, radius, found, &filter);
+
+	objects.reserve(found.size());
+	for (std::vector<void *>::const_iterator o = found.begin(); o != found.end(); ++o)
+		objects.push_back(static_cast<NWN::Object *>(*o));
+}
+
 void Area::notifyCameraMoved() {
 	checkActive();
 }
@@ -33,6 +33,8 @@
 #include "src/common/ptrlist.h"
 #include "src/common/ustring.h"
 #include "src/common/mutex.h"
+#include "src/common/scopedptr.h"
+#include "src/common/pointgrid.h"
 
 #include "src/aurora/types.h"
 
@@ -111,6 +113,35 @@ public:
 	/** Forcibly remove the focus from the currently highlighted object. */
 	void removeFocus();
 
+	// Object positions
+
+	/** Add an object in this area to the index of object positions. */
+	Common::PointGrid::PointID addObjectPosition(NWN::Object &object);
+	/** Remove an object from the index of object positions. */
+	void removeObjectPosition(Common::PointGrid::PointID point);
+	/** Update the position of an object in the index of object positions. */
+	void moveObjectPosition(Common::PointGrid::PointID point, float x, float y, float z);
+
+	/** Find the objects in this area nearest to the target object, nearest first.
+	 *
+	 *  @param target The object to search around. It's never found itself.
+	 *  @param count The maximum number of objects to find.
+	 *  @param typeMask Only find objects of these types.
+	 *  @param tag If not empty, only find objects with this tag.
+	 *  @param objects Filled with the found objects.
+	 */
+	void findNearestObjects(const NWN::Object &target, size_t count, uint32 typeMask,
+	                        const Common::UString &tag, std::vector<NWN::Object *> &objects) const;
+
+	/** Find all objects in this area within radius of x.y.z, nearest first.
+	 *
+	 *  @param typeMask Only find objects of these types.
+	 *  @param tag If not empty, only find objects with this tag.
+	 *  @param objects Filled with the found objects.
+	 */
+	void findObjectsInRadius(float x, float y, float z, float radius, uint32 typeMask,
+	                         const Common::UString &tag, std::vector<NWN::Object *> &objects) const;
+
 
 	/** Return the localized name of an area. */
 	static Common::UString getName(const Common::UString &resRef);
@@ -190,6 +221,9 @@ private:
 	ObjectList _objects;   ///< List of all objects in the area.
 	ObjectMap  _objectMap; ///< Map of all non-static objects in the area.
 
+	/** The positions of all objects in the area, including the ones we don't own. */
+	Common::ScopedPtr<Common::PointGrid> _objectGrid;
+
 	/** The currently active (highlighted) object. */
 	NWN::Object *_activeObject;
 
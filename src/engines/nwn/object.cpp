@@ -43,6 +43,7 @@
 
 #include "src/engines/nwn/types.h"
 #include "src/engines/nwn/object.h"
+#include "src/engines/nwn/area.h"
 
 namespace Engines {
 
@@ -50,7 +51,7 @@ namespace NWN {
 
 Object::Object(ObjectType type) : _type(type),
 	_soundSet(Aurora::kFieldIDInvalid), _static(false), _usable(true),
-	_pcSpeaker(0), _area(0) {
+	_pcSpeaker(0), _area(0), _areaPosition(Common::PointGrid::kPointNone) {
 
 	_id = Common::generateIDNumber();
 
@@ -64,6 +65,9 @@ Object::Object(ObjectType type) : _type(type),
 }
 
 Object::~Object() {
+	if (_area)
+		_area->removeObjectPosition(_areaPosition);
+
 	destroyTooltip();
 }
 
@@ -135,7 +139,17 @@ Area *Object::getArea() const {
 }
 
 void Object::setArea(Area *area) {
-	_area = area;
+	if (area == _area)
+		return;
+
+	if (_area)
+		_area->removeObjectPosition(_areaPosition);
+
+	_area         = area;
+	_areaPosition = Common::PointGrid::kPointNone;
+
+	if (_area)
+		_areaPosition = _area->addObjectPosition(*this);
 }
 
 Location Object::getLocation() const {
@@ -168,6 +182,9 @@ void Object::setPosition(float x, float y, float z) {
 	_position[0] = x;
 	_position[1] = y;
 	_position[2] = z;
+
+	if (_area)
+		_area->moveObjectPosition(_areaPosition, x, y, z);
 }
 
 void Object::setOrientation(float x, float y, float z, float angle) {
@@ -30,6 +30,7 @@
 #include "src/common/types.h"
 #include "src/common/scopedptr.h"
 #include "src/common/ustring.h"
+#include "src/common/pointgrid.h"
 
 #include "src/aurora/nwscript/object.h"
 
@@ -180,6 +181,8 @@ protected:
 	Aurora::NWScript::Object *_pcSpeaker; ///< The current PC speaking with the object.
 
 	Area *_area; ///< The area the object is currently in.
+	/** The object's position in its area's index of object positions. */
+	Common::PointGrid::PointID _areaPosition;
 
 	float _position[3];    ///< The object's position.
 	float _orientation[4]; ///< The object's orientation.
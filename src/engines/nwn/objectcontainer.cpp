@@ -22,6 +22,8 @@
  *  A container of Neverwinter Nights objects.
  */
 
+#include <algorithm>
+
 #include "src/common/types.h"
 #include "src/common/util.h"
 
@@ -40,32 +42,6 @@ namespace Engines {
 
 namespace NWN {
 
-ObjectDistanceSort::ObjectDistanceSort(const NWN::Object &target) {
-	target.getPosition(xt, yt, zt);
-}
-
-bool ObjectDistanceSort::operator()(NWN::Object *a, NWN::Object *b) {
-	return getDistance(*a) < getDistance(*b);
-}
-
-float ObjectDistanceSort::getDistance(NWN::Object &a) {
-	float x, y, z;
-	a.getPosition(x, y, z);
-
-	return ABS(x - xt) + ABS(y - yt) + ABS(z - zt);
-}
-
-
-class SearchType : public ::Aurora::NWScript::SearchRange< std::list<NWN::Object *> > {
-public:
-	SearchType(const iterator &a, const iterator &b) : ::Aurora::NWScript::SearchRange<type>(std::make_pair(a, b)) { }
-	SearchType(const type &l) : ::Aurora::NWScript::SearchRange<type>(std::make_pair(l.begin(), l.end())) { }
-	~SearchType() { }
-
-	::Aurora::NWScript::Object *getObject(const iterator &t) { return *t; }
-};
-
-
 ObjectContainer::ObjectContainer() {
 }
 
@@ -95,7 +71,8 @@ void ObjectContainer::addObject(NWN::Object &object) {
 void ObjectContainer::removeObject(NWN::Object &object) {
 	lock();
 
-	_objects[object.getType()].remove(&object);
+	ObjectList &objects = _objects[object.getType()];
+	objects.erase(std::remove(objects.begin(), objects.end(), &object), objects.end());
 
 	::Aurora::NWScript::ObjectContainer::removeObject(object);
 
@@ -107,19 +84,15 @@ void ObjectContainer::removeObject(NWN::Object &object) {
 	if (l == _objects.end())
 		return 0;
 
-	SearchType ctx(l->second);
-
-	return ctx.get();
+	return l->second.empty() ? 0 : l->second.front();
 }
 
-::Aurora::NWScript::ObjectSearch *ObjectContainer::findObjectsByType(ObjectType type) const {
-	static const ObjectList kEmptyObjectList;
-
+::Aurora::NWScript::ObjectSearch ObjectContainer::findObjectsByType(ObjectType type) const {
 	ObjectMap::const_iterator l = _objects.find(type);
 	if (l == _objects.end())
-		return new SearchType(kEmptyObjectList.begin(), kEmptyObjectList.end());
+		return ::Aurora::NWScript::ObjectSearch();
 
-	return new SearchType(l->second);
+	return ::Aurora::NWScript::ObjectSearch(l->second);
 }
 
 NWN::Object *ObjectContainer::toObject(::Aurora::NWScript::Object *object) {
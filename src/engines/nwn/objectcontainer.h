@@ -25,7 +25,6 @@
 #ifndef ENGINES_NWN_OBJECTCONTAINER_H
 #define ENGINES_NWN_OBJECTCONTAINER_H
 
-#include <list>
 #include <map>
 
 #include "src/common/types.h"
@@ -48,19 +47,6 @@ class Door;
 class Creature;
 class Location;
 
-/** A class able to sort objects by distance to a target object. */
-class ObjectDistanceSort {
-public:
-	ObjectDistanceSort(const NWN::Object &target);
-
-	bool operator()(NWN::Object *a, NWN::Object *b);
-
-private:
-	float xt, yt, zt;
-
-	float getDistance(NWN::Object &a);
-};
-
 class ObjectContainer : public ::Aurora::NWScript::ObjectContainer {
 public:
 	ObjectContainer();
@@ -77,7 +63,7 @@ public:
 	::Aurora::NWScript::Object *getFirstObjectByType(ObjectType type) const;
 
 	/** Return a search context to iterate over all objects of this type. */
-	::Aurora::NWScript::ObjectSearch *findObjectsByType(ObjectType type) const;
+	::Aurora::NWScript::ObjectSearch findObjectsByType(ObjectType type) const;
 
 	static NWN::Object *toObject(::Aurora::NWScript::Object *object);
 
@@ -93,7 +79,7 @@ public:
 	static Location *toLocation(Aurora::NWScript::EngineType *engineType);
 
 private:
-	typedef std::list<NWN::Object *> ObjectList;
+	typedef ::Aurora::NWScript::ObjectSearch::ObjectList ObjectList;
 	typedef std::map<ObjectType, ObjectList> ObjectMap;
 
 	ObjectMap _objects;
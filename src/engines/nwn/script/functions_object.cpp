@@ -22,7 +22,8 @@
  *  Neverwinter Nights engine functions messing with objects.
  */
 
-#include "src/common/scopedptr.h"
+#include <vector>
+
 #include "src/common/util.h"
 
 #include "src/aurora/nwscript/functioncontext.h"
@@ -30,6 +31,7 @@
 #include "src/engines/nwn/types.h"
 #include "src/engines/nwn/game.h"
 #include "src/engines/nwn/module.h"
+#include "src/engines/nwn/area.h"
 #include "src/engines/nwn/objectcontainer.h"
 #include "src/engines/nwn/object.h"
 #include "src/engines/nwn/creature.h"
@@ -199,11 +201,11 @@ void Functions::getObjectByTag(Aurora::NWScript::FunctionContext &ctx) {
 
 	int nth = ctx.getParams()[1].getInt();
 
-	Common::ScopedPtr<Aurora::NWScript::ObjectSearch> search(_game->getModule().findObjectsByTag(tag));
+	Aurora::NWScript::ObjectSearch search(_game->getModule().findObjectsByTag(tag));
 	while (nth-- > 0)
-		search->next();
+		search.next();
 
-	ctx.getReturn() = search->get();
+	ctx.getReturn() = search.get();
 }
 
 void Functions::getWaypointByTag(Aurora::NWScript::FunctionContext &ctx) {
@@ -213,10 +215,10 @@ void Functions::getWaypointByTag(Aurora::NWScript::FunctionContext &ctx) {
 	if (tag.empty())
 		return;
 
-	Common::ScopedPtr<Aurora::NWScript::ObjectSearch> search(_game->getModule().findObjectsByTag(tag));
+	Aurora::NWScript::ObjectSearch search(_game->getModule().findObjectsByTag(tag));
 	Aurora::NWScript::Object *object = 0;
 
-	while ((object = search->next())) {
+	while ((object = search.next())) {
 		Waypoint *waypoint = NWN::ObjectContainer::toWaypoint(object);
 
 		if (waypoint) {
@@ -230,7 +232,7 @@ void Functions::getNearestObject(Aurora::NWScript::FunctionContext &ctx) {
 	ctx.getReturn() = (Aurora::NWScript::Object *) 0;
 
 	NWN::Object *target = NWN::ObjectContainer::toObject(getParamObject(ctx, 1));
-	if (!target)
+	if (!target || !target->getArea())
 		return;
 
 	// Bitfield of type(s) to check for
@@ -238,33 +240,11 @@ void Functions::getNearestObject(Aurora::NWScript::FunctionContext &ctx) {
 	// We want the nth nearest object
 	size_t nth  = MAX<int32>(ctx.getParams()[2].getInt() - 1, 0);
 
-	Common::ScopedPtr<Aurora::NWScript::ObjectSearch> search(_game->getModule().findObjects());
-	Aurora::NWScript::Object *object = 0;
-
-	std::list<Object *> objects;
-	while ((object = search->next())) {
-		// Needs to be a valid object, not the target, but in the target's area
-		NWN::Object *nwnObject = NWN::ObjectContainer::toObject(object);
-		if (!nwnObject || (nwnObject == target) || (nwnObject->getArea() != target->getArea()))
-			continue;
-
-		// Ignore invalid object types
-		const uint32 objectType = (uint32) nwnObject->getType();
-		if (objectType >= kObjectTypeMAX)
-			continue;
-
-		if (type & objectType)
-			objects.push_back(nwnObject);
-	}
-
-	objects.sort(ObjectDistanceSort(*target));
-
-	std::list<Object *>::iterator it = objects.begin();
-	for (size_t n = 0; (n < nth) && (it != objects.end()); ++n)
-		++it;
+	std::vector<Object *> objects;
+	target->getArea()->findNearestObjects(*target, nth + 1, type, "", objects);
 
-	if (it != objects.end())
-		ctx.getReturn() = *it;
+	if (nth < objects.size())
+		ctx.getReturn() = objects[nth];
 }
 
 void Functions::getNearestObjectByTag(Aurora::NWScript::FunctionContext &ctx) {
@@ -275,39 +255,23 @@ void Functions::getNearestObjectByTag(Aurora::NWScript::FunctionContext &ctx) {
 		return;
 
 	NWN::Object *target = NWN::ObjectContainer::toObject(getParamObject(ctx, 1));
-	if (!target)
+	if (!target || !target->getArea())
 		return;
 
 	size_t nth = MAX<int32>(ctx.getParams()[2].getInt() - 1, 0);
 
-	Common::ScopedPtr<Aurora::NWScript::ObjectSearch> search(_game->getModule().findObjectsByTag(tag));
-	Aurora::NWScript::Object *object = 0;
-
-	std::list<Object *> objects;
-	while ((object = search->next())) {
-		// Needs to be a valid object, not the target, but in the target's area
-		NWN::Object *nwnObject = NWN::ObjectContainer::toObject(object);
-		if (!nwnObject || (nwnObject == target) || (nwnObject->getArea() != target->getArea()))
-			continue;
+	std::vector<Object *> objects;
+	target->getArea()->findNearestObjects(*target, nth + 1, kObjectTypeAll, tag, objects);
 
-		objects.push_back(nwnObject);
-	}
-
-	objects.sort(ObjectDistanceSort(*target));
-
-	std::list<Object *>::iterator it = objects.begin();
-	for (size_t n = 0; (n < nth) && (it != objects.end()); ++n)
-		++it;
-
-	if (it != objects.end())
-		ctx.getReturn() = *it;
+	if (nth < objects.size())
+		ctx.getReturn() = objects[nth];
 }
 
 void Functions::getNearestCreature(Aurora::NWScript::FunctionContext &ctx) {
 	ctx.getReturn() = (Aurora::NWScript::Object *) 0;
 
 	NWN::Object *target = NWN::ObjectContainer::toObject(getParamObject(ctx, 2));
-	if (!target)
+	if (!target || !target->getArea())
 		return;
 
 	size_t nth = MAX<int32>(ctx.getParams()[3].getInt() - 1, 0);
@@ -322,25 +286,11 @@ void Functions::getNearestCreature(Aurora::NWScript::FunctionContext &ctx) {
 	 * int crit3Value = ctx.getParams()[7].getInt();
 	 */
 
-	Common::ScopedPtr<Aurora::NWScript::ObjectSearch> search(_game->getModule().findObjects());
-	Aurora::NWScript::Object *object = 0;
-
-	std::list<Object *> creatures;
-	while ((object = search->next())) {
-		Creature *creature = NWN::ObjectContainer::toCreature(object);
-
-		if (creature && (creature != target) && (creature->getArea() == target->getArea()))
-			creatures.push_back(creature);
-	}
-
-	creatures.sort(ObjectDistanceSort(*target));
-
-	std::list<Object *>::iterator it = creatures.begin();
-	for (size_t n = 0; (n < nth) && (it != creatures.end()); ++n)
-		++it;
+	std::vector<Object *> creatures;
+	target->getArea()->findNearestObjects(*target, nth + 1, kObjectTypeCreature, "", creatures);
 
-	if (it != creatures.end())
-		ctx.getReturn() = *it;
+	if (nth < creatures.size())
+		ctx.getReturn() = creatures[nth];
 }
 
 void Functions::playAnimation(Aurora::NWScript::FunctionContext &ctx) {
@@ -25,7 +25,6 @@
 #ifndef ENGINES_SONIC_OBJECTCONTAINER_H
 #define ENGINES_SONIC_OBJECTCONTAINER_H
 
-#include <list>
 #include <map>
 
 #include "src/common/types.h"
@@ -72,7 +71,7 @@ public:
 	::Aurora::NWScript::Object *getFirstObjectByType(ObjectType type) const;
 
 	/** Return a search context to iterate over all objects of this type. */
-	::Aurora::NWScript::ObjectSearch *findObjectsByType(ObjectType type) const;
+	::Aurora::NWScript::ObjectSearch findObjectsByType(ObjectType type) const;
 
 	static Sonic::Object *toObject(::Aurora::NWScript::Object *object);
 
@@ -81,7 +80,7 @@ public:
 	static Placeable *toPlaceable(Aurora::NWScript::Object *object);
 
 private:
-	typedef std::list<Sonic::Object *> ObjectList;
+	typedef ::Aurora::NWScript::ObjectSearch::ObjectList ObjectList;
 	typedef std::map<ObjectType, ObjectList> ObjectMap;
 
 	ObjectMap _objects;
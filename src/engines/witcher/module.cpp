@@ -22,7 +22,6 @@
  *  The context needed to run a The Witcher module.
  */
 
-#include "src/common/scopedptr.h"
 #include "src/common/util.h"
 #include "src/common/maths.h"
 #include "src/common/error.h"
@@ -216,11 +215,11 @@ bool Module::getObjectLocation(const Common::UString &object, Common::UString &a
 	if (object.empty())
 		return false;
 
-	Common::ScopedPtr<Aurora::NWScript::ObjectSearch> search(findObjectsByTag(object));
+	Aurora::NWScript::ObjectSearch search(findObjectsByTag(object));
 
 	Witcher::Object *witcherObject = 0;
-	while (!witcherObject && search->get()) {
-		witcherObject = Witcher::ObjectContainer::toObject(search->next());
+	while (!witcherObject && search.get()) {
+		witcherObject = Witcher::ObjectContainer::toObject(search.next());
 		if (!witcherObject || (witcherObject->getType() != kObjectTypeWaypoint))
 			witcherObject = 0;
 	}
@@ -25,7 +25,6 @@
 #ifndef ENGINES_WITCHER_OBJECTCONTAINER_H
 #define ENGINES_WITCHER_OBJECTCONTAINER_H
 
-#include <list>
 #include <map>
 
 #include "src/common/types.h"
@@ -77,7 +76,7 @@ public:
 	::Aurora::NWScript::Object *getFirstObjectByType(ObjectType type) const;
 
 	/** Return a search context to iterate over all objects of this type. */
-	::Aurora::NWScript::ObjectSearch *findObjectsByType(ObjectType type) const;
+	::Aurora::NWScript::ObjectSearch findObjectsByType(ObjectType type) const;
 
 	static Witcher::Object *toObject(::Aurora::NWScript::Object *object);
 
@@ -93,7 +92,7 @@ public:
 	static Location *toLocation(Aurora::NWScript::EngineType *engineType);
 
 private:
-	typedef std::list<Witcher::Object *> ObjectList;
+	typedef ::Aurora::NWScript::ObjectSearch::ObjectList ObjectList;
 	typedef std::map<ObjectType, ObjectList> ObjectMap;
 
 	ObjectMap _objects;
@@ -29,6 +29,8 @@
 
 #include "src/aurora/resman.h"
 
+#include "src/graphics/glypharrays.h"
+
 #include "src/graphics/aurora/textureman.h"
 #include "src/graphics/aurora/texture.h"
 #include "src/graphics/aurora/abcfont.h"
@@ -56,21 +58,18 @@ float ABCFont::getWidth(uint32 c) const {
 	return cC.spaceL + cC.width + cC.spaceR;
 }
 
-void ABCFont::draw(uint32 c) const {
-	TextureMan.set(_texture);
-
+void ABCFont::addGlyph(GlyphArrays &glyphs, uint32 c, float &x, float y) const {
 	const Char &cC = findChar(c);
 
-	glTranslatef(cC.spaceL, 0.0f, 0.0f);
+	x += cC.spaceL;
 
-	glBegin(GL_QUADS);
-	for (int i = 0; i < 4; i++) {
-		glTexCoord2f(cC.tX[i], cC.tY[i]);
-		glVertex2f  (cC.vX[i], cC.vY[i]);
-	}
-	glEnd();
+	glyphs.addQuad(0, x, y, cC.vX, cC.vY, cC.tX, cC.tY);
 
-	glTranslatef(cC.width + cC.spaceR, 0.0f, 0.0f);
+	x += cC.width + cC.spaceR;
+}
+
+void ABCFont::bindPage(size_t UNUSED(page)) const {
+	TextureMan.set(_texture);
 }
 
 void ABCFont::load(const Common::UString &name) {
@@ -51,7 +51,8 @@ public:
 	float getWidth (uint32 c) const;
 	float getHeight()         const;
 
-	void draw(uint32 c) const;
+	void addGlyph(GlyphArrays &glyphs, uint32 c, float &x, float y) const;
+	void bindPage(size_t page) const;
 
 private:
 	/** A font character. */
@@ -35,6 +35,7 @@
 #include "src/graphics/aurora/modelnode.h"
 #include "src/graphics/aurora/animation.h"
 #include "src/graphics/aurora/animnode.h"
+#include "src/graphics/aurora/skinning.h"
 
 using Common::kDebugGraphics;
 
@@ -235,16 +236,6 @@ void Animation::interpolateOrientation(ModelNode *animNode, ModelNode *target, f
 	target->setBufferedOrientation(x, y, z, Common::rad2deg(acos(q) * 2.0));
 }
 
-static void multiply(const float *v, const glm::mat4 &m, float *rv) {
-	rv[0]   = v[0] * m[0][0] + v[1] * m[1][0] + v[2] * m[2][0] + m[3][0];
-	rv[1]   = v[0] * m[0][1] + v[1] * m[1][1] + v[2] * m[2][1] + m[3][1];
-	rv[2]   = v[0] * m[0][2] + v[1] * m[1][2] + v[2] * m[2][2] + m[3][2];
-	float w = v[0] * m[0][3] + v[1] * m[1][3] + v[2] * m[2][3] + m[3][3];
-	rv[0] /= w;
-	rv[1] /= w;
-	rv[2] /= w;
-}
-
 void Animation::updateSkinnedModel(Model *model) {
 	const std::list<ModelNode *> &nodes = model->getNodes();
 	for (std::list<ModelNode *>::const_iterator it = nodes.begin(); it != nodes.end(); ++it) {
@@ -273,50 +264,40 @@ void Animation::updateSkinnedModel(Model *model) {
 
 		for (uint16 i = 0; i < skin->boneMappingCount; ++i) {
 			int index = static_cast<int>(skin->boneMapping[i]);
-			if (index != -1)
+			if ((index >= 0) && ((size_t) index < skin->boneNodeMap.size()) && skin->boneNodeMap[index])
 				skin->boneNodeMap[index]->computeAbsoluteTransform();
 		}
 
+		/* All these transformations are affine, so instead of running each vertex
+		 * through all of them for every bone it uses, combine them into a single
+		 * matrix per bone, once per frame. */
+
+		skin->boneMatrices.resize(skin->boneNodeMap.size());
+		for (size_t i = 0; i < skin->boneNodeMap.size(); ++i) {
+			const ModelNode *bone = skin->boneNodeMap[i];
+			if (!bone) {
+				skin->boneMatrices[i] = glm::mat4(0.0f);
+				continue;
+			}
+
+			skin->boneMatrices[i] = invTransform * bone->_absoluteTransform * bone->_invBindPose * transform;
+		}
+
 		// TODO: Use vertex shader
 
 		ModelNode::MeshData *meshData = node->_mesh->data;
 		uint32 vertexCount = meshData->vertexBuffer.getCount();
 
+		if ((meshData->initialVertexCoords.size() < 3 * vertexCount) ||
+		    (skin->boneWeights.size() < 4 * vertexCount) || (skin->boneMappingId.size() < 4 * vertexCount))
+			continue;
+
 		std::vector<float> &vcb = node->_vertexCoordsBuffer;
-		vcb.reserve(3 * vertexCount);
-		float *v = &vcb[0];
-
-		float *iv = &meshData->initialVertexCoords[0];
-		float *boneWeights = &skin->boneWeights[0];
-		float *boneMappingId = &skin->boneMappingId[0];
-
-		for (uint32 i = 0; i < vertexCount; ++i) {
-			v[0] = 0;
-			v[1] = 0;
-			v[2] = 0;
-			for (uint8 j = 0; j < 4; ++j) {
-				int index = static_cast<int>(boneMappingId[j]);
-				if (index != -1) {
-					float rv[3];
-					float tv[3];
-					const glm::mat4 &invBindPose = skin->boneNodeMap[index]->_invBindPose;
-					const glm::mat4 &boneTransform = skin->boneNodeMap[index]->_absoluteTransform;
-
-					multiply(iv, transform, rv);
-					multiply(rv, invBindPose, tv);
-					multiply(tv, boneTransform, rv);
-					multiply(rv, invTransform, tv);
-
-					v[0] += tv[0] * boneWeights[j];
-					v[1] += tv[1] * boneWeights[j];
-					v[2] += tv[2] * boneWeights[j];
-				}
-			}
-			v += 3;
-			iv += 3;
-			boneWeights += 4;
-			boneMappingId += 4;
-		}
+		vcb.resize(3 * vertexCount);
+
+		if (vertexCount > 0)
+			skinVertices(&meshData->initialVertexCoords[0], &skin->boneWeights[0], &skin->boneMappingId[0],
+			             skin->boneMatrices.empty() ? 0 : &skin->boneMatrices[0], vertexCount, &vcb[0]);
 
 		node->_vertexCoordsBuffered = true;
 	}
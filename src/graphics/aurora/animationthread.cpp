@@ -24,7 +24,9 @@
 
 #include "glm/gtc/type_ptr.hpp"
 
+#include "src/common/util.h"
 #include "src/common/threads.h"
+#include "src/common/threadpool.h"
 
 #include "src/events/events.h"
 
@@ -43,13 +45,33 @@ AnimationThread::PoolModel::PoolModel(Model *m)
 		  skippedCount(0) {
 }
 
+/** A job helping to update the models due in this iteration. */
+class AnimationThread::UpdateJob : public Common::ThreadPool::Job {
+public:
+	UpdateJob(AnimationThread &thread) : _thread(&thread) {
+	}
+
+	void run() {
+		_thread->runDueModels();
+	}
+
+private:
+	AnimationThread *_thread;
+};
+
+
 AnimationThread::AnimationThread()
-		: _paused(true),
+		: _nextModel(0),
+		  _modelsChanged(false),
+		  _paused(true),
 		  _flushing(false),
 		  _modelsSem(1),
 		  _registerSem(1) {
 }
 
+AnimationThread::~AnimationThread() {
+}
+
 void AnimationThread::pause() {
 	_paused.store(true);
 	_modelsSem.lock();
@@ -121,40 +143,87 @@ void AnimationThread::threadMethod() {
 			continue;
 		}
 
-		for (ModelList::iterator m = _models.begin();
-				m != _models.end();
-				++m) {
-			if (EventMan.quitRequested() || _paused.load())
-				break;
-
+		// Find the models that are due an update, skipping those far away from the camera more often
+		_dueModels.clear();
+		for (ModelList::iterator m = _models.begin(); m != _models.end(); ++m) {
 			if (m->skippedCount < getNumIterationsToSkip(m->model)) {
 				++m->skippedCount;
 				continue;
 			} else
 				m->skippedCount = 0;
 
-			if (_flushing.load()) {
-				_modelsSem.unlock();
-				while (_flushing.load()) // Spin until flushing is complete
-					;
-				_modelsSem.lock();
-			}
-
-			uint32 now = EventMan.getTimestamp();
-			float dt = 0;
-			if (m->lastChanged > 0)
-				dt = (now - m->lastChanged) / 1000.f;
-			m->lastChanged = now;
-
-			m->model->manageAnimations(dt);
+			_dueModels.push_back(&*m);
 		}
 
+		updateDueModels();
+
 		_modelsSem.unlock();
 
 		EventMan.delay(10);
 	}
 }
 
+void AnimationThread::updateDueModels() {
+	_nextModel.store(0);
+	_modelsChanged = false;
+
+	while (_nextModel.load() < _dueModels.size()) {
+		if (EventMan.quitRequested() || _paused.load())
+			break;
+
+		if (_flushing.load()) {
+			_modelsSem.unlock();
+			while (_flushing.load()) // Spin until flushing is complete
+				;
+			_modelsSem.lock();
+
+			// Models might have been removed in the meantime, leaving us with dangling pointers
+			if (_modelsChanged)
+				break;
+
+			continue;
+		}
+
+		// Let the helper threads join in, if there's more than one model left to update
+		const size_t modelsLeft = _dueModels.size() - _nextModel.load();
+		if (modelsLeft > 1) {
+			if (!_pool)
+				_pool.reset(new Common::ThreadPool(0, "AnimationHelper"));
+
+			const size_t helperCount = MIN<size_t>(_pool->getThreadCount(), modelsLeft - 1);
+			for (size_t i = 0; i < helperCount; i++)
+				_pool->addJob(new UpdateJob(*this));
+		}
+
+		runDueModels();
+
+		if (_pool)
+			_pool->wait();
+	}
+
+	_dueModels.clear();
+}
+
+void AnimationThread::runDueModels() {
+	while (!_flushing.load() && !_paused.load() && !EventMan.quitRequested()) {
+		const size_t index = _nextModel.fetch_add(1);
+		if (index >= _dueModels.size())
+			break;
+
+		updateModel(*_dueModels[index]);
+	}
+}
+
+void AnimationThread::updateModel(PoolModel &model) {
+	uint32 now = EventMan.getTimestamp();
+	float dt = 0;
+	if (model.lastChanged > 0)
+		dt = (now - model.lastChanged) / 1000.f;
+	model.lastChanged = now;
+
+	model.model->manageAnimations(dt);
+}
+
 void AnimationThread::registerModelInternal(Model *model) {
 	for (ModelList::iterator m = _models.begin(); m != _models.end(); ++m) {
 		if (m->model == model)
@@ -169,8 +238,10 @@ void AnimationThread::unregisterModelInternal(Model *model) {
 		if (m->model == model)
 			break;
 	}
-	if (m != _models.end())
+	if (m != _models.end()) {
 		_models.erase(m);
+		_modelsChanged = true;
+	}
 }
 
 uint8 AnimationThread::getNumIterationsToSkip(Model *model) const {
@@ -25,25 +25,39 @@
 #ifndef GRAPHICS_AURORA_ANIMATIONTHREAD_H
 #define GRAPHICS_AURORA_ANIMATIONTHREAD_H
 
+#include <list>
 #include <queue>
+#include <vector>
 
 #include <boost/atomic.hpp>
 
 #include "glm/vec3.hpp"
 #include "glm/vec4.hpp"
 
+#include "src/common/scopedptr.h"
 #include "src/common/mutex.h"
 #include "src/common/thread.h"
 
+namespace Common {
+	class ThreadPool;
+}
+
 namespace Graphics {
 
 namespace Aurora {
 
 class Model;
 
+/** The thread advancing the animations of all visible models.
+ *
+ *  The models that are due an update in an iteration are handed out one by
+ *  one to this thread and a pool of helper threads, so that the animations
+ *  of many models are computed in parallel.
+ */
 class AnimationThread : public Common::Thread {
 public:
 	AnimationThread();
+	~AnimationThread();
 	void pause();
 	void resume();
 
@@ -64,12 +78,21 @@ private:
 		PoolModel(Model *m);
 	};
 
+	class UpdateJob;
+
 	typedef std::list<PoolModel> ModelList;
 	typedef std::queue<Model *> ModelQueue;
+	typedef std::vector<PoolModel *> DueModels;
 
 	ModelList _models;
 	ModelQueue _registerQueue;
 
+	DueModels _dueModels;               ///< The models to update in the current iteration.
+	boost::atomic<size_t> _nextModel;   ///< Index of the next model in _dueModels to update.
+	bool _modelsChanged;                ///< Was a model unregistered while we released _modelsSem?
+
+	Common::ScopedPtr<Common::ThreadPool> _pool; ///< The helper threads.
+
 	boost::atomic<bool> _paused;
 	boost::atomic<bool> _flushing;
 
@@ -77,6 +100,14 @@ private:
 	Common::Semaphore _registerSem; ///< Semaphore protecting access to the registration queue.
 
 	void threadMethod();
+
+	/** Update all models in _dueModels, in parallel. */
+	void updateDueModels();
+	/** Update models from _dueModels until none are left, or until we're paused or flushing. */
+	void runDueModels();
+	/** Advance the animations of this model. */
+	void updateModel(PoolModel &model);
+
 	void registerModelInternal(Model *model);
 	void unregisterModelInternal(Model *model);
 	uint8 getNumIterationsToSkip(Model *model) const;
@@ -34,7 +34,7 @@ namespace Graphics {
 
 namespace Aurora {
 
-FPS::FPS(const FontHandle &font) : Text(font, WindowMan.getWindowWidth(), WindowMan.getWindowHeight(), "0 fps"), _fps(0) {
+FPS::FPS(const FontHandle &font) : Text(font, WindowMan.getWindowWidth(), WindowMan.getWindowHeight(), "0 fps"), _fps(0), _drawn(0), _culled(0) {
 	init();
 }
 
@@ -54,10 +54,18 @@ void FPS::render(RenderPass pass) {
 
 	uint32 fps = GfxMan.getFPS();
 
-	if (fps != _fps) {
-		_fps = fps;
+	uint32 drawn, culled;
+	GfxMan.getWorldObjectCounts(drawn, culled);
 
-		setText(Common::UString::format("%d fps", _fps));
+	if ((fps != _fps) || (drawn != _drawn) || (culled != _culled)) {
+		_fps    = fps;
+		_drawn  = drawn;
+		_culled = culled;
+
+		if ((_drawn + _culled) > 0)
+			setText(Common::UString::format("%d fps, %u drawn, %u culled", _fps, (uint) _drawn, (uint) _culled));
+		else
+			setText(Common::UString::format("%d fps", _fps));
 	}
 
 	Text::render(pass);
@@ -36,6 +36,7 @@ STOP_IGNORE_IMPLICIT_FALLTHROUGH
 
 #include "src/common/readstream.h"
 #include "src/common/debug.h"
+#include "src/common/frustum.h"
 
 #include "src/graphics/camera.h"
 
@@ -57,7 +58,8 @@ namespace Aurora {
 
 Model::Model(ModelType type) : Renderable((RenderableType) type),
 	_type(type), _superModel(0), _currentState(0),
-	_currentAnimation(0), _nextAnimation(0), _skinned(false), _drawBound(false),
+	_currentAnimation(0), _nextAnimation(0), _pickProxy(Common::AABBTree::kProxyNone),
+	_skinned(false), _drawBound(false),
 	_drawSkeleton(false), _drawSkeletonInvisible(false) {
 
 	_scale   [0] = 1.0f; _scale   [1] = 1.0f; _scale   [2] = 1.0f;
@@ -105,11 +107,39 @@ Model::~Model() {
 void Model::show() {
 	Renderable::show();
 	GfxMan.registerAnimatedModel(this);
+
+	updatePickable();
 }
 
 void Model::hide() {
+	// Stop the animation thread from updating the model and make it invisible
+	// first, so that nothing can add it back to the pickable objects afterwards
 	GfxMan.unregisterAnimatedModel(this);
 	Renderable::hide();
+
+	updatePickable();
+}
+
+void Model::updatePickable() {
+	// Check and update the model's entry in one go, in case the
+	// model is moved by the animation thread and hidden at the same time
+	GfxMan.lockPickables();
+
+	// Only visible world objects can be picked
+	const bool pickable = (_type == kModelTypeObject) && !_absoluteBoundBox.empty() && isVisible();
+
+	if (!pickable) {
+		if (_pickProxy != Common::AABBTree::kProxyNone)
+			GfxMan.removePickable(_pickProxy);
+
+		_pickProxy = Common::AABBTree::kProxyNone;
+
+	} else if (_pickProxy == Common::AABBTree::kProxyNone)
+		_pickProxy = GfxMan.addPickable(*this, _absoluteBoundBox);
+	else
+		GfxMan.movePickable(_pickProxy, _absoluteBoundBox);
+
+	GfxMan.unlockPickables();
 }
 
 ModelType Model::getType() const {
@@ -153,6 +183,24 @@ bool Model::isIn(float x1, float y1, float z1, float x2, float y2, float z2) con
 	return _absoluteBoundBox.isIn(x1, y1, z1, x2, y2, z2);
 }
 
+bool Model::isIn(float x1, float y1, float z1, float x2, float y2, float z2, float &distance) const {
+	if (_type == kModelTypeGUIFront)
+		return false;
+
+	return _absoluteBoundBox.isIn(x1, y1, z1, x2, y2, z2, distance);
+}
+
+bool Model::isInFrustum(const Common::Frustum &frustum) const {
+	// Without a bounding box, we can't know. Better draw it
+	if ((_type == kModelTypeGUIFront) || _absoluteBoundBox.empty())
+		return true;
+
+	if (_drawDistance > 0.0f)
+		return frustum.isIn(_absoluteBoundBox, _drawDistance);
+
+	return frustum.isIn(_absoluteBoundBox);
+}
+
 float Model::getWidth() const {
 	return _boundBox.getWidth() * _scale[0];
 }
@@ -437,6 +485,8 @@ void Model::createAbsolutePosition() {
 	_absoluteBoundBox = _boundBox;
 	_absoluteBoundBox.transform(_absolutePosition);
 	_absoluteBoundBox.absolutize();
+
+	updatePickable();
 }
 
 const std::list<Common::UString> &Model::getStates() const {
@@ -891,6 +941,12 @@ void Model::doDestroy() {
 }
 
 void Model::finalize() {
+	/* The loaders only requested the textures, to be decoded in the background.
+	 * Now wait for them and evaluate them, for all nodes in one go. */
+	for (StateList::iterator s = _stateList.begin(); s != _stateList.end(); ++s)
+		for (NodeList::iterator n = (*s)->nodeList.begin(); n != (*s)->nodeList.end(); ++n)
+			(*n)->finalizeTextures();
+
 	_currentState = 0;
 
 	createStateNamesList();
@@ -957,6 +1013,8 @@ void Model::createBound() {
 	_absoluteBoundBox = _boundBox;
 	_absoluteBoundBox.transform(_absolutePosition);
 	_absoluteBoundBox.absolutize();
+
+	updatePickable();
 }
 
 void Model::readValue(Common::SeekableReadStream &stream, uint32 &value) {
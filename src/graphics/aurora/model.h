@@ -33,6 +33,7 @@
 
 #include "src/common/ustring.h"
 #include "src/common/boundingbox.h"
+#include "src/common/aabbtree.h"
 
 #include "src/graphics/types.h"
 #include "src/graphics/glcontainer.h"
@@ -88,6 +89,9 @@ public:
 	bool isIn(float x, float y, float z) const;
 	/** Does the line from x1.y1.z1 to x2.y2.z2 intersect with model's bounding box? */
 	bool isIn(float x1, float y1, float z1, float x2, float y2, float z2) const;
+	bool isIn(float x1, float y1, float z1, float x2, float y2, float z2, float &distance) const;
+
+	bool isInFrustum(const Common::Frustum &frustum) const;
 
 
 	// Positioning
@@ -263,6 +267,8 @@ protected:
 	Common::BoundingBox _boundBox;
 	/** The model's box after translate/rotate. */
 	Common::BoundingBox _absoluteBoundBox;
+	/** The model's entry in the graphics manager's pickable world objects. */
+	Common::AABBTree::ProxyID _pickProxy;
 
 	bool _skinned;
 
@@ -311,6 +317,9 @@ private:
 
 	void createAbsolutePosition();
 
+	/** Add, update or remove the model in the graphics manager's pickable world objects. */
+	void updatePickable();
+
 	void manageAnimations(float dt);
 
 	Animation *selectDefaultAnimation() const;
@@ -386,10 +386,10 @@ void Model_KotOR::makeBoneNodeMap() {
 		ModelNode::Mesh *mesh = node->getMesh();
 		if (mesh && mesh->skin) {
 			ModelNode::Skin *skin = mesh->skin;
-			skin->boneNodeMap.reserve(skin->boneMappingCount);
+			skin->boneNodeMap.resize(skin->boneMappingCount, 0);
 			for (uint16 i = 0; i < skin->boneMappingCount; ++i) {
 				int index = static_cast<int>(skin->boneMapping[i]);
-				if (index != -1) {
+				if ((index >= 0) && ((size_t) index < skin->boneNodeMap.size())) {
 					ModelNode *node2 = getNode(i);
 					node2->computeInverseBindPose();
 					skin->boneNodeMap[index] = node2;
@@ -798,7 +798,10 @@ void ModelNode_KotOR::readSkin(Model_KotOR::ParserContext &ctx) {
 	ctx.mdl->seek(pos);
 
 	std::vector<float> &boneWeights = _mesh->skin->boneWeights;
-	std::vector<float> &boneMappingId = _mesh->skin->boneMappingId;
+	std::vector<int16> &boneMappingId = _mesh->skin->boneMappingId;
+
+	boneWeights.reserve(4 * ctx.vertexCount);
+	boneMappingId.reserve(4 * ctx.vertexCount);
 
 	for (int i = 0; i < ctx.vertexCount; i++) {
 		// Bone weights
@@ -808,12 +811,13 @@ void ModelNode_KotOR::readSkin(Model_KotOR::ParserContext &ctx) {
 		boneWeights.push_back(ctx.mdx->readIEEEFloatLE());
 		boneWeights.push_back(ctx.mdx->readIEEEFloatLE());
 
-		// Bone mapping identifiers
+		// Bone mapping identifiers, stored as floats
 		ctx.mdx->seek(ctx.offNodeData + i * ctx.mdxStructSize + mdxOffsetBoneMappingId);
-		boneMappingId.push_back(ctx.mdx->readIEEEFloatLE());
-		boneMappingId.push_back(ctx.mdx->readIEEEFloatLE());
-		boneMappingId.push_back(ctx.mdx->readIEEEFloatLE());
-		boneMappingId.push_back(ctx.mdx->readIEEEFloatLE());
+		for (int j = 0; j < 4; j++) {
+			const int id = static_cast<int>(ctx.mdx->readIEEEFloatLE());
+
+			boneMappingId.push_back(((id >= 0) && ((uint32) id < boneMappingCount)) ? id : -1);
+		}
 	}
 }
 
@@ -73,6 +73,7 @@ ModelNode::ModelNode(Model &model)
 		  _level(0),
 		  _render(false),
 		  _mesh(0),
+		  _texturesPending(false),
 		  _nodeNumber(0),
 		  _positionBuffered(false),
 		  _orientationBuffered(false),
@@ -287,10 +288,11 @@ void ModelNode::setTextures(const std::vector<Common::UString> &textures) {
 
 	lockFrameIfVisible();
 
-	// NOTE: loadTextures() will automatically disable rendering of the node
+	// NOTE: finalizeTextures() will automatically disable rendering of the node
 	//       again when texture loading fails.
 	_render = true;
 	loadTextures(textures);
+	finalizeTextures();
 
 	unlockFrameIfVisible();
 }
@@ -300,44 +302,72 @@ ModelNode::Mesh *ModelNode::getMesh() const {
 }
 
 void ModelNode::loadTextures(const std::vector<Common::UString> &textures) {
-	bool hasTexture = false;
-
+	_mesh->data->textures.clear();
 	_mesh->data->textures.resize(textures.size());
 
+	for (size_t t = 0; t != textures.size(); t++) {
+
+		try {
+
+			if (!textures[t].empty() && (textures[t] != "NULL"))
+				_mesh->data->textures[t] = TextureMan.get(textures[t]);
+
+		} catch (...) {
+			Common::exceptionDispatcherWarning();
+		}
+
+	}
+
+	_texturesPending = true;
+}
+
+void ModelNode::finalizeTextures() {
+	if (!_texturesPending || !_mesh || !_mesh->data)
+		return;
+
+	_texturesPending = false;
+
+	bool hasTexture = false;
+
 	bool hasAlpha = true;
 	bool isDecal  = true;
 
 	Common::UString envMap;
 
-	for (size_t t = 0; t != textures.size(); t++) {
+	for (size_t t = 0; t != _mesh->data->textures.size(); t++) {
+		if (_mesh->data->textures[t].empty())
+			continue;
 
 		try {
+			const Texture &texture = _mesh->data->textures[t].getTexture();
 
-			if (!textures[t].empty() && (textures[t] != "NULL")) {
-				_mesh->data->textures[t] = TextureMan.get(textures[t]);
-				if (_mesh->data->textures[t].empty())
-					continue;
+			// This waits for the image to be decoded
+			const bool textureHasAlpha = texture.hasAlpha();
 
-				hasTexture = true;
+			// Treat a texture whose image couldn't be decoded like no texture at all
+			if (texture.hasFailed()) {
+				_mesh->data->textures[t].clear();
+				continue;
+			}
 
-				if (!_mesh->data->textures[t].getTexture().hasAlpha())
-					hasAlpha = false;
-				if (_mesh->data->textures[t].getTexture().getTXI().getFeatures().alphaMean == 1.0f)
-					hasAlpha = false;
+			hasTexture = true;
 
-				if (!_mesh->data->textures[t].getTexture().getTXI().getFeatures().decal)
-					isDecal = false;
+			if (!textureHasAlpha)
+				hasAlpha = false;
+			if (texture.getTXI().getFeatures().alphaMean == 1.0f)
+				hasAlpha = false;
 
-				if (!_mesh->data->textures[t].getTexture().getTXI().getFeatures().bumpyShinyTexture.empty())
-					envMap = _mesh->data->textures[t].getTexture().getTXI().getFeatures().bumpyShinyTexture;
-				if (!_mesh->data->textures[t].getTexture().getTXI().getFeatures().envMapTexture.empty())
-					envMap = _mesh->data->textures[t].getTexture().getTXI().getFeatures().envMapTexture;
-			}
+			if (!texture.getTXI().getFeatures().decal)
+				isDecal = false;
+
+			if (!texture.getTXI().getFeatures().bumpyShinyTexture.empty())
+				envMap = texture.getTXI().getFeatures().bumpyShinyTexture;
+			if (!texture.getTXI().getFeatures().envMapTexture.empty())
+				envMap = texture.getTXI().getFeatures().envMapTexture;
 
 		} catch (...) {
 			Common::exceptionDispatcherWarning();
 		}
-
 	}
 
 	envMap.trim();
@@ -137,10 +137,14 @@ public:
 	struct Skin {
 		std::vector<float>       boneMapping;
 		uint32                   boneMappingCount;
-		std::vector<float>       boneWeights;
-		std::vector<float>       boneMappingId;
+		std::vector<float>       boneWeights;   ///< 4 bone weights per vertex.
+		std::vector<int16>       boneMappingId; ///< 4 bone indices per vertex, -1 for none.
 		std::vector<ModelNode *> boneNodeMap;
 
+		/** The per-frame skinning matrix of each bone, transforming
+		 *  straight from the initial vertex coordinates. */
+		std::vector<glm::mat4> boneMatrices;
+
 		Skin();
 	};
 
@@ -218,6 +222,8 @@ protected:
 
 	Mesh *_mesh;
 
+	bool _texturesPending; ///< Were textures loaded, but not yet evaluated?
+
 	Common::BoundingBox _boundBox;
 	Common::BoundingBox _absoluteBoundBox;
 
@@ -237,7 +243,15 @@ protected:
 
 
 	// Loading helpers
+	/** Request these textures. Their properties are looked at later, by finalizeTextures(). */
 	void loadTextures(const std::vector<Common::UString> &textures);
+	/** Evaluate the properties of the textures requested by loadTextures().
+	 *
+	 *  This has to wait for the textures' images to be decoded. Model::finalize()
+	 *  does this for all nodes at once, so that all textures of a model are
+	 *  decoded in parallel. Textures whose images failed to decode are dropped.
+	 */
+	void finalizeTextures();
 	void createBound();
 	void createCenter();
 
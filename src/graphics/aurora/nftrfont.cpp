@@ -62,6 +62,8 @@
 
 #include "src/aurora/resman.h"
 
+#include "src/graphics/glypharrays.h"
+
 #include "src/graphics/images/surface.h"
 
 #include "src/graphics/aurora/nftrfont.h"
@@ -373,38 +375,33 @@ float NFTRFont::getHeight() const {
 	return _height;
 }
 
-void NFTRFont::drawMissing() const {
-	TextureMan.set();
-
+void NFTRFont::addMissing(GlyphArrays &glyphs, float &x, float y) const {
 	const float width = _missingWidth - 1.0f;
 
-	glBegin(GL_QUADS);
-		glVertex2f(0.0f ,    0.0f);
-		glVertex2f(width,    0.0f);
-		glVertex2f(width, _height);
-		glVertex2f(0.0f , _height);
-	glEnd();
+	glyphs.addRect(x, y, width, _height);
 
-	glTranslatef(width + 1.0f, 0.0f, 0.0f);
+	x += width + 1.0f;
 }
 
-void NFTRFont::draw(uint32 c) const {
+void NFTRFont::addGlyph(GlyphArrays &glyphs, uint32 c, float &x, float y) const {
 	std::map<uint32, Char>::const_iterator cC = _chars.find(c);
 	if (cC == _chars.end()) {
-		drawMissing();
+		addMissing(glyphs, x, y);
 		return;
 	}
 
-	TextureMan.set(_texture);
+	glyphs.addQuad(0, x, y, cC->second.vX, cC->second.vY, cC->second.tX, cC->second.tY);
 
-	glBegin(GL_QUADS);
-	for (int i = 0; i < 4; i++) {
-		glTexCoord2f(cC->second.tX[i], cC->second.tY[i]);
-		glVertex2f  (cC->second.vX[i], cC->second.vY[i]);
+	x += cC->second.width;
+}
+
+void NFTRFont::bindPage(size_t page) const {
+	if (page == GlyphArrays::kPageUntextured) {
+		TextureMan.set();
+		return;
 	}
-	glEnd();
 
-	glTranslatef(cC->second.width, 0.0f, 0.0f);
+	TextureMan.set(_texture);
 }
 
 void NFTRFont::drawGlyphs(const std::vector<Glyph> &glyphs) {
@@ -51,7 +51,8 @@ public:
 	float getWidth (uint32 c) const;
 	float getHeight()         const;
 
-	void draw(uint32 c) const;
+	void addGlyph(GlyphArrays &glyphs, uint32 c, float &x, float y) const;
+	void bindPage(size_t page) const;
 
 private:
 	struct Header {
@@ -115,7 +116,7 @@ private:
 	void drawGlyphs(const std::vector<Glyph> &glyphs);
 	void drawGlyph(const Glyph &glyph, Surface &surface, uint32 x, uint32 y);
 
-	void drawMissing() const;
+	void addMissing(GlyphArrays &glyphs, float &x, float y) const;
 
 	static uint32 convertToUTF32(uint16 codePoint, uint8 encoding);
 };
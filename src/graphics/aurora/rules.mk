@@ -48,6 +48,7 @@ src_graphics_aurora_libaurora_la_SOURCES += \
     src/graphics/aurora/model.h \
     src/graphics/aurora/animnode.h \
     src/graphics/aurora/animation.h \
+    src/graphics/aurora/skinning.h \
     src/graphics/aurora/fadequad.h \
     src/graphics/aurora/borderquad.h \
     src/graphics/aurora/subscenequad.h \
@@ -87,6 +88,7 @@ src_graphics_aurora_libaurora_la_SOURCES += \
     src/graphics/aurora/model.cpp \
     src/graphics/aurora/animnode.cpp \
     src/graphics/aurora/animation.cpp \
+    src/graphics/aurora/skinning.cpp \
     src/graphics/aurora/fadequad.cpp \
     src/graphics/aurora/borderquad.cpp \
     src/graphics/aurora/subscenequad.cpp \
@@ -0,0 +1,103 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Skinning vertices by the matrices of their bones.
+ */
+
+#include "glm/gtc/type_ptr.hpp"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 1))
+	#define XOREOS_SKINNING_SSE 1
+	#include <xmmintrin.h>
+#endif
+
+#include "src/graphics/aurora/skinning.h"
+
+namespace Graphics {
+
+namespace Aurora {
+
+void skinVerticesScalar(const float *iv, const float *boneWeights, const int16 *boneIds,
+                        const glm::mat4 *boneMatrices, uint32 vertexCount, float *v) {
+
+	for (uint32 i = 0; i < vertexCount; ++i, iv += 3, v += 3, boneWeights += 4, boneIds += 4) {
+		v[0] = 0.0f;
+		v[1] = 0.0f;
+		v[2] = 0.0f;
+
+		for (size_t j = 0; j < 4; ++j) {
+			if (boneIds[j] < 0)
+				continue;
+
+			const glm::mat4 &m = boneMatrices[boneIds[j]];
+			const float      w = boneWeights[j];
+
+			v[0] += (iv[0] * m[0][0] + iv[1] * m[1][0] + iv[2] * m[2][0] + m[3][0]) * w;
+			v[1] += (iv[0] * m[0][1] + iv[1] * m[1][1] + iv[2] * m[2][1] + m[3][1]) * w;
+			v[2] += (iv[0] * m[0][2] + iv[1] * m[1][2] + iv[2] * m[2][2] + m[3][2]) * w;
+		}
+	}
+}
+
+void skinVertices(const float *iv, const float *boneWeights, const int16 *boneIds,
+                  const glm::mat4 *boneMatrices, uint32 vertexCount, float *v) {
+
+#ifdef XOREOS_SKINNING_SSE
+	/* Each column of the matrix is one SSE register, so a vertex is
+	 * transformed with 3 multiply-adds and then weighted with one more. */
+
+	for (uint32 i = 0; i < vertexCount; ++i, iv += 3, v += 3, boneWeights += 4, boneIds += 4) {
+		const __m128 x = _mm_set1_ps(iv[0]);
+		const __m128 y = _mm_set1_ps(iv[1]);
+		const __m128 z = _mm_set1_ps(iv[2]);
+
+		__m128 sum = _mm_setzero_ps();
+
+		for (size_t j = 0; j < 4; ++j) {
+			if (boneIds[j] < 0)
+				continue;
+
+			const float *m = glm::value_ptr(boneMatrices[boneIds[j]]);
+
+			const __m128 xy  = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(m + 0), x), _mm_mul_ps(_mm_loadu_ps(m + 4), y));
+			const __m128 zw  = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(m + 8), z), _mm_loadu_ps(m + 12));
+			const __m128 xyz = _mm_add_ps(xy, zw);
+
+			sum = _mm_add_ps(sum, _mm_mul_ps(xyz, _mm_set1_ps(boneWeights[j])));
+		}
+
+		float result[4];
+		_mm_storeu_ps(result, sum);
+
+		v[0] = result[0];
+		v[1] = result[1];
+		v[2] = result[2];
+	}
+
+#else
+	skinVerticesScalar(iv, boneWeights, boneIds, boneMatrices, vertexCount, v);
+#endif
+
+}
+
+} // End of namespace Aurora
+
+} // End of namespace Graphics
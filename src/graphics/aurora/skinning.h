@@ -0,0 +1,62 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Skinning vertices by the matrices of their bones.
+ */
+
+#ifndef GRAPHICS_AURORA_SKINNING_H
+#define GRAPHICS_AURORA_SKINNING_H
+
+#include "glm/mat4x4.hpp"
+
+#include "src/common/types.h"
+
+namespace Graphics {
+
+namespace Aurora {
+
+/** Skin the vertices: transform each by up to 4 bone matrices and blend the results by the bone weights.
+ *
+ *  Uses SSE, if the compiler supports it.
+ *
+ *  @param iv           The initial vertex coordinates, 3 floats per vertex.
+ *  @param boneWeights  The bone weights, 4 per vertex.
+ *  @param boneIds      The bone indices into boneMatrices, 4 per vertex. Negative means none.
+ *  @param boneMatrices The skinning matrix of each bone.
+ *  @param vertexCount  The number of vertices to skin.
+ *  @param v            The skinned vertex coordinates are written here, 3 floats per vertex.
+ */
+void skinVertices(const float *iv, const float *boneWeights, const int16 *boneIds,
+                  const glm::mat4 *boneMatrices, uint32 vertexCount, float *v);
+
+/** Skin the vertices like skinVertices(), but never use SSE.
+ *
+ *  This is what skinVertices() falls back to without SSE. It's always built,
+ *  so that the SSE path can be checked against it.
+ */
+void skinVerticesScalar(const float *iv, const float *boneWeights, const int16 *boneIds,
+                        const glm::mat4 *boneMatrices, uint32 vertexCount, float *v);
+
+} // End of namespace Aurora
+
+} // End of namespace Graphics
+
+#endif // GRAPHICS_AURORA_SKINNING_H
@@ -22,6 +22,8 @@
  *  A text object.
  */
 
+#include <cassert>
+
 #include "src/events/requests.h"
 
 #include "src/graphics/font.h"
@@ -37,7 +39,7 @@ Text::Text(const FontHandle &font, const Common::UString &str,
 		float r, float g, float b, float a, float halign, float valign) :
 	Graphics::GUIElement(Graphics::GUIElement::kGUIElementFront),
 	_r(r), _g(g), _b(b), _a(a), _font(font), _x(0.0f), _y(0.0f), _halign(halign),_valign(valign),
-	_disableColorTokens(false) {
+	_disableColorTokens(false), _needLayout(true) {
 
 	set(str);
 
@@ -48,7 +50,7 @@ Text::Text(const FontHandle &font, float w, float h, const Common::UString &str,
 		float r, float g, float b, float a, float halign, float valign) :
 	Graphics::GUIElement(Graphics::GUIElement::kGUIElementFront), _r(r), _g(g), _b(b), _a(a),
 	_font(font), _x(0.0f), _y(0.0f), _halign(halign),_valign(valign),
-	_disableColorTokens(false) {
+	_disableColorTokens(false), _needLayout(true) {
 
 	_width = roundf(w);
 	_height = roundf(h);
@@ -62,7 +64,7 @@ Text::Text(Graphics::GUIElement::GUIElementType type, const FontHandle &font, fl
 		float r, float g, float b, float a, float halign, float valign) :
 	Graphics::GUIElement(type), _r(r), _g(g), _b(b), _a(a),
 	_font(font), _x(0.0f), _y(0.0f), _halign(halign),_valign(valign),
-	_disableColorTokens(false) {
+	_disableColorTokens(false), _needLayout(true) {
 
 	_width = roundf(w);
 	_height = roundf(h);
@@ -92,6 +94,8 @@ void Text::set(const Common::UString &str, float maxWidth, float maxHeight) {
 
 	font.buildChars(str);
 
+	_needLayout = true;
+
 	_lineCount = font.getLineCount(_str, maxWidth, maxHeight);
 
 	_height = font.getHeight(_str, maxWidth, maxHeight);
@@ -112,6 +116,8 @@ void Text::setText(const Common::UString &str) {
 
 	font.buildChars(str);
 
+	_needLayout = true;
+
 	_lineCount = font.getLineCount(_str, _width, _height);
 
 	unlockFrameIfVisible();
@@ -144,7 +150,13 @@ float Text::getHorizontalAlign() const {
 }
 
 void Text::setHorizontalAlign(float halign) {
+	lockFrameIfVisible();
+
 	_halign = halign;
+
+	_needLayout = true;
+
+	unlockFrameIfVisible();
 }
 
 float Text::getVerticalAlign() const {
@@ -152,7 +164,13 @@ float Text::getVerticalAlign() const {
 }
 
 void Text::setVerticalAlign(float valign) {
+	lockFrameIfVisible();
+
 	_valign = valign;
+
+	_needLayout = true;
+
+	unlockFrameIfVisible();
 }
 
 const Common::UString &Text::get() const {
@@ -189,6 +207,8 @@ void Text::setSize(float width, float height) {
 
 	_lineCount = _font.getFont().getLineCount(_str, _width, _height);
 
+	_needLayout = true;
+
 	unlockFrameIfVisible();
 }
 
@@ -221,41 +241,39 @@ void Text::render(RenderPass pass) {
 		return;
 
 	Font &font = _font.getFont();
-	float lineHeight = font.getHeight() + font.getLineSpacing();
-
-	glTranslatef(_x, _y, 0.0f);
-
-	glColor4f(_r, _g, _b, _a);
 
-	std::vector<Common::UString> lines;
-	font.split(_str, lines, _width, _height, false);
+	if (_needLayout) {
+		font.buildGlyphs(_glyphs, _str, _colors, _width, _height, _halign, _valign);
 
-	float blockSize = lines.size() * lineHeight;
-
-	// Move position to the top
-	glTranslatef(0.0f, roundf(((_height - blockSize) * _valign) + blockSize - lineHeight), 0.0f);
+		_needLayout = false;
+	}
 
-	size_t position = 0;
+	if (_glyphs.empty())
+		return;
 
-	ColorPositions::const_iterator color = _colors.begin();
+	glTranslatef(_x, _y, 0.0f);
 
-	// Draw lines
-	for (std::vector<Common::UString>::iterator l = lines.begin(); l != lines.end(); ++l) {
-		// Save the current position
-		glPushMatrix();
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glVertexPointer(2, GL_FLOAT, 0, &_glyphs.getVertices()[0]);
 
-		drawLine(*l, color, position);
+	glClientActiveTextureARB(GL_TEXTURE0);
+	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+	glTexCoordPointer(2, GL_FLOAT, 0, &_glyphs.getTexCoords()[0]);
 
-		// Restore position to the start of the line
-		glPopMatrix();
+	// Draw all glyphs of a page in one go, changing the color where necessary
+	const std::vector<GlyphArrays::Run> &runs = _glyphs.getRuns();
+	for (std::vector<GlyphArrays::Run>::const_iterator r = runs.begin(); r != runs.end(); ++r) {
+		if ((r == runs.begin()) || (r->page != (r - 1)->page))
+			font.bindPage(r->page);
 
-		// Move to the next line
-		glTranslatef(0.0f, -lineHeight, 0.0f);
+		applyColor(r->color);
 
-		// \n character
-		position++;
+		glDrawArrays(GL_QUADS, r->first, r->count);
 	}
 
+	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	glDisableClientState(GL_VERTEX_ARRAY);
+
 	glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
 }
 
@@ -354,31 +372,24 @@ void Text::parseColors(const Common::UString &str, Common::UString &parsed,
 }
 
 void Text::setFont(const Common::UString &fnt) {
-	_font = FontMan.get(fnt);
-}
+	lockFrameIfVisible();
 
-void Text::drawLine(const Common::UString &line,
-                    ColorPositions::const_iterator color, size_t position) {
+	_font = FontMan.get(fnt);
 
-	Font &font = _font.getFont();
+	_needLayout = true;
 
-	// Horizontal Align
-	glTranslatef(roundf((_width - font.getLineWidth(line)) * _halign), 0.0f, 0.0f);
+	unlockFrameIfVisible();
+}
 
-	// Draw line
-	for (Common::UString::iterator s = line.begin(); s != line.end(); ++s, position++) {
-		// If we have color changes, apply them
-		while ((color != _colors.end()) && (color->position <= position)) {
-			if (color->defaultColor)
-				glColor4f(_r, _g, _b, _a);
-			else
-				glColor4f(color->r, color->g, color->b, color->a);
+void Text::applyColor(size_t color) const {
+	if (color == GlyphArrays::kColorDefault) {
+		glColor4f(_r, _g, _b, _a);
+		return;
+	}
 
-			++color;
-		}
+	assert(color < _colors.size());
 
-		font.draw(*s);
-	}
+	glColor4f(_colors[color].r, _colors[color].g, _colors[color].b, _colors[color].a);
 }
 
 } // End of namespace Aurora
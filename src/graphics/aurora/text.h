@@ -29,6 +29,7 @@
 #include "src/common/maths.h"
 
 #include "src/graphics/types.h"
+#include "src/graphics/glypharrays.h"
 #include <src/graphics/guielement.h>
 
 #include "src/graphics/aurora/fonthandle.h"
@@ -109,10 +110,14 @@ private:
 
 	bool _disableColorTokens;
 
+	GlyphArrays _glyphs;     ///< The laid out glyphs of the text.
+	bool        _needLayout; ///< Do the glyphs need to be laid out again?
+
 	void parseColors(const Common::UString &str, Common::UString &parsed,
 	                 ColorPositions &colors);
 
-	void drawLine(const Common::UString &line, ColorPositions::const_iterator color, size_t position);
+	/** Apply the color with this index within the color changes. */
+	void applyColor(size_t color) const;
 };
 
 } // End of namespace Aurora
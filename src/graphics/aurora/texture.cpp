@@ -29,6 +29,7 @@
 #include "src/common/strutil.h"
 #include "src/common/error.h"
 #include "src/common/readstream.h"
+#include "src/common/threadpool.h"
 
 #include "src/graphics/aurora/texture.h"
 #include "src/graphics/aurora/pltfile.h"
@@ -55,17 +56,62 @@ namespace Graphics {
 
 namespace Aurora {
 
-Texture::Texture() : _type(::Aurora::kFileTypeNone), _width(0), _height(0) {
+/** A job decoding the image of a deferred texture. */
+class Texture::DecodeJob : public Common::ThreadPool::Job {
+public:
+	DecodeJob(Texture &texture, Common::SeekableReadStream *imageStream) :
+		_texture(&texture), _imageStream(imageStream) {
+	}
+
+	~DecodeJob() {
+		// The job was cancelled before it could run. Don't leave the texture waiting forever
+		if (_texture)
+			_texture->finishDecode(0);
+	}
+
+	void run() {
+		Texture *texture = _texture;
+		_texture = 0;
+
+		ImageDecoder *image = 0;
+		try {
+			image = loadImage(_imageStream.release(), texture->_type, texture->_txi.get());
+		} catch (...) {
+			Common::exceptionDispatcherWarning("Failed to decode texture \"%s\"", texture->_name.c_str());
+		}
+
+		texture->finishDecode(image);
+	}
+
+private:
+	Texture *_texture;
+	Common::ScopedPtr<Common::SeekableReadStream> _imageStream;
+};
+
+
+Texture::Texture() : _type(::Aurora::kFileTypeNone), _width(0), _height(0),
+	_deferred(false), _decoding(false), _decodeDone(_decodeMutex) {
+
 }
 
 Texture::Texture(const Common::UString &name, ImageDecoder *image, ::Aurora::FileType type, TXI *txi) :
-	_name(name), _type(type), _width(0), _height(0) {
+	_name(name), _type(type), _width(0), _height(0),
+	_deferred(false), _decoding(false), _decodeDone(_decodeMutex) {
 
 	set(name, image, type, txi);
 	addToQueues();
 }
 
+Texture::Texture(const Common::UString &name, ::Aurora::FileType type, TXI *txi) :
+	_name(name), _type(type), _txi(txi), _width(0), _height(0),
+	_deferred(true), _decoding(true), _decodeDone(_decodeMutex) {
+
+}
+
 Texture::~Texture() {
+	// The decoding job still references us
+	waitForDecode();
+
 	removeFromQueues();
 
 	if (_textureID != 0)
@@ -73,14 +119,20 @@ Texture::~Texture() {
 }
 
 uint32 Texture::getWidth() const {
+	waitForDecode();
+
 	return _width;
 }
 
 uint32 Texture::getHeight() const {
+	waitForDecode();
+
 	return _height;
 }
 
 bool Texture::hasAlpha() const {
+	waitForDecode();
+
 	if (!_image)
 		return false;
 
@@ -91,11 +143,30 @@ bool Texture::isDynamic() const {
 	return false;
 }
 
+bool Texture::isPending() const {
+	/* The texture ID is only ever changed in the main thread, so we don't need
+	 * to lock anything here. A deferred texture whose image failed to decode
+	 * stays pending forever, see hasFailed(). */
+
+	return _deferred && (_textureID == 0);
+}
+
+bool Texture::hasFailed() const {
+	if (!_deferred)
+		return false;
+
+	Common::StackLock lock(_decodeMutex);
+
+	return !_decoding && !_image;
+}
+
 static const TXI kEmptyTXI;
 const TXI &Texture::getTXI() const {
 	if (_txi)
 		return *_txi;
 
+	waitForDecode();
+
 	if (_image)
 		return _image->getTXI();
 
@@ -103,7 +174,10 @@ const TXI &Texture::getTXI() const {
 }
 
 const ImageDecoder &Texture::getImage() const {
-	assert(_image);
+	waitForDecode();
+
+	if (!_image)
+		throw Common::Exception("Texture \"%s\" has no image", _name.c_str());
 
 	return *_image;
 }
@@ -112,6 +186,8 @@ bool Texture::reload() {
 	if (_name.empty())
 		return false;
 
+	waitForDecode();
+
 	::Aurora::FileType type = ::Aurora::kFileTypeNone;
 	ImageDecoder *image = 0;
 	TXI *txi = 0;
@@ -136,6 +212,8 @@ bool Texture::reload() {
 }
 
 bool Texture::dumpTGA(const Common::UString &fileName) const {
+	waitForDecode();
+
 	if (!_image)
 		return false;
 
@@ -372,6 +450,46 @@ Texture *Texture::create(const Common::UString &name) {
 	return new Texture(name, image, type, txi);
 }
 
+Texture *Texture::createDeferred(const Common::UString &name, Common::ThreadPool &pool) {
+	::Aurora::FileType type = ::Aurora::kFileTypeNone;
+	Common::SeekableReadStream *imageStream = 0;
+	TXI *txi = 0;
+
+	try {
+		txi = loadTXI(name);
+
+		// Each side of this cube map is a separate file, so let create() combine them
+		const bool isFileCubeMap = txi && txi->getFeatures().cube && (txi->getFeatures().fileRange == 6);
+		if (isFileCubeMap) {
+			delete txi;
+
+			return create(name);
+		}
+
+		imageStream = ResMan.getResource(::Aurora::kResourceImage, name, &type);
+		if (!imageStream)
+			throw Common::Exception("No such image resource \"%s\"", name.c_str());
+
+	} catch (Common::Exception &e) {
+		delete txi;
+
+		e.add("Failed to create texture \"%s\" (%d)", name.c_str(), type);
+		throw;
+	}
+
+	// PLT needs extra handling, since they're their own Texture class
+	if (type == ::Aurora::kFileTypePLT) {
+		delete txi;
+
+		return createPLT(name, imageStream);
+	}
+
+	Texture *texture = new Texture(name, type, txi);
+	pool.addJob(new DecodeJob(*texture, imageStream));
+
+	return texture;
+}
+
 Texture *Texture::create(ImageDecoder *image, ::Aurora::FileType type, TXI *txi) {
 	if (!image)
 		throw Common::Exception("Can't create a texture from an empty image");
@@ -399,6 +517,32 @@ ImageDecoder *Texture::loadImage(const Common::UString &name) {
 	return loadImage(name, type);
 }
 
+void Texture::waitForDecode() const {
+	Common::StackLock lock(_decodeMutex);
+
+	while (_decoding)
+		_decodeDone.wait();
+}
+
+void Texture::finishDecode(ImageDecoder *image) {
+	/* Queue the texture for uploading before waking up anybody, because a
+	 * waiting destructor might free the texture as soon as it wakes up. */
+
+	if (image) {
+		_image.reset(image);
+
+		_width  = _image->getMipMap(0).width;
+		_height = _image->getMipMap(0).height;
+
+		addToQueues();
+	}
+
+	Common::StackLock lock(_decodeMutex);
+
+	_decoding = false;
+	_decodeDone.broadcast();
+}
+
 void Texture::addToQueues() {
 	addToQueue(kQueueTexture);
 	addToQueue(kQueueNewTexture);
@@ -27,6 +27,7 @@
 
 #include "src/common/scopedptr.h"
 #include "src/common/ustring.h"
+#include "src/common/mutex.h"
 
 #include "src/graphics/types.h"
 #include "src/graphics/texture.h"
@@ -35,6 +36,7 @@
 
 namespace Common {
 	class SeekableReadStream;
+	class ThreadPool;
 }
 
 namespace Graphics {
@@ -57,6 +59,12 @@ public:
 	/** Is this a dynamic texture, or a shared static one? */
 	virtual bool isDynamic() const;
 
+	/** Is this texture still waiting for its image to be decoded in the background
+	 *  and uploaded? Never blocks; only meaningful in the main thread. */
+	bool isPending() const;
+	/** Did the background decoding of the image fail? Never blocks. */
+	bool hasFailed() const;
+
 	/** Return the TXI. */
 	const TXI &getTXI() const;
 	/** Return the image. */
@@ -76,6 +84,16 @@ public:
 
 	/** Create a texture from this image resource. */
 	static Texture *create(const Common::UString &name);
+	/** Create a texture from this image resource, decoding the image in the background.
+	 *
+	 *  The TXI and the image resource are still read right away, but the image
+	 *  itself is decoded by a job on this thread pool. Until then, the texture
+	 *  isn't uploaded, and all methods that need the image block until it's ready.
+	 *
+	 *  Cube maps made out of several image files and PLT files are created
+	 *  immediately, exactly like create() does.
+	 */
+	static Texture *createDeferred(const Common::UString &name, Common::ThreadPool &pool);
 	/** Take over the image and create a texture from it. */
 	static Texture *create(ImageDecoder *image, ::Aurora::FileType type = ::Aurora::kFileTypeNone, TXI *txi = 0);
 
@@ -93,6 +111,8 @@ protected:
 
 	Texture();
 	Texture(const Common::UString &name, ImageDecoder *image, ::Aurora::FileType type, TXI *txi = 0);
+	/** Create a texture whose image will be delivered by finishDecode(). */
+	Texture(const Common::UString &name, ::Aurora::FileType type, TXI *txi);
 
 	void set(const Common::UString &name, ImageDecoder *image, ::Aurora::FileType type, TXI *txi);
 
@@ -122,6 +142,21 @@ protected:
 	static ImageDecoder *loadImage(const Common::UString &name, ::Aurora::FileType &type, TXI *txi);
 
 	static Texture *createPLT(const Common::UString &name, Common::SeekableReadStream *imageStream);
+
+
+private:
+	class DecodeJob;
+
+	bool _deferred; ///< Was the image decoded in the background?
+	bool _decoding; ///< Is the image still being decoded?
+
+	mutable Common::Mutex     _decodeMutex;
+	mutable Common::Condition _decodeDone;
+
+	/** Wait until the background decoding of the image has finished. */
+	void waitForDecode() const;
+	/** Take over the decoded image (or 0 on failure) and wake up everybody waiting for it. */
+	void finishDecode(ImageDecoder *image);
 };
 
 } // End of namespace Aurora
@@ -32,6 +32,8 @@
 
 #include "src/aurora/language.h"
 
+#include "src/graphics/glypharrays.h"
+
 #include "src/graphics/images/txi.h"
 
 #include "src/graphics/aurora/texturefont.h"
@@ -85,39 +87,34 @@ float TextureFont::getLineSpacing() const {
 	return _spaceB;
 }
 
-void TextureFont::drawMissing() const {
-	TextureMan.set();
-
+void TextureFont::addMissing(GlyphArrays &glyphs, float &x, float y) const {
 	float width = getWidth('m') - _spaceR;
 
-	glBegin(GL_QUADS);
-		glVertex2f(0.0f ,    0.0f);
-		glVertex2f(width,    0.0f);
-		glVertex2f(width, _height);
-		glVertex2f(0.0f , _height);
-	glEnd();
+	glyphs.addRect(x, y, width, _height);
 
-	glTranslatef(width + _spaceR, 0.0f, 0.0f);
+	x += width + _spaceR;
 }
 
-void TextureFont::draw(uint32 c) const {
+void TextureFont::addGlyph(GlyphArrays &glyphs, uint32 c, float &x, float y) const {
 	std::map<uint32, Char>::const_iterator cC = _chars.find(c);
 
 	if (cC == _chars.end()) {
-		drawMissing();
+		addMissing(glyphs, x, y);
 		return;
 	}
 
-	TextureMan.set(_texture);
+	glyphs.addQuad(0, x, y, cC->second.vX, cC->second.vY, cC->second.tX, cC->second.tY);
 
-	glBegin(GL_QUADS);
-	for (int i = 0; i < 4; i++) {
-		glTexCoord2f(cC->second.tX[i], cC->second.tY[i]);
-		glVertex2f  (cC->second.vX[i], cC->second.vY[i]);
+	x += cC->second.width + _spaceR;
+}
+
+void TextureFont::bindPage(size_t page) const {
+	if (page == GlyphArrays::kPageUntextured) {
+		TextureMan.set();
+		return;
 	}
-	glEnd();
 
-	glTranslatef(cC->second.width + _spaceR, 0.0f, 0.0f);
+	TextureMan.set(_texture);
 }
 
 void TextureFont::load() {
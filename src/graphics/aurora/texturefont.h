@@ -54,7 +54,8 @@ public:
 
 	float getLineSpacing() const;
 
-	void draw(uint32 c) const;
+	void addGlyph(GlyphArrays &glyphs, uint32 c, float &x, float y) const;
+	void bindPage(size_t page) const;
 
 private:
 	/** A font character. */
@@ -74,7 +75,7 @@ private:
 
 	void load();
 
-	void drawMissing() const;
+	void addMissing(GlyphArrays &glyphs, float &x, float y) const;
 };
 
 } // End of namespace Aurora
@@ -26,11 +26,13 @@
 #include "src/common/util.h"
 #include "src/common/error.h"
 #include "src/common/uuid.h"
+#include "src/common/threadpool.h"
 
 #include "src/graphics/aurora/textureman.h"
 #include "src/graphics/aurora/texture.h"
 
 #include "src/graphics/images/decoder.h"
+#include "src/graphics/images/surface.h"
 
 #include "src/graphics/graphics.h"
 
@@ -85,11 +87,18 @@ TextureManager::TextureManager() : _recordNewTextures(false) {
 
 TextureManager::~TextureManager() {
 	clear();
+
+	_decodePool.reset();
+	_placeholder.reset();
 }
 
 void TextureManager::clear() {
 	Common::StackLock lock(_mutex);
 
+	// Textures wait for their decoding job, so drop those that haven't even started yet
+	if (_decodePool)
+		_decodePool->cancel();
+
 	_bogusTextures.clear();
 
 	for (TextureMap::iterator t = _textures.begin(); t != _textures.end(); ++t)
@@ -153,7 +162,10 @@ TextureHandle TextureManager::get(Common::UString name) {
 	if (texture == _textures.end()) {
 		std::pair<TextureMap::iterator, bool> result;
 
-		ManagedTexture *managedTexture = new ManagedTexture(Texture::create(name));
+		if (!_decodePool)
+			_decodePool.reset(new Common::ThreadPool(0, "TextureDecode"));
+
+		ManagedTexture *managedTexture = new ManagedTexture(Texture::createDeferred(name, *_decodePool));
 
 		if (managedTexture->texture->isDynamic())
 			name = name + "#" + Common::generateIDRandomString();
@@ -273,11 +285,29 @@ void TextureManager::set(const TextureHandle &handle, TextureMode mode) {
 		return;
 	}
 
-	TextureID id = handle._it->second->texture->getID();
-	if (id == 0)
-		warning("Empty texture ID for texture \"%s\"", handle._it->first.c_str());
+	const Texture &texture = *handle._it->second->texture;
+
+	TextureID id = 0;
+	bool isCubeMap = false;
+
+	if (texture.isPending()) {
+		// The image couldn't be decoded, so there's no texture to show
+		if (texture.hasFailed()) {
+			set();
+			return;
+		}
+
+		// Still being decoded in the background
+		id = getPlaceholderID();
+	} else {
+		id = texture.getID();
+		if (id == 0)
+			warning("Empty texture ID for texture \"%s\"", handle._it->first.c_str());
+
+		isCubeMap = texture.getImage().isCubeMap();
+	}
 
-	if (handle._it->second->texture->getImage().isCubeMap()) {
+	if (isCubeMap) {
 		glBindTexture(GL_TEXTURE_CUBE_MAP, id);
 
 		glDisable(GL_TEXTURE_2D);
@@ -291,7 +321,7 @@ void TextureManager::set(const TextureHandle &handle, TextureMode mode) {
 
 	switch (mode) {
 		case kModeEnvironmentMapReflective:
-			if (handle._it->second->texture->getImage().isCubeMap()) {
+			if (isCubeMap) {
 				glTexGeni(GL_S, GL_TEXTURE_GEN_MODE, GL_REFLECTION_MAP);
 				glTexGeni(GL_T, GL_TEXTURE_GEN_MODE, GL_REFLECTION_MAP);
 				glTexGeni(GL_R, GL_TEXTURE_GEN_MODE, GL_REFLECTION_MAP);
@@ -318,6 +348,21 @@ void TextureManager::set(const TextureHandle &handle, TextureMode mode) {
 	}
 }
 
+TextureID TextureManager::getPlaceholderID() {
+	if (!_placeholder) {
+		Surface *surface = new Surface(4, 4);
+		surface->fill(0x80, 0x80, 0x80, 0xFF);
+
+		_placeholder.reset(Texture::create(surface));
+	}
+
+	// We're in the main thread, so we can build it right now if need be
+	if (_placeholder->getID() == 0)
+		_placeholder->rebuild();
+
+	return _placeholder->getID();
+}
+
 void TextureManager::activeTexture(size_t n) {
 	if ((n >= GfxMan.getMultipleTextureCount()) || (n >= ARRAYSIZE(kTextureUnit)))
 		return;
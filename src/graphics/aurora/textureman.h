@@ -29,17 +29,30 @@
 #include <list>
 
 #include "src/common/types.h"
+#include "src/common/scopedptr.h"
 #include "src/common/singleton.h"
 #include "src/common/mutex.h"
 #include "src/common/ustring.h"
 
+#include "src/graphics/types.h"
+
 #include "src/graphics/aurora/texturehandle.h"
 
+namespace Common {
+	class ThreadPool;
+}
+
 namespace Graphics {
 
 namespace Aurora {
 
-/** The global Aurora texture manager. */
+/** The global Aurora texture manager.
+ *
+ *  Images of textures loaded by get() are decoded on a pool of worker threads.
+ *  Until a texture's image has been decoded and uploaded, a plain placeholder
+ *  texture is bound in its stead. A texture whose image failed to decode is
+ *  treated like no texture at all.
+ */
 class TextureManager : public Common::Singleton<TextureManager> {
 public:
 	/** The mode/usage of a specific texture. */
@@ -99,12 +112,19 @@ private:
 
 	Common::Mutex _mutex;
 
+	/** The threads decoding the images of newly loaded textures. */
+	Common::ScopedPtr<Common::ThreadPool> _decodePool;
+	/** The texture shown while the real one is still being decoded. */
+	Common::ScopedPtr<Texture> _placeholder;
+
 	bool _recordNewTextures;
 	std::list<Common::UString> _newTextureNames;
 
 	void assign(TextureHandle &texture, const TextureHandle &from);
 	void release(TextureHandle &texture);
 
+	TextureID getPlaceholderID();
+
 	friend class TextureHandle;
 };
 
@@ -32,6 +32,7 @@
 
 #include "src/graphics/texture.h"
 #include "src/graphics/ttf.h"
+#include "src/graphics/glypharrays.h"
 
 #include "src/graphics/images/surface.h"
 
@@ -125,45 +126,41 @@ float TTFFont::getHeight() const {
 	return _height;
 }
 
-void TTFFont::drawMissing() const {
-	TextureMan.set();
-
+void TTFFont::addMissing(GlyphArrays &glyphs, float &x, float y) const {
 	const float width = _missingWidth - 1.0f;
 
-	glBegin(GL_QUADS);
-		glVertex2f(0.0f ,    0.0f);
-		glVertex2f(width,    0.0f);
-		glVertex2f(width, _height);
-		glVertex2f(0.0f , _height);
-	glEnd();
+	glyphs.addRect(x, y, width, _height);
 
-	glTranslatef(width + 1.0f, 0.0f, 0.0f);
+	x += width + 1.0f;
 }
 
-void TTFFont::draw(uint32 c) const {
+void TTFFont::addGlyph(GlyphArrays &glyphs, uint32 c, float &x, float y) const {
 	std::map<uint32, Char>::const_iterator cC = _chars.find(c);
 	if (cC == _chars.end()) {
 		cC = _missingChar;
 
 		if (cC == _chars.end()) {
-			drawMissing();
+			addMissing(glyphs, x, y);
 			return;
 		}
 	}
 
-	size_t page = cC->second.page;
-	assert(page < _pages.size());
+	assert(cC->second.page < _pages.size());
 
-	TextureMan.set(_pages[page]->texture);
+	glyphs.addQuad(cC->second.page, x, y, cC->second.vX, cC->second.vY, cC->second.tX, cC->second.tY);
+
+	x += cC->second.width;
+}
 
-	glBegin(GL_QUADS);
-	for (int i = 0; i < 4; i++) {
-		glTexCoord2f(cC->second.tX[i], cC->second.tY[i]);
-		glVertex2f  (cC->second.vX[i], cC->second.vY[i]);
+void TTFFont::bindPage(size_t page) const {
+	if (page == GlyphArrays::kPageUntextured) {
+		TextureMan.set();
+		return;
 	}
-	glEnd();
 
-	glTranslatef(cC->second.width, 0.0f, 0.0f);
+	assert(page < _pages.size());
+
+	TextureMan.set(_pages[page]->texture);
 }
 
 void TTFFont::buildChars(const Common::UString &str) {
@@ -56,7 +56,8 @@ public:
 	float getWidth (uint32 c) const;
 	float getHeight()         const;
 
-	void draw(uint32 c) const;
+	void addGlyph(GlyphArrays &glyphs, uint32 c, float &x, float y) const;
+	void bindPage(size_t page) const;
 
 	void buildChars(const Common::UString &str);
 
@@ -104,7 +105,7 @@ private:
 
 	void rebuildPages();
 	void addChar(uint32 c);
-	void drawMissing() const;
+	void addMissing(GlyphArrays &glyphs, float &x, float y) const;
 };
 
 } // End of namespace Aurora
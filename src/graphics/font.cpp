@@ -27,6 +27,7 @@
 
 #include "src/graphics/types.h"
 #include "src/graphics/font.h"
+#include "src/graphics/glypharrays.h"
 
 namespace Graphics {
 
@@ -263,6 +264,56 @@ float Font::getLineWidth(const Common::UString &text) const {
 	return width;
 }
 
+void Font::buildGlyphs(GlyphArrays &glyphs, const Common::UString &text, const ColorPositions &colors,
+                       float width, float height, float halign, float valign) const {
+
+	glyphs.clear();
+
+	const float lineHeight = getHeight() + getLineSpacing();
+
+	std::vector<Common::UString> lines;
+	split(text, lines, width, height, false);
+
+	const float blockSize = lines.size() * lineHeight;
+
+	// Move position to the top
+	float y = roundf(((height - blockSize) * valign) + blockSize - lineHeight);
+
+	size_t position = 0;
+
+	ColorPositions::const_iterator color = colors.begin();
+
+	for (std::vector<Common::UString>::const_iterator l = lines.begin(); l != lines.end(); ++l) {
+		buildLine(glyphs, *l, colors, color, position, y, width, halign);
+
+		// Move to the next line
+		y -= lineHeight;
+
+		// \n character
+		position++;
+	}
+
+	glyphs.finish();
+}
+
+void Font::buildLine(GlyphArrays &glyphs, const Common::UString &line, const ColorPositions &colors,
+                     ColorPositions::const_iterator color, size_t position, float y, float width, float halign) const {
+
+	// Horizontal Align
+	float x = roundf((width - getLineWidth(line)) * halign);
+
+	for (Common::UString::iterator s = line.begin(); s != line.end(); ++s, position++) {
+		// If we have color changes, apply them
+		while ((color != colors.end()) && (color->position <= position)) {
+			glyphs.setColor(color->defaultColor ? GlyphArrays::kColorDefault : (size_t)(color - colors.begin()));
+
+			++color;
+		}
+
+		addGlyph(glyphs, *s, x, y);
+	}
+}
+
 bool Font::addLine(std::vector<Common::UString> &lines, const Common::UString &newLine,
                    float maxHeight) const {
 
@@ -33,6 +33,8 @@
 
 namespace Graphics {
 
+class GlyphArrays;
+
 /** An abstract font. */
 class Font {
 public:
@@ -60,8 +62,19 @@ public:
 	/** Build all necessary characters to display this string. */
 	virtual void buildChars(const Common::UString &str);
 
-	/** Draw this character. */
-	virtual void draw(uint32 c) const = 0;
+	/** Add the quad of this character at x, y to the glyph arrays, and advance x past it. */
+	virtual void addGlyph(GlyphArrays &glyphs, uint32 c, float &x, float y) const = 0;
+	/** Bind the texture of this font page, for drawing glyph arrays. */
+	virtual void bindPage(size_t page) const = 0;
+
+	/** Lay out this text into glyph arrays.
+	 *
+	 *  The text is split into lines fitting into the given area and aligned
+	 *  within it, with the first line at the top. The color index of each
+	 *  glyph is the index of the last color change applied before it.
+	 */
+	void buildGlyphs(GlyphArrays &glyphs, const Common::UString &text, const ColorPositions &colors,
+	                 float width, float height, float halign, float valign) const;
 
 	float split(const Common::UString &line, std::vector<Common::UString> &lines,
 	            float maxWidth = 0.0f, float maxHeight = 0.0f, bool trim = true) const;
@@ -70,6 +83,9 @@ public:
 
 private:
 	bool addLine(std::vector<Common::UString> &lines, const Common::UString &newLine, float maxHeight) const;
+
+	void buildLine(GlyphArrays &glyphs, const Common::UString &line, const ColorPositions &colors,
+	               ColorPositions::const_iterator color, size_t position, float y, float width, float halign) const;
 };
 
 } // End of namespace Graphics
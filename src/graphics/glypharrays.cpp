@@ -0,0 +1,147 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Vertex and texture coordinate arrays of laid out glyphs.
+ */
+
+#include <algorithm>
+
+#include "src/graphics/glypharrays.h"
+
+namespace Graphics {
+
+const size_t GlyphArrays::kPageUntextured;
+const size_t GlyphArrays::kColorDefault;
+
+GlyphArrays::GlyphArrays() : _color(kColorDefault) {
+}
+
+GlyphArrays::~GlyphArrays() {
+}
+
+void GlyphArrays::clear() {
+	_color = kColorDefault;
+
+	_quads.clear();
+
+	_vertices.clear();
+	_texCoords.clear();
+
+	_runs.clear();
+}
+
+bool GlyphArrays::empty() const {
+	return _quads.empty() && _runs.empty();
+}
+
+void GlyphArrays::setColor(size_t color) {
+	_color = color;
+}
+
+GlyphArrays::Quad &GlyphArrays::newQuad(size_t page) {
+	_quads.push_back(Quad());
+
+	Quad &quad = _quads.back();
+
+	quad.page  = page;
+	quad.color = _color;
+
+	return quad;
+}
+
+void GlyphArrays::addQuad(size_t page, float x, float y,
+                          const float *vX, const float *vY, const float *tX, const float *tY) {
+
+	Quad &quad = newQuad(page);
+
+	for (int i = 0; i < 4; i++) {
+		quad.v[i * 2 + 0] = x + vX[i];
+		quad.v[i * 2 + 1] = y + vY[i];
+
+		quad.t[i * 2 + 0] = tX[i];
+		quad.t[i * 2 + 1] = tY[i];
+	}
+}
+
+void GlyphArrays::addRect(float x, float y, float width, float height) {
+	Quad &quad = newQuad(kPageUntextured);
+
+	const float vX[4] = { x, x + width, x + width , x          };
+	const float vY[4] = { y, y        , y + height, y + height };
+
+	for (int i = 0; i < 4; i++) {
+		quad.v[i * 2 + 0] = vX[i];
+		quad.v[i * 2 + 1] = vY[i];
+
+		quad.t[i * 2 + 0] = 0.0f;
+		quad.t[i * 2 + 1] = 0.0f;
+	}
+}
+
+bool GlyphArrays::comparePage(const Quad &a, const Quad &b) {
+	return a.page < b.page;
+}
+
+void GlyphArrays::finish() {
+	// Keep the quads of each page in the order they were added
+	std::stable_sort(_quads.begin(), _quads.end(), &comparePage);
+
+	_vertices.resize (_quads.size() * 8);
+	_texCoords.resize(_quads.size() * 8);
+
+	_runs.clear();
+
+	for (size_t i = 0; i < _quads.size(); i++) {
+		const Quad &quad = _quads[i];
+
+		std::copy(quad.v, quad.v + 8, _vertices.begin()  + i * 8);
+		std::copy(quad.t, quad.t + 8, _texCoords.begin() + i * 8);
+
+		if (_runs.empty() || (_runs.back().page != quad.page) || (_runs.back().color != quad.color)) {
+			Run run;
+
+			run.page  = quad.page;
+			run.color = quad.color;
+			run.first = i * 4;
+			run.count = 0;
+
+			_runs.push_back(run);
+		}
+
+		_runs.back().count += 4;
+	}
+
+	_quads.clear();
+}
+
+const std::vector<float> &GlyphArrays::getVertices() const {
+	return _vertices;
+}
+
+const std::vector<float> &GlyphArrays::getTexCoords() const {
+	return _texCoords;
+}
+
+const std::vector<GlyphArrays::Run> &GlyphArrays::getRuns() const {
+	return _runs;
+}
+
+} // End of namespace Graphics
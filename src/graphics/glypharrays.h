@@ -0,0 +1,119 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Vertex and texture coordinate arrays of laid out glyphs.
+ */
+
+#ifndef GRAPHICS_GLYPHARRAYS_H
+#define GRAPHICS_GLYPHARRAYS_H
+
+#include <vector>
+
+#include "src/common/types.h"
+
+namespace Graphics {
+
+/** The glyph quads of a laid out text, batched by font page.
+ *
+ *  Glyphs are added as quads, each on a font page and in a color. Once
+ *  all glyphs have been added, finish() sorts the quads by page and
+ *  builds flat vertex and texture coordinate arrays out of them, with
+ *  two floats per vertex and four vertices per quad. Consecutive quads
+ *  sharing both the page and the color form a run, which can be drawn
+ *  with a single call.
+ *
+ *  The colors are only indices, so that the actual color values can
+ *  change without needing to lay out the text again.
+ *
+ *  This class doesn't touch OpenGL at all.
+ */
+class GlyphArrays {
+public:
+	/** The page of quads that are drawn without a texture. */
+	static const size_t kPageUntextured = SIZE_MAX;
+	/** The color index of quads drawn in the default color. */
+	static const size_t kColorDefault   = SIZE_MAX;
+
+	/** A range of quads drawn from the same page in the same color. */
+	struct Run {
+		size_t page;  ///< The font page, or kPageUntextured.
+		size_t color; ///< The color index, or kColorDefault.
+		size_t first; ///< The index of the first vertex.
+		size_t count; ///< The number of vertices.
+	};
+
+	GlyphArrays();
+	~GlyphArrays();
+
+	/** Remove all quads and arrays. */
+	void clear();
+
+	/** Are there no quads to draw? */
+	bool empty() const;
+
+	/** Set the color index of all quads added from now on. */
+	void setColor(size_t color);
+
+	/** Add a textured quad, with its four vertices moved by x and y. */
+	void addQuad(size_t page, float x, float y,
+	             const float *vX, const float *vY, const float *tX, const float *tY);
+
+	/** Add an untextured rectangle. */
+	void addRect(float x, float y, float width, float height);
+
+	/** Sort the added quads by page and build the arrays. */
+	void finish();
+
+	/** Return the vertex coordinates, two floats per vertex. */
+	const std::vector<float> &getVertices() const;
+	/** Return the texture coordinates, two floats per vertex. */
+	const std::vector<float> &getTexCoords() const;
+
+	/** Return all runs, sorted by page. */
+	const std::vector<Run> &getRuns() const;
+
+private:
+	/** A quad that has been added, but not yet put into the arrays. */
+	struct Quad {
+		size_t page;
+		size_t color;
+
+		float v[8];
+		float t[8];
+	};
+
+	size_t _color;
+
+	std::vector<Quad> _quads;
+
+	std::vector<float> _vertices;
+	std::vector<float> _texCoords;
+
+	std::vector<Run> _runs;
+
+	Quad &newQuad(size_t page);
+
+	static bool comparePage(const Quad &a, const Quad &b);
+};
+
+} // End of namespace Graphics
+
+#endif // GRAPHICS_GLYPHARRAYS_H
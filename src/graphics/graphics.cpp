@@ -38,6 +38,8 @@
 #include "src/common/configman.h"
 #include "src/common/debugman.h"
 #include "src/common/threads.h"
+#include "src/common/boundingbox.h"
+#include "src/common/frustum.h"
 
 #include "src/events/requests.h"
 #include "src/events/events.h"
@@ -96,6 +98,9 @@ GraphicsManager::GraphicsManager() : Events::Notifyable() {
 
 	_fpsCounter.reset(new FPSCounter(3));
 
+	_drawnWorldObjectCount  = 0;
+	_culledWorldObjectCount = 0;
+
 	_frameLock.store(0);
 
 	_cursor = 0;
@@ -204,6 +209,11 @@ uint32 GraphicsManager::getFPS() const {
 	return _fpsCounter->getFPS();
 }
 
+void GraphicsManager::getWorldObjectCounts(uint32 &drawn, uint32 &culled) const {
+	drawn  = _drawnWorldObjectCount;
+	culled = _culledWorldObjectCount;
+}
+
 bool GraphicsManager::setFSAA(int level) {
 	// Force calling it from the main thread
 	if (!Common::isMainThread()) {
@@ -829,6 +839,28 @@ Renderable *GraphicsManager::getGUIObjectAt(float x, float y) const {
 	return object;
 }
 
+/** Checks whether a line in world space hits a clickable world object. */
+class WorldObjectPicker : public Common::AABBTree::RayCallback {
+public:
+	WorldObjectPicker(float x1, float y1, float z1, float x2, float y2, float z2) {
+		_line[0] = x1; _line[1] = y1; _line[2] = z1;
+		_line[3] = x2; _line[4] = y2; _line[5] = z2;
+	}
+
+	bool intersect(void *data, float &distance) {
+		const Renderable &r = *static_cast<const Renderable *>(data);
+
+		if (!r.isClickable())
+			// Object isn't clickable, don't check
+			return false;
+
+		return r.isIn(_line[0], _line[1], _line[2], _line[3], _line[4], _line[5], distance);
+	}
+
+private:
+	float _line[6];
+};
+
 Renderable *GraphicsManager::getWorldObjectAt(float x, float y) const {
 	if (QueueMan.isQueueEmpty(kQueueVisibleWorldObject))
 		return 0;
@@ -840,27 +872,33 @@ Renderable *GraphicsManager::getWorldObjectAt(float x, float y) const {
 	if (!unproject(x, y, x1, y1, z1, x2, y2, z2))
 		return 0;
 
-	Renderable *object = 0;
+	// Find the closest object the line hits
+	WorldObjectPicker picker(x1, y1, z1, x2, y2, z2);
+	float distance;
 
-	QueueMan.lockQueue(kQueueVisibleWorldObject);
-	const std::list<Queueable *> &objects = QueueMan.getQueue(kQueueVisibleWorldObject);
+	Common::StackLock lock(_pickMutex);
 
-	for (std::list<Queueable *>::const_iterator o = objects.begin(); o != objects.end(); ++o) {
-		Renderable &r = static_cast<Renderable &>(**o);
+	return static_cast<Renderable *>(_pickTree.findClosest(x1, y1, z1, x2, y2, z2, picker, distance));
+}
 
-		if (!r.isClickable())
-			// Object isn't clickable, don't check
-			continue;
+void GraphicsManager::lockPickables() {
+	_pickMutex.lock();
+}
 
-		// If the line intersects with the object, return it
-		if (r.isIn(x1, y1, z1, x2, y2, z2)) {
-			object = &r;
-			break;
-		}
-	}
+void GraphicsManager::unlockPickables() {
+	_pickMutex.unlock();
+}
 
-	QueueMan.unlockQueue(kQueueVisibleWorldObject);
-	return object;
+Common::AABBTree::ProxyID GraphicsManager::addPickable(Renderable &renderable, const Common::BoundingBox &box) {
+	return _pickTree.insert(box, &renderable);
+}
+
+void GraphicsManager::movePickable(Common::AABBTree::ProxyID proxy, const Common::BoundingBox &box) {
+	_pickTree.move(proxy, box);
+}
+
+void GraphicsManager::removePickable(Common::AABBTree::ProxyID proxy) {
+	_pickTree.remove(proxy);
 }
 
 Renderable *GraphicsManager::getObjectAt(float x, float y) {
@@ -926,9 +964,33 @@ bool GraphicsManager::playVideo() {
 	return true;
 }
 
+void GraphicsManager::cullWorld(const std::list<Queueable *> &objects) {
+	const Common::Frustum frustum(_projection, _modelview);
+
+	_drawnWorldObjects.clear();
+	_culledWorldObjectCount = 0;
+
+	for (std::list<Queueable *>::const_reverse_iterator o = objects.rbegin();
+	     o != objects.rend(); ++o) {
+
+		Renderable *r = static_cast<Renderable *>(*o);
+
+		if (r->isInFrustum(frustum))
+			_drawnWorldObjects.push_back(r);
+		else
+			_culledWorldObjectCount++;
+	}
+
+	_drawnWorldObjectCount = _drawnWorldObjects.size();
+}
+
 bool GraphicsManager::renderWorld() {
-	if (QueueMan.isQueueEmpty(kQueueVisibleWorldObject))
+	if (QueueMan.isQueueEmpty(kQueueVisibleWorldObject)) {
+		_drawnWorldObjectCount  = 0;
+		_culledWorldObjectCount = 0;
+
 		return false;
+	}
 
 	float cPos[3];
 	float cOrient[3];
@@ -984,21 +1046,24 @@ bool GraphicsManager::renderWorld() {
 		}
 	}
 
+	// Only draw objects within the view frustum
+	cullWorld(objects);
+
 	// Draw opaque objects
-	for (std::list<Queueable *>::const_reverse_iterator o = objects.rbegin();
-	     o != objects.rend(); ++o) {
+	for (std::vector<Renderable *>::const_iterator o = _drawnWorldObjects.begin();
+	     o != _drawnWorldObjects.end(); ++o) {
 
 		glPushMatrix();
-		static_cast<Renderable *>(*o)->render(kRenderPassOpaque);
+		(*o)->render(kRenderPassOpaque);
 		glPopMatrix();
 	}
 
 	// Draw transparent objects
-	for (std::list<Queueable *>::const_reverse_iterator o = objects.rbegin();
-	     o != objects.rend(); ++o) {
+	for (std::vector<Renderable *>::const_iterator o = _drawnWorldObjects.begin();
+	     o != _drawnWorldObjects.end(); ++o) {
 
 		glPushMatrix();
-		static_cast<Renderable *>(*o)->render(kRenderPassTransparent);
+		(*o)->render(kRenderPassTransparent);
 		glPopMatrix();
 	}
 
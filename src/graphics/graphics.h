@@ -37,6 +37,7 @@
 #include "src/common/singleton.h"
 #include "src/common/mutex.h"
 #include "src/common/ustring.h"
+#include "src/common/aabbtree.h"
 
 #include "src/graphics/types.h"
 #include "src/graphics/windowman.h"
@@ -54,6 +55,7 @@ namespace Aurora {
 class FPSCounter;
 class Cursor;
 class Renderable;
+class Queueable;
 
 /** The graphics manager. */
 class GraphicsManager : public Common::Singleton<GraphicsManager>, public Events::Notifyable {
@@ -93,6 +95,9 @@ public:
 	/** How many frames per second to we render at the moments? */
 	uint32 getFPS() const;
 
+	/** How many world objects were drawn and culled in the last frame? */
+	void getWorldObjectCounts(uint32 &drawn, uint32 &culled) const;
+
 	/** Enable/Disable face culling. */
 	void setCullFace(bool enabled, GLenum mode = GL_BACK);
 
@@ -123,6 +128,18 @@ public:
 	/** Get the object at this screen position. */
 	Renderable *getObjectAt(float x, float y);
 
+	/** Lock the pickable world objects. Needed around addPickable(), movePickable() and removePickable(). */
+	void lockPickables();
+	/** Unlock the pickable world objects again. */
+	void unlockPickables();
+
+	/** Add a visible world object with this bounding box to the objects that can be picked by getObjectAt(). */
+	Common::AABBTree::ProxyID addPickable(Renderable &renderable, const Common::BoundingBox &box);
+	/** Update the bounding box of a pickable world object. */
+	void movePickable(Common::AABBTree::ProxyID proxy, const Common::BoundingBox &box);
+	/** Remove a world object from the objects that can be picked by getObjectAt(). */
+	void removePickable(Common::AABBTree::ProxyID proxy);
+
 	/** Recalculate all object distances to the camera and resort the objects. */
 	void recalculateObjectDistances();
 
@@ -239,6 +256,15 @@ private:
 
 	Common::Mutex _abandonMutex; ///< A mutex protecting abandoned structures.
 
+	/** The world objects that survived culling in the current frame, in render order. */
+	std::vector<Renderable *> _drawnWorldObjects;
+
+	uint32 _drawnWorldObjectCount;  ///< Number of world objects drawn in the last frame.
+	uint32 _culledWorldObjectCount; ///< Number of world objects culled in the last frame.
+
+	Common::AABBTree      _pickTree;  ///< The bounding boxes of all pickable world objects.
+	mutable Common::Mutex _pickMutex; ///< A mutex protecting the pickable world objects.
+
 	Aurora::AnimationThread _animationThread;
 	bool _dedicatedAnimThread; ///< Use dedicated thread for animations?
 
@@ -267,6 +293,9 @@ private:
 
 	void beginScene();
 	bool playVideo();
+	/** Collect the world objects within the view frustum into _drawnWorldObjects. */
+	void cullWorld(const std::list<Queueable *> &objects);
+
 	bool renderWorld();
 	bool renderGUIFront();
 	bool renderGUIBack();
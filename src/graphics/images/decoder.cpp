@@ -24,10 +24,13 @@
 
 #include <cassert>
 
+#include <boost/noncopyable.hpp>
+
 #include "src/common/scopedptr.h"
 #include "src/common/util.h"
 #include "src/common/error.h"
-#include "src/common/memreadstream.h"
+#include "src/common/mutex.h"
+#include "src/common/threadpool.h"
 
 #include "src/graphics/graphics.h"
 
@@ -212,7 +215,121 @@ const ImageDecoder::MipMap &ImageDecoder::getMipMap(size_t mipMap, size_t layer)
 	return *_mipMaps[index];
 }
 
-void ImageDecoder::decompress(MipMap &out, const MipMap &in, PixelFormatRaw format) {
+/** Split mip maps with more than that many pixels into several jobs when decompressing. */
+static const int kDecompressJobPixels = 128 * 128;
+
+/** Return the size of a DXTn block of 4x4 pixels. */
+static size_t getBlockSize(PixelFormatRaw format) {
+	return (format == kPixelFormatDXT1) ? 8 : 16;
+}
+
+/** Decompress a band of rows of a DXTn mip map. The band has to start at a block boundary. */
+static void decompressRows(ImageDecoder::MipMap &out, const ImageDecoder::MipMap &in,
+                           PixelFormatRaw format, int row, int rowCount) {
+
+	assert((row % 4) == 0);
+
+	const size_t srcOffset  = (row / 4) * ((in.width + 3) / 4) * getBlockSize(format);
+	const size_t destOffset = row * out.width * 4;
+
+	const byte  *src     = in.data.get() + srcOffset;
+	const size_t srcSize = in.size - srcOffset;
+
+	byte *dest = out.data.get() + destOffset;
+
+	if      (format == kPixelFormatDXT1)
+		decompressDXT1(dest, src, srcSize, out.width, rowCount, out.width * 4);
+	else if (format == kPixelFormatDXT3)
+		decompressDXT3(dest, src, srcSize, out.width, rowCount, out.width * 4);
+	else if (format == kPixelFormatDXT5)
+		decompressDXT5(dest, src, srcSize, out.width, rowCount, out.width * 4);
+}
+
+/** The worker threads shared by all DXTn decompressions, created on first use. */
+struct DecompressPool {
+	Common::Mutex mutex;
+	Common::ScopedPtr<Common::ThreadPool> pool;
+
+	static Common::ThreadPool &get() {
+		static DecompressPool decompressPool;
+
+		Common::StackLock lock(decompressPool.mutex);
+
+		if (!decompressPool.pool)
+			decompressPool.pool.reset(new Common::ThreadPool(0, "DXTDecompress"));
+
+		return *decompressPool.pool;
+	}
+};
+
+/** The jobs of one decompression, since the shared pool runs the jobs of others too. */
+class DecompressBatch : boost::noncopyable {
+public:
+	DecompressBatch() : _finished(_mutex), _pendingJobs(0) {
+	}
+
+	void addJob() {
+		Common::StackLock lock(_mutex);
+
+		_pendingJobs++;
+	}
+
+	void finishJob() {
+		Common::StackLock lock(_mutex);
+
+		assert(_pendingJobs > 0);
+		_pendingJobs--;
+
+		_finished.broadcast();
+	}
+
+	/** Wait until all jobs of this batch have finished. */
+	void wait() {
+		Common::StackLock lock(_mutex);
+
+		while (_pendingJobs > 0)
+			_finished.wait();
+	}
+
+private:
+	Common::Mutex _mutex;
+	Common::Condition _finished;
+
+	size_t _pendingJobs;
+};
+
+/** A job decompressing a band of rows of a DXTn mip map. */
+class DecompressJob : public Common::ThreadPool::Job {
+public:
+	DecompressJob(DecompressBatch &batch, ImageDecoder::MipMap &out, const ImageDecoder::MipMap &in,
+	              PixelFormatRaw format, int row, int rowCount) :
+		_batch(&batch), _out(&out), _in(&in), _format(format), _row(row), _rowCount(rowCount) {
+
+		_batch->addJob();
+	}
+
+	~DecompressJob() {
+		// The pool deletes the job after it ran, even if it threw
+		_batch->finishJob();
+	}
+
+	void run() {
+		decompressRows(*_out, *_in, _format, _row, _rowCount);
+	}
+
+private:
+	DecompressBatch *_batch;
+
+	ImageDecoder::MipMap *_out;
+	const ImageDecoder::MipMap *_in;
+
+	PixelFormatRaw _format;
+
+	int _row;
+	int _rowCount;
+};
+
+void ImageDecoder::createDecompressed(MipMap &out, const MipMap &in, PixelFormatRaw format) {
 	if ((format != kPixelFormatDXT1) &&
 	    (format != kPixelFormatDXT3) &&
 	    (format != kPixelFormatDXT5))
@@ -223,34 +340,72 @@ void ImageDecoder::decompress(MipMap &out, const MipMap &in, PixelFormatRaw form
 	if (!hasValidDimensions(format, in.width, in.height))
 		throw Common::Exception("Invalid dimensions (%dx%d) for format %d", in.width, in.height, format);
 
+	if (in.size < (((in.width + 3) / 4) * ((in.height + 3) / 4) * getBlockSize(format)))
+		throw Common::Exception(Common::kReadError);
+
 	out.width  = in.width;
 	out.height = in.height;
 	out.size   = out.width * out.height * 4;
 
 	out.data.reset(new byte[out.size]);
-
-	Common::ScopedPtr<Common::MemoryReadStream> stream(new Common::MemoryReadStream(in.data.get(), in.size));
-
-	if      (format == kPixelFormatDXT1)
-		decompressDXT1(out.data.get(), *stream, out.width, out.height, out.width * 4);
-	else if (format == kPixelFormatDXT3)
-		decompressDXT3(out.data.get(), *stream, out.width, out.height, out.width * 4);
-	else if (format == kPixelFormatDXT5)
-		decompressDXT5(out.data.get(), *stream, out.width, out.height, out.width * 4);
 }
 
 void ImageDecoder::decompress() {
 	if (!_compressed)
 		return;
 
-	for (MipMaps::iterator m = _mipMaps.begin(); m != _mipMaps.end(); ++m) {
-		MipMap decompressed(this);
+	MipMaps decompressed;
+	decompressed.reserve(_mipMaps.size());
 
-		decompress(decompressed, **m, _formatRaw);
+	size_t pixelCount = 0;
+	for (MipMaps::const_iterator m = _mipMaps.begin(); m != _mipMaps.end(); ++m) {
+		decompressed.push_back(new MipMap(this));
+		createDecompressed(*decompressed.back(), **m, _formatRaw);
 
-		decompressed.swap(**m);
+		pixelCount += (*m)->width * (*m)->height;
 	}
 
+	const size_t threadCount = Common::ThreadPool::getDefaultThreadCount();
+
+	if ((threadCount > 1) && (pixelCount > (size_t) (2 * kDecompressJobPixels))) {
+		/* Split the bigger mip maps into bands of whole blocks. The last band
+		 * also takes the rows of an incomplete block at the bottom. */
+
+		Common::ThreadPool &pool = DecompressPool::get();
+		DecompressBatch batch;
+
+		for (size_t i = 0; i < _mipMaps.size(); i++) {
+			const int width  = _mipMaps[i]->width;
+			const int height = _mipMaps[i]->height;
+
+			const int bandRows = MAX(4, ((kDecompressJobPixels / MAX(width, 1)) / 4) * 4);
+
+			if (height < (2 * bandRows)) {
+				pool.addJob(new DecompressJob(batch, *decompressed[i], *_mipMaps[i], _formatRaw, 0, height));
+				continue;
+			}
+
+			const int lastBand = ((height / 4) * 4) - bandRows;
+
+			for (int row = 0; row < height; row += bandRows) {
+				const int rowCount = (row >= lastBand) ? (height - row) : bandRows;
+
+				pool.addJob(new DecompressJob(batch, *decompressed[i], *_mipMaps[i], _formatRaw, row, rowCount));
+
+				if (row >= lastBand)
+					break;
+			}
+		}
+
+		batch.wait();
+
+	} else
+		for (size_t i = 0; i < _mipMaps.size(); i++)
+			decompressRows(*decompressed[i], *_mipMaps[i], _formatRaw, 0, decompressed[i]->height);
+
+	for (size_t i = 0; i < _mipMaps.size(); i++)
+		decompressed[i]->swap(*_mipMaps[i]);
+
 	_format     = kPixelFormatRGBA;
 	_formatRaw  = kPixelFormatRGBA8;
 	_dataType   = kPixelDataType8;
@@ -132,7 +132,8 @@ protected:
 
 	TXI _txi;
 
-	static void decompress(MipMap &out, const MipMap &in, PixelFormatRaw format);
+	/** Check that the compressed mip map is valid and allocate its decompressed counterpart. */
+	static void createDecompressed(MipMap &out, const MipMap &in, PixelFormatRaw format);
 };
 
 } // End of namespace Graphics
@@ -17,203 +17,206 @@
  * You should have received a copy of the GNU General Public License
  * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
  */
-
 /** @file
  *  Manual S3TC DXTn decompression methods.
  */
 
 #include "src/common/util.h"
-#include "src/common/readstream.h"
+#include "src/common/endianness.h"
+#include "src/common/error.h"
 
 #include "src/graphics/images/s3tc.h"
 
 namespace Graphics {
 
+/** The weights of the second color when interpolating the two colors of a block. */
+static const double kWeights[3] = { 0.333333f, 0.666666f, 0.5f };
+
+enum Weight {
+	kWeightThird     = 0,
+	kWeightTwoThirds = 1,
+	kWeightHalf      = 2
+};
+
+static inline byte interpolate(double weight, byte color_0, byte color_1) {
+	return (byte)((1.0f - weight) * (double)color_0 + weight * (double)color_1);
+}
+
+/** The interpolated values of all possible pairs of color channels in a block.
+ *
+ *  The 565 colors of a block expand to only 32 or 64 different values per
+ *  channel, so we can look up the results of the floating point
+ *  interpolation instead of calculating them for every block.
+ */
+struct InterpolationTables {
+	byte channel5[3][32][32]; ///< Red and blue, by weight and 5-bit values.
+	byte channel6[3][64][64]; ///< Green, by weight and 6-bit values.
+	byte alpha[3];            ///< Two opaque alpha values, by weight.
+
+	InterpolationTables() {
+		for (size_t w = 0; w < ARRAYSIZE(kWeights); w++) {
+			for (size_t i = 0; i < 32; i++)
+				for (size_t j = 0; j < 32; j++)
+					channel5[w][i][j] = interpolate(kWeights[w], i << 3, j << 3);
+
+			for (size_t i = 0; i < 64; i++)
+				for (size_t j = 0; j < 64; j++)
+					channel6[w][i][j] = interpolate(kWeights[w], i << 2, j << 2);
+
+			alpha[w] = interpolate(kWeights[w], 0xFF, 0xFF);
+		}
+	}
+};
+
+static const InterpolationTables kInterpolation;
+
 static inline uint32 convert565To8888(uint16 color) {
 	return ((color & 0x1F) << 11) | ((color & 0x7E0) << 13) | ((color & 0xF800) << 16) | 0xFF;
 }
 
-static inline uint32 interpolate32(double weight, uint32 color_0, uint32 color_1) {
-	byte r[3], g[3], b[3], a[3];
-	r[0] = color_0 >> 24;
-	r[1] = color_1 >> 24;
-	r[2] = (byte)((1.0f - weight) * (double)r[0] + weight * (double)r[1]);
-	g[0] = (color_0 >> 16) & 0xFF;
-	g[1] = (color_1 >> 16) & 0xFF;
-	g[2] = (byte)((1.0f - weight) * (double)g[0] + weight * (double)g[1]);
-	b[0] = (color_0 >> 8) & 0xFF;
-	b[1] = (color_1 >> 8) & 0xFF;
-	b[2] = (byte)((1.0f - weight) * (double)b[0] + weight * (double)b[1]);
-	a[0] = color_0 & 0xFF;
-	a[1] = color_1 & 0xFF;
-	a[2] = (byte)((1.0f - weight) * (double)a[0] + weight * (double)a[1]);
-	return r[2] << 24 | g[2] << 16 | b[2] << 8 | a[2];
+static inline uint32 interpolate565(Weight weight, uint16 color_0, uint16 color_1, byte alpha) {
+	const byte r = kInterpolation.channel5[weight][ color_0 >> 11        ][ color_1 >> 11        ];
+	const byte g = kInterpolation.channel6[weight][(color_0 >>  5) & 0x3F][(color_1 >>  5) & 0x3F];
+	const byte b = kInterpolation.channel5[weight][ color_0        & 0x1F][ color_1        & 0x1F];
+
+	return (r << 24) | (g << 16) | (b << 8) | alpha;
 }
 
-struct DXT1Texel {
-	uint16 color_0;
-	uint16 color_1;
-	uint32 pixels;
-};
+/** Create the color palette of a block. The alpha is 0, unless it's a DXT1 block. */
+static inline void createPalette(uint32 (&palette)[4], uint16 color_0, uint16 color_1, bool dxt1) {
+	if (!dxt1) {
+		palette[0] = convert565To8888(color_0) & 0xFFFFFF00;
+		palette[1] = convert565To8888(color_1) & 0xFFFFFF00;
+		palette[2] = interpolate565(kWeightThird    , color_0, color_1, 0);
+		palette[3] = interpolate565(kWeightTwoThirds, color_0, color_1, 0);
+		return;
+	}
 
-#define READ_DXT1_TEXEL(x) \
-	x.color_0 = src.readUint16LE(); \
-	x.color_1 = src.readUint16LE(); \
-	x.pixels = src.readUint32BE()
+	palette[0] = convert565To8888(color_0);
+	palette[1] = convert565To8888(color_1);
 
-void decompressDXT1(byte *dest, Common::SeekableReadStream &src, uint32 width, uint32 height, uint32 pitch) {
-	for (int32 ty = height; ty > 0; ty -= 4) {
-		for (uint32 tx = 0; tx < width; tx += 4) {
-			DXT1Texel tex;
-			READ_DXT1_TEXEL(tex);
-			uint32 blended[4];
-
-			blended[0] = convert565To8888(tex.color_0);
-			blended[1] = convert565To8888(tex.color_1);
-
-			if (tex.color_0 > tex.color_1) {
-				blended[2] = interpolate32(0.333333f, blended[0], blended[1]);
-				blended[3] = interpolate32(0.666666f, blended[0], blended[1]);
-			} else {
-				blended[2] = interpolate32(0.5f, blended[0], blended[1]);
-				blended[3] = 0;
-			}
+	if (color_0 > color_1) {
+		palette[2] = interpolate565(kWeightThird    , color_0, color_1, kInterpolation.alpha[kWeightThird]);
+		palette[3] = interpolate565(kWeightTwoThirds, color_0, color_1, kInterpolation.alpha[kWeightTwoThirds]);
+	} else {
+		palette[2] = interpolate565(kWeightHalf, color_0, color_1, kInterpolation.alpha[kWeightHalf]);
+		palette[3] = 0;
+	}
+}
 
-			uint32 cpx = tex.pixels;
-			uint32 blockWidth = MIN<uint32>(width, 4);
-			uint32 blockHeight = MIN<uint32>(height, 4);
+/* The pixel of a block is addressed by n, its index in the order the pixels
+ * are written, and x and y, its position within the block. y counts from
+ * the bottom, since the rows of a block are written bottom-up. */
 
-			for (byte y = 0; y < blockHeight; ++y) {
-				for (byte x = 0; x < blockWidth; ++x) {
-					const uint32 destX = tx + x;
-					const uint32 destY = height - 1 - (ty - blockHeight + y);
+/** A DXT1 block: two 565 colors and 2-bit color indices. */
+struct DXT1Block {
+	static const size_t kSize = 8;
 
-					const uint32 pixel =  blended[cpx & 3];
+	uint32 palette[4];
+	uint32 pixels;
 
-					cpx >>= 2;
+	DXT1Block(const byte *src, bool dxt1 = true) : pixels(READ_BE_UINT32(src + 4)) {
+		createPalette(palette, READ_LE_UINT16(src), READ_LE_UINT16(src + 2), dxt1);
+	}
 
-					if ((destX < width) && (destY < height))
-						WRITE_BE_UINT32(dest + destY * pitch + destX * 4, pixel);
-				}
-			}
-		}
+	inline uint32 getPixel(uint32 n, uint32 UNUSED(x), uint32 UNUSED(y)) const {
+		return palette[(pixels >> (2 * n)) & 3];
 	}
-}
+};
+
+/** A DXT3 block: explicit 4-bit alpha values, followed by a DXT1 color block. */
+struct DXT3Block : public DXT1Block {
+	static const size_t kSize = 16;
 
-struct DXT23Texel : public DXT1Texel {
 	uint16 alpha[4];
+
+	DXT3Block(const byte *src) : DXT1Block(src + 8, false) {
+		for (size_t i = 0; i < 4; i++)
+			alpha[i] = READ_LE_UINT16(src + 2 * i);
+	}
+
+	inline uint32 getPixel(uint32 n, uint32 x, uint32 y) const {
+		return DXT1Block::getPixel(n, x, y) | (((alpha[y] >> (x * 4)) & 0xF) << 4);
+	}
 };
 
-#define READ_DXT3_TEXEL(x) \
-	x.alpha[0] = src.readUint16LE(); \
-	x.alpha[1] = src.readUint16LE(); \
-	x.alpha[2] = src.readUint16LE(); \
-	x.alpha[3] = src.readUint16LE(); \
-	READ_DXT1_TEXEL(x)
+/** A DXT5 block: two alpha values and 3-bit alpha indices, followed by a DXT1 color block. */
+struct DXT5Block : public DXT1Block {
+	static const size_t kSize = 16;
 
-void decompressDXT3(byte *dest, Common::SeekableReadStream &src, uint32 width, uint32 height, uint32 pitch) {
-	for (int32 ty = height; ty > 0; ty -= 4) {
-		for (uint32 tx = 0; tx < width; tx += 4) {
-			DXT23Texel tex;
-			uint32 blended[4];
-			READ_DXT3_TEXEL(tex);
-
-			blended[0] = convert565To8888(tex.color_0) & 0xFFFFFF00;
-			blended[1] = convert565To8888(tex.color_1) & 0xFFFFFF00;
-			blended[2] = interpolate32(0.333333f, blended[0], blended[1]);
-			blended[3] = interpolate32(0.666666f, blended[0], blended[1]);
-
-			uint32 cpx = tex.pixels;
-			uint32 blockWidth = MIN<uint32>(width, 4);
-			uint32 blockHeight = MIN<uint32>(height, 4);
-
-			for (byte y = 0; y < blockHeight; ++y) {
-				for (byte x = 0; x < blockWidth; ++x) {
-					const uint32 destX = tx + x;
-					const uint32 destY = height - 1 - (ty - blockHeight + y);
+	byte   alpha[8];
+	uint64 alphaBits;
 
-					const uint32 alpha = (tex.alpha[y] >> (x * 4)) & 0xF;
-					const uint32 pixel = blended[cpx & 3] | alpha << 4;
+	DXT5Block(const byte *src) : DXT1Block(src + 8, false) {
+		alpha[0] = src[0];
+		alpha[1] = src[1];
 
-					cpx >>= 2;
+		if (alpha[0] > alpha[1]) {
+			for (int i = 1; i < 7; i++)
+				alpha[i + 1] = ((7 - i) * alpha[0] + i * alpha[1] + 3) / 7;
+		} else {
+			for (int i = 1; i < 5; i++)
+				alpha[i + 1] = ((5 - i) * alpha[0] + i * alpha[1] + 2) / 5;
 
-					if ((destX < width) && (destY < height))
-						WRITE_BE_UINT32(dest + destY * pitch + destX * 4, pixel);
-				}
-			}
+			alpha[6] = 0;
+			alpha[7] = 255;
 		}
+
+		alphaBits = READ_LE_UINT32(src + 2) | (((uint64) READ_LE_UINT16(src + 6)) << 32);
 	}
-}
 
-struct DXT45Texel : public DXT1Texel {
-	byte alpha_0;
-	byte alpha_1;
-	uint64 alphabl;
+	inline uint32 getPixel(uint32 n, uint32 x, uint32 y) const {
+		return DXT1Block::getPixel(n, x, y) | alpha[(alphaBits >> (3 * (4 * (3 - y) + x))) & 7];
+	}
 };
 
-static uint64 readUint48LE(Common::SeekableReadStream &src) {
-	uint64 output = src.readUint32LE();
-	return output | ((uint64)src.readUint16LE() << 32);
-}
+template<class Block>
+static void decompressDXT(byte *dest, const byte *src, size_t srcSize, uint32 width, uint32 height, uint32 pitch) {
+	const size_t blockCount = ((width + 3) / 4) * ((height + 3) / 4);
+	if (srcSize < (blockCount * Block::kSize))
+		throw Common::Exception(Common::kReadError);
 
-#define READ_DXT5_TEXEL(x) \
-	x.alpha_0 = src.readByte(); \
-	x.alpha_1 = src.readByte(); \
-	x.alphabl = readUint48LE(src); \
-	READ_DXT1_TEXEL(x)
+	const uint32 blockWidth  = MIN<uint32>(width , 4);
+	const uint32 blockHeight = MIN<uint32>(height, 4);
 
-void decompressDXT5(byte *dest, Common::SeekableReadStream &src, uint32 width, uint32 height, uint32 pitch) {
 	for (int32 ty = height; ty > 0; ty -= 4) {
-		for (uint32 tx = 0; tx < width; tx += 4) {
-			uint32 blended[4];
-			byte alphab[8];
-			DXT45Texel tex;
-			READ_DXT5_TEXEL(tex);
-
-			alphab[0] = tex.alpha_0;
-			alphab[1] = tex.alpha_1;
-
-			if (tex.alpha_0 > tex.alpha_1) {
-				alphab[2] = (byte)((6.0f * (double)alphab[0] + 1.0f * (double)alphab[1] + 3.0f) / 7.0f);
-				alphab[3] = (byte)((5.0f * (double)alphab[0] + 2.0f * (double)alphab[1] + 3.0f) / 7.0f);
-				alphab[4] = (byte)((4.0f * (double)alphab[0] + 3.0f * (double)alphab[1] + 3.0f) / 7.0f);
-				alphab[5] = (byte)((3.0f * (double)alphab[0] + 4.0f * (double)alphab[1] + 3.0f) / 7.0f);
-				alphab[6] = (byte)((2.0f * (double)alphab[0] + 5.0f * (double)alphab[1] + 3.0f) / 7.0f);
-				alphab[7] = (byte)((1.0f * (double)alphab[0] + 6.0f * (double)alphab[1] + 3.0f) / 7.0f);
-			} else {
-				alphab[2] = (byte)((4.0f * (double)alphab[0] + 1.0f * (double)alphab[1] + 2.0f) / 5.0f);
-				alphab[3] = (byte)((3.0f * (double)alphab[0] + 2.0f * (double)alphab[1] + 2.0f) / 5.0f);
-				alphab[4] = (byte)((2.0f * (double)alphab[0] + 3.0f * (double)alphab[1] + 2.0f) / 5.0f);
-				alphab[5] = (byte)((1.0f * (double)alphab[0] + 4.0f * (double)alphab[1] + 2.0f) / 5.0f);
-				alphab[6] = 0;
-				alphab[7] = 255;
-			}
+		for (uint32 tx = 0; tx < width; tx += 4, src += Block::kSize) {
+			const Block block(src);
 
-			blended[0] = convert565To8888(tex.color_0) & 0xFFFFFF00;
-			blended[1] = convert565To8888(tex.color_1) & 0xFFFFFF00;
-			blended[2] = interpolate32(0.333333f, blended[0], blended[1]);
-			blended[3] = interpolate32(0.666666f, blended[0], blended[1]);
+			if ((blockWidth == 4) && (blockHeight == 4) && ((tx + 4) <= width) && (ty >= 4)) {
+				// The block lies completely within the image, no need to check each pixel
 
-			uint32 cpx = tex.pixels;
-			uint32 blockWidth = MIN<uint32>(width, 4);
-			uint32 blockHeight = MIN<uint32>(height, 4);
+				byte *row = dest + (height - ty + 3) * pitch + tx * 4;
+				for (uint32 y = 0; y < 4; y++, row -= pitch)
+					for (uint32 x = 0; x < 4; x++)
+						WRITE_BE_UINT32(row + x * 4, block.getPixel(y * 4 + x, x, y));
 
-			for (byte y = 0; y < blockHeight; ++y) {
-				for (byte x = 0; x < blockWidth; ++x) {
+				continue;
+			}
+
+			for (uint32 y = 0; y < blockHeight; ++y) {
+				for (uint32 x = 0; x < blockWidth; ++x) {
 					const uint32 destX = tx + x;
 					const uint32 destY = height - 1 - (ty - blockHeight + y);
 
-					const uint32 alpha = alphab[(tex.alphabl >> (3 * (4 * (3 - y) + x))) & 7];
-					const uint32 pixel = blended[cpx & 3] | alpha;
-
-					cpx >>= 2;
-
 					if ((destX < width) && (destY < height))
-						WRITE_BE_UINT32(dest + destY * pitch + destX * 4, pixel);
+						WRITE_BE_UINT32(dest + destY * pitch + destX * 4, block.getPixel(y * blockWidth + x, x, y));
 				}
 			}
 		}
 	}
 }
 
+void decompressDXT1(byte *dest, const byte *src, size_t srcSize, uint32 width, uint32 height, uint32 pitch) {
+	decompressDXT<DXT1Block>(dest, src, srcSize, width, height, pitch);
+}
+
+void decompressDXT3(byte *dest, const byte *src, size_t srcSize, uint32 width, uint32 height, uint32 pitch) {
+	decompressDXT<DXT3Block>(dest, src, srcSize, width, height, pitch);
+}
+
+void decompressDXT5(byte *dest, const byte *src, size_t srcSize, uint32 width, uint32 height, uint32 pitch) {
+	decompressDXT<DXT5Block>(dest, src, srcSize, width, height, pitch);
+}
+
 } // End of namespace Graphics
@@ -27,15 +27,17 @@
 
 #include "src/common/types.h"
 
-namespace Common {
-	class SeekableReadStream;
-}
-
 namespace Graphics {
 
-void decompressDXT1(byte *dest, Common::SeekableReadStream &src, uint32 width, uint32 height, uint32 pitch);
-void decompressDXT3(byte *dest, Common::SeekableReadStream &src, uint32 width, uint32 height, uint32 pitch);
-void decompressDXT5(byte *dest, Common::SeekableReadStream &src, uint32 width, uint32 height, uint32 pitch);
+/* Decompress S3TC DXTn data of this size into RGBA8 pixels.
+ *
+ * The whole image has to be in src, one 4x4 block after the other.
+ * If srcSize is too small for an image of these dimensions, an
+ * exception is thrown. */
+
+void decompressDXT1(byte *dest, const byte *src, size_t srcSize, uint32 width, uint32 height, uint32 pitch);
+void decompressDXT3(byte *dest, const byte *src, size_t srcSize, uint32 width, uint32 height, uint32 pitch);
+void decompressDXT5(byte *dest, const byte *src, size_t srcSize, uint32 width, uint32 height, uint32 pitch);
 
 } // End of namespace Graphics
 
@@ -30,7 +30,7 @@
 
 namespace Graphics {
 
-Renderable::Renderable(RenderableType type) : _clickable(false), _distance(0.0f) {
+Renderable::Renderable(RenderableType type) : _clickable(false), _distance(0.0f), _drawDistance(0.0f) {
 	switch (type) {
 		case kRenderableTypeVideo:
 			_queueExists  = kQueueVideo;
@@ -138,6 +138,24 @@ bool Renderable::isIn(float UNUSED(x1), float UNUSED(y1), float UNUSED(z1),
 	return false;
 }
 
+bool Renderable::isIn(float UNUSED(x1), float UNUSED(y1), float UNUSED(z1),
+                      float UNUSED(x2), float UNUSED(y2), float UNUSED(z2), float &UNUSED(distance)) const {
+
+	return false;
+}
+
+bool Renderable::isInFrustum(const Common::Frustum &UNUSED(frustum)) const {
+	return true;
+}
+
+float Renderable::getDrawDistance() const {
+	return _drawDistance;
+}
+
+void Renderable::setDrawDistance(float distance) {
+	_drawDistance = distance;
+}
+
 void Renderable::lockFrame() {
 	GfxMan.lockFrame();
 }
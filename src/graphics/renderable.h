@@ -34,6 +34,10 @@
 #include "src/graphics/types.h"
 #include "src/graphics/queueable.h"
 
+namespace Common {
+	class Frustum;
+}
+
 namespace Graphics {
 
 /** An object that can be displayed by the graphics manager. */
@@ -80,6 +84,23 @@ public:
 	virtual bool isIn(float x, float y, float z) const;
 	/** Does the line from x1.y1.z1 to x2.y2.z2 intersect with the object? */
 	virtual bool isIn(float x1, float y1, float z1, float x2, float y2, float z2) const;
+	/** Does the line from x1.y1.z1 to x2.y2.z2 intersect with the object?
+	 *
+	 *  If it does, distance is set to the position along the line where it
+	 *  enters the object, from 0.0f (at x1.y1.z1) to 1.0f (at x2.y2.z2).
+	 */
+	virtual bool isIn(float x1, float y1, float z1, float x2, float y2, float z2, float &distance) const;
+
+	/** Is the object within the view frustum, and close enough to be drawn?
+	 *
+	 *  Objects that can't tell always claim to be.
+	 */
+	virtual bool isInFrustum(const Common::Frustum &frustum) const;
+
+	/** Get the maximum distance from the viewer the object is drawn at. 0.0f means no limit. */
+	float getDrawDistance() const;
+	/** Set the maximum distance from the viewer the object is drawn at. 0.0f means no limit. */
+	void setDrawDistance(float distance);
 
 protected:
 	QueueType _queueExists;
@@ -92,6 +113,8 @@ protected:
 
 	double _distance; ///< The distance of the object from the viewer.
 
+	float _drawDistance; ///< The maximum distance from the viewer the object is drawn at.
+
 	void resort();
 
 	void lockFrame();
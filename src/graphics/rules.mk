@@ -34,6 +34,7 @@ src_graphics_libgraphics_la_SOURCES += \
     src/graphics/glcontainer.h \
     src/graphics/texture.h \
     src/graphics/font.h \
+    src/graphics/glypharrays.h \
     src/graphics/camera.h \
     src/graphics/renderable.h \
     src/graphics/resolution.h \
@@ -56,6 +57,7 @@ src_graphics_libgraphics_la_SOURCES += \
     src/graphics/glcontainer.cpp \
     src/graphics/texture.cpp \
     src/graphics/font.cpp \
+    src/graphics/glypharrays.cpp \
     src/graphics/camera.cpp \
     src/graphics/renderable.cpp \
     src/graphics/yuv_to_rgb.cpp \
@@ -27,7 +27,7 @@
 // derived from mpeg_play. The following copyright notices have been included
 // in accordance with the original license. Please note that the term "software"
 // in this context only applies to the YUVToRGBLookup constructor, YUVToRGBManager
-// constructor and convert420() functions below.
+// constructor and convert420Rows() function below.
 
 // Copyright (c) 1995 The Regents of the University of California.
 // All rights reserved.
@@ -86,6 +86,11 @@
 // BASIS, AND BROWN UNIVERSITY HAS NO OBLIGATION TO PROVIDE MAINTENANCE,
 // SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#define XOREOS_YUV_SSE2 1
+	#include <emmintrin.h>
+#endif
+
 #include "src/common/error.h"
 #include "src/common/singleton.h"
 #include "src/common/util.h"
@@ -158,7 +163,7 @@ YUVToRGBLookup::YUVToRGBLookup(YUVToRGBManager::LuminanceScale scale) {
 	}
 }
 
-YUVToRGBManager::YUVToRGBManager() {
+YUVToRGBManager::YUVToRGBManager() : _useSIMD(hasSIMD()) {
 	int16 *Cr_r_tab = &_colorTab[0 * 256];
 	int16 *Cr_g_tab = &_colorTab[1 * 256];
 	int16 *Cb_g_tab = &_colorTab[2 * 256];
@@ -189,6 +194,151 @@ const YUVToRGBLookup *YUVToRGBManager::getLookup(LuminanceScale scale) {
 	return _lookup.get();
 }
 
+#ifdef XOREOS_YUV_SSE2
+
+/** Fixed-point factor for dividing by 73 when scaling the ITU-R BT.601 luminance range.
+ *
+ *  (x * 10776) >> 16 == (x * 12) / 73 holds for all x in [0, 219].
+ */
+static const int16 kITUScaleFactor = 10776;
+
+/** Fixed-point factors for the fractional parts of the chroma coefficients in the color table.
+ *
+ *  For all a in [0, 128], (a * factor) >> 16 == trunc(a * fraction) holds, where
+ *  fraction is the part of the coefficient after the decimal point. Together with
+ *  the integer part, this gives exactly the same values as the table.
+ */
+static const uint16 kCrRFactor = 26299; ///< 0.419 / 0.299 = 1.401...
+static const uint16 kCrGFactor = 46763; ///< 0.299 / 0.419 = 0.713...
+static const uint16 kCbGFactor = 22568; ///< 0.114 / 0.331 = 0.344...
+static const uint16 kCbBFactor = 50683; ///< 0.587 / 0.331 = 1.773...
+
+/** Multiply signed chroma values in [-128, 127] by a coefficient and truncate, like the color table.
+ *
+ *  @param c       The chroma values, minus 128.
+ *  @param integer The integer part of the coefficient, 0 or 1.
+ *  @param factor  The fixed-point factor for the fractional part of the coefficient.
+ */
+static inline __m128i multiplyChroma(__m128i c, bool integer, uint16 factor) {
+	const __m128i sign = _mm_srai_epi16(c, 15);
+
+	// Work on the absolute value, so that truncation is just a shift
+	const __m128i a = _mm_max_epi16(c, _mm_sub_epi16(_mm_setzero_si128(), c));
+
+	__m128i x = _mm_mulhi_epu16(a, _mm_set1_epi16((int16) factor));
+	if (integer)
+		x = _mm_add_epi16(x, a);
+
+	// Restore the sign
+	return _mm_sub_epi16(_mm_xor_si128(x, sign), sign);
+}
+
+/** Scale luminance values from [16, 235] up to [0, 255], like the YUVToRGBLookup tables do.
+ *
+ *  Values outside that range are clamped first. Since (x * 255) / 219 ==
+ *  x + (x * 12) / 73, the result is exactly the same as the table's.
+ */
+static inline __m128i scaleITU(__m128i x) {
+	x = _mm_max_epi16(x, _mm_set1_epi16(16));
+	x = _mm_min_epi16(x, _mm_set1_epi16(235));
+	x = _mm_sub_epi16(x, _mm_set1_epi16(16));
+
+	return _mm_add_epi16(x, _mm_mulhi_epu16(x, _mm_set1_epi16(kITUScaleFactor)));
+}
+
+/** Convert 16 luminance values to 16 BGRA pixels.
+ *
+ *  @param ySrc The 16 luminance values.
+ *  @param r    The red chroma offset for each pixel, in two halves of 8 pixels.
+ *  @param g    The green chroma offset for each pixel, in two halves of 8 pixels.
+ *  @param b    The blue chroma offset for each pixel, in two halves of 8 pixels.
+ *  @param a    The 16 alpha values.
+ *  @param itu  Do the luminance values use the ITU-R BT.601 range?
+ *  @param dst  The 16 pixels are written here.
+ */
+static inline void convertPixelsSSE2(const byte *ySrc, const __m128i *r, const __m128i *g, const __m128i *b,
+                                     __m128i a, bool itu, byte *dst) {
+
+	const __m128i zero = _mm_setzero_si128();
+
+	const __m128i y  = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ySrc));
+	const __m128i yL = _mm_unpacklo_epi8(y, zero);
+	const __m128i yH = _mm_unpackhi_epi8(y, zero);
+
+	__m128i bL = _mm_add_epi16(yL, b[0]), bH = _mm_add_epi16(yH, b[1]);
+	__m128i gL = _mm_add_epi16(yL, g[0]), gH = _mm_add_epi16(yH, g[1]);
+	__m128i rL = _mm_add_epi16(yL, r[0]), rH = _mm_add_epi16(yH, r[1]);
+
+	if (itu) {
+		bL = scaleITU(bL);
+		bH = scaleITU(bH);
+		gL = scaleITU(gL);
+		gH = scaleITU(gH);
+		rL = scaleITU(rL);
+		rH = scaleITU(rH);
+	}
+
+	// Packing with unsigned saturation clamps to [0, 255], like the tables do
+	const __m128i b8 = _mm_packus_epi16(bL, bH);
+	const __m128i g8 = _mm_packus_epi16(gL, gH);
+	const __m128i r8 = _mm_packus_epi16(rL, rH);
+
+	const __m128i bgL = _mm_unpacklo_epi8(b8, g8), bgH = _mm_unpackhi_epi8(b8, g8);
+	const __m128i raL = _mm_unpacklo_epi8(r8, a ), raH = _mm_unpackhi_epi8(r8, a );
+
+	__m128i *d = reinterpret_cast<__m128i *>(dst);
+
+	_mm_storeu_si128(d + 0, _mm_unpacklo_epi16(bgL, raL));
+	_mm_storeu_si128(d + 1, _mm_unpackhi_epi16(bgL, raL));
+	_mm_storeu_si128(d + 2, _mm_unpacklo_epi16(bgH, raH));
+	_mm_storeu_si128(d + 3, _mm_unpackhi_epi16(bgH, raH));
+}
+
+/** Convert the start of two rows of YUV420 pixels, sharing one row of chroma values.
+ *
+ *  If aSrc0 and aSrc1 are 0, the pixels are fully opaque.
+ *
+ *  @return The number of chroma values converted, a multiple of 8.
+ */
+static int convert420RowsSSE2(bool itu, byte *dst0, byte *dst1,
+                              const byte *ySrc0, const byte *ySrc1, const byte *aSrc0, const byte *aSrc1,
+                              const byte *uSrc, const byte *vSrc, int halfWidth) {
+
+	const __m128i opaque = _mm_set1_epi8((char) 0xFF);
+
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i half = _mm_set1_epi16(128);
+
+	int w = 0;
+	for (; (w + 8) <= halfWidth; w += 8) {
+		/* Calculate the same chroma offsets the color table holds, without the
+		 * offsets into the separate red, green and blue parts of the tables. */
+
+		const __m128i u = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(uSrc + w)), zero), half);
+		const __m128i v = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(vSrc + w)), zero), half);
+
+		const __m128i r16 = multiplyChroma(v, true, kCrRFactor);
+		const __m128i g16 = _mm_sub_epi16(_mm_sub_epi16(zero, multiplyChroma(v, false, kCrGFactor)),
+		                                  multiplyChroma(u, false, kCbGFactor));
+		const __m128i b16 = multiplyChroma(u, true, kCbBFactor);
+
+		// Each chroma offset is used by two neighbouring pixels
+		const __m128i rPixels[2] = { _mm_unpacklo_epi16(r16, r16), _mm_unpackhi_epi16(r16, r16) };
+		const __m128i gPixels[2] = { _mm_unpacklo_epi16(g16, g16), _mm_unpackhi_epi16(g16, g16) };
+		const __m128i bPixels[2] = { _mm_unpacklo_epi16(b16, b16), _mm_unpackhi_epi16(b16, b16) };
+
+		const __m128i a0 = aSrc0 ? _mm_loadu_si128(reinterpret_cast<const __m128i *>(aSrc0 + 2 * w)) : opaque;
+		const __m128i a1 = aSrc1 ? _mm_loadu_si128(reinterpret_cast<const __m128i *>(aSrc1 + 2 * w)) : opaque;
+
+		convertPixelsSSE2(ySrc0 + 2 * w, rPixels, gPixels, bPixels, a0, itu, dst0 + 8 * w);
+		convertPixelsSSE2(ySrc1 + 2 * w, rPixels, gPixels, bPixels, a1, itu, dst1 + 8 * w);
+	}
+
+	return w;
+}
+
+#endif // XOREOS_YUV_SSE2
+
 #define PUT_PIXEL(s, a, d) \
 	L = &rgbToPix[(s)]; \
 	*((d)) = L[cb_b]; \
@@ -196,79 +346,111 @@ const YUVToRGBLookup *YUVToRGBManager::getLookup(LuminanceScale scale) {
 	*((d) + 2) = L[cr_r]; \
 	*((d) + 3) = (a)
 
-void YUVToRGBManager::convert420(LuminanceScale scale, byte *dst, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
-	const YUVToRGBLookup *lookup = YUVToRGBMan.getLookup(scale);
-	const byte *rgbToPix = lookup->getRGBToPix();
+bool YUVToRGBManager::hasSIMD() {
+#ifdef XOREOS_YUV_SSE2
+	return true;
+#else
+	return false;
+#endif
+}
 
-	int halfHeight = yHeight >> 1;
-	int halfWidth = yWidth >> 1;
+bool YUVToRGBManager::getUseSIMD() const {
+	return _useSIMD;
+}
 
-	dst += dstPitch * (yHeight - 2);
+void YUVToRGBManager::setUseSIMD(bool useSIMD) {
+	_useSIMD = useSIMD && hasSIMD();
+}
 
-	for (int h = 0; h < halfHeight; h++) {
-		for (int w = 0; w < halfWidth; w++) {
+void YUVToRGBManager::convert420Rows(LuminanceScale scale, const byte *rgbToPix, byte *dst0, byte *dst1,
+                                     const byte *ySrc0, const byte *ySrc1, const byte *aSrc0, const byte *aSrc1,
+                                     const byte *uSrc, const byte *vSrc, int halfWidth) const {
+
+	// Convert as many pixels as possible with SIMD instructions, and the rest with the tables
+	int start = 0;
+
+#ifdef XOREOS_YUV_SSE2
+	if (_useSIMD)
+		start = convert420RowsSSE2(scale == kScaleITU, dst0, dst1, ySrc0, ySrc1, aSrc0, aSrc1, uSrc, vSrc, halfWidth);
+#endif
+
+	dst0  += 8 * start;
+	dst1  += 8 * start;
+	ySrc0 += 2 * start;
+	ySrc1 += 2 * start;
+
+	if (aSrc0) {
+		aSrc0 += 2 * start;
+		aSrc1 += 2 * start;
+
+		for (int w = start; w < halfWidth; w++) {
 			const byte *L;
 
-			int16 cr_r  = _colorTab[*vSrc + 0 * 256];
-			int16 crb_g = _colorTab[*vSrc + 1 * 256] + _colorTab[*uSrc + 2 * 256];
-			int16 cb_b  = _colorTab[*uSrc + 3 * 256];
-			uSrc++;
-			vSrc++;
-
-			PUT_PIXEL(*ySrc, *aSrc, dst + dstPitch);
-			PUT_PIXEL(*(ySrc + yPitch), *(aSrc + yPitch), dst);
-			ySrc++;
-			aSrc++;
-			dst += 4;
-			PUT_PIXEL(*ySrc, *aSrc, dst + dstPitch);
-			PUT_PIXEL(*(ySrc + yPitch), *(aSrc + yPitch), dst);
-			ySrc++;
-			aSrc++;
-			dst += 4;
+			int16 cr_r  = _colorTab[vSrc[w] + 0 * 256];
+			int16 crb_g = _colorTab[vSrc[w] + 1 * 256] + _colorTab[uSrc[w] + 2 * 256];
+			int16 cb_b  = _colorTab[uSrc[w] + 3 * 256];
+
+			PUT_PIXEL(ySrc0[0], aSrc0[0], dst0);
+			PUT_PIXEL(ySrc1[0], aSrc1[0], dst1);
+			PUT_PIXEL(ySrc0[1], aSrc0[1], dst0 + 4);
+			PUT_PIXEL(ySrc1[1], aSrc1[1], dst1 + 4);
+
+			ySrc0 += 2;
+			ySrc1 += 2;
+			aSrc0 += 2;
+			aSrc1 += 2;
+			dst0  += 8;
+			dst1  += 8;
 		}
 
-		dst -= yWidth * 4 + dstPitch * 2;
-		ySrc += (yPitch << 1) - yWidth;
-		aSrc += (yPitch << 1) - yWidth;
-		uSrc += uvPitch - halfWidth;
-		vSrc += uvPitch - halfWidth;
+		return;
+	}
+
+	for (int w = start; w < halfWidth; w++) {
+		const byte *L;
+
+		int16 cr_r  = _colorTab[vSrc[w] + 0 * 256];
+		int16 crb_g = _colorTab[vSrc[w] + 1 * 256] + _colorTab[uSrc[w] + 2 * 256];
+		int16 cb_b  = _colorTab[uSrc[w] + 3 * 256];
+
+		PUT_PIXEL(ySrc0[0], 0xFF, dst0);
+		PUT_PIXEL(ySrc1[0], 0xFF, dst1);
+		PUT_PIXEL(ySrc0[1], 0xFF, dst0 + 4);
+		PUT_PIXEL(ySrc1[1], 0xFF, dst1 + 4);
+
+		ySrc0 += 2;
+		ySrc1 += 2;
+		dst0  += 8;
+		dst1  += 8;
 	}
 }
 
-void YUVToRGBManager::convert420(LuminanceScale scale, byte *dst, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
-	const YUVToRGBLookup *lookup = YUVToRGBMan.getLookup(scale);
+void YUVToRGBManager::convert420(LuminanceScale scale, byte *dst, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	const YUVToRGBLookup *lookup = getLookup(scale);
 	const byte *rgbToPix = lookup->getRGBToPix();
 
 	int halfHeight = yHeight >> 1;
 	int halfWidth = yWidth >> 1;
 
-	dst += dstPitch * (yHeight - 2);
+	// The image is stored bottom-up in the destination surface
+	dst += dstPitch * (yHeight - 1);
 
 	for (int h = 0; h < halfHeight; h++) {
-		for (int w = 0; w < halfWidth; w++) {
-			const byte *L;
+		convert420Rows(scale, rgbToPix, dst, dst - dstPitch, ySrc, ySrc + yPitch, aSrc, aSrc ? (aSrc + yPitch) : 0,
+		               uSrc, vSrc, halfWidth);
 
-			int16 cr_r  = _colorTab[*vSrc + 0 * 256];
-			int16 crb_g = _colorTab[*vSrc + 1 * 256] + _colorTab[*uSrc + 2 * 256];
-			int16 cb_b  = _colorTab[*uSrc + 3 * 256];
-			uSrc++;
-			vSrc++;
-
-			PUT_PIXEL(*ySrc, 0xFF, dst + dstPitch);
-			PUT_PIXEL(*(ySrc + yPitch), 0xFF, dst);
-			ySrc++;
-			dst += 4;
-			PUT_PIXEL(*ySrc, 0xFF, dst + dstPitch);
-			PUT_PIXEL(*(ySrc + yPitch), 0xFF, dst);
-			ySrc++;
-			dst += 4;
-		}
+		dst  -= dstPitch * 2;
+		ySrc += yPitch * 2;
+		uSrc += uvPitch;
+		vSrc += uvPitch;
 
-		dst -= yWidth * 4 + dstPitch * 2;
-		ySrc += (yPitch << 1) - yWidth;
-		uSrc += uvPitch - halfWidth;
-		vSrc += uvPitch - halfWidth;
+		if (aSrc)
+			aSrc += yPitch * 2;
 	}
 }
 
+void YUVToRGBManager::convert420(LuminanceScale scale, byte *dst, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	convert420(scale, dst, dstPitch, ySrc, uSrc, vSrc, 0, yWidth, yHeight, yPitch, uvPitch);
+}
+
 } // End of namespace Graphics
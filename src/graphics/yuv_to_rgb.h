@@ -75,6 +75,18 @@ public:
 	 */
 	void convert420(LuminanceScale scale, byte *dst, int dstPitch, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch);
 
+	/** Can the conversion use SIMD instructions on this platform? */
+	static bool hasSIMD();
+
+	/** Is the conversion using SIMD instructions? */
+	bool getUseSIMD() const;
+	/**
+	 * Use SIMD instructions for the conversion, if available, or only the
+	 * lookup tables. Both produce exactly the same output; the tables are
+	 * kept as the reference implementation.
+	 */
+	void setUseSIMD(bool useSIMD);
+
 private:
 	friend class Common::Singleton<SingletonBaseType>;
 	YUVToRGBManager();
@@ -82,8 +94,19 @@ private:
 
 	const YUVToRGBLookup *getLookup(LuminanceScale scale);
 
+	/**
+	 * Convert two rows of YUV420 pixels, sharing one row of chroma values.
+	 *
+	 * If aSrc0 and aSrc1 are 0, the pixels are fully opaque.
+	 */
+	void convert420Rows(LuminanceScale scale, const byte *rgbToPix, byte *dst0, byte *dst1,
+	                    const byte *ySrc0, const byte *ySrc1, const byte *aSrc0, const byte *aSrc1,
+	                    const byte *uSrc, const byte *vSrc, int halfWidth) const;
+
 	Common::ScopedPtr<YUVToRGBLookup> _lookup;
 	int16 _colorTab[4 * 256]; // 2048 bytes
+
+	bool _useSIMD;
 };
 
 } // End of namespace Graphics
@@ -27,12 +27,14 @@ src_sound_libsound_la_SOURCES += \
     src/sound/sound.h \
     src/sound/audiostream.h \
     src/sound/interleaver.h \
+    src/sound/samplecache.h \
     $(EMPTY)
 
 src_sound_libsound_la_SOURCES += \
     src/sound/sound.cpp \
     src/sound/audiostream.cpp \
     src/sound/interleaver.cpp \
+    src/sound/samplecache.cpp \
     $(EMPTY)
 
 src_sound_libsound_la_LIBADD = \
@@ -0,0 +1,260 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A cache of fully decoded sounds.
+ */
+
+#include <cstring>
+
+#include "src/common/util.h"
+#include "src/common/scopedptr.h"
+#include "src/common/error.h"
+
+#include "src/sound/samplecache.h"
+#include "src/sound/audiostream.h"
+
+/** Number of samples to decode at once while filling the cache. */
+static const size_t kDecodeChunkSize = 4096;
+
+namespace Sound {
+
+/** A stream playing the shared samples of a cached sound. */
+class CachedAudioStream : public RewindableAudioStream {
+public:
+	CachedAudioStream(const SampleCache::SamplesPtr &samples) : _samples(samples), _pos(0) {
+	}
+
+	size_t readBuffer(int16 *buffer, const size_t numSamples) {
+		const size_t count = MIN<size_t>(numSamples, _samples->data.size() - _pos);
+		if (count > 0)
+			std::memcpy(buffer, &_samples->data[_pos], count * sizeof(int16));
+
+		_pos += count;
+		return count;
+	}
+
+	int getChannels() const {
+		return _samples->channels;
+	}
+
+	int getRate() const {
+		return _samples->rate;
+	}
+
+	bool endOfData() const {
+		return _pos >= _samples->data.size();
+	}
+
+	bool rewind() {
+		_pos = 0;
+		return true;
+	}
+
+	uint64 getLength() const {
+		return _samples->data.size() / _samples->channels;
+	}
+
+private:
+	SampleCache::SamplesPtr _samples;
+
+	size_t _pos; ///< The position of the next sample to read.
+};
+
+
+SampleCache::SampleCache(size_t budget) : _budget(budget), _size(0) {
+}
+
+SampleCache::~SampleCache() {
+}
+
+size_t SampleCache::getBudget() const {
+	Common::StackLock lock(_mutex);
+
+	return _budget;
+}
+
+void SampleCache::setBudget(size_t budget) {
+	Common::StackLock lock(_mutex);
+
+	_budget = budget;
+
+	// Sounds that were too long for the old budget might fit the new one
+	_tooLong.clear();
+
+	shrink();
+}
+
+size_t SampleCache::getSize() const {
+	Common::StackLock lock(_mutex);
+
+	return _size;
+}
+
+size_t SampleCache::getCount() const {
+	Common::StackLock lock(_mutex);
+
+	return _entries.size();
+}
+
+void SampleCache::clear() {
+	Common::StackLock lock(_mutex);
+
+	_entryMap.clear();
+	_entries.clear();
+	_tooLong.clear();
+
+	_size = 0;
+}
+
+RewindableAudioStream *SampleCache::get(const Common::UString &name) {
+	Common::StackLock lock(_mutex);
+
+	EntryMap::iterator entry = _entryMap.find(name);
+	if (entry == _entryMap.end())
+		return 0;
+
+	// Move the sound to the front of the list, marking it as the most recently played
+	_entries.splice(_entries.begin(), _entries, entry->second);
+
+	return new CachedAudioStream(entry->second->samples);
+}
+
+RewindableAudioStream *SampleCache::add(const Common::UString &name, RewindableAudioStream *stream) {
+	Common::ScopedPtr<RewindableAudioStream> audioStream(stream);
+	if (!audioStream)
+		throw Common::Exception("No audio stream");
+
+	size_t maxSize = 0;
+
+	{
+		Common::StackLock lock(_mutex);
+
+		// If the sound was added in the meantime, use the cached samples instead
+		EntryMap::iterator entry = _entryMap.find(name);
+		if (entry != _entryMap.end()) {
+			_entries.splice(_entries.begin(), _entries, entry->second);
+
+			return new CachedAudioStream(entry->second->samples);
+		}
+
+		if (_tooLong.find(name) != _tooLong.end())
+			return audioStream.release();
+
+		maxSize = getMaxSize();
+	}
+
+	const int channels = audioStream->getChannels();
+	if ((maxSize == 0) || (channels <= 0))
+		return audioStream.release();
+
+	Common::ScopedPtr<Samples> samples(new Samples);
+
+	samples->channels = channels;
+	samples->rate     = audioStream->getRate();
+
+	// Decode the sound without holding the lock, so that other sounds can still be played
+	if (!decode(*audioStream, samples->data, maxSize / sizeof(int16))) {
+		if (!audioStream->rewind())
+			throw Common::Exception("Failed to rewind sound \"%s\"", name.c_str());
+
+		Common::StackLock lock(_mutex);
+
+		_tooLong.insert(name);
+		return audioStream.release();
+	}
+
+	SamplesPtr sharedSamples(samples.release());
+
+	Common::StackLock lock(_mutex);
+
+	// Another thread might have added the same sound while we were decoding
+	if (_entryMap.find(name) == _entryMap.end()) {
+		_entries.push_front(Entry());
+
+		_entries.front().name    = name;
+		_entries.front().samples = sharedSamples;
+
+		_entryMap.insert(std::make_pair(name, _entries.begin()));
+
+		_size += getSize(*sharedSamples);
+
+		shrink();
+	}
+
+	return new CachedAudioStream(sharedSamples);
+}
+
+size_t SampleCache::getSize(const Samples &samples) {
+	return samples.data.size() * sizeof(int16);
+}
+
+size_t SampleCache::getMaxSize() const {
+	return _budget / 8;
+}
+
+bool SampleCache::decode(RewindableAudioStream &stream, std::vector<int16> &data, size_t maxSamples) {
+	const uint64 length = stream.getLength();
+	if (length != RewindableAudioStream::kInvalidLength) {
+		// We know the length of the sound beforehand, so we can bail out early
+		if ((length * stream.getChannels()) > maxSamples)
+			return false;
+
+		data.reserve(length * stream.getChannels());
+	}
+
+	while (!stream.endOfData()) {
+		const size_t pos = data.size();
+		data.resize(pos + kDecodeChunkSize);
+
+		const size_t count = stream.readBuffer(&data[pos], kDecodeChunkSize);
+		if (count == AudioStream::kSizeInvalid)
+			throw Common::Exception("Failed to decode sound");
+
+		data.resize(pos + count);
+
+		if (data.size() > maxSamples) {
+			std::vector<int16>().swap(data);
+			return false;
+		}
+
+		if (count == 0)
+			break;
+	}
+
+	// Trim any unused capacity
+	if (data.capacity() > data.size())
+		std::vector<int16>(data).swap(data);
+
+	return true;
+}
+
+void SampleCache::shrink() {
+	while ((_size > _budget) && !_entries.empty()) {
+		const Entry &entry = _entries.back();
+
+		_size -= getSize(*entry.samples);
+
+		_entryMap.erase(entry.name);
+		_entries.pop_back();
+	}
+}
+
+} // End of namespace Sound
@@ -0,0 +1,140 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A cache of fully decoded sounds.
+ */
+
+#ifndef SOUND_SAMPLECACHE_H
+#define SOUND_SAMPLECACHE_H
+
+#include <list>
+#include <map>
+#include <set>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include "src/common/types.h"
+#include "src/common/ustring.h"
+#include "src/common/mutex.h"
+
+namespace Sound {
+
+class RewindableAudioStream;
+
+/** A cache of fully decoded sounds, bounded by a memory budget.
+ *
+ *  Short sounds that are played over and over again, like footsteps or
+ *  button clicks, don't need to be decoded anew every time. Instead, their
+ *  decoded samples are kept in memory and shared by all streams playing
+ *  them. Once the cache grows over its budget, the sounds that haven't
+ *  been played for the longest time are dropped. Streams still playing a
+ *  dropped sound keep its samples alive until they are destroyed.
+ *
+ *  A single sound may take up at most an eighth of the budget. Longer
+ *  sounds are not cached.
+ *
+ *  The cache is thread-safe.
+ */
+class SampleCache : boost::noncopyable {
+public:
+	/** Create a cache with a budget of this many bytes. */
+	SampleCache(size_t budget);
+	~SampleCache();
+
+	/** Return the memory budget of the cache, in bytes. */
+	size_t getBudget() const;
+	/** Change the memory budget of the cache, in bytes. 0 disables the cache. */
+	void setBudget(size_t budget);
+
+	/** Return the number of bytes taken up by all cached sounds. */
+	size_t getSize() const;
+	/** Return the number of cached sounds. */
+	size_t getCount() const;
+
+	/** Drop all cached sounds. */
+	void clear();
+
+	/** Return a new stream playing the cached sound with this name, or 0 if it isn't cached. */
+	RewindableAudioStream *get(const Common::UString &name);
+
+	/** Decode a sound and add it to the cache under this name.
+	 *
+	 *  The cache takes over the stream. If the sound is short enough to be
+	 *  cached, it is decoded completely, the stream is deleted and a new
+	 *  stream playing the cached samples is returned. Otherwise, the stream
+	 *  is rewound and returned as is.
+	 */
+	RewindableAudioStream *add(const Common::UString &name, RewindableAudioStream *stream);
+
+private:
+	/** The decoded samples of a sound. */
+	struct Samples {
+		std::vector<int16> data; ///< Interleaved 16-bit samples.
+
+		int channels; ///< The number of channels.
+		int rate;     ///< The sample rate.
+	};
+
+	typedef boost::shared_ptr<const Samples> SamplesPtr;
+
+	/** A cached sound. */
+	struct Entry {
+		Common::UString name;
+		SamplesPtr samples;
+	};
+
+	/** All cached sounds, the most recently played one first. */
+	typedef std::list<Entry> EntryList;
+	typedef std::map<Common::UString, EntryList::iterator, Common::UString::iless> EntryMap;
+
+	typedef std::set<Common::UString, Common::UString::iless> NameSet;
+
+	size_t _budget; ///< The memory budget in bytes.
+	size_t _size;   ///< The number of bytes taken up by all cached sounds.
+
+	EntryList _entries;
+	EntryMap  _entryMap;
+
+	/** The names of all sounds found to be too long to be cached. */
+	NameSet _tooLong;
+
+	mutable Common::Mutex _mutex;
+
+	/** Return the number of bytes taken up by these samples. */
+	static size_t getSize(const Samples &samples);
+
+	/** Return the maximum number of bytes a single sound may take up. */
+	size_t getMaxSize() const;
+
+	/** Decode the whole stream. Returns false if the sound is longer than maxSamples. */
+	static bool decode(RewindableAudioStream &stream, std::vector<int16> &data, size_t maxSamples);
+
+	/** Drop the least recently played sounds until the cache fits its budget again. */
+	void shrink();
+
+	friend class CachedAudioStream;
+};
+
+} // End of namespace Sound
+
+#endif // SOUND_SAMPLECACHE_H
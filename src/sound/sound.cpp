@@ -23,7 +23,6 @@
  */
 
 #include <cassert>
-#include <cstring>
 
 #include <boost/scope_exit.hpp>
 
@@ -49,30 +48,43 @@
 
 DECLARE_SINGLETON(Sound::SoundManager)
 
-/** Control how many buffers per sound OpenAL will create.
- *
- *  @note clone2727 says: 5 is just a safe number. Mine only reached a max of 2.
- */
-static const size_t kOpenALBufferCount = 5;
-
-/** Number of bytes per OpenAL buffer.
- *
- *  @note Needs to be high enough to prevent stuttering, but low enough to
- *        prevent a noticeable lag. 32768 seems to work just fine.
- */
-static const size_t kOpenALBufferSize = 32768;
-
 namespace Sound {
 
 SoundManager::Channel::Channel(uint32 i, size_t idx, SoundType t,
                                const TypeList::iterator &ti, AudioStream *s, bool d) :
-	id(i), index(idx), state(AL_PAUSED), stream(s, d), source(0),
-	type(t), typeIt(ti), finishedBuffers(0), gain(1.0f) {
+	id(i), index(idx), state(AL_PAUSED), stream(s, d), source(0), bufferCount(0),
+	freeBufferStart(0), freeBufferCount(0), pcm(new int16[kOpenALBufferSize / 2]),
+	type(t), typeIt(ti), finishedBuffers(0), gain(1.0f), activeIndex(0) {
+
+	for (size_t j = 0; j < kOpenALBufferCount; j++) {
+		buffers   [j] = 0;
+		bufferSize[j] = 0;
+
+		freeBuffers[j] = 0;
+	}
+}
+
+
+SoundManager::ChannelLock::ChannelLock(SoundManager &manager, const ChannelHandle &handle) : _channel(0) {
+	Common::StackLock lock(manager._mutex);
+
+	_channel = manager.getChannel(handle);
+	if (_channel)
+		_channel->mutex.lock();
+}
 
+SoundManager::ChannelLock::~ChannelLock() {
+	if (_channel)
+		_channel->mutex.unlock();
+}
+
+SoundManager::Channel *SoundManager::ChannelLock::get() const {
+	return _channel;
 }
 
 
-SoundManager::SoundManager() : _ready(false), _hasSound(false), _hasMultiChannel(false), _format51(0) {
+SoundManager::SoundManager() : _ready(false), _hasSound(false), _hasMultiChannel(false), _format51(0),
+	_sampleCache(0) {
 }
 
 SoundManager::~SoundManager() {
@@ -129,6 +141,9 @@ void SoundManager::init() {
 	setTypeGain(kSoundTypeSFX  , ConfigMan.getDouble("volume_sfx"  , 1.0));
 	setTypeGain(kSoundTypeVoice, ConfigMan.getDouble("volume_voice", 1.0));
 	setTypeGain(kSoundTypeVideo, ConfigMan.getDouble("volume_video", 1.0));
+
+	// The budget of the sample cache is configured in MiB
+	setSampleCacheBudget(((size_t) MAX(ConfigMan.getInt("soundcache", 16), 0)) * 1024 * 1024);
 }
 
 void SoundManager::deinit() {
@@ -138,8 +153,9 @@ void SoundManager::deinit() {
 	if (!destroyThread())
 		warning("SoundManager::deinit(): Sound thread had to be killed");
 
-	for (size_t i = 0; i < kChannelCount; i++)
-		freeChannel(i);
+	stopAll();
+
+	_sampleCache.clear();
 
 	if (_hasSound) {
 		alcMakeContextCurrent(0);
@@ -171,21 +187,16 @@ bool SoundManager::isValidChannel(const ChannelHandle &handle) const {
 }
 
 bool SoundManager::isPlaying(const ChannelHandle &handle) {
-	Common::StackLock lock(_mutex);
-
-	if ((handle.channel >= kChannelCount) || (handle.id == 0) || !_channels[handle.channel])
-		return false;
+	ChannelLock lock(*this, handle);
 
-	if (_channels[handle.channel]->id != handle.id)
+	Channel *channel = lock.get();
+	if (!channel)
 		return false;
 
-	return isPlaying(handle.channel);
+	return isPlaying(*channel);
 }
 
-bool SoundManager::isPlaying(size_t channel) const {
-	if ((channel >= kChannelCount) || !_channels[channel])
-		return false;
-
+bool SoundManager::isPlaying(Channel &channel) const {
 	// TODO: This might pose a problem should we ever need to wait
 	//       for sounds to finish (for syncing, ...). We need to
 	//       add a way for audio streams to tell us how long they are
@@ -196,33 +207,33 @@ bool SoundManager::isPlaying(size_t channel) const {
 	ALenum error = AL_NO_ERROR;
 
 	ALint val;
-	alGetSourcei(_channels[channel]->source, AL_SOURCE_STATE, &val);
+	alGetSourcei(channel.source, AL_SOURCE_STATE, &val);
 	if ((error = alGetError()) != AL_NO_ERROR)
 		throw Common::Exception("OpenAL error while getting source state in %s: 0x%X",
-		                        formatChannel(_channels[channel].get()).c_str(), error);
+		                        formatChannel(&channel).c_str(), error);
 
 	if (val != AL_PLAYING) {
-		if (!_channels[channel]->stream || _channels[channel]->stream->endOfStream()) {
+		if (!channel.stream || channel.stream->endOfStream()) {
 			ALint buffersQueued;
-			alGetSourcei(_channels[channel]->source, AL_BUFFERS_QUEUED, &buffersQueued);
+			alGetSourcei(channel.source, AL_BUFFERS_QUEUED, &buffersQueued);
 			if ((error = alGetError()) != AL_NO_ERROR)
 				throw Common::Exception("OpenAL error while getting queued buffers in %s: 0x%X",
-				                        formatChannel(_channels[channel].get()).c_str(), error);
+				                        formatChannel(&channel).c_str(), error);
 
 			ALint buffersProcessed;
-			alGetSourcei(_channels[channel]->source, AL_BUFFERS_PROCESSED, &buffersProcessed);
+			alGetSourcei(channel.source, AL_BUFFERS_PROCESSED, &buffersProcessed);
 			if ((error = alGetError()) != AL_NO_ERROR)
 				throw Common::Exception("OpenAL error while getting processed buffers in %s: 0x%X",
-				                        formatChannel(_channels[channel].get()).c_str(), error);
+				                        formatChannel(&channel).c_str(), error);
 
 			if (buffersQueued == buffersProcessed)
 				return false;
 		}
 
-		if (_channels[channel]->state != AL_PLAYING)
+		if (channel.state != AL_PLAYING)
 			return true;
 
-		alSourcePlay(_channels[channel]->source);
+		alSourcePlay(channel.source);
 	}
 
 	return true;
@@ -349,6 +360,10 @@ ChannelHandle SoundManager::playAudioStream(AudioStream *audStream, SoundType ty
 	_channels[handle.channel].reset(new Channel(handle.id, handle.channel, type, typeEndIt, audStream, disposeAfterUse));
 	Channel &channel = *_channels[handle.channel];
 
+	// Add the channel to the list of active channels
+	channel.activeIndex = _activeChannels.size();
+	_activeChannels.push_back(handle.channel);
+
 	if (!channel.stream)
 		throw Common::Exception("Could not detect stream type");
 
@@ -362,24 +377,22 @@ ChannelHandle SoundManager::playAudioStream(AudioStream *audStream, SoundType ty
 
 		// Create all needed buffers
 		for (size_t i = 0; i < kOpenALBufferCount; i++) {
-			ALuint buffer;
-
-			alGenBuffers(1, &buffer);
+			alGenBuffers(1, &channel.buffers[i]);
 			if ((error = alGetError()) != AL_NO_ERROR)
 				throw Common::Exception("OpenAL error while generating buffers: 0x%X", error);
 
-			if (fillBuffer(channel, buffer, channel.stream.get(), channel.bufferSize[buffer])) {
+			channel.bufferCount++;
+
+			if (fillBuffer(channel, i)) {
 				// If we could fill the buffer with data, queue it
 
-				alSourceQueueBuffers(channel.source, 1, &buffer);
+				alSourceQueueBuffers(channel.source, 1, &channel.buffers[i]);
 				if ((error = alGetError()) != AL_NO_ERROR)
 					throw Common::Exception("OpenAL error while queueing buffers: 0x%X", error);
 
 			} else
-				// If not, put it into our free list
-				channel.freeBuffers.push_back(buffer);
-
-			channel.buffers.push_back(buffer);
+				// If not, put it into our free ring
+				pushFreeBuffer(channel, i);
 		}
 
 		// Set the gain to the current sound type gain
@@ -399,15 +412,43 @@ ChannelHandle SoundManager::playAudioStream(AudioStream *audStream, SoundType ty
 ChannelHandle SoundManager::playSoundFile(Common::SeekableReadStream *wavStream, SoundType type, bool loop) {
 	checkReady();
 
+	if (!wavStream)
+		throw Common::Exception("No stream");
+
+	return playSoundStream(makeAudioStream(wavStream), type, loop);
+}
+
+ChannelHandle SoundManager::playSoundFile(const Common::UString &name, Common::SeekableReadStream *wavStream,
+                                          SoundType type, bool loop) {
+	checkReady();
+
 	if (!wavStream)
 		throw Common::Exception("No stream");
 
 	AudioStream *audioStream = makeAudioStream(wavStream);
 
+	RewindableAudioStream *reAudStream = dynamic_cast<RewindableAudioStream *>(audioStream);
+	if (reAudStream)
+		audioStream = _sampleCache.add(name, reAudStream);
+
+	return playSoundStream(audioStream, type, loop);
+}
+
+ChannelHandle SoundManager::playCachedSoundFile(const Common::UString &name, SoundType type, bool loop) {
+	checkReady();
+
+	AudioStream *audioStream = _sampleCache.get(name);
+	if (!audioStream)
+		return ChannelHandle();
+
+	return playSoundStream(audioStream, type, loop);
+}
+
+ChannelHandle SoundManager::playSoundStream(AudioStream *audioStream, SoundType type, bool loop) {
 	if (loop) {
 		RewindableAudioStream *reAudStream = dynamic_cast<RewindableAudioStream *>(audioStream);
 		if (!reAudStream)
-			warning("SoundManager::playSoundFile(): The input stream cannot be rewound, this will not loop.");
+			warning("SoundManager::playSoundStream(): The input stream cannot be rewound, this will not loop.");
 		else
 			audioStream = makeLoopingAudioStream(reAudStream, 0);
 	}
@@ -448,7 +489,11 @@ void SoundManager::startChannel(ChannelHandle &handle) {
 	if (!channel || !channel->stream)
 		throw Common::Exception("Invalid channel");
 
-	channel->state = AL_PLAYING;
+	{
+		Common::StackLock channelLock(channel->mutex);
+
+		channel->state = AL_PLAYING;
+	}
 
 	debugC(Common::kDebugSound, 1, "Start sound channel %s", formatChannel(handle).c_str());
 
@@ -490,15 +535,16 @@ void SoundManager::stopChannel(ChannelHandle &handle) {
 void SoundManager::pauseAll(bool pause) {
 	Common::StackLock lock(_mutex);
 
-	for (size_t i = 0; i < kChannelCount; i++)
-		pauseChannel(_channels[i].get(), pause);
+	for (std::vector<size_t>::const_iterator c = _activeChannels.begin(); c != _activeChannels.end(); ++c)
+		pauseChannel(_channels[*c].get(), pause);
 }
 
 void SoundManager::stopAll() {
 	Common::StackLock lock(_mutex);
 
-	for (size_t i = 0; i < kChannelCount; i++)
-		freeChannel(i);
+	// Freeing a channel removes it from the active list
+	while (!_activeChannels.empty())
+		freeChannel(_activeChannels.back());
 }
 
 void SoundManager::setListenerGain(float gain) {
@@ -511,9 +557,9 @@ void SoundManager::setListenerGain(float gain) {
 }
 
 void SoundManager::setChannelPosition(const ChannelHandle &handle, float x, float y, float z) {
-	Common::StackLock lock(_mutex);
+	ChannelLock lock(*this, handle);
 
-	Channel *channel = getChannel(handle);
+	Channel *channel = lock.get();
 	if (!channel || !channel->stream)
 		throw Common::Exception("Invalid channel");
 
@@ -526,9 +572,9 @@ void SoundManager::setChannelPosition(const ChannelHandle &handle, float x, floa
 }
 
 void SoundManager::getChannelPosition(const ChannelHandle &handle, float &x, float &y, float &z) {
-	Common::StackLock lock(_mutex);
+	ChannelLock lock(*this, handle);
 
-	Channel *channel = getChannel(handle);
+	Channel *channel = lock.get();
 	if (!channel || !channel->stream)
 		throw Common::Exception("Invalid channel");
 
@@ -541,9 +587,9 @@ void SoundManager::getChannelPosition(const ChannelHandle &handle, float &x, flo
 }
 
 void SoundManager::setChannelGain(const ChannelHandle &handle, float gain) {
-	Common::StackLock lock(_mutex);
+	ChannelLock lock(*this, handle);
 
-	Channel *channel = getChannel(handle);
+	Channel *channel = lock.get();
 	if (!channel || !channel->stream)
 		throw Common::Exception("Invalid channel");
 
@@ -554,9 +600,9 @@ void SoundManager::setChannelGain(const ChannelHandle &handle, float gain) {
 }
 
 void SoundManager::setChannelPitch(const ChannelHandle &handle, float pitch) {
-	Common::StackLock lock(_mutex);
+	ChannelLock lock(*this, handle);
 
-	Channel *channel = getChannel(handle);
+	Channel *channel = lock.get();
 	if (!channel || !channel->stream)
 		throw Common::Exception("Invalid channel");
 
@@ -565,34 +611,46 @@ void SoundManager::setChannelPitch(const ChannelHandle &handle, float pitch) {
 }
 
 uint64 SoundManager::getChannelSamplesPlayed(const ChannelHandle &handle) {
-	Common::StackLock lock(_mutex);
+	ChannelLock lock(*this, handle);
 
-	Channel *channel = getChannel(handle);
+	Channel *channel = lock.get();
+	if (!channel || !channel->stream)
+		return 0;
+
+	return getSamplesPlayed(*channel);
+}
+
+uint64 SoundManager::getChannelDurationPlayed(const ChannelHandle &handle) {
+	ChannelLock lock(*this, handle);
+
+	Channel *channel = lock.get();
 	if (!channel || !channel->stream)
 		return 0;
 
+	return (getSamplesPlayed(*channel) * 1000) / channel->stream->getRate();
+}
+
+uint64 SoundManager::getSamplesPlayed(Channel &channel) {
 	// Update the queued/unqueued buffers to make sure the channel is up-to-date
-	bufferData(*channel);
+	bufferData(channel);
 
 	// The position within the currently playing buffer
 	ALint currentPosition;
-	alGetSourcei(channel->source, AL_BYTE_OFFSET, &currentPosition);
+	alGetSourcei(channel.source, AL_BYTE_OFFSET, &currentPosition);
 
 	// Total number of bytes processed
-	uint64 byteCount = channel->finishedBuffers + currentPosition;
+	uint64 byteCount = channel.finishedBuffers + currentPosition;
 
 	// Number of 16bit samples per channel
-	return byteCount / channel->stream->getChannels() / 2;
+	return byteCount / channel.stream->getChannels() / 2;
 }
 
-uint64 SoundManager::getChannelDurationPlayed(const ChannelHandle &handle) {
-	Common::StackLock lock(_mutex);
-
-	Channel *channel = getChannel(handle);
-	if (!channel || !channel->stream)
-		return 0;
+void SoundManager::setSampleCacheBudget(size_t budget) {
+	_sampleCache.setBudget(budget);
+}
 
-	return (getChannelSamplesPlayed(handle) * 1000) / channel->stream->getRate();
+void SoundManager::clearSampleCache() {
+	_sampleCache.clear();
 }
 
 void SoundManager::setTypeGain(SoundType type, float gain) {
@@ -607,13 +665,18 @@ void SoundManager::setTypeGain(SoundType type, float gain) {
 	for (TypeList::iterator t = _types[type].list.begin(); t != _types[type].list.end(); ++t) {
 		assert(*t);
 
+		Common::StackLock channelLock((*t)->mutex);
+
 		if (_hasSound)
 			alSourcef((*t)->source, AL_GAIN, (*t)->gain * gain);
 	}
 }
 
-bool SoundManager::fillBuffer(const Channel &channel, ALuint alBuffer,
-                              AudioStream *stream, ALsizei &bufferedSize) const {
+bool SoundManager::fillBuffer(Channel &channel, size_t buffer) const {
+	assert(buffer < kOpenALBufferCount);
+
+	ALsizei &bufferedSize = channel.bufferSize[buffer];
+	AudioStream *stream = channel.stream.get();
 
 	bufferedSize = 0;
 
@@ -648,20 +711,18 @@ bool SoundManager::fillBuffer(const Channel &channel, ALuint alBuffer,
 		return false;
 	}
 
-	// Read in the required amount of samples
+	// Read in the required amount of samples into the channel's scratch space.
+	// OpenAL copies the data, so the scratch space can be reused right away.
 	size_t numSamples = kOpenALBufferSize / 2;
 
-	Common::ScopedArray<byte> buffer(new byte[kOpenALBufferSize]);
-	std::memset(buffer.get(), 0, kOpenALBufferSize);
-
-	numSamples = stream->readBuffer(reinterpret_cast<int16 *>(buffer.get()), numSamples);
+	numSamples = stream->readBuffer(channel.pcm.get(), numSamples);
 	if (numSamples == AudioStream::kSizeInvalid) {
 		warning("Failed reading from stream while filling buffer in %s", formatChannel(&channel).c_str());
 		return false;
 	}
 
 	bufferedSize = numSamples * 2;
-	alBufferData(alBuffer, format, buffer.get(), bufferedSize, stream->getRate());
+	alBufferData(channel.buffers[buffer], format, channel.pcm.get(), bufferedSize, stream->getRate());
 
 	ALenum error = alGetError();
 	if (error != AL_NO_ERROR) {
@@ -672,13 +733,6 @@ bool SoundManager::fillBuffer(const Channel &channel, ALuint alBuffer,
 	return true;
 }
 
-void SoundManager::bufferData(size_t channel) {
-	if ((channel >= kChannelCount) || !_channels[channel])
-		return;
-
-	bufferData(*_channels[channel]);
-}
-
 void SoundManager::bufferData(Channel &channel) {
 	if (!channel.stream)
 		return;
@@ -702,60 +756,97 @@ void SoundManager::bufferData(Channel &channel) {
 		                        formatChannel(&channel).c_str());
 
 	// Unqueue the processed buffers
-	ALuint freeBuffers[kOpenALBufferCount];
-	alSourceUnqueueBuffers(channel.source, buffersProcessed, freeBuffers);
+	ALuint processedBuffers[kOpenALBufferCount];
+	alSourceUnqueueBuffers(channel.source, buffersProcessed, processedBuffers);
 	if ((error = alGetError()) != AL_NO_ERROR)
 		throw Common::Exception("OpenAL error while unqueueing buffers in %s: 0x%X",
 		                        formatChannel(&channel).c_str(), error);
 
-	// Put them into the free buffers list
+	// Put them into the free buffers ring
 	for (size_t i = 0; i < (size_t)buffersProcessed; i++) {
-		channel.freeBuffers.push_back(freeBuffers[i]);
+		size_t buffer = 0;
+		while ((buffer < channel.bufferCount) && (channel.buffers[buffer] != processedBuffers[i]))
+			buffer++;
 
-		channel.finishedBuffers += channel.bufferSize[freeBuffers[i]];
+		if (buffer >= channel.bufferCount)
+			throw Common::Exception("OpenAL unqueued an unknown buffer in %s", formatChannel(&channel).c_str());
+
+		pushFreeBuffer(channel, buffer);
+
+		channel.finishedBuffers += channel.bufferSize[buffer];
 	}
 
 	// Buffer as long as we still have data and free buffers
-	std::list<ALuint>::iterator buffer = channel.freeBuffers.begin();
-	while (buffer != channel.freeBuffers.end()) {
-		if (!fillBuffer(channel, *buffer, channel.stream.get(), channel.bufferSize[*buffer]))
+	while (channel.freeBufferCount > 0) {
+		const size_t buffer = channel.freeBuffers[channel.freeBufferStart];
+
+		if (!fillBuffer(channel, buffer))
 			break;
 
-		alSourceQueueBuffers(channel.source, 1, &*buffer);
+		alSourceQueueBuffers(channel.source, 1, &channel.buffers[buffer]);
 		if ((error = alGetError()) != AL_NO_ERROR)
 			throw Common::Exception("OpenAL error while queueing buffers in %s: 0x%X",
 			                        formatChannel(&channel).c_str(), error);
 
-		buffer = channel.freeBuffers.erase(buffer);
+		channel.freeBufferStart = (channel.freeBufferStart + 1) % kOpenALBufferCount;
+		channel.freeBufferCount--;
 	}
 }
 
+void SoundManager::pushFreeBuffer(Channel &channel, size_t buffer) {
+	assert(channel.freeBufferCount < kOpenALBufferCount);
+
+	channel.freeBuffers[(channel.freeBufferStart + channel.freeBufferCount) % kOpenALBufferCount] = buffer;
+	channel.freeBufferCount++;
+}
+
 void SoundManager::checkReady() {
 	if (!_ready)
 		throw Common::Exception("SoundManager not ready");
 }
 
 void SoundManager::update() {
-	Common::StackLock lock(_mutex);
+	{
+		Common::StackLock lock(_mutex);
 
-	size_t channelCount = 0;
-	for (size_t i = 0; i < kChannelCount; i++) {
-		if (!_channels[i])
-			continue;
+		// Remember which channels are active, so that we don't need the global lock while buffering
+		_updateChannels.clear();
+		for (std::vector<size_t>::const_iterator c = _activeChannels.begin(); c != _activeChannels.end(); ++c) {
+			ChannelHandle handle;
 
-		channelCount++;
+			handle.channel = *c;
+			handle.id      = _channels[*c]->id;
 
-		// Free the channel if it is no longer playing
-		if (!isPlaying(i)) {
-			freeChannel(i);
-			continue;
+			_updateChannels.push_back(handle);
 		}
+	}
+
+	for (std::vector<ChannelHandle>::iterator h = _updateChannels.begin(); h != _updateChannels.end(); ++h) {
+		bool playing = false;
 
-		// Try to buffer some more data
-		bufferData(i);
+		{
+			ChannelLock lock(*this, *h);
+
+			Channel *channel = lock.get();
+			if (!channel)
+				// The channel has been freed in the meantime
+				continue;
+
+			// Try to buffer some more data
+			playing = isPlaying(*channel);
+			if (playing)
+				bufferData(*channel);
+		}
+
+		// Free the channel if it is no longer playing
+		if (!playing) {
+			Common::StackLock lock(_mutex);
+
+			freeChannel(*h);
+		}
 	}
 
-	debugC(Common::kDebugSound, 9, "Active sound channel: %s", Common::composeString(channelCount).c_str());
+	debugC(Common::kDebugSound, 9, "Active sound channel: %u", (uint) _updateChannels.size());
 }
 
 ChannelHandle SoundManager::newChannel() {
@@ -784,6 +875,8 @@ void SoundManager::pauseChannel(Channel *channel, bool pause) {
 	if (!channel || channel->id == 0)
 		return;
 
+	Common::StackLock channelLock(channel->mutex);
+
 	ALenum error = AL_NO_ERROR;
 	if (pause) {
 		if (_hasSound) {
@@ -830,23 +923,38 @@ void SoundManager::freeChannel(size_t channel) {
 		// Nothing to do
 		return;
 
-	// Discard the stream
-	c->stream.reset();
+	{
+		// Wait for the sound thread to finish buffering this channel
+		Common::StackLock channelLock(c->mutex);
 
-	if (_hasSound) {
-		// Delete the channel's OpenAL source
-		if (c->source)
-			alDeleteSources(1, &c->source);
+		// Discard the stream
+		c->stream.reset();
 
-		// Delete the OpenAL buffers
-		for (std::list<ALuint>::iterator buffer = c->buffers.begin(); buffer != c->buffers.end(); ++buffer)
-			alDeleteBuffers(1, &*buffer);
+		if (_hasSound) {
+			// Delete the channel's OpenAL source
+			if (c->source)
+				alDeleteSources(1, &c->source);
+
+			// Delete the OpenAL buffers
+			if (c->bufferCount > 0)
+				alDeleteBuffers((ALsizei) c->bufferCount, c->buffers);
+		}
 	}
 
 	// Remove the channel from the type list
 	if (c->typeIt != _types[c->type].list.end())
 		_types[c->type].list.erase(c->typeIt);
 
+	// Remove the channel from the active list, moving the last active channel into its place
+	assert((c->activeIndex < _activeChannels.size()) && (_activeChannels[c->activeIndex] == channel));
+
+	const size_t lastChannel = _activeChannels.back();
+
+	_activeChannels[c->activeIndex] = lastChannel;
+	_channels[lastChannel]->activeIndex = c->activeIndex;
+
+	_activeChannels.pop_back();
+
 	// And finally delete the channel itself
 	_channels[channel].reset();
 }
@@ -36,7 +36,9 @@
 #endif
 
 #include <list>
-#include <map>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
 
 #include "src/common/types.h"
 #include "src/common/scopedptr.h"
@@ -47,6 +49,7 @@
 #include "src/common/ustring.h"
 
 #include "src/sound/types.h"
+#include "src/sound/samplecache.h"
 
 namespace Common {
 	class SeekableReadStream;
@@ -56,7 +59,19 @@ namespace Sound {
 
 class AudioStream;
 
-/** The sound manager. */
+/** The sound manager.
+ *
+ *  Only the channels that are currently allocated are kept in a list of
+ *  active channels, so that the sound thread's regular update only ever
+ *  visits those.
+ *
+ *  Besides the global mutex protecting the channel slots and lists, each
+ *  channel has its own mutex protecting its OpenAL source and buffers.
+ *  The sound thread only holds a channel's mutex while buffering data for
+ *  it, so changing the properties of one channel doesn't have to wait for
+ *  all others to be buffered. When both are needed, the global mutex is
+ *  always locked first.
+ */
 class SoundManager : public Common::Singleton<SoundManager>, public Common::Thread {
 public:
 	SoundManager();
@@ -74,6 +89,13 @@ public:
 	/** Signal that one of streams currently being played has changed and should be updated immediately. */
 	void triggerUpdate();
 
+	/** Update the sound information, buffering more data for all playing channels.
+	 *
+	 *  This is called regularly by the sound thread. Only call it directly after
+	 *  stopping the sound thread with destroyThread(), like the sound benchmark does.
+	 */
+	void update();
+
 
 	// .--- Channel status
 	/** Does this channel handle point to an existing channel? */
@@ -104,6 +126,37 @@ public:
 	ChannelHandle playSoundFile(Common::SeekableReadStream *wavStream,
 	                            SoundType type, bool loop = false);
 
+	/** Play a sound file, and keep its decoded samples in the sample cache.
+	 *
+	 *  If the sound is short enough, it is decoded completely and cached
+	 *  under this name, so that playCachedSoundFile() can play it again
+	 *  without decoding it anew.
+	 *
+	 *  This only allocate a channel for the sound, to actually start playing it,
+	 *  call startChannel().
+	 *
+	 *  @param  name The name to cache the sound under.
+	 *  @param  wavStream The stream to play. Will be taken over.
+	 *  @param  type The type of the sound.
+	 *  @param  loop Should the sound loop?
+	 *  @return The channel the sound has been assigned to, or -1 on error.
+	 */
+	ChannelHandle playSoundFile(const Common::UString &name, Common::SeekableReadStream *wavStream,
+	                            SoundType type, bool loop = false);
+
+	/** Play a sound file from the sample cache.
+	 *
+	 *  This only allocate a channel for the sound, to actually start playing it,
+	 *  call startChannel().
+	 *
+	 *  @param  name The name the sound was cached under.
+	 *  @param  type The type of the sound.
+	 *  @param  loop Should the sound loop?
+	 *  @return The channel the sound has been assigned to, or an invalid
+	 *          channel if the sound is not in the cache.
+	 */
+	ChannelHandle playCachedSoundFile(const Common::UString &name, SoundType type, bool loop = false);
+
 	/** Play an audio stream.
 	 *
 	 *  This only allocate a channel for the sound, to actually start playing it,
@@ -159,6 +212,14 @@ public:
 	void setChannelPitch(const ChannelHandle &handle, float pitch);
 	// '---
 
+	// .--- Sample cache
+	/** Set the memory budget of the sample cache in bytes. 0 disables the cache. */
+	void setSampleCacheBudget(size_t budget);
+
+	/** Drop all sounds from the sample cache. */
+	void clearSampleCache();
+	// '---
+
 	// .--- Type properties
 	/** Set the gain/volume of all channels of a specific type. */
 	void setTypeGain(SoundType type, float gain);
@@ -179,6 +240,19 @@ public:
 private:
 	static const size_t kChannelCount = 65535; ///< Maximal number of channels.
 
+	/** Control how many buffers per sound OpenAL will create.
+	 *
+	 *  @note clone2727 says: 5 is just a safe number. Mine only reached a max of 2.
+	 */
+	static const size_t kOpenALBufferCount = 5;
+
+	/** Number of bytes per OpenAL buffer.
+	 *
+	 *  @note Needs to be high enough to prevent stuttering, but low enough to
+	 *        prevent a noticeable lag. 32768 seems to work just fine.
+	 */
+	static const size_t kOpenALBufferSize = 32768;
+
 	struct Channel;
 	typedef std::list<Channel *> TypeList;
 
@@ -199,10 +273,17 @@ private:
 
 		ALuint source; ///< OpenAL source for this channel.
 
-		std::list<ALuint> buffers;     ///< List of buffers for that channel.
-		std::list<ALuint> freeBuffers; ///< List of free buffers not filled with data.
+		size_t bufferCount;                     ///< Number of OpenAL buffers created for that channel.
+		ALuint buffers[kOpenALBufferCount];     ///< OpenAL buffers for that channel.
+		ALsizei bufferSize[kOpenALBufferCount]; ///< Size of the data in each buffer in bytes.
 
-		std::map<ALuint, ALsizei> bufferSize; ///< Size of a buffer in bytes.
+		/** Ring of the indices of free buffers not filled with data, in the order they were freed. */
+		size_t freeBuffers[kOpenALBufferCount];
+		size_t freeBufferStart; ///< Position of the first free buffer in the ring.
+		size_t freeBufferCount; ///< Number of free buffers in the ring.
+
+		/** Scratch space for decoding one buffer's worth of PCM data. */
+		Common::ScopedArray<int16> pcm;
 
 		SoundType type;            ///< The channel's sound type.
 		TypeList::iterator typeIt; ///< Iterator into the type list.
@@ -212,9 +293,28 @@ private:
 
 		float gain; ///< The channel's gain.
 
+		size_t activeIndex; ///< The channel's position in the list of active channels.
+
+		Common::Mutex mutex; ///< Protects the channel's OpenAL source and buffers.
+
 		Channel(uint32 i, size_t idx, SoundType t, const TypeList::iterator &ti, AudioStream *s, bool d);
 	};
 
+	/** Find the channel a handle refers to and hold its mutex for as long as the lock exists. */
+	class ChannelLock : boost::noncopyable {
+	public:
+		ChannelLock(SoundManager &manager, const ChannelHandle &handle);
+		~ChannelLock();
+
+		/** Return the locked channel, or 0 if the handle doesn't refer to a channel. */
+		Channel *get() const;
+
+	private:
+		Channel *_channel;
+	};
+
+	friend class ChannelLock;
+
 	bool _ready; ///< Was the sound subsystem successfully initialized?
 
 	bool _hasSound; ///< Do we have working sound output?
@@ -225,8 +325,15 @@ private:
 	Common::ScopedPtr<Channel> _channels[kChannelCount]; ///< The sound channels.
 	Type _types[kSoundTypeMAX]; ///< The sound types.
 
+	std::vector<size_t> _activeChannels; ///< The indices of all allocated channels.
+
+	/** The channels the sound thread is currently updating. */
+	std::vector<ChannelHandle> _updateChannels;
+
 	uint32 _curID; ///< The ID the next sound will get.
 
+	SampleCache _sampleCache; ///< Decoded samples of recently played short sounds.
+
 	Common::Mutex _mutex;
 
 	/** Condition to signal that an update is needed. */
@@ -238,19 +345,20 @@ private:
 	/** Check that the SoundManager was properly initialized. */
 	void checkReady();
 
-	/** Update the sound information. Called regularly from within the thread method. */
-	void update();
+	/** Play a decoded sound file, wrapping it into a looping stream if requested. */
+	ChannelHandle playSoundStream(AudioStream *audioStream, SoundType type, bool loop);
 
 	/** Look for a free place in the channel vector. */
 	ChannelHandle newChannel();
 
 	/** Buffer more sound from the channel to the OpenAL buffers. */
 	void bufferData(Channel &channel);
-	/** Buffer more sound from the channel to the OpenAL buffers. */
-	void bufferData(size_t channel);
 
 	/** Is that channel currently playing a sound? */
-	bool isPlaying(size_t channel) const;
+	bool isPlaying(Channel &channel) const;
+
+	/** Return the number of samples this channel has already played. */
+	uint64 getSamplesPlayed(Channel &channel);
 
 	/** Pause/Unpause a channel. */
 	void pauseChannel(Channel *channel, bool pause);
@@ -269,9 +377,11 @@ private:
 
 	void threadMethod();
 
-	/** Fill the buffer with data from the audio stream. */
-	bool fillBuffer(const Channel &channel, ALuint alBuffer,
-	                AudioStream *stream, ALsizei &bufferedSize) const;
+	/** Fill one of the channel's buffers with data from its audio stream. */
+	bool fillBuffer(Channel &channel, size_t buffer) const;
+
+	/** Put one of the channel's buffers at the end of its ring of free buffers. */
+	static void pushFreeBuffer(Channel &channel, size_t buffer);
 
 	/** Return a string representing this channel. */
 	Common::UString formatChannel(const Channel *channel) const;
@@ -76,10 +76,12 @@
 #include "src/common/error.h"
 #include "src/common/maths.h"
 #include "src/common/readstream.h"
+#include "src/common/memreadstream.h"
 #include "src/common/bitstream.h"
 #include "src/common/huffman.h"
 #include "src/common/rdft.h"
 #include "src/common/dct.h"
+#include "src/common/threadpool.h"
 
 #include "src/graphics/yuv_to_rgb.h"
 
@@ -126,6 +128,30 @@ Bink::VideoFrame::~VideoFrame() {
 }
 
 
+/** A job decoding the video packet of the next frame in the background. */
+class Bink::DecodeJob : public Common::ThreadPool::Job {
+public:
+	DecodeJob(Bink &bink, VideoFrame &frame) : _bink(&bink), _frame(&frame) {
+	}
+
+	void run() {
+		try {
+			_bink->videoPacket(*_frame);
+		} catch (Common::Exception &e) {
+			_bink->_decodeError.reset(new Common::Exception(e));
+		} catch (std::exception &e) {
+			_bink->_decodeError.reset(new Common::Exception(e));
+		} catch (...) {
+			_bink->_decodeError.reset(new Common::Exception("Unknown error while decoding a Bink frame"));
+		}
+	}
+
+private:
+	Bink *_bink;
+	VideoFrame *_frame;
+};
+
+
 Bink::AudioTrack::AudioTrack() : bits(0), bands(0), rdft(0), dct(0) {
 }
 
@@ -140,14 +166,18 @@ Bink::AudioTrack::~AudioTrack() {
 
 
 Bink::Bink(Common::SeekableReadStream *bink) : _bink(bink), _disableAudio(false),
-	_curFrame(0), _audioTrack(0) {
+	_curFrame(0), _audioTrack(0), _decodingAhead(false) {
 
 	assert(_bink);
 
 	load();
+
+	_decodePool.reset(new Common::ThreadPool(1, "BinkDecoder"));
 }
 
 Bink::~Bink() {
+	// Wait for the background decoding to finish before tearing down its data
+	_decodePool.reset();
 }
 
 uint32 Bink::getTimeToNextFrame() const {
@@ -184,6 +214,31 @@ void Bink::processData() {
 
 	VideoFrame &frame = _frames[_curFrame];
 
+	if (_decodingAhead) {
+		finishDecodeAhead(frame);
+	} else {
+		readFrame(frame);
+
+		videoPacket(frame);
+
+		delete frame.bits;
+		frame.bits = 0;
+	}
+
+	showFrame();
+
+	_needCopy = true;
+
+	_curFrame++;
+
+	// Decode the next frame while this one is copied and shown
+	if (_curFrame < _frames.size()) {
+		readFrame(_frames[_curFrame]);
+		startDecodeAhead(_frames[_curFrame]);
+	}
+}
+
+void Bink::readFrame(VideoFrame &frame) {
 	_bink->seek(frame.offset);
 
 	size_t frameSize = frame.size;
@@ -212,7 +267,11 @@ void Bink::processData() {
 					new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink.get(),
 					    audioPacketStart + 4, audioPacketEnd), true);
 
-				audioPacket(audio);
+				{
+					StageTimer timer(*this, kStageAudio);
+
+					audioPacket(audio);
+				}
 
 				delete audio.bits;
 				audio.bits = 0;
@@ -224,21 +283,36 @@ void Bink::processData() {
 		}
 	}
 
-	size_t videoPacketStart = _bink->pos();
-	size_t videoPacketEnd   = _bink->pos() + frameSize;
+	/* Read the whole video packet into memory, so that it can be decoded
+	 * in the background while we're reading from the Bink stream again. */
+	delete frame.bits;
+	frame.bits = new Common::BitStream32LELSB(_bink->readStream(frameSize), true);
+}
+
+void Bink::startDecodeAhead(VideoFrame &frame) {
+	assert(!_decodingAhead);
+
+	_decodingAhead = true;
 
-	frame.bits =
-		new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink.get(),
-		    videoPacketStart, videoPacketEnd), true);
+	_decodePool->addJob(new DecodeJob(*this, frame));
+}
+
+void Bink::finishDecodeAhead(VideoFrame &frame) {
+	assert(_decodingAhead);
+
+	_decodePool->wait();
 
-	videoPacket(frame);
+	_decodingAhead = false;
 
 	delete frame.bits;
 	frame.bits = 0;
 
-	_needCopy = true;
+	if (_decodeError) {
+		Common::Exception error(*_decodeError);
+		_decodeError.reset();
 
-	_curFrame++;
+		throw error;
+	}
 }
 
 void Bink::audioPacket(AudioTrack &audio) {
@@ -264,6 +338,8 @@ void Bink::audioPacket(AudioTrack &audio) {
 void Bink::videoPacket(VideoFrame &video) {
 	assert(video.bits);
 
+	StageTimer timer(*this, kStageVideo);
+
 	if (_hasAlpha) {
 		if (_id == kBIKiID)
 			video.bits->skip(32);
@@ -282,6 +358,10 @@ void Bink::videoPacket(VideoFrame &video) {
 		if (video.bits->pos() >= video.bits->size())
 			break;
 	}
+}
+
+void Bink::showFrame() {
+	StageTimer timer(*this, kStageConvert);
 
 	// Convert the YUVA data we have to BGRA
 	assert(_surface && _curPlanes[0] && _curPlanes[1] && _curPlanes[2] && _curPlanes[3]);
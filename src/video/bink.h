@@ -75,6 +75,7 @@
 
 #include "src/common/types.h"
 #include "src/common/scopedptr.h"
+#include "src/common/error.h"
 
 #include "src/video/decoder.h"
 
@@ -85,11 +86,18 @@ namespace Common {
 
 	class RDFT;
 	class DCT;
+
+	class ThreadPool;
 }
 
 namespace Video {
 
-/** A decoder for RAD Game Tools' Bink videos. */
+/** A decoder for RAD Game Tools' Bink videos.
+ *
+ *  While a frame is shown, the next frame is already decoded in the
+ *  background, so that the decoding overlaps with the color conversion
+ *  and the texture upload of the current frame.
+ */
 class Bink : public VideoDecoder {
 public:
 	Bink(Common::SeekableReadStream *bink);
@@ -276,6 +284,16 @@ private:
 	Common::ScopedArray<byte> _curPlanes[4]; ///< The 4 color planes, YUVA, current frame.
 	Common::ScopedArray<byte> _oldPlanes[4]; ///< The 4 color planes, YUVA, last frame.
 
+	class DecodeJob;
+
+	bool _decodingAhead; ///< Is the next frame being decoded in the background?
+
+	/** The error that occurred while decoding the next frame in the background. */
+	Common::ScopedPtr<Common::Exception> _decodeError;
+
+	/** The thread decoding the next frame in the background. */
+	Common::ScopedPtr<Common::ThreadPool> _decodePool;
+
 	/** Load a Bink file. */
 	void load();
 
@@ -287,8 +305,18 @@ private:
 
 	/** Decode an audio packet. */
 	void audioPacket(AudioTrack &audio);
-	/** Decode a video packet. */
+	/** Read a frame's audio and video packets, decoding the audio. */
+	void readFrame(VideoFrame &frame);
+
+	/** Start decoding the video packet of the next frame in the background. */
+	void startDecodeAhead(VideoFrame &frame);
+	/** Wait for the background decoding of the next frame to finish. */
+	void finishDecodeAhead(VideoFrame &frame);
+
+	/** Decode a video packet into the current planes. */
 	void videoPacket(VideoFrame &video);
+	/** Convert the current planes into the surface and make them the reference planes. */
+	void showFrame();
 
 	/** Decode a plane. */
 	void decodePlane(VideoFrame &video, int planeIdx, bool isChroma);
@@ -24,6 +24,12 @@
 
 #include <cassert>
 
+#include "src/common/fallthrough.h"
+START_IGNORE_IMPLICIT_FALLTHROUGH
+#include <SDL_timer.h>
+STOP_IGNORE_IMPLICIT_FALLTHROUGH
+
+#include "src/common/util.h"
 #include "src/common/error.h"
 #include "src/common/memreadstream.h"
 #include "src/common/threads.h"
@@ -41,12 +47,16 @@
 
 namespace Video {
 
+bool VideoDecoder::_createHeadless = false;
+
 VideoDecoder::VideoDecoder() : Renderable(Graphics::kRenderableTypeVideo),
 	_started(false), _finished(false), _needCopy(false),
 	_width(0), _height(0), _texture(0),
 	_textureWidth(0.0f), _textureHeight(0.0f), _scale(kScaleNone),
-	_soundRate(0), _soundFlags(0) {
+	_soundRate(0), _soundFlags(0), _headless(_createHeadless) {
 
+	for (size_t i = 0; i < kStageMAX; i++)
+		_stageTimes[i].store(0);
 }
 
 VideoDecoder::~VideoDecoder() {
@@ -80,7 +90,8 @@ void VideoDecoder::initVideo(uint32 width, uint32 height) {
 
 	_surface->fill(0, 0, 0, 0);
 
-	rebuild();
+	if (!_headless)
+		rebuild();
 }
 
 void VideoDecoder::initSound(uint16 rate, int channels, bool is16) {
@@ -98,7 +109,8 @@ void VideoDecoder::initSound(uint16 rate, int channels, bool is16) {
 
 	_sound.reset(Sound::makeQueuingAudioStream(_soundRate, channels));
 
-	_soundHandle = SoundMan.playAudioStream(_sound.get(), Sound::kSoundTypeVideo, false);
+	if (!_headless)
+		_soundHandle = SoundMan.playAudioStream(_sound.get(), Sound::kSoundTypeVideo, false);
 }
 
 void VideoDecoder::deinitSound() {
@@ -106,13 +118,30 @@ void VideoDecoder::deinitSound() {
 		return;
 
 	_sound->finish();
-	SoundMan.triggerUpdate();
 
-	SoundMan.stopChannel(_soundHandle);
+	if (!_headless) {
+		SoundMan.triggerUpdate();
+
+		SoundMan.stopChannel(_soundHandle);
+	}
 
 	_sound.reset();
 }
 
+void VideoDecoder::drainSound() {
+	if (!_sound)
+		return;
+
+	StageTimer timer(*this, kStageAudio);
+
+	int16 buffer[4096];
+
+	size_t count;
+	do {
+		count = _sound->readBuffer(buffer, ARRAYSIZE(buffer));
+	} while ((count != Sound::AudioStream::kSizeInvalid) && (count > 0));
+}
+
 void VideoDecoder::queueSound(const byte *data, uint32 dataSize) {
 	assert(data && dataSize);
 
@@ -131,7 +160,8 @@ void VideoDecoder::queueSound(const byte *data, uint32 dataSize) {
 	_sound->queueAudioStream(dataPCM.get());
 	dataPCM.release();
 
-	SoundMan.startChannel(_soundHandle);
+	if (!_headless)
+		SoundMan.startChannel(_soundHandle);
 }
 
 void VideoDecoder::queueSound(Sound::AudioStream *stream) {
@@ -145,7 +175,8 @@ void VideoDecoder::queueSound(Sound::AudioStream *stream) {
 	_sound->queueAudioStream(audioStream.get());
 	audioStream.release();
 
-	SoundMan.startChannel(_soundHandle);
+	if (!_headless)
+		SoundMan.startChannel(_soundHandle);
 }
 
 void VideoDecoder::finishSound() {
@@ -298,6 +329,9 @@ void VideoDecoder::finish() {
 }
 
 void VideoDecoder::start() {
+	if (_headless)
+		throw Common::Exception("Can't play a headless video");
+
 	startVideo();
 
 	show();
@@ -309,4 +343,59 @@ void VideoDecoder::abort() {
 	finish();
 }
 
+void VideoDecoder::setHeadless(bool headless) {
+	_createHeadless = headless;
+}
+
+bool VideoDecoder::decodeNextFrame() {
+	if (!_headless)
+		throw Common::Exception("Only headless videos can be decoded frame by frame");
+
+	_needCopy = false;
+
+	while (!_finished && !_needCopy) {
+		processData();
+
+		drainSound();
+	}
+
+	const bool decoded = _needCopy;
+
+	_needCopy = false;
+
+	return decoded;
+}
+
+const Graphics::Surface &VideoDecoder::getSurface() const {
+	if (!_surface)
+		throw Common::Exception("Video has no surface");
+
+	return *_surface;
+}
+
+uint64 VideoDecoder::getStageTime(Stage stage) const {
+	assert((stage >= 0) && (stage < kStageMAX));
+
+	return _stageTimes[stage].load();
+}
+
+
+VideoDecoder::StageTimer::StageTimer(VideoDecoder &decoder, Stage stage) : _time(0), _start(0) {
+	// Only headless videos are timed, to keep this out of the way of playing videos
+	if (!decoder._headless)
+		return;
+
+	_time  = &decoder._stageTimes[stage];
+	_start = SDL_GetPerformanceCounter();
+}
+
+VideoDecoder::StageTimer::~StageTimer() {
+	if (!_time)
+		return;
+
+	const uint64 elapsed = SDL_GetPerformanceCounter() - _start;
+
+	_time->fetch_add((elapsed * 1000000) / SDL_GetPerformanceFrequency());
+}
+
 } // End of namespace Video
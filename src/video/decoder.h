@@ -25,8 +25,11 @@
 #ifndef VIDEO_DECODER_H
 #define VIDEO_DECODER_H
 
+#include <boost/noncopyable.hpp>
+
 #include "src/common/types.h"
 #include "src/common/scopedptr.h"
+#include "src/common/atomic.h"
 
 #include "src/graphics/types.h"
 #include "src/graphics/glcontainer.h"
@@ -55,6 +58,21 @@ public:
 		kScaleUpDown ///< Scale the video up and down, if necessary.
 	};
 
+	/** The stages of decoding a video, for measuring where the time goes. */
+	enum Stage {
+		kStageAudio   = 0, ///< Decoding the sound.
+		/** Decoding the video bitstream into pixels.
+		 *
+		 *  This includes parsing the bitstream, the IDCT and the motion
+		 *  compensation, which are interleaved block by block. For videos
+		 *  whose codec writes directly into the surface, this also includes
+		 *  the color conversion.
+		 */
+		kStageVideo      ,
+		kStageConvert    , ///< Converting the decoded pixels into the surface.
+		kStageMAX
+	};
+
 	VideoDecoder();
 	~VideoDecoder();
 
@@ -72,6 +90,35 @@ public:
 	/** Abort the playing of the video. */
 	void abort();
 
+	/** Create all videos from now on headless, or not.
+	 *
+	 *  Headless videos have neither a texture nor a sound channel, so they
+	 *  don't need a window or a sound device. They can't be played, only
+	 *  decoded with decodeNextFrame(), which makes them useful for benchmarking
+	 *  and testing the decoders. Only headless videos measure the time spent
+	 *  in each stage of decoding.
+	 */
+	static void setHeadless(bool headless);
+
+	/** Decode the next frame of a headless video into the video's surface.
+	 *
+	 *  The frames are decoded as fast as possible, ignoring the video's frame
+	 *  rate, and the sound is decoded and thrown away.
+	 *
+	 *  @return true if a new frame was decoded, false if the video has ended.
+	 */
+	bool decodeNextFrame();
+
+	/** Return the surface the video's frames are decoded into.
+	 *
+	 *  The surface's dimensions are rounded up to the next power of two, with
+	 *  the video occupying the first getSize() pixels, stored bottom-up.
+	 */
+	const Graphics::Surface &getSurface() const;
+
+	/** Return the time spent in this stage of decoding a headless video so far, in microseconds. */
+	uint64 getStageTime(Stage stage) const;
+
 	/** Return the time, in milliseconds, to the next frame. */
 	virtual uint32 getTimeToNextFrame() const = 0;
 
@@ -89,6 +136,18 @@ protected:
 
 	Common::ScopedPtr<Graphics::Surface> _surface; ///< The video's surface.
 
+	/** Adds the time from its creation to its destruction to a stage of decoding a headless video. */
+	class StageTimer : boost::noncopyable {
+	public:
+		StageTimer(VideoDecoder &decoder, Stage stage);
+		~StageTimer();
+
+	private:
+		boost::atomic<uint64> *_time;
+
+		uint64 _start;
+	};
+
 	/** Create a surface for video of these dimensions.
 	 *
 	 *  Since the data will be copied into the graphics card memory, the surface's
@@ -138,6 +197,17 @@ private:
 	uint16 _soundRate;
 	byte   _soundFlags;
 
+	/** Should new videos be created headless? */
+	static bool _createHeadless;
+
+	bool _headless; ///< Is this a headless video, without a texture or a sound channel?
+
+	/** Time spent in each stage of decoding, in microseconds. */
+	boost::atomic<uint64> _stageTimes[kStageMAX];
+
+
+	/** Decode and throw away all queued sound. */
+	void drainSound();
 
 	/** Update the video, if necessary. */
 	void update();
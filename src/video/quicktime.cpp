@@ -305,7 +305,11 @@ void QuickTimeDecoder::processData() {
 	_nextFrameStartTime += getFrameDuration();
 
 	// Update the audio while we're at it
-	updateAudioBuffer();
+	{
+		StageTimer timer(*this, kStageAudio);
+
+		updateAudioBuffer();
+	}
 
 	// Get the next packet
 	uint32 descId;
@@ -320,7 +324,12 @@ void QuickTimeDecoder::processData() {
 	if (entry._videoCodec) {
 		assert(_surface);
 
-		entry._videoCodec->decodeFrame(*_surface, *frameData);
+		{
+			StageTimer timer(*this, kStageVideo);
+
+			entry._videoCodec->decodeFrame(*_surface, *frameData);
+		}
+
 		_needCopy = true;
 	}
 }
@@ -139,7 +139,12 @@ void XboxMediaVideo::processNextFrame(PacketVideo &videoPacket) {
 			Common::SeekableSubReadStream frameData(_xmv.get(), _xmv->pos(),
 			                                        _xmv->pos() + videoPacket.currentFrameSize);
 
-			_videoCodec->decodeFrame(*_surface, frameData);
+			{
+				StageTimer timer(*this, kStageVideo);
+
+				_videoCodec->decodeFrame(*_surface, frameData);
+			}
+
 			_needCopy = true;
 		} else
 			warning("XboxMediaVideo::processNextFrame(): Video frame without a decoder");
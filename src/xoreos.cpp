@@ -256,6 +256,10 @@ static void initConfig() {
 
 	ConfigMan.setBool(Common::kConfigRealmDefault, "skipvideos", false);
 
+	ConfigMan.setBool(Common::kConfigRealmDefault, "maparchives", false);
+
+	ConfigMan.setInt(Common::kConfigRealmDefault, "soundcache", 16);
+
 	ConfigMan.setBool(Common::kConfigRealmDefault, "saveconf", true);
 
 	// Populate the new config with the defaults
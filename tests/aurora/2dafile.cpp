@@ -155,6 +155,49 @@ GTEST_TEST(TwoDAFileASCII, getRow) {
 	EXPECT_EQ(&twoda.getRow("ID"  , "Nope"), &twoda.getRow(Aurora::kFieldIDInvalid));
 }
 
+GTEST_TEST(TwoDAFileASCII, isNumericColumn) {
+	Common::MemoryReadStream stream(k2DAASCII);
+	const Aurora::TwoDAFile twoda(stream);
+
+	EXPECT_TRUE (twoda.isNumericColumn(0));
+	EXPECT_TRUE (twoda.isNumericColumn(1));
+	EXPECT_FALSE(twoda.isNumericColumn(2));
+
+	EXPECT_FALSE(twoda.isNumericColumn(Aurora::kFieldIDInvalid));
+}
+
+GTEST_TEST(TwoDAFileASCII, getIntColumn) {
+	Common::MemoryReadStream stream(k2DAASCII);
+	const Aurora::TwoDAFile twoda(stream);
+
+	for (size_t i = 0; i < 2; i++) {
+		const std::vector<int32> &column = twoda.getIntColumn(i);
+		ASSERT_EQ(column.size(), ARRAYSIZE(kDataInt[i]));
+
+		for (size_t j = 0; j < ARRAYSIZE(kDataInt[i]); j++)
+			EXPECT_EQ(column[j], kDataInt[i][j]) << "At index " << j << "." << i;
+	}
+
+	EXPECT_TRUE(twoda.getIntColumn(2).empty());
+	EXPECT_TRUE(twoda.getIntColumn(Aurora::kFieldIDInvalid).empty());
+}
+
+GTEST_TEST(TwoDAFileASCII, getFloatColumn) {
+	Common::MemoryReadStream stream(k2DAASCII);
+	const Aurora::TwoDAFile twoda(stream);
+
+	for (size_t i = 0; i < 2; i++) {
+		const std::vector<float> &column = twoda.getFloatColumn(i);
+		ASSERT_EQ(column.size(), ARRAYSIZE(kDataFloat[i]));
+
+		for (size_t j = 0; j < ARRAYSIZE(kDataFloat[i]); j++)
+			EXPECT_FLOAT_EQ(column[j], kDataFloat[i][j]) << "At index " << j << "." << i;
+	}
+
+	EXPECT_TRUE(twoda.getFloatColumn(2).empty());
+	EXPECT_TRUE(twoda.getFloatColumn(Aurora::kFieldIDInvalid).empty());
+}
+
 GTEST_TEST(TwoDAFileASCII, writeBinary) {
 	Common::MemoryReadStream stream(k2DAASCII);
 	const Aurora::TwoDAFile twoda(stream);
@@ -22,14 +22,25 @@
  *  Unit tests for our BIF file archive class.
  */
 
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
 #include "gtest/gtest.h"
 
 #include "src/common/error.h"
+#include "src/common/platform.h"
 #include "src/common/memreadstream.h"
+#include "src/common/memwritestream.h"
+#include "src/common/writefile.h"
+#include "src/common/readfile.h"
+#include "src/common/threadpool.h"
 
 #include "src/aurora/biffile.h"
 #include "src/aurora/keyfile.h"
 
+#include "tests/random.h"
+
 // Percy Bysshe Shelley's "Ozymandias"
 static const char *kFileData =
 	"I met a traveller from an antique land\n"
@@ -308,3 +319,119 @@ GTEST_TEST(BIFFile11, mergeKEY) {
 	EXPECT_EQ(resource.hash, 0);
 	EXPECT_EQ(resource.index, 0);
 }
+
+// --- Concurrent reads ---
+
+static const size_t kStressResourceCount = 64;
+static const size_t kStressThreadCount   = 8;
+static const size_t kStressIterations    = 2000;
+
+/** The contents of resource i of our generated stress test BIF. */
+static byte getStressByte(size_t resource, size_t offset) {
+	return (byte) ((resource * 31 + offset * 7 + (offset >> 8)) & 0xFF);
+}
+
+static size_t getStressSize(size_t resource) {
+	return 100 + resource * 97;
+}
+
+/** Write a BIF V1.0 with kStressResourceCount resources into a file. */
+static void writeStressBIF(const Common::UString &fileName) {
+	Common::MemoryWriteStreamDynamic bif(true);
+
+	bif.writeString("BIFFV1  ");
+	bif.writeUint32LE(kStressResourceCount);
+	bif.writeUint32LE(0);
+	bif.writeUint32LE(20);
+
+	uint32 offset = 20 + kStressResourceCount * 16;
+	for (size_t i = 0; i < kStressResourceCount; i++) {
+		bif.writeUint32LE(i);
+		bif.writeUint32LE(offset);
+		bif.writeUint32LE(getStressSize(i));
+		bif.writeUint32LE(Aurora::kFileTypeTXT);
+
+		offset += getStressSize(i);
+	}
+
+	for (size_t i = 0; i < kStressResourceCount; i++)
+		for (size_t j = 0; j < getStressSize(i); j++)
+			bif.writeByte(getStressByte(i, j));
+
+	Common::WriteFile file(fileName);
+	file.write(bif.getData(), bif.size());
+	file.flush();
+	file.close();
+}
+
+/** Read random resources from the BIF and count every mismatching byte. */
+class StressJob : public Common::ThreadPool::Job {
+public:
+	StressJob(const Aurora::BIFFile &bif, uint32 seed, size_t &failures) :
+		_bif(&bif), _seed(seed), _failures(&failures) {
+	}
+
+	void run() {
+		uint32 state = _seed;
+		for (size_t i = 0; i < kStressIterations; i++) {
+			const size_t index     = makeRandom(state) % kStressResourceCount;
+			const bool   tryNoCopy = makeRandom(state, 0.0f, 1.0f) < 0.5f;
+
+			try {
+				Common::SeekableReadStream *stream = _bif->getResource(index, tryNoCopy);
+
+				if (stream->size() != getStressSize(index))
+					(*_failures)++;
+
+				std::vector<byte> buffer(stream->size());
+				if (stream->read(&buffer[0], buffer.size()) != buffer.size())
+					(*_failures)++;
+
+				for (size_t j = 0; j < buffer.size(); j++)
+					if (buffer[j] != getStressByte(index, j))
+						(*_failures)++;
+
+				delete stream;
+
+			} catch (...) {
+				(*_failures)++;
+			}
+		}
+	}
+
+private:
+	const Aurora::BIFFile *_bif;
+
+	uint32 _seed;
+	size_t *_failures;
+};
+
+GTEST_TEST(BIFFileConcurrent, getResource) {
+	Common::Platform::init();
+
+	const boost::filesystem::path path = boost::filesystem::temp_directory_path() /
+		boost::filesystem::unique_path("%%%%_%%%%_%%%%_%%%%.xoreos");
+
+	const Common::UString fileName = path.generic_string();
+
+	writeStressBIF(fileName);
+
+	{
+		const Aurora::BIFFile bif(new Common::ReadFile(fileName));
+
+		std::vector<size_t> failures(kStressThreadCount, 0);
+
+		Common::ThreadPool pool(kStressThreadCount, "stressReader");
+		ASSERT_EQ(pool.getThreadCount(), kStressThreadCount);
+
+		for (size_t i = 0; i < kStressThreadCount; i++)
+			pool.addJob(new StressJob(bif, i + 1, failures[i]));
+
+		pool.wait();
+
+		for (size_t i = 0; i < kStressThreadCount; i++)
+			EXPECT_EQ(failures[i], 0) << "In thread " << i;
+	}
+
+	boost::filesystem::remove(path);
+}
@@ -157,6 +157,20 @@ GTEST_TEST(GFF3Struct, getFieldNames) {
 		EXPECT_STREQ(fieldNames[i].c_str(), kFieldNamesSingle[i]) << "At index " << i;
 }
 
+GTEST_TEST(GFF3File, getLabelID) {
+	Aurora::GFF3File gff3(new Common::MemoryReadStream(kGFF3SingleStruct));
+
+	for (size_t i = 0; i < ARRAYSIZE(kFieldNamesSingle); i++) {
+		const Aurora::GFF3File::LabelID id = gff3.getLabelID(kFieldNamesSingle[i]);
+
+		ASSERT_NE(id, Aurora::GFF3File::kLabelNone) << "At index " << i;
+		EXPECT_STREQ(gff3.getLabel(id).c_str(), kFieldNamesSingle[i]) << "At index " << i;
+	}
+
+	EXPECT_EQ(gff3.getLabelID("Nope"), Aurora::GFF3File::kLabelNone);
+	EXPECT_THROW(gff3.getLabel(ARRAYSIZE(kFieldNamesSingle)), Common::Exception);
+}
+
 GTEST_TEST(GFF3Struct, getFieldType) {
 	Aurora::GFF3File gff3(new Common::MemoryReadStream(kGFF3SingleStruct));
 	const Aurora::GFF3Struct &strct = gff3.getTopLevel();
@@ -480,6 +494,56 @@ GTEST_TEST(GFF3File, premiumNWN) {
 	EXPECT_STREQ(strct.getString("FieldExoString").c_str(), "Foobar");
 }
 
+GTEST_TEST(GFF3Struct, getByLabelID) {
+	LangMan.addLanguage(Aurora::kLanguageEnglish, 0, Common::kEncodingUTF8);
+
+	Aurora::GFF3File gff3(new Common::MemoryReadStream(kGFF3SingleStruct));
+	const Aurora::GFF3Struct &strct = gff3.getTopLevel();
+
+	for (size_t i = 0; i < ARRAYSIZE(kFieldNamesSingle); i++) {
+		const Aurora::GFF3File::LabelID id = gff3.getLabelID(kFieldNamesSingle[i]);
+
+		EXPECT_TRUE(strct.hasField(id)) << "At index " << i;
+		EXPECT_EQ(strct.getFieldType(id), kFieldTypesSingle[i]) << "At index " << i;
+	}
+
+	EXPECT_EQ(strct.getChar  (gff3.getLabelID("FieldChar"  )), 'x');
+	EXPECT_EQ(strct.getUint  (gff3.getLabelID("FieldUint32")), 25);
+	EXPECT_EQ(strct.getSint  (gff3.getLabelID("FieldSint64")), -42);
+	EXPECT_EQ(strct.getBool  (gff3.getLabelID("FieldByte"  )), true);
+
+	EXPECT_DOUBLE_EQ(strct.getDouble(gff3.getLabelID("FieldDouble")), 25.6);
+
+	EXPECT_STREQ(strct.getString(gff3.getLabelID("FieldExoString")).c_str(), "Foobar");
+	EXPECT_STREQ(strct.getString(gff3.getLabelID("FieldLocString")).c_str(), "Quuuux");
+
+	Aurora::LocString locString;
+	EXPECT_TRUE(strct.getLocString(gff3.getLabelID("FieldLocString"), locString));
+	EXPECT_STREQ(locString.getString().c_str(), "Quuuux");
+
+	float x = 0.0f, y = 0.0f, z = 0.0f;
+	strct.getVector(gff3.getLabelID("FieldVector"), x, y, z);
+	EXPECT_FLOAT_EQ(x, 43.1f);
+	EXPECT_FLOAT_EQ(y, 43.2f);
+	EXPECT_FLOAT_EQ(z, 43.3f);
+
+	Common::SeekableReadStream *data = strct.getData(gff3.getLabelID("FieldVoid"));
+	ASSERT_NE(data, static_cast<Common::SeekableReadStream *>(0));
+	EXPECT_EQ(data->size(), 6);
+	delete data;
+
+	// Labels that don't exist in this GFF3
+	EXPECT_FALSE(strct.hasField(Aurora::GFF3File::kLabelNone));
+	EXPECT_EQ(strct.getFieldType(Aurora::GFF3File::kLabelNone), Aurora::GFF3Struct::kFieldTypeNone);
+	EXPECT_EQ(strct.getUint(gff3.getLabelID("Nope"), 99), 99);
+	EXPECT_STREQ(strct.getString(gff3.getLabelID("Nope"), "NOOOPE").c_str(), "NOOOPE");
+
+	EXPECT_THROW(strct.getUint(gff3.getLabelID("FieldLocString")), Common::Exception);
+	EXPECT_THROW(strct.getStruct(gff3.getLabelID("Nope")), Common::Exception);
+
+	Aurora::LanguageManager::destroy();
+}
+
 // --- GFF3, structs ---
 
 GTEST_TEST(GFF3Struct, getStruct) {
@@ -520,6 +584,11 @@ GTEST_TEST(GFF3Struct, getStruct) {
 	EXPECT_EQ(strct0.getUint("FieldUint32"), 32);
 	EXPECT_EQ(strct1.getUint("FieldUint32"), 33);
 	EXPECT_EQ(strct2.getUint("FieldUint32"), 34);
+
+	const Aurora::GFF3File::LabelID fieldStruct = gff3.getLabelID("FieldStruct");
+
+	EXPECT_EQ(&strct0.getStruct(fieldStruct), &strct1);
+	EXPECT_EQ(&strct1.getStruct(fieldStruct), &strct2);
 }
 
 // --- GFF3, lists ---
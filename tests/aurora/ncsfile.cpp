@@ -0,0 +1,240 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our NCSFile class.
+ */
+
+#include <boost/filesystem.hpp>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/platform.h"
+#include "src/common/memreadstream.h"
+#include "src/common/writefile.h"
+
+#include "src/aurora/resman.h"
+
+#include "src/aurora/nwscript/ncsfile.h"
+
+// (3 + 4) * 2, with the multiplication in a subroutine
+static const byte kNCSSubroutine[] = {
+	0x4E, 0x43, 0x53, 0x20, 0x56, 0x31, 0x2E, 0x30, 0x42, 0x00, 0x00, 0x00, 0x2D, // Header
+	0x04, 0x03, 0x00, 0x00, 0x00, 0x03, // CONST 3
+	0x04, 0x03, 0x00, 0x00, 0x00, 0x04, // CONST 4
+	0x14, 0x20,                         // ADD
+	0x1E, 0x00, 0x00, 0x00, 0x00, 0x08, // JSR +8
+	0x20, 0x00,                         // RETN
+	0x04, 0x03, 0x00, 0x00, 0x00, 0x02, // CONST 2
+	0x16, 0x20,                         // MUL
+	0x20, 0x00                          // RETN
+};
+
+// if (0) 100 else 200
+static const byte kNCSBranch[] = {
+	0x4E, 0x43, 0x53, 0x20, 0x56, 0x31, 0x2E, 0x30, 0x42, 0x00, 0x00, 0x00, 0x2B, // Header
+	0x04, 0x03, 0x00, 0x00, 0x00, 0x00, // CONST 0
+	0x1F, 0x00, 0x00, 0x00, 0x00, 0x12, // JZ +18
+	0x04, 0x03, 0x00, 0x00, 0x00, 0x64, // CONST 100
+	0x1D, 0x00, 0x00, 0x00, 0x00, 0x0C, // JMP +12, to the end of the script
+	0x04, 0x03, 0x00, 0x00, 0x00, 0xC8  // CONST 200
+};
+
+// "ab" == "ab"
+static const byte kNCSString[] = {
+	0x4E, 0x43, 0x53, 0x20, 0x56, 0x31, 0x2E, 0x30, 0x42, 0x00, 0x00, 0x00, 0x1B, // Header
+	0x04, 0x05, 0x00, 0x02, 0x61, 0x62, // CONST "ab"
+	0x04, 0x05, 0x00, 0x02, 0x61, 0x62, // CONST "ab"
+	0x0B, 0x23                          // EQ
+};
+
+// A jump into the middle of an instruction
+static const byte kNCSBrokenJump[] = {
+	0x4E, 0x43, 0x53, 0x20, 0x56, 0x31, 0x2E, 0x30, 0x42, 0x00, 0x00, 0x00, 0x19, // Header
+	0x1D, 0x00, 0x00, 0x00, 0x00, 0x08, // JMP +8
+	0x04, 0x03, 0x00, 0x00, 0x00, 0x01  // CONST 1
+};
+
+// A constant that's missing two bytes
+static const byte kNCSTruncated[] = {
+	0x4E, 0x43, 0x53, 0x20, 0x56, 0x31, 0x2E, 0x30, 0x42, 0x00, 0x00, 0x00, 0x11, // Header
+	0x04, 0x03, 0x00, 0x00              // CONST ?
+};
+
+// An opcode that doesn't exist
+static const byte kNCSIllegal[] = {
+	0x4E, 0x43, 0x53, 0x20, 0x56, 0x31, 0x2E, 0x30, 0x42, 0x00, 0x00, 0x00, 0x0F, // Header
+	0x2E, 0x00                          // ???
+};
+
+// A jump over a constant, followed by an opcode that doesn't exist
+static const byte kNCSJumpIllegal[] = {
+	0x4E, 0x43, 0x53, 0x20, 0x56, 0x31, 0x2E, 0x30, 0x42, 0x00, 0x00, 0x00, 0x23, // Header
+	0x04, 0x03, 0x00, 0x00, 0x00, 0x64, // CONST 100
+	0x1D, 0x00, 0x00, 0x00, 0x00, 0x0C, // JMP +12
+	0x04, 0x03, 0x00, 0x00, 0x00, 0x01, // CONST 1
+	0x20, 0x00,                         // RETN
+	0x2E, 0x00                          // ???
+};
+
+// A jump over a constant, followed by a constant that's missing two bytes
+static const byte kNCSJumpTruncated[] = {
+	0x4E, 0x43, 0x53, 0x20, 0x56, 0x31, 0x2E, 0x30, 0x42, 0x00, 0x00, 0x00, 0x25, // Header
+	0x04, 0x03, 0x00, 0x00, 0x00, 0x64, // CONST 100
+	0x1D, 0x00, 0x00, 0x00, 0x00, 0x0C, // JMP +12
+	0x04, 0x03, 0x00, 0x00, 0x00, 0x01, // CONST 1
+	0x20, 0x00,                         // RETN
+	0x04, 0x03, 0x00, 0x00              // CONST ?
+};
+
+GTEST_TEST(NCSFile, getID) {
+	Aurora::NWScript::NCSFile ncs(new Common::MemoryReadStream(kNCSSubroutine));
+
+	EXPECT_EQ(ncs.getID(), MKTAG('N', 'C', 'S', ' '));
+	EXPECT_EQ(ncs.getVersion(), MKTAG('V', '1', '.', '0'));
+}
+
+GTEST_TEST(NCSFile, runSubroutine) {
+	Aurora::NWScript::NCSFile ncs(new Common::MemoryReadStream(kNCSSubroutine));
+
+	const Aurora::NWScript::Variable &retVal = ncs.run();
+
+	ASSERT_EQ(retVal.getType(), Aurora::NWScript::kTypeInt);
+	EXPECT_EQ(retVal.getInt(), 14);
+}
+
+GTEST_TEST(NCSFile, runBranch) {
+	Aurora::NWScript::NCSFile ncs(new Common::MemoryReadStream(kNCSBranch));
+
+	const Aurora::NWScript::Variable &retVal = ncs.run();
+
+	ASSERT_EQ(retVal.getType(), Aurora::NWScript::kTypeInt);
+	EXPECT_EQ(retVal.getInt(), 200);
+}
+
+GTEST_TEST(NCSFile, runString) {
+	Aurora::NWScript::NCSFile ncs(new Common::MemoryReadStream(kNCSString));
+
+	const Aurora::NWScript::Variable &retVal = ncs.run();
+
+	ASSERT_EQ(retVal.getType(), Aurora::NWScript::kTypeInt);
+	EXPECT_EQ(retVal.getInt(), 1);
+}
+
+GTEST_TEST(NCSFile, runTwice) {
+	Aurora::NWScript::NCSFile ncs(new Common::MemoryReadStream(kNCSSubroutine));
+
+	EXPECT_EQ(ncs.run().getInt(), 14);
+	EXPECT_EQ(ncs.run().getInt(), 14);
+}
+
+GTEST_TEST(NCSFile, runState) {
+	Aurora::NWScript::NCSFile ncs(new Common::MemoryReadStream(kNCSSubroutine));
+
+	// Start right at the CONST 2, with a 5 already on the stack
+	Aurora::NWScript::ScriptState state;
+	state.offset = 35;
+	state.locals.push_back(Aurora::NWScript::Variable((int32) 5));
+
+	const Aurora::NWScript::Variable &retVal = ncs.run(state);
+
+	ASSERT_EQ(retVal.getType(), Aurora::NWScript::kTypeInt);
+	EXPECT_EQ(retVal.getInt(), 10);
+
+	// Not the start of an instruction
+	state.offset = 36;
+	EXPECT_THROW(ncs.run(state), Common::Exception);
+}
+
+GTEST_TEST(NCSFile, runBrokenJump) {
+	Aurora::NWScript::NCSFile ncs(new Common::MemoryReadStream(kNCSBrokenJump));
+
+	EXPECT_THROW(ncs.run(), Common::Exception);
+}
+
+GTEST_TEST(NCSFile, runTruncated) {
+	Aurora::NWScript::NCSFile ncs(new Common::MemoryReadStream(kNCSTruncated));
+
+	EXPECT_THROW(ncs.run(), Common::Exception);
+}
+
+GTEST_TEST(NCSFile, runIllegal) {
+	Aurora::NWScript::NCSFile ncs(new Common::MemoryReadStream(kNCSIllegal));
+
+	EXPECT_THROW(ncs.run(), Common::Exception);
+}
+
+GTEST_TEST(NCSFile, runJumpBeforeIllegal) {
+	Aurora::NWScript::NCSFile ncs(new Common::MemoryReadStream(kNCSJumpIllegal));
+
+	const Aurora::NWScript::Variable &retVal = ncs.run();
+
+	ASSERT_EQ(retVal.getType(), Aurora::NWScript::kTypeInt);
+	EXPECT_EQ(retVal.getInt(), 100);
+}
+
+GTEST_TEST(NCSFile, runJumpBeforeTruncated) {
+	Aurora::NWScript::NCSFile ncs(new Common::MemoryReadStream(kNCSJumpTruncated));
+
+	const Aurora::NWScript::Variable &retVal = ncs.run();
+
+	ASSERT_EQ(retVal.getType(), Aurora::NWScript::kTypeInt);
+	EXPECT_EQ(retVal.getInt(), 100);
+}
+
+static void writeNCS(const boost::filesystem::path &path, const byte *data, size_t size) {
+	Common::WriteFile file(path.generic_string());
+
+	file.write(data, size);
+	file.flush();
+	file.close();
+}
+
+GTEST_TEST(NCSFile, getProgram) {
+	Common::Platform::init();
+
+	const boost::filesystem::path dir = boost::filesystem::temp_directory_path() /
+		boost::filesystem::unique_path("%%%%_%%%%_%%%%_%%%%.xoreos");
+
+	boost::filesystem::create_directory(dir);
+
+	writeNCS(dir / "cached.ncs", kNCSSubroutine, sizeof(kNCSSubroutine));
+
+	ResMan.registerDataBase(dir.generic_string());
+
+	EXPECT_EQ(Aurora::NWScript::NCSFile("cached").run().getInt(), 14);
+	EXPECT_THROW(Aurora::NWScript::NCSFile("missing"), Common::Exception);
+
+	// Without a change to the resources, the script comes out of the cache
+	writeNCS(dir / "cached.ncs", kNCSBranch, sizeof(kNCSBranch));
+
+	EXPECT_EQ(Aurora::NWScript::NCSFile("cached").run().getInt(), 14);
+
+	// Re-indexing the resources invalidates the cache
+	ResMan.registerDataBase(dir.generic_string());
+
+	EXPECT_EQ(Aurora::NWScript::NCSFile("cached").run().getInt(), 200);
+
+	ResMan.clear();
+
+	boost::filesystem::remove_all(dir);
+}
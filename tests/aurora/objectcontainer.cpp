@@ -0,0 +1,164 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our NWScript ObjectContainer class.
+ */
+
+#include "gtest/gtest.h"
+
+#include "src/common/types.h"
+#include "src/common/ustring.h"
+
+#include "src/aurora/nwscript/object.h"
+#include "src/aurora/nwscript/objectcontainer.h"
+
+class TestObject : public Aurora::NWScript::Object {
+public:
+	TestObject(uint32 id, const Common::UString &tag) {
+		_id  = id;
+		_tag = tag;
+	}
+};
+
+static size_t countObjects(Aurora::NWScript::ObjectSearch search) {
+	size_t count = 0;
+	while (search.next())
+		count++;
+
+	return count;
+}
+
+GTEST_TEST(NWScriptObjectContainer, empty) {
+	Aurora::NWScript::ObjectContainer container;
+
+	EXPECT_EQ(container.getFirstObject(), (Aurora::NWScript::Object *) 0);
+	EXPECT_EQ(container.getFirstObjectByTag("foo"), (Aurora::NWScript::Object *) 0);
+	EXPECT_EQ(container.getObjectByID(1), (Aurora::NWScript::Object *) 0);
+
+	Aurora::NWScript::ObjectSearch search = container.findObjects();
+	EXPECT_EQ(search.get(), (Aurora::NWScript::Object *) 0);
+	EXPECT_EQ(search.next(), (Aurora::NWScript::Object *) 0);
+
+	Aurora::NWScript::ObjectSearch emptySearch;
+	EXPECT_EQ(emptySearch.get(), (Aurora::NWScript::Object *) 0);
+}
+
+GTEST_TEST(NWScriptObjectContainer, findObjects) {
+	TestObject object1(1, "foo"), object2(2, "bar"), object3(3, "foo");
+
+	Aurora::NWScript::ObjectContainer container;
+	container.addObject(object1);
+	container.addObject(object2);
+	container.addObject(object3);
+
+	// All objects, in the order they were added
+	Aurora::NWScript::ObjectSearch search = container.findObjects();
+
+	EXPECT_EQ(search.get() , &object1);
+	EXPECT_EQ(search.next(), &object1);
+	EXPECT_EQ(search.next(), &object2);
+	EXPECT_EQ(search.next(), &object3);
+	EXPECT_EQ(search.next(), (Aurora::NWScript::Object *) 0);
+
+	EXPECT_EQ(container.getFirstObject(), &object1);
+}
+
+GTEST_TEST(NWScriptObjectContainer, findObjectsByTag) {
+	TestObject object1(1, "foo"), object2(2, "bar"), object3(3, "foo"), object4(4, "Foo");
+
+	Aurora::NWScript::ObjectContainer container;
+	container.addObject(object1);
+	container.addObject(object2);
+	container.addObject(object3);
+	container.addObject(object4);
+
+	Aurora::NWScript::ObjectSearch search = container.findObjectsByTag("foo");
+
+	EXPECT_EQ(search.next(), &object1);
+	EXPECT_EQ(search.next(), &object3);
+	EXPECT_EQ(search.next(), (Aurora::NWScript::Object *) 0);
+
+	// Tags are case-sensitive
+	EXPECT_EQ(container.getFirstObjectByTag("Foo"), &object4);
+	EXPECT_EQ(container.getFirstObjectByTag("bar"), &object2);
+	EXPECT_EQ(container.getFirstObjectByTag("baz"), (Aurora::NWScript::Object *) 0);
+
+	EXPECT_EQ(countObjects(container.findObjectsByTag("baz")), 0);
+}
+
+GTEST_TEST(NWScriptObjectContainer, getObjectByID) {
+	TestObject object1(1, "foo"), object2(1000, "bar"), object3(0xFFFFFFFF, "baz");
+
+	Aurora::NWScript::ObjectContainer container;
+	container.addObject(object1);
+	container.addObject(object2);
+	container.addObject(object3);
+
+	EXPECT_EQ(container.getObjectByID(1), &object1);
+	EXPECT_EQ(container.getObjectByID(1000), &object2);
+	EXPECT_EQ(container.getObjectByID(0xFFFFFFFF), &object3);
+
+	EXPECT_EQ(container.getObjectByID(0), (Aurora::NWScript::Object *) 0);
+	EXPECT_EQ(container.getObjectByID(2), (Aurora::NWScript::Object *) 0);
+	EXPECT_EQ(container.getObjectByID(5000), (Aurora::NWScript::Object *) 0);
+	EXPECT_EQ(container.getObjectByID(0x7FFFFFFF), (Aurora::NWScript::Object *) 0);
+}
+
+GTEST_TEST(NWScriptObjectContainer, removeObject) {
+	TestObject object1(1, "foo"), object2(2, "foo"), object3(0xFFFFFFFF, "bar");
+
+	Aurora::NWScript::ObjectContainer container;
+	container.addObject(object1);
+	container.addObject(object2);
+	container.addObject(object3);
+
+	container.removeObject(object1);
+	container.removeObject(object3);
+
+	EXPECT_EQ(container.getObjectByID(1), (Aurora::NWScript::Object *) 0);
+	EXPECT_EQ(container.getObjectByID(2), &object2);
+	EXPECT_EQ(container.getObjectByID(0xFFFFFFFF), (Aurora::NWScript::Object *) 0);
+
+	EXPECT_EQ(container.getFirstObjectByTag("foo"), &object2);
+	EXPECT_EQ(container.getFirstObjectByTag("bar"), (Aurora::NWScript::Object *) 0);
+
+	EXPECT_EQ(countObjects(container.findObjects()), 1);
+
+	container.clearObjects();
+
+	EXPECT_EQ(container.getFirstObject(), (Aurora::NWScript::Object *) 0);
+	EXPECT_EQ(container.getObjectByID(2), (Aurora::NWScript::Object *) 0);
+}
+
+GTEST_TEST(NWScriptObjectContainer, sharedID) {
+	TestObject object1(5, "foo"), object2(5, "bar");
+
+	Aurora::NWScript::ObjectContainer container;
+	container.addObject(object1);
+	container.addObject(object2);
+
+	// The first object with an ID wins, and removing another one doesn't affect it
+	EXPECT_EQ(container.getObjectByID(5), &object1);
+
+	container.removeObject(object2);
+
+	EXPECT_EQ(container.getObjectByID(5), &object1);
+}
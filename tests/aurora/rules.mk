@@ -155,3 +155,13 @@ check_PROGRAMS                             += tests/aurora/test_textureatlasfile
 tests_aurora_test_textureatlasfile_SOURCES  = tests/aurora/textureatlasfile.cpp
 tests_aurora_test_textureatlasfile_LDADD    = $(aurora_LIBS)
 tests_aurora_test_textureatlasfile_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                    += tests/aurora/test_ncsfile
+tests_aurora_test_ncsfile_SOURCES  = tests/aurora/ncsfile.cpp
+tests_aurora_test_ncsfile_LDADD    = $(aurora_LIBS)
+tests_aurora_test_ncsfile_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                            += tests/aurora/test_objectcontainer
+tests_aurora_test_objectcontainer_SOURCES  = tests/aurora/objectcontainer.cpp
+tests_aurora_test_objectcontainer_LDADD    = $(aurora_LIBS)
+tests_aurora_test_objectcontainer_CXXFLAGS = $(test_CXXFLAGS)
@@ -0,0 +1,246 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our AABBTree class.
+ */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/common/aabbtree.h"
+#include "src/common/boundingbox.h"
+
+#include "tests/random.h"
+
+static const size_t kBoxCount = 1000;
+
+static Common::BoundingBox makeBox(float x, float y, float z, float size) {
+	Common::BoundingBox box;
+
+	box.add(x, y, z);
+	box.add(x + size, y + size, z + size);
+
+	return box;
+}
+
+/** Intersect the line segment with the exact boxes of the objects. */
+class BoxCallback : public Common::AABBTree::RayCallback {
+public:
+	BoxCallback(const std::vector<Common::BoundingBox> &boxes, const float *line) :
+		_boxes(&boxes), _line(line), _count(0) {
+
+	}
+
+	bool intersect(void *data, float &distance) {
+		_count++;
+
+		const size_t i = reinterpret_cast<size_t>(data) - 1;
+
+		return (*_boxes)[i].isIn(_line[0], _line[1], _line[2], _line[3], _line[4], _line[5], distance);
+	}
+
+	size_t getCount() const {
+		return _count;
+	}
+
+private:
+	const std::vector<Common::BoundingBox> *_boxes;
+	const float *_line;
+
+	size_t _count;
+};
+
+static void *makeData(size_t i) {
+	return reinterpret_cast<void *>(i + 1);
+}
+
+/** Find the closest box hit by a line segment, by looking at every box. */
+static void *findClosestBrute(const std::vector<Common::BoundingBox> &boxes, const std::vector<bool> &present,
+                              const float *line, float &distance) {
+
+	void *closest = 0;
+	distance = 2.0f;
+
+	for (size_t i = 0; i < boxes.size(); i++) {
+		float d;
+		if (present[i] && boxes[i].isIn(line[0], line[1], line[2], line[3], line[4], line[5], d) && (d < distance)) {
+			closest  = makeData(i);
+			distance = d;
+		}
+	}
+
+	return closest;
+}
+
+static void compareClosest(const Common::AABBTree &tree, const std::vector<Common::BoundingBox> &boxes,
+                           const std::vector<bool> &present, uint32 &state) {
+
+	for (size_t t = 0; t < 200; t++) {
+		const float line[6] = {
+			makeRandom(state, 0.0f, 100.0f), makeRandom(state, 0.0f, 100.0f), -10.0f,
+			makeRandom(state, 0.0f, 100.0f), makeRandom(state, 0.0f, 100.0f), 110.0f
+		};
+
+		BoxCallback callback(boxes, line);
+
+		float treeDistance = -1.0f, bruteDistance = -1.0f;
+
+		void *treeHit  = tree.findClosest(line[0], line[1], line[2], line[3], line[4], line[5], callback, treeDistance);
+		void *bruteHit = findClosestBrute(boxes, present, line, bruteDistance);
+
+		EXPECT_EQ(treeHit, bruteHit) << "At case " << t;
+		if (treeHit && bruteHit) {
+			EXPECT_FLOAT_EQ(treeDistance, bruteDistance) << "At case " << t;
+		}
+
+		// Only a small part of all objects should ever be looked at
+		EXPECT_LT(callback.getCount(), boxes.size() / 4) << "At case " << t;
+	}
+}
+
+GTEST_TEST(AABBTree, empty) {
+	Common::AABBTree tree;
+
+	EXPECT_TRUE(tree.empty());
+	EXPECT_EQ(tree.size(), 0);
+	EXPECT_EQ(tree.getHeight(), 0);
+
+	const std::vector<Common::BoundingBox> boxes;
+	const float line[6] = { 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f };
+
+	BoxCallback callback(boxes, line);
+
+	float distance = -1.0f;
+	EXPECT_EQ(tree.findClosest(0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, callback, distance), (void *) 0);
+	EXPECT_EQ(distance, -1.0f);
+}
+
+GTEST_TEST(AABBTree, insert) {
+	Common::AABBTree tree;
+
+	Common::AABBTree::ProxyID proxy1 = tree.insert(makeBox(0.0f, 0.0f, 0.0f, 1.0f), makeData(0));
+	Common::AABBTree::ProxyID proxy2 = tree.insert(makeBox(5.0f, 0.0f, 0.0f, 1.0f), makeData(1));
+
+	EXPECT_FALSE(tree.empty());
+	EXPECT_EQ(tree.size(), 2);
+	EXPECT_EQ(tree.getHeight(), 2);
+
+	EXPECT_EQ(tree.getData(proxy1), makeData(0));
+	EXPECT_EQ(tree.getData(proxy2), makeData(1));
+}
+
+GTEST_TEST(AABBTree, remove) {
+	Common::AABBTree tree;
+
+	Common::AABBTree::ProxyID proxy1 = tree.insert(makeBox(0.0f, 0.0f, 0.0f, 1.0f), makeData(0));
+	Common::AABBTree::ProxyID proxy2 = tree.insert(makeBox(5.0f, 0.0f, 0.0f, 1.0f), makeData(1));
+
+	tree.remove(proxy1);
+
+	EXPECT_EQ(tree.size(), 1);
+	EXPECT_EQ(tree.getHeight(), 1);
+	EXPECT_EQ(tree.getData(proxy2), makeData(1));
+
+	tree.remove(proxy2);
+
+	EXPECT_TRUE(tree.empty());
+	EXPECT_EQ(tree.getHeight(), 0);
+}
+
+GTEST_TEST(AABBTree, move) {
+	Common::AABBTree tree(0.5f);
+
+	Common::AABBTree::ProxyID proxy = tree.insert(makeBox(0.0f, 0.0f, 0.0f, 1.0f), makeData(0));
+
+	// Within the margin
+	EXPECT_FALSE(tree.move(proxy, makeBox(0.25f, 0.0f, 0.0f, 1.0f)));
+	// Outside the margin
+	EXPECT_TRUE(tree.move(proxy, makeBox(10.0f, 0.0f, 0.0f, 1.0f)));
+
+	EXPECT_EQ(tree.getData(proxy), makeData(0));
+}
+
+GTEST_TEST(AABBTree, findClosest) {
+	Common::AABBTree tree;
+
+	std::vector<Common::BoundingBox> boxes;
+	std::vector<bool> present(kBoxCount, true);
+
+	uint32 state = 1;
+	for (size_t i = 0; i < kBoxCount; i++) {
+		boxes.push_back(makeBox(makeRandom(state, 0.0f, 100.0f), makeRandom(state, 0.0f, 100.0f),
+		                        makeRandom(state, 0.0f, 100.0f), makeRandom(state, 0.5f, 2.0f)));
+
+		tree.insert(boxes.back(), makeData(i));
+	}
+
+	EXPECT_EQ(tree.size(), kBoxCount);
+
+	// A balanced tree over 1000 objects shouldn't be much higher than log2(1000) ~= 10
+	EXPECT_LE(tree.getHeight(), 20);
+
+	compareClosest(tree, boxes, present, state);
+}
+
+GTEST_TEST(AABBTree, findClosestAfterChanges) {
+	Common::AABBTree tree;
+
+	std::vector<Common::BoundingBox> boxes;
+	std::vector<Common::AABBTree::ProxyID> proxies;
+	std::vector<bool> present(kBoxCount, true);
+
+	uint32 state = 2;
+	for (size_t i = 0; i < kBoxCount; i++) {
+		boxes.push_back(makeBox(makeRandom(state, 0.0f, 100.0f), makeRandom(state, 0.0f, 100.0f),
+		                        makeRandom(state, 0.0f, 100.0f), 1.0f));
+
+		proxies.push_back(tree.insert(boxes.back(), makeData(i)));
+	}
+
+	// Move every other box around and remove every third
+	for (size_t i = 0; i < kBoxCount; i += 2) {
+		boxes[i] = makeBox(makeRandom(state, 0.0f, 100.0f), makeRandom(state, 0.0f, 100.0f),
+		                   makeRandom(state, 0.0f, 100.0f), 1.0f);
+
+		tree.move(proxies[i], boxes[i]);
+	}
+
+	for (size_t i = 0; i < kBoxCount; i += 3) {
+		tree.remove(proxies[i]);
+		present[i] = false;
+	}
+
+	EXPECT_EQ(tree.size(), kBoxCount - (kBoxCount + 2) / 3);
+	EXPECT_LE(tree.getHeight(), 20);
+
+	compareClosest(tree, boxes, present, state);
+
+	// Re-add the removed boxes; they should reuse the freed nodes
+	for (size_t i = 0; i < kBoxCount; i += 3) {
+		proxies[i] = tree.insert(boxes[i], makeData(i));
+		present[i] = true;
+	}
+
+	EXPECT_EQ(tree.size(), kBoxCount);
+
+	compareClosest(tree, boxes, present, state);
+}
@@ -22,12 +22,16 @@
  *  Unit tests for our bit stream.
  */
 
+#include <vector>
+
 #include "gtest/gtest.h"
 
 #include "src/common/util.h"
 #include "src/common/memreadstream.h"
 #include "src/common/bitstream.h"
 
+#include "tests/random.h"
+
 GTEST_TEST(BitStream, skip) {
 	static const byte data[4] = { 0 };
 	Common::MemoryReadStream stream(data);
@@ -192,3 +196,113 @@ GTEST_TEST(BitStream, BitStream64BELSB) {
 
 	testBitStream(bitStream, compValues);
 }
+
+/** Return bit n of the data, as the bit stream with this memory layout should hand it out. */
+static uint32 getReferenceBit(const std::vector<byte> &data, size_t n,
+                              size_t valueBits, bool isLE, bool isMSB2LSB) {
+
+	const size_t valueBytes = valueBits / 8;
+	const size_t value      = n / valueBits;
+
+	size_t bit = n % valueBits;
+	if (isMSB2LSB)
+		bit = valueBits - 1 - bit;
+
+	// Byte offset within the value
+	const size_t byteInValue = isLE ? (bit / 8) : (valueBytes - 1 - bit / 8);
+
+	return (data[value * valueBytes + byteInValue] >> (bit % 8)) & 1;
+}
+
+/** Read a mix of bit counts using getBits(), peekBits() and skip() and compare with the reference. */
+template<typename BitStreamType>
+static void testBitStreamMixed(size_t valueBits, bool isLE, bool isMSB2LSB) {
+	// More than one block of the bit stream's buffer, and not a whole number of values
+	std::vector<byte> data(1003);
+
+	uint32 seed = 42;
+	for (size_t i = 0; i < data.size(); i++)
+		data[i] = makeRandom(seed) >> 8;
+
+	const size_t size = ((data.size() * 8) / valueBits) * valueBits;
+
+	Common::MemoryReadStream stream(&data[0], data.size());
+	BitStreamType bitStream(stream);
+
+	EXPECT_EQ(bitStream.size(), size);
+	EXPECT_EQ(bitStream.isMSBFirst(), isMSB2LSB);
+
+	size_t pos = 0;
+	for (size_t i = 0; pos < size; i++) {
+		const size_t n = MIN<size_t>(makeRandom(seed) % 33, size - pos);
+
+		uint32 reference = 0;
+		for (size_t j = 0; j < n; j++) {
+			const uint32 bit = getReferenceBit(data, pos + j, valueBits, isLE, isMSB2LSB);
+
+			if (isMSB2LSB)
+				reference = (reference << 1) | bit;
+			else
+				reference |= bit << j;
+		}
+
+		EXPECT_EQ(bitStream.peekBits(n), reference) << "At bit " << pos;
+
+		// Alternate between reading the bits and skipping over them
+		if ((i % 3) == 2)
+			bitStream.skip(n);
+		else
+			EXPECT_EQ(bitStream.getBits(n), reference) << "At bit " << pos;
+
+		pos += n;
+		ASSERT_EQ(bitStream.pos(), pos);
+	}
+
+	EXPECT_TRUE(bitStream.eos());
+	EXPECT_EQ(bitStream.peekBits(8), 0);
+	EXPECT_THROW(bitStream.getBit(), Common::Exception);
+
+	// Skip far ahead, then back to the start
+	bitStream.rewind();
+	EXPECT_EQ(bitStream.pos(), 0);
+
+	bitStream.skip(size - 13);
+	EXPECT_EQ(bitStream.pos(), size - 13);
+
+	for (size_t i = 0; i < 13; i++)
+		EXPECT_EQ(bitStream.getBit(), getReferenceBit(data, size - 13 + i, valueBits, isLE, isMSB2LSB));
+
+	bitStream.rewind();
+	bitStream.skip(301);
+
+	for (size_t i = 0; i < 13; i++)
+		EXPECT_EQ(bitStream.getBit(), getReferenceBit(data, 301 + i, valueBits, isLE, isMSB2LSB));
+
+	EXPECT_THROW(bitStream.skip(size), Common::Exception);
+}
+
+GTEST_TEST(BitStream, mixed8) {
+	testBitStreamMixed<Common::BitStream8MSB>(8, false, true );
+	testBitStreamMixed<Common::BitStream8LSB>(8, false, false);
+}
+
+GTEST_TEST(BitStream, mixed16) {
+	testBitStreamMixed<Common::BitStream16LEMSB>(16, true , true );
+	testBitStreamMixed<Common::BitStream16LELSB>(16, true , false);
+	testBitStreamMixed<Common::BitStream16BEMSB>(16, false, true );
+	testBitStreamMixed<Common::BitStream16BELSB>(16, false, false);
+}
+
+GTEST_TEST(BitStream, mixed32) {
+	testBitStreamMixed<Common::BitStream32LEMSB>(32, true , true );
+	testBitStreamMixed<Common::BitStream32LELSB>(32, true , false);
+	testBitStreamMixed<Common::BitStream32BEMSB>(32, false, true );
+	testBitStreamMixed<Common::BitStream32BELSB>(32, false, false);
+}
+
+GTEST_TEST(BitStream, mixed64) {
+	testBitStreamMixed<Common::BitStream64LEMSB>(64, true , true );
+	testBitStreamMixed<Common::BitStream64LELSB>(64, true , false);
+	testBitStreamMixed<Common::BitStream64BEMSB>(64, false, true );
+	testBitStreamMixed<Common::BitStream64BELSB>(64, false, false);
+}
@@ -210,6 +210,31 @@ GTEST_TEST(BoundingBox, translate) {
 	compareULP(b.getOrigin(), kResult);
 }
 
+GTEST_TEST(BoundingBox, isInLineDistance) {
+	Common::BoundingBox b;
+
+	b.add(0.0f, 0.0f, 0.0f);
+	b.add(1.0f, 1.0f, 1.0f);
+
+	float distance = -1.0f;
+
+	EXPECT_TRUE(b.isIn(-1.0f, 0.5f, 0.5f, 3.0f, 0.5f, 0.5f, distance));
+	EXPECT_FLOAT_EQ(distance, 0.25f);
+
+	EXPECT_TRUE(b.isIn(0.5f, 0.5f, 3.0f, 0.5f, 0.5f, -1.0f, distance));
+	EXPECT_FLOAT_EQ(distance, 0.5f);
+
+	// Starting inside the box
+	EXPECT_TRUE(b.isIn(0.5f, 0.5f, 0.5f, 3.0f, 3.0f, 3.0f, distance));
+	EXPECT_FLOAT_EQ(distance, 0.0f);
+
+	// Missing the box, or ending in front of it
+	EXPECT_FALSE(b.isIn(-1.0f, 2.0f, 0.5f, 3.0f, 2.0f, 0.5f, distance));
+	EXPECT_FALSE(b.isIn(-3.0f, 0.5f, 0.5f, -1.0f, 0.5f, 0.5f, distance));
+
+	EXPECT_FALSE(Common::BoundingBox().isIn(-1.0f, 0.5f, 0.5f, 3.0f, 0.5f, 0.5f, distance));
+}
+
 GTEST_TEST(BoundingBox, scale) {
 	static const float kResult[] = {
 		2.0f, 0.0f, 0.0f, 0.0f,
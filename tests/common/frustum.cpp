@@ -0,0 +1,117 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for the Frustum class.
+ */
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "gtest/gtest.h"
+
+#include "src/common/frustum.h"
+#include "src/common/boundingbox.h"
+#include "src/common/maths.h"
+
+static Common::BoundingBox makeBox(float x, float y, float z, float size) {
+	Common::BoundingBox box;
+
+	box.add(x - size, y - size, z - size);
+	box.add(x + size, y + size, z + size);
+
+	return box;
+}
+
+/** A camera at the origin, looking down the negative z axis. */
+static Common::Frustum makePerspective(const glm::mat4 &modelview = glm::mat4()) {
+	return Common::Frustum(glm::perspective(Common::deg2rad(90.0f), 1.0f, 1.0f, 100.0f), modelview);
+}
+
+GTEST_TEST(Frustum, everything) {
+	const Common::Frustum frustum;
+
+	EXPECT_TRUE(frustum.isIn(makeBox(   0.0f, 0.0f,    0.0f, 1.0f)));
+	EXPECT_TRUE(frustum.isIn(makeBox(1000.0f, 0.0f, -500.0f, 1.0f)));
+
+	EXPECT_FALSE(frustum.isIn(Common::BoundingBox()));
+}
+
+GTEST_TEST(Frustum, perspective) {
+	const Common::Frustum frustum = makePerspective();
+
+	EXPECT_TRUE(frustum.isIn(makeBox(0.0f, 0.0f, -10.0f, 1.0f)));
+	EXPECT_TRUE(frustum.isIn(makeBox(8.0f, 8.0f, -10.0f, 1.0f)));
+
+	// Behind the camera
+	EXPECT_FALSE(frustum.isIn(makeBox(0.0f, 0.0f, 10.0f, 1.0f)));
+	// Left, right, below and above
+	EXPECT_FALSE(frustum.isIn(makeBox(-20.0f,   0.0f, -10.0f, 1.0f)));
+	EXPECT_FALSE(frustum.isIn(makeBox( 20.0f,   0.0f, -10.0f, 1.0f)));
+	EXPECT_FALSE(frustum.isIn(makeBox(  0.0f, -20.0f, -10.0f, 1.0f)));
+	EXPECT_FALSE(frustum.isIn(makeBox(  0.0f,  20.0f, -10.0f, 1.0f)));
+	// Beyond the far plane
+	EXPECT_FALSE(frustum.isIn(makeBox(0.0f, 0.0f, -200.0f, 1.0f)));
+
+	// Crossing the near, the far and a side plane
+	EXPECT_TRUE(frustum.isIn(makeBox( 0.0f, 0.0f,   -1.0f, 1.0f)));
+	EXPECT_TRUE(frustum.isIn(makeBox( 0.0f, 0.0f, -100.0f, 1.0f)));
+	EXPECT_TRUE(frustum.isIn(makeBox(10.5f, 0.0f,  -10.0f, 1.0f)));
+
+	// Containing the whole frustum
+	EXPECT_TRUE(frustum.isIn(makeBox(0.0f, 0.0f, 0.0f, 1000.0f)));
+}
+
+GTEST_TEST(Frustum, orthogonal) {
+	const Common::Frustum frustum(glm::ortho(-10.0f, 10.0f, -10.0f, 10.0f, 1.0f, 100.0f), glm::mat4());
+
+	EXPECT_TRUE (frustum.isIn(makeBox(  9.0f, 0.0f, -50.0f, 0.5f)));
+	EXPECT_FALSE(frustum.isIn(makeBox( 12.0f, 0.0f, -50.0f, 0.5f)));
+	EXPECT_FALSE(frustum.isIn(makeBox(  0.0f, 0.0f,  50.0f, 0.5f)));
+}
+
+GTEST_TEST(Frustum, modelview) {
+	// Move the camera to 100.0f on the x axis, and turn it to look down the negative x axis
+	glm::mat4 modelview;
+	modelview = glm::rotate(modelview, Common::deg2rad(-90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	modelview = glm::translate(modelview, glm::vec3(-100.0f, 0.0f, 0.0f));
+
+	const Common::Frustum frustum = makePerspective(modelview);
+
+	EXPECT_NEAR(frustum.getEye().x, 100.0f, 0.0001f);
+	EXPECT_NEAR(frustum.getEye().y,   0.0f, 0.0001f);
+	EXPECT_NEAR(frustum.getEye().z,   0.0f, 0.0001f);
+
+	EXPECT_TRUE (frustum.isIn(makeBox( 90.0f, 0.0f, 0.0f, 1.0f)));
+	EXPECT_FALSE(frustum.isIn(makeBox(110.0f, 0.0f, 0.0f, 1.0f)));
+	EXPECT_FALSE(frustum.isIn(makeBox( 90.0f, 0.0f, 20.0f, 1.0f)));
+}
+
+GTEST_TEST(Frustum, distance) {
+	const Common::Frustum frustum = makePerspective();
+
+	EXPECT_TRUE (frustum.isIn(makeBox(0.0f, 0.0f, -50.0f, 1.0f), 60.0f));
+	EXPECT_FALSE(frustum.isIn(makeBox(0.0f, 0.0f, -50.0f, 1.0f), 40.0f));
+
+	// The distance is measured to the closest point of the box
+	EXPECT_TRUE(frustum.isIn(makeBox(0.0f, 0.0f, -50.0f, 10.0f), 45.0f));
+
+	// Close enough, but outside the frustum
+	EXPECT_FALSE(frustum.isIn(makeBox(0.0f, 0.0f, 10.0f, 1.0f), 60.0f));
+}
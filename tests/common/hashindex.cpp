@@ -0,0 +1,225 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our HashIndex template.
+ */
+
+#include <map>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/common/hashindex.h"
+
+/** A simple, deterministic key generator, to get well-spread 64-bit keys. */
+static uint64 makeKey(uint64 i) {
+	uint64 key = (i + 1) * UINT64_C(0x9E3779B97F4A7C15);
+
+	return key ^ (key >> 29);
+}
+
+GTEST_TEST(HashIndex, empty) {
+	Common::HashIndex<int> index;
+
+	EXPECT_TRUE(index.empty());
+	EXPECT_EQ(index.size(), 0);
+
+	EXPECT_EQ(index.find(0), static_cast<int *>(0));
+	EXPECT_EQ(index.find(23), static_cast<int *>(0));
+
+	EXPECT_FALSE(index.erase(23));
+
+	EXPECT_TRUE(index.begin() == index.end());
+}
+
+GTEST_TEST(HashIndex, insertAndFind) {
+	Common::HashIndex<int> index;
+
+	index[23] = 5;
+	index[42] = 6;
+	index[0]  = 7;
+
+	EXPECT_FALSE(index.empty());
+	EXPECT_EQ(index.size(), 3);
+
+	ASSERT_NE(index.find(23), static_cast<int *>(0));
+	ASSERT_NE(index.find(42), static_cast<int *>(0));
+	ASSERT_NE(index.find(0) , static_cast<int *>(0));
+
+	EXPECT_EQ(*index.find(23), 5);
+	EXPECT_EQ(*index.find(42), 6);
+	EXPECT_EQ(*index.find(0) , 7);
+
+	EXPECT_EQ(index.find(1), static_cast<int *>(0));
+
+	// Accessing an existing key doesn't create a new entry
+	index[23] = 8;
+
+	EXPECT_EQ(index.size(), 3);
+	EXPECT_EQ(*index.find(23), 8);
+}
+
+GTEST_TEST(HashIndex, defaultValue) {
+	Common::HashIndex<int> index;
+
+	EXPECT_EQ(index[23], 0);
+	EXPECT_EQ(index.size(), 1);
+}
+
+GTEST_TEST(HashIndex, grow) {
+	static const size_t kCount = 10000;
+
+	Common::HashIndex<size_t> index;
+
+	for (size_t i = 0; i < kCount; i++)
+		index[makeKey(i)] = i;
+
+	EXPECT_EQ(index.size(), kCount);
+
+	for (size_t i = 0; i < kCount; i++) {
+		const size_t *value = index.find(makeKey(i));
+
+		ASSERT_NE(value, static_cast<const size_t *>(0)) << "At index " << i;
+		EXPECT_EQ(*value, i) << "At index " << i;
+	}
+
+	EXPECT_EQ(index.find(makeKey(kCount)), static_cast<size_t *>(0));
+}
+
+GTEST_TEST(HashIndex, erase) {
+	static const size_t kCount = 10000;
+
+	Common::HashIndex<size_t> index;
+
+	for (size_t i = 0; i < kCount; i++)
+		index[makeKey(i)] = i;
+
+	// Remove every odd key
+	for (size_t i = 1; i < kCount; i += 2)
+		EXPECT_TRUE(index.erase(makeKey(i))) << "At index " << i;
+
+	EXPECT_FALSE(index.erase(makeKey(1)));
+
+	EXPECT_EQ(index.size(), kCount / 2);
+
+	// All the even ones have to still be reachable
+	for (size_t i = 0; i < kCount; i++) {
+		const size_t *value = index.find(makeKey(i));
+
+		if (i & 1) {
+			EXPECT_EQ(value, static_cast<const size_t *>(0)) << "At index " << i;
+		} else {
+			ASSERT_NE(value, static_cast<const size_t *>(0)) << "At index " << i;
+			EXPECT_EQ(*value, i) << "At index " << i;
+		}
+	}
+}
+
+GTEST_TEST(HashIndex, eraseSmallKeys) {
+	// Small, consecutive keys, to provoke long probing runs
+	Common::HashIndex<uint64> index;
+
+	for (uint64 i = 0; i < 1000; i++)
+		index[i] = i;
+
+	for (uint64 i = 0; i < 1000; i += 3)
+		EXPECT_TRUE(index.erase(i));
+
+	for (uint64 i = 0; i < 1000; i++) {
+		if ((i % 3) == 0) {
+			EXPECT_EQ(index.find(i), static_cast<uint64 *>(0)) << "At index " << i;
+		} else {
+			ASSERT_NE(index.find(i), static_cast<uint64 *>(0)) << "At index " << i;
+			EXPECT_EQ(*index.find(i), i) << "At index " << i;
+		}
+	}
+}
+
+GTEST_TEST(HashIndex, iterate) {
+	static const size_t kCount = 1000;
+
+	Common::HashIndex<size_t> index;
+
+	for (size_t i = 0; i < kCount; i++)
+		index[makeKey(i)] = i;
+
+	std::vector<bool> seen(kCount, false);
+
+	size_t count = 0;
+	for (Common::HashIndex<size_t>::const_iterator it = index.begin(); it != index.end(); ++it, count++) {
+		ASSERT_LT(it.value(), kCount);
+
+		EXPECT_EQ(it.key(), makeKey(it.value()));
+		EXPECT_FALSE(seen[it.value()]);
+
+		seen[it.value()] = true;
+	}
+
+	EXPECT_EQ(count, kCount);
+}
+
+GTEST_TEST(HashIndex, clear) {
+	Common::HashIndex<int> index;
+
+	for (int i = 0; i < 100; i++)
+		index[makeKey(i)] = i;
+
+	index.clear();
+
+	EXPECT_TRUE(index.empty());
+	EXPECT_EQ(index.find(makeKey(0)), static_cast<int *>(0));
+	EXPECT_TRUE(index.begin() == index.end());
+
+	index[5] = 5;
+	EXPECT_EQ(index.size(), 1);
+}
+
+GTEST_TEST(HashIndex, findLikeMap) {
+	static const size_t kCount   = 5000;
+	static const size_t kLookups = 20000;
+
+	std::map<uint64, size_t> map;
+	Common::HashIndex<size_t> index;
+
+	for (size_t i = 0; i < kCount; i++) {
+		map[makeKey(i)]   = i;
+		index[makeKey(i)] = i;
+	}
+
+	// Look up a mix of existing (3/4) and missing (1/4) keys
+	size_t found = 0;
+	for (size_t i = 0; i < kLookups; i++) {
+		const uint64 key = makeKey((i * 7919) % (kCount + kCount / 3));
+
+		std::map<uint64, size_t>::const_iterator m = map.find(key);
+		const size_t *r = index.find(key);
+
+		ASSERT_EQ(r != 0, m != map.end()) << "At lookup " << i;
+		if (!r)
+			continue;
+
+		EXPECT_EQ(*r, m->second) << "At lookup " << i;
+		found++;
+	}
+
+	EXPECT_GT(found, kLookups / 2);
+	EXPECT_LT(found, kLookups);
+}
@@ -22,6 +22,8 @@
  *  Unit tests for our Huffman decoder.
  */
 
+#include <vector>
+
 #include "gtest/gtest.h"
 
 #include "src/common/huffman.h"
@@ -30,6 +32,8 @@
 #include "src/common/memreadstream.h"
 #include "src/common/bitstream.h"
 
+#include "tests/random.h"
+
 static const uint32 kCodes  [] = {  0,   4,   5,   6,   7  };
 static const uint8  kLengths[] = {  1,   3,   3,   3,   3  };
 static const uint32 kSymbols[] = { 'A', 'B', 'C', 'D', 'E' };
@@ -120,3 +124,71 @@ GTEST_TEST(Huffman, invalidSymbol) {
 
 	EXPECT_THROW(huffman.getSymbol(bitStream), Common::Exception);
 }
+
+/** Encode pseudo-random symbols with long codes, decode them again and compare. */
+template<typename BitStreamType>
+static void testLongCodes(bool isMSB2LSB) {
+	/* Codes of every length from 1 to 20 (0, 10, 110, ...), plus one
+	 * more of length 20. These need several levels of lookup tables.
+	 * Reading LSB to MSB, the first bit is the lowest one of the code. */
+	static const size_t kCodeCount = 21;
+
+	uint32 codes[kCodeCount];
+	uint8  lengths[kCodeCount];
+	uint32 symbols[kCodeCount];
+
+	for (size_t i = 0; i < kCodeCount; i++) {
+		lengths[i] = MIN<size_t>(i + 1, 20);
+		symbols[i] = 1000 + i;
+
+		if (i == (kCodeCount - 1))
+			codes[i] = (1 << 20) - 1;
+		else if (isMSB2LSB)
+			codes[i] = (1 << lengths[i]) - 2;
+		else
+			codes[i] = (1 << (lengths[i] - 1)) - 1;
+	}
+
+	// Encode, in the order the bit stream reads the bits
+	std::vector<size_t> encoded;
+	std::vector<byte> data;
+
+	size_t bitCount = 0;
+	uint32 seed = 23;
+
+	for (size_t i = 0; i < 500; i++) {
+		const size_t index = makeRandom(seed) % kCodeCount;
+		encoded.push_back(index);
+
+		for (size_t j = 0; j < lengths[index]; j++, bitCount++) {
+			const uint32 bit = isMSB2LSB ? ((codes[index] >> (lengths[index] - 1 - j)) & 1) :
+			                               ((codes[index] >> j) & 1);
+
+			if ((bitCount % 8) == 0)
+				data.push_back(0);
+
+			if (isMSB2LSB)
+				data.back() |= bit << (7 - (bitCount % 8));
+			else
+				data.back() |= bit << (bitCount % 8);
+		}
+	}
+
+	Common::MemoryReadStream byteStream(&data[0], data.size());
+	BitStreamType bitStream(byteStream);
+
+	Common::Huffman huffman(0, kCodeCount, codes, lengths, symbols);
+
+	for (size_t i = 0; i < encoded.size(); i++)
+		EXPECT_EQ(huffman.getSymbol(bitStream), symbols[encoded[i]]) << "At index " << i;
+
+	EXPECT_EQ(bitStream.pos(), bitCount);
+}
+
+GTEST_TEST(Huffman, longCodesMSB) {
+	testLongCodes<Common::BitStream8MSB>(true);
+}
+
+GTEST_TEST(Huffman, longCodesLSB) {
+	testLongCodes<Common::BitStream8LSB>(false);
+}
@@ -0,0 +1,152 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our memory-mapped file stream.
+ */
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/scopedptr.h"
+#include "src/common/platform.h"
+#include "src/common/memreadstream.h"
+#include "src/common/mappedfile.h"
+
+static const byte kData[16] = {
+	0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+	0x88, 0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF
+};
+
+boost::filesystem::path kFilePath;
+
+class MappedFile : public ::testing::Test {
+protected:
+	static void SetUpTestCase() {
+		Common::Platform::init();
+
+		boost::filesystem::path tmpPath    = boost::filesystem::temp_directory_path();
+		boost::filesystem::path uniquePath = boost::filesystem::unique_path("%%%%_%%%%_%%%%_%%%%.xoreos");
+
+		kFilePath = tmpPath / uniquePath;
+
+		boost::filesystem::ofstream testFile(kFilePath, std::ofstream::binary);
+
+		testFile.write(reinterpret_cast<const char *>(kData), ARRAYSIZE(kData));
+		testFile.close();
+	}
+
+	static void TearDownTestCase() {
+		if (!kFilePath.empty())
+			boost::filesystem::remove(kFilePath);
+	}
+};
+
+GTEST_TEST_F(MappedFile, read) {
+	if (!Common::MappedFile::isSupported())
+		return;
+
+	Common::MappedFile file(kFilePath.generic_string());
+
+	ASSERT_EQ(file.size(), ARRAYSIZE(kData));
+
+	for (size_t i = 0; i < ARRAYSIZE(kData); i++) {
+		EXPECT_EQ(file.readByte(), kData[i]) << "At index " << i;
+		EXPECT_FALSE(file.eos()) << "At index " << i;
+	}
+
+	EXPECT_THROW(file.readByte(), Common::Exception);
+	EXPECT_TRUE(file.eos());
+
+	file.seek(4);
+	EXPECT_EQ(file.readUint32BE(), 0x44556677);
+	EXPECT_FALSE(file.eos());
+}
+
+GTEST_TEST_F(MappedFile, readAt) {
+	if (!Common::MappedFile::isSupported())
+		return;
+
+	Common::MappedFile file(kFilePath.generic_string());
+
+	file.seek(2);
+
+	byte data[4];
+	ASSERT_EQ(file.readAt(12, data, sizeof(data)), 4);
+	EXPECT_EQ(data[0], 0xCC);
+	EXPECT_EQ(data[3], 0xFF);
+
+	EXPECT_EQ(file.readAt(14, data, sizeof(data)), 2);
+	EXPECT_EQ(file.readAt(16, data, sizeof(data)), 0);
+
+	EXPECT_EQ(file.pos(), 2);
+}
+
+GTEST_TEST_F(MappedFile, readStreamAt) {
+	if (!Common::MappedFile::isSupported())
+		return;
+
+	Common::ScopedPtr<Common::MappedFile> file(new Common::MappedFile(kFilePath.generic_string()));
+
+	Common::ScopedPtr<Common::MemoryReadStream> stream(file->readStreamAt(4, 8));
+	ASSERT_EQ(stream->size(), 8);
+
+	// The stream points directly into the mapping
+	EXPECT_EQ(stream->getData(), file->getData() + 4);
+
+	// Sub streams of that stream do as well
+	Common::ScopedPtr<Common::MemoryReadStream> subStream(stream->readStreamAt(2, 4));
+	ASSERT_EQ(subStream->size(), 4);
+	EXPECT_EQ(subStream->getData(), file->getData() + 6);
+
+	EXPECT_THROW(file->readStreamAt(12, 8), Common::Exception);
+	EXPECT_THROW(stream->readStreamAt(6, 4), Common::Exception);
+
+	// And the streams keep the mapping alive
+	file.reset();
+
+	for (size_t i = 0; i < 8; i++)
+		EXPECT_EQ(stream->readByte(), kData[4 + i]) << "At index " << i;
+
+	EXPECT_EQ(subStream->readUint32BE(), 0x66778899);
+}
+
+GTEST_TEST_F(MappedFile, subStreamReadStreamAt) {
+	if (!Common::MappedFile::isSupported())
+		return;
+
+	Common::MappedFile file(kFilePath.generic_string());
+
+	Common::ConcurrentSubReadStream subFile(&file, 8, 16);
+
+	Common::ScopedPtr<Common::MemoryReadStream> stream(subFile.readStreamAt(4, 4));
+	ASSERT_EQ(stream->size(), 4);
+
+	EXPECT_EQ(stream->getData(), file.getData() + 12);
+	EXPECT_EQ(stream->readUint32BE(), 0xCCDDEEFF);
+}
+
+GTEST_TEST_F(MappedFile, nonExistent) {
+	EXPECT_THROW(Common::MappedFile file("/this/file/does/not/exist"), Common::Exception);
+}
@@ -105,6 +105,44 @@ GTEST_TEST(MemoryReadStream, readStream) {
 	EXPECT_THROW(stream.readStream(ARRAYSIZE(data) + 1), Common::Exception);
 }
 
+GTEST_TEST(MemoryReadStream, readAt) {
+	static const byte data[5] = { 0x12, 0x34, 0x56, 0x78, 0x90 };
+	Common::MemoryReadStream stream(data);
+
+	stream.seek(1);
+
+	byte readData[4] = { 0 };
+	EXPECT_EQ(stream.readAt(2, readData, 2), 2);
+
+	EXPECT_EQ(readData[0], data[2]);
+	EXPECT_EQ(readData[1], data[3]);
+
+	// Reading past the end is cut short
+	EXPECT_EQ(stream.readAt(3, readData, 4), 2);
+	EXPECT_EQ(stream.readAt(5, readData, 4), 0);
+
+	// The position indicator stays untouched
+	EXPECT_EQ(stream.pos(), 1);
+	EXPECT_FALSE(stream.eos());
+}
+
+GTEST_TEST(MemoryReadStream, readStreamAt) {
+	static const byte data[5] = { 0x12, 0x34, 0x56, 0x78, 0x90 };
+	Common::MemoryReadStream stream(data);
+
+	Common::MemoryReadStream *streamRead = stream.readStreamAt(1, 3);
+
+	EXPECT_EQ(streamRead->size(), 3);
+	for (size_t i = 0; i < 3; i++)
+		EXPECT_EQ(streamRead->readByte(), data[i + 1]) << "At index " << i;
+
+	delete streamRead;
+
+	EXPECT_EQ(stream.pos(), 0);
+
+	EXPECT_THROW(stream.readStreamAt(3, 3), Common::Exception);
+}
+
 GTEST_TEST(MemoryReadStream, readChar) {
 	static const byte data[3] = { 0x12, 0x34, 0x56 };
 	Common::MemoryReadStream stream(data);
@@ -315,6 +353,54 @@ GTEST_TEST(SeekableSubReadStream, fromMem) {
 	EXPECT_FALSE(subStream.eos());
 }
 
+GTEST_TEST(SeekableSubReadStream, readAt) {
+	static const byte data[5] = { 0x12, 0x34, 0x56, 0x78, 0x90 };
+	Common::MemoryReadStream stream(data);
+
+	Common::SeekableSubReadStream subStream(&stream, 1, 4);
+
+	byte readData[4] = { 0 };
+	EXPECT_EQ(subStream.readAt(1, readData, 4), 2);
+
+	EXPECT_EQ(readData[0], data[2]);
+	EXPECT_EQ(readData[1], data[3]);
+
+	EXPECT_EQ(subStream.pos(), 0);
+}
+
+GTEST_TEST(ConcurrentSubReadStream, fromMem) {
+	static const byte data[5] = { 0x12, 0x34, 0x56, 0x78, 0x90 };
+	Common::MemoryReadStream stream(data);
+
+	Common::ConcurrentSubReadStream subStream1(&stream, 1, 4);
+	Common::ConcurrentSubReadStream subStream2(&stream, 2, 5);
+
+	// Reading from one doesn't disturb the other, or the parent stream
+	EXPECT_EQ(subStream1.readByte(), data[1]);
+	EXPECT_EQ(subStream2.readByte(), data[2]);
+	EXPECT_EQ(subStream1.readByte(), data[2]);
+	EXPECT_EQ(subStream2.readByte(), data[3]);
+
+	EXPECT_EQ(stream.pos(), 0);
+
+	byte readData[4] = { 0 };
+	EXPECT_EQ(subStream1.read(readData, 4), 1);
+	EXPECT_TRUE(subStream1.eos());
+
+	EXPECT_EQ(readData[0], data[3]);
+
+	subStream1.seek(-1, Common::SeekableReadStream::kOriginEnd);
+
+	EXPECT_EQ(subStream1.pos(), 2);
+	EXPECT_FALSE(subStream1.eos());
+
+	EXPECT_THROW(subStream1.seek(4), Common::Exception);
+
+	EXPECT_EQ(subStream2.size(), 3);
+	EXPECT_EQ(subStream2.readAt(2, readData, 4), 1);
+	EXPECT_EQ(readData[0], data[4]);
+}
+
 GTEST_TEST(SeekableSubReadStreamEndian, streamEndianLE) {
 	static const byte data[4] = { 0x78, 0x56, 0x34, 0x12 };
 	Common::MemoryReadStream stream(data);
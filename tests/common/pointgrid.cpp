@@ -0,0 +1,311 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our PointGrid class.
+ */
+
+#include <vector>
+#include <algorithm>
+
+#include "gtest/gtest.h"
+
+#include "src/common/pointgrid.h"
+
+#include "tests/random.h"
+
+static const size_t kPointCount = 1000;
+
+static void *makeData(size_t i) {
+	return reinterpret_cast<void *>(i + 1);
+}
+
+static size_t getIndex(void *data) {
+	return reinterpret_cast<size_t>(data) - 1;
+}
+
+/** Only accept points with an even index. */
+class EvenFilter : public Common::PointGrid::Filter {
+public:
+	bool accept(void *data) {
+		return (getIndex(data) % 2) == 0;
+	}
+};
+
+/** A set of random points, mirrored in a grid. */
+struct Points {
+	Common::PointGrid grid;
+
+	std::vector<float> positions;
+	std::vector<Common::PointGrid::PointID> ids;
+	std::vector<bool> present;
+
+	Points() : grid(0.0f, 0.0f, 100.0f, 100.0f, 10.0f) {
+	}
+
+	void insert(uint32 &state) {
+		// Some of the points lie outside the grid
+		const float x = makeRandom(state, -20.0f, 120.0f);
+		const float y = makeRandom(state, -20.0f, 120.0f);
+		const float z = makeRandom(state, -5.0f, 5.0f);
+
+		positions.push_back(x);
+		positions.push_back(y);
+		positions.push_back(z);
+
+		ids.push_back(grid.insert(x, y, z, makeData(present.size())));
+		present.push_back(true);
+	}
+
+	void move(size_t i, uint32 &state) {
+		positions[i * 3 + 0] = makeRandom(state, -20.0f, 120.0f);
+		positions[i * 3 + 1] = makeRandom(state, -20.0f, 120.0f);
+		positions[i * 3 + 2] = makeRandom(state, -5.0f, 5.0f);
+
+		grid.move(ids[i], positions[i * 3 + 0], positions[i * 3 + 1], positions[i * 3 + 2]);
+	}
+
+	void remove(size_t i) {
+		grid.remove(ids[i]);
+		present[i] = false;
+	}
+
+	float getDistanceSquared(size_t i, float x, float y, float z) const {
+		const float dX = positions[i * 3 + 0] - x;
+		const float dY = positions[i * 3 + 1] - y;
+		const float dZ = positions[i * 3 + 2] - z;
+
+		return dX * dX + dY * dY + dZ * dZ;
+	}
+
+	/** Find the points within radius (or all points, if radius is negative), by looking at every point. */
+	void findBrute(float x, float y, float z, float radius, size_t count,
+	               std::vector<void *> &result, Common::PointGrid::Filter *filter) const {
+
+		std::vector< std::pair<float, Common::PointGrid::PointID> > candidates;
+		for (size_t i = 0; i < present.size(); i++) {
+			if (!present[i] || (filter && !filter->accept(makeData(i))))
+				continue;
+
+			const float distance = getDistanceSquared(i, x, y, z);
+			if ((radius < 0.0f) || (distance <= (radius * radius)))
+				candidates.push_back(std::make_pair(distance, ids[i]));
+		}
+
+		std::sort(candidates.begin(), candidates.end());
+		if (candidates.size() > count)
+			candidates.resize(count);
+
+		result.clear();
+		for (size_t i = 0; i < candidates.size(); i++)
+			result.push_back(grid.getData(candidates[i].second));
+	}
+};
+
+static void compareNearest(const Points &points, size_t count, Common::PointGrid::Filter *filter, uint32 &state) {
+	for (size_t t = 0; t < 100; t++) {
+		const float x = makeRandom(state, -30.0f, 130.0f);
+		const float y = makeRandom(state, -30.0f, 130.0f);
+		const float z = makeRandom(state, -5.0f, 5.0f);
+
+		std::vector<void *> gridResult, bruteResult;
+
+		points.grid.findNearest(x, y, z, count, gridResult, filter);
+		points.findBrute(x, y, z, -1.0f, count, bruteResult, filter);
+
+		EXPECT_EQ(gridResult, bruteResult) << "At case " << t;
+	}
+}
+
+static void compareRadius(const Points &points, float radius, Common::PointGrid::Filter *filter, uint32 &state) {
+	for (size_t t = 0; t < 100; t++) {
+		const float x = makeRandom(state, -30.0f, 130.0f);
+		const float y = makeRandom(state, -30.0f, 130.0f);
+		const float z = makeRandom(state, -5.0f, 5.0f);
+
+		std::vector<void *> gridResult, bruteResult;
+
+		points.grid.findInRadius(x, y, z, radius, gridResult, filter);
+		points.findBrute(x, y, z, radius, kPointCount, bruteResult, filter);
+
+		EXPECT_EQ(gridResult, bruteResult) << "At case " << t;
+	}
+}
+
+GTEST_TEST(PointGrid, empty) {
+	Common::PointGrid grid(0.0f, 0.0f, 100.0f, 100.0f, 10.0f);
+
+	EXPECT_TRUE(grid.empty());
+	EXPECT_EQ(grid.size(), 0);
+
+	std::vector<void *> result(1, makeData(0));
+
+	grid.findNearest(50.0f, 50.0f, 0.0f, 5, result);
+	EXPECT_TRUE(result.empty());
+
+	grid.findInRadius(50.0f, 50.0f, 0.0f, 10.0f, result);
+	EXPECT_TRUE(result.empty());
+}
+
+GTEST_TEST(PointGrid, insert) {
+	Common::PointGrid grid(0.0f, 0.0f, 100.0f, 100.0f, 10.0f);
+
+	Common::PointGrid::PointID point1 = grid.insert( 5.0f,  5.0f, 0.0f, makeData(0));
+	Common::PointGrid::PointID point2 = grid.insert(55.0f, 55.0f, 0.0f, makeData(1));
+
+	EXPECT_FALSE(grid.empty());
+	EXPECT_EQ(grid.size(), 2);
+
+	EXPECT_EQ(grid.getData(point1), makeData(0));
+	EXPECT_EQ(grid.getData(point2), makeData(1));
+
+	std::vector<void *> data;
+	grid.getData(data);
+
+	ASSERT_EQ(data.size(), 2);
+	EXPECT_NE(std::find(data.begin(), data.end(), makeData(0)), data.end());
+	EXPECT_NE(std::find(data.begin(), data.end(), makeData(1)), data.end());
+}
+
+GTEST_TEST(PointGrid, remove) {
+	Common::PointGrid grid(0.0f, 0.0f, 100.0f, 100.0f, 10.0f);
+
+	Common::PointGrid::PointID point1 = grid.insert(5.0f, 5.0f, 0.0f, makeData(0));
+	Common::PointGrid::PointID point2 = grid.insert(6.0f, 6.0f, 0.0f, makeData(1));
+
+	grid.remove(point1);
+
+	EXPECT_EQ(grid.size(), 1);
+	EXPECT_EQ(grid.getData(point2), makeData(1));
+
+	std::vector<void *> result;
+	grid.findNearest(5.0f, 5.0f, 0.0f, 5, result);
+
+	ASSERT_EQ(result.size(), 1);
+	EXPECT_EQ(result[0], makeData(1));
+
+	// The freed point is reused
+	EXPECT_EQ(grid.insert(7.0f, 7.0f, 0.0f, makeData(2)), point1);
+	EXPECT_EQ(grid.size(), 2);
+
+	grid.clear();
+
+	EXPECT_TRUE(grid.empty());
+}
+
+GTEST_TEST(PointGrid, move) {
+	Common::PointGrid grid(0.0f, 0.0f, 100.0f, 100.0f, 10.0f);
+
+	Common::PointGrid::PointID point1 = grid.insert( 5.0f,  5.0f, 0.0f, makeData(0));
+	Common::PointGrid::PointID point2 = grid.insert(15.0f, 15.0f, 0.0f, makeData(1));
+
+	std::vector<void *> result;
+
+	grid.findNearest(90.0f, 90.0f, 0.0f, 1, result);
+	ASSERT_EQ(result.size(), 1);
+	EXPECT_EQ(result[0], makeData(1));
+
+	grid.move(point1, 95.0f, 95.0f, 0.0f);
+
+	grid.findNearest(90.0f, 90.0f, 0.0f, 1, result);
+	ASSERT_EQ(result.size(), 1);
+	EXPECT_EQ(result[0], makeData(0));
+
+	EXPECT_EQ(grid.getData(point1), makeData(0));
+	EXPECT_EQ(grid.getData(point2), makeData(1));
+}
+
+GTEST_TEST(PointGrid, findNearestTies) {
+	Common::PointGrid grid(0.0f, 0.0f, 100.0f, 100.0f, 10.0f);
+
+	// Four points at the same distance, in four different cells
+	grid.insert(60.0f, 50.0f, 0.0f, makeData(0));
+	grid.insert(40.0f, 50.0f, 0.0f, makeData(1));
+	grid.insert(50.0f, 60.0f, 0.0f, makeData(2));
+	grid.insert(50.0f, 40.0f, 0.0f, makeData(3));
+
+	std::vector<void *> result;
+	grid.findNearest(50.0f, 50.0f, 0.0f, 4, result);
+
+	ASSERT_EQ(result.size(), 4);
+	for (size_t i = 0; i < result.size(); i++)
+		EXPECT_EQ(result[i], makeData(i)) << "At index " << i;
+}
+
+GTEST_TEST(PointGrid, findNearest) {
+	Points points;
+
+	uint32 state = 1;
+	for (size_t i = 0; i < kPointCount; i++)
+		points.insert(state);
+
+	EvenFilter filter;
+
+	compareNearest(points,  1, 0, state);
+	compareNearest(points, 10, 0, state);
+	compareNearest(points, 10, &filter, state);
+	compareNearest(points, kPointCount + 1, 0, state);
+
+	// Move and remove some of the points
+	for (size_t i = 0; i < kPointCount; i += 3)
+		points.move(i, state);
+	for (size_t i = 0; i < kPointCount; i += 7)
+		points.remove(i);
+
+	compareNearest(points,  1, 0, state);
+	compareNearest(points, 10, &filter, state);
+}
+
+GTEST_TEST(PointGrid, findInRadius) {
+	Points points;
+
+	uint32 state = 2;
+	for (size_t i = 0; i < kPointCount; i++)
+		points.insert(state);
+
+	EvenFilter filter;
+
+	compareRadius(points,   5.0f, 0, state);
+	compareRadius(points,  25.0f, 0, state);
+	compareRadius(points,  25.0f, &filter, state);
+	compareRadius(points, 500.0f, 0, state);
+
+	for (size_t i = 0; i < kPointCount; i += 3)
+		points.move(i, state);
+	for (size_t i = 0; i < kPointCount; i += 7)
+		points.remove(i);
+
+	compareRadius(points, 15.0f, 0, state);
+}
+
+GTEST_TEST(PointGrid, tooManyCells) {
+	// A cell size this small would need millions of cells
+	Common::PointGrid grid(0.0f, 0.0f, 10000.0f, 10000.0f, 0.001f);
+
+	grid.insert(   10.0f,    10.0f, 0.0f, makeData(0));
+	grid.insert( 9990.0f,  9990.0f, 0.0f, makeData(1));
+
+	std::vector<void *> result;
+	grid.findNearest(10000.0f, 10000.0f, 0.0f, 2, result);
+
+	ASSERT_EQ(result.size(), 2);
+	EXPECT_EQ(result[0], makeData(1));
+	EXPECT_EQ(result[1], makeData(0));
+}
@@ -50,11 +50,26 @@ tests_common_test_ptrvector_SOURCES  = tests/common/ptrvector.cpp
 tests_common_test_ptrvector_LDADD    = $(common_LIBS)
 tests_common_test_ptrvector_CXXFLAGS = $(test_CXXFLAGS)
 
+check_PROGRAMS                       += tests/common/test_threadpool
+tests_common_test_threadpool_SOURCES  = tests/common/threadpool.cpp
+tests_common_test_threadpool_LDADD    = $(common_LIBS)
+tests_common_test_threadpool_CXXFLAGS = $(test_CXXFLAGS)
+
 check_PROGRAMS                   += tests/common/test_ptrmap
 tests_common_test_ptrmap_SOURCES  = tests/common/ptrmap.cpp
 tests_common_test_ptrmap_LDADD    = $(common_LIBS)
 tests_common_test_ptrmap_CXXFLAGS = $(test_CXXFLAGS)
 
+check_PROGRAMS                      += tests/common/test_hashindex
+tests_common_test_hashindex_SOURCES  = tests/common/hashindex.cpp
+tests_common_test_hashindex_LDADD    = $(common_LIBS)
+tests_common_test_hashindex_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                       += tests/common/test_stringpool
+tests_common_test_stringpool_SOURCES  = tests/common/stringpool.cpp
+tests_common_test_stringpool_LDADD    = $(common_LIBS)
+tests_common_test_stringpool_CXXFLAGS = $(test_CXXFLAGS)
+
 check_PROGRAMS                    += tests/common/test_ustring
 tests_common_test_ustring_SOURCES  = tests/common/ustring.cpp
 tests_common_test_ustring_LDADD    = $(common_LIBS)
@@ -90,6 +105,11 @@ tests_common_test_readfile_SOURCES  = tests/common/readfile.cpp
 tests_common_test_readfile_LDADD    = $(common_LIBS)
 tests_common_test_readfile_CXXFLAGS = $(test_CXXFLAGS)
 
+check_PROGRAMS                       += tests/common/test_mappedfile
+tests_common_test_mappedfile_SOURCES  = tests/common/mappedfile.cpp
+tests_common_test_mappedfile_LDADD    = $(common_LIBS)
+tests_common_test_mappedfile_CXXFLAGS = $(test_CXXFLAGS)
+
 check_PROGRAMS                      += tests/common/test_writefile
 tests_common_test_writefile_SOURCES  = tests/common/writefile.cpp
 tests_common_test_writefile_LDADD    = $(common_LIBS)
@@ -236,3 +256,18 @@ check_PROGRAMS                        += tests/common/test_boundingbox
 tests_common_test_boundingbox_SOURCES  = tests/common/boundingbox.cpp
 tests_common_test_boundingbox_LDADD    = $(common_LIBS)
 tests_common_test_boundingbox_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                     += tests/common/test_aabbtree
+tests_common_test_aabbtree_SOURCES  = tests/common/aabbtree.cpp
+tests_common_test_aabbtree_LDADD    = $(common_LIBS)
+tests_common_test_aabbtree_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                      += tests/common/test_pointgrid
+tests_common_test_pointgrid_SOURCES  = tests/common/pointgrid.cpp
+tests_common_test_pointgrid_LDADD    = $(common_LIBS)
+tests_common_test_pointgrid_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                    += tests/common/test_frustum
+tests_common_test_frustum_SOURCES  = tests/common/frustum.cpp
+tests_common_test_frustum_LDADD    = $(common_LIBS)
+tests_common_test_frustum_CXXFLAGS = $(test_CXXFLAGS)
@@ -0,0 +1,89 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our StringPool class.
+ */
+
+#include "gtest/gtest.h"
+
+#include "src/common/stringpool.h"
+
+GTEST_TEST(StringPool, empty) {
+	Common::StringPool pool;
+
+	EXPECT_EQ(pool.add(""), Common::StringPool::kEmptyString);
+
+	EXPECT_TRUE(pool.isEmpty(Common::StringPool::kEmptyString));
+	EXPECT_STREQ(pool.get(Common::StringPool::kEmptyString).c_str(), "");
+}
+
+GTEST_TEST(StringPool, add) {
+	Common::StringPool pool;
+
+	const Common::StringPool::StringID foo = pool.add("foo");
+	const Common::StringPool::StringID bar = pool.add("bar");
+
+	EXPECT_NE(foo, Common::StringPool::kEmptyString);
+	EXPECT_NE(bar, Common::StringPool::kEmptyString);
+	EXPECT_NE(foo, bar);
+
+	EXPECT_FALSE(pool.isEmpty(foo));
+	EXPECT_FALSE(pool.isEmpty(bar));
+
+	EXPECT_STREQ(pool.get(foo).c_str(), "foo");
+	EXPECT_STREQ(pool.get(bar).c_str(), "bar");
+}
+
+GTEST_TEST(StringPool, intern) {
+	Common::StringPool pool;
+
+	const Common::StringPool::StringID foo1 = pool.add("foo");
+	const size_t size = pool.getSize();
+
+	const Common::StringPool::StringID foo2 = pool.add("foo");
+
+	EXPECT_EQ(foo1, foo2);
+	EXPECT_EQ(pool.getSize(), size);
+
+	// Interning is case-sensitive
+	EXPECT_NE(pool.add("Foo"), foo1);
+}
+
+GTEST_TEST(StringPool, utf8) {
+	Common::StringPool pool;
+
+	const Common::StringPool::StringID id = pool.add("F\xC3\xB6\xC3\xB6");
+
+	EXPECT_STREQ(pool.get(id).c_str(), "F\xC3\xB6\xC3\xB6");
+	EXPECT_EQ(pool.get(id).size(), 3);
+}
+
+GTEST_TEST(StringPool, clear) {
+	Common::StringPool pool;
+
+	pool.add("foo");
+	pool.add("bar");
+
+	pool.clear();
+
+	EXPECT_EQ(pool.getSize(), 1);
+	EXPECT_STREQ(pool.get(pool.add("foobar")).c_str(), "foobar");
+}
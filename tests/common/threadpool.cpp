@@ -0,0 +1,157 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our thread pool.
+ */
+
+#include <vector>
+
+#include "src/common/fallthrough.h"
+START_IGNORE_IMPLICIT_FALLTHROUGH
+#include <SDL_thread.h>
+#include <SDL_timer.h>
+STOP_IGNORE_IMPLICIT_FALLTHROUGH
+
+#include "gtest/gtest.h"
+
+#include "src/common/threadpool.h"
+#include "src/common/mutex.h"
+#include "src/common/error.h"
+
+namespace {
+
+class CountJob : public Common::ThreadPool::Job {
+public:
+	CountJob(Common::Mutex &mutex, std::vector<int> &counts, size_t index) :
+		_mutex(&mutex), _counts(&counts), _index(index) {
+	}
+
+	void run() {
+		Common::StackLock lock(*_mutex);
+
+		(*_counts)[_index]++;
+	}
+
+private:
+	Common::Mutex *_mutex;
+	std::vector<int> *_counts;
+	size_t _index;
+};
+
+class BlockJob : public Common::ThreadPool::Job {
+public:
+	BlockJob(Common::Semaphore &started, Common::Semaphore &release) :
+		_started(&started), _release(&release) {
+	}
+
+	void run() {
+		_started->unlock();
+		_release->lock();
+	}
+
+private:
+	Common::Semaphore *_started;
+	Common::Semaphore *_release;
+};
+
+class ThrowJob : public Common::ThreadPool::Job {
+public:
+	void run() {
+		throw Common::Exception("Job failed on purpose");
+	}
+};
+
+/** Unlock the semaphore after a short while, from another thread. */
+static int delayedUnlock(void *semaphore) {
+	SDL_Delay(50);
+	static_cast<Common::Semaphore *>(semaphore)->unlock();
+
+	return 0;
+}
+
+} // End of anonymous namespace
+
+GTEST_TEST(ThreadPool, getThreadCount) {
+	Common::ThreadPool pool(3);
+	EXPECT_EQ(pool.getThreadCount(), 3);
+
+	EXPECT_GE(Common::ThreadPool::getDefaultThreadCount(), 1);
+}
+
+GTEST_TEST(ThreadPool, wait) {
+	static const size_t kJobCount = 1000;
+
+	Common::Mutex mutex;
+	std::vector<int> counts(kJobCount, 0);
+
+	Common::ThreadPool pool(4);
+	for (size_t i = 0; i < kJobCount; i++)
+		pool.addJob(new CountJob(mutex, counts, i));
+
+	pool.wait();
+
+	for (size_t i = 0; i < kJobCount; i++)
+		EXPECT_EQ(counts[i], 1) << "At index " << i;
+}
+
+GTEST_TEST(ThreadPool, cancel) {
+	Common::Semaphore started, release;
+
+	Common::Mutex mutex;
+	std::vector<int> counts(1, 0);
+
+	Common::ThreadPool pool(1);
+
+	// Keep the only thread busy, so that the counting job stays queued
+	pool.addJob(new BlockJob(started, release));
+	started.lock();
+
+	pool.addJob(new CountJob(mutex, counts, 0));
+
+	// Cancelling drops the queued job right away, then waits for the blocking one
+	SDL_Thread *releaser = SDL_CreateThread(delayedUnlock, 0, &release);
+	ASSERT_TRUE(releaser != 0);
+
+	pool.cancel();
+	SDL_WaitThread(releaser, 0);
+
+	pool.wait();
+	EXPECT_EQ(counts[0], 0);
+
+	// The pool is still usable afterwards
+	pool.addJob(new CountJob(mutex, counts, 0));
+	pool.wait();
+
+	EXPECT_EQ(counts[0], 1);
+}
+
+GTEST_TEST(ThreadPool, exception) {
+	Common::Mutex mutex;
+	std::vector<int> counts(1, 0);
+
+	Common::ThreadPool pool(1);
+
+	pool.addJob(new ThrowJob);
+	pool.addJob(new CountJob(mutex, counts, 0));
+	pool.wait();
+
+	EXPECT_EQ(counts[0], 1);
+}
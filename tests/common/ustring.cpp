@@ -145,6 +145,64 @@ GTEST_TEST(UString, caseInsensitiveUTF8) {
 	EXPECT_FALSE(str1.equalsIgnoreCase(str2));
 }
 
+GTEST_TEST(UString, compareUTF8) {
+	const Common::UString str1(reinterpret_cast<const char *>(kTestStringUTF8));
+	const Common::UString str2(reinterpret_cast<const char *>(kTestStringUpperUTF8));
+
+	// The order is the order of the code points
+	EXPECT_LT(str2.strcmp(str1), 0);
+	EXPECT_GT(str1.strcmp(str2), 0);
+	EXPECT_EQ(str1.strcmp(str1), 0);
+
+	EXPECT_LT(Common::UString("F").strcmp(str1), 0);
+	EXPECT_LT(Common::UString("Fz").strcmp(str1), 0);
+	EXPECT_GT(Common::UString(0x100).strcmp(str1), 0);
+
+	EXPECT_TRUE(Common::UString("Fa").less(str1));
+	EXPECT_FALSE(str1.less(str1));
+}
+
+GTEST_TEST(UString, compareCaseInsensitive) {
+	const Common::UString str1(reinterpret_cast<const char *>(kTestStringUTF8));
+
+	EXPECT_EQ(Common::UString("abc").stricmp("ABC"), 0);
+	EXPECT_LT(Common::UString("abc").stricmp("ABD"), 0);
+	EXPECT_GT(Common::UString("abd").stricmp("ABC"), 0);
+	EXPECT_LT(Common::UString("AB").stricmp("abc"), 0);
+
+	// '_' sits between the upper- and lowercase letters, so it sorts before both
+	EXPECT_TRUE(Common::UString("_").lessIgnoreCase("B"));
+	EXPECT_TRUE(Common::UString("_").lessIgnoreCase("b"));
+	EXPECT_FALSE(Common::UString("B").lessIgnoreCase("_"));
+
+	// Only the ASCII characters are folded
+	EXPECT_EQ(Common::UString("f\xC3\xB6\xC3\xB6" "B\xC3\xA4" "R").stricmp(str1), 0);
+	EXPECT_LT(Common::UString("FZ").stricmp(str1), 0);
+
+	EXPECT_FALSE(Common::UString("abc").equalsIgnoreCase("abcd"));
+}
+
+GTEST_TEST(UString, hash) {
+	const Common::hashUStringCaseSensitive   hashSensitive;
+	const Common::hashUStringCaseInsensitive hashInsensitive;
+
+	EXPECT_EQ(hashSensitive(kTestString1), hashSensitive(kTestString1));
+	EXPECT_NE(hashSensitive(kTestString1), hashSensitive(kTestStringLower1));
+
+	EXPECT_EQ(hashInsensitive(kTestString1), hashInsensitive(kTestStringLower1));
+	EXPECT_EQ(hashInsensitive(kTestString1), hashInsensitive(kTestStringUpper1));
+	EXPECT_NE(hashInsensitive(kTestString1), hashInsensitive(kTestString2));
+}
+
+GTEST_TEST(UString, lowerUTF8) {
+	const Common::UString str(reinterpret_cast<const char *>(kTestStringUpperUTF8));
+	const Common::UString lower = str.toLower();
+
+	// Only the ASCII characters are lowercased
+	EXPECT_STREQ(lower.c_str(), "f\xC3\x96\xC3\x96" "b\xC3\x84" "r");
+	EXPECT_EQ(lower.size(), str.size());
+}
+
 GTEST_TEST(UString, clear) {
 	Common::UString str(kTestString1);
 
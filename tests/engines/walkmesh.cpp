@@ -0,0 +1,352 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for the walkmesh face grid and the elevation evaluator.
+ */
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+#include "src/common/maths.h"
+
+#include "src/engines/aurora/walkmesh.h"
+#include "src/engines/aurora/walkeleveval.h"
+
+#include "tests/random.h"
+
+/** The number of quads along each side of the synthetic walkmesh. */
+static const uint32 kMeshSize = 30;
+/** The size of each quad. */
+static const float kCellSize = 2.0f;
+
+static const size_t kPointCount = 5000;
+
+/** Points this close to the edge of a face might or might not be found inside it. */
+static const float kEdgeEpsilon = 0.001f;
+
+/** A jittered height field of kMeshSize * kMeshSize quads, with some holes and a bridge. */
+class TestWalkmesh : public Engines::Walkmesh {
+public:
+	TestWalkmesh(uint32 &state) {
+		const uint32 rowSize = kMeshSize + 1;
+
+		for (uint32 y = 0; y < rowSize; y++) {
+			for (uint32 x = 0; x < rowSize; x++) {
+				// Move the inner vertices around a bit, so that the faces aren't all aligned to the grid
+				const bool inner = (x > 0) && (y > 0) && (x < kMeshSize) && (y < kMeshSize);
+
+				const float jitterX = inner ? makeRandom(state, -0.2f, 0.2f) : 0.0f;
+				const float jitterY = inner ? makeRandom(state, -0.2f, 0.2f) : 0.0f;
+
+				addVertex((x + jitterX) * kCellSize, (y + jitterY) * kCellSize, makeRandom(state, 0.0f, 10.0f));
+			}
+		}
+
+		for (uint32 y = 0; y < kMeshSize; y++) {
+			for (uint32 x = 0; x < kMeshSize; x++) {
+				const uint32 a = y * rowSize + x;
+				const uint32 b = a + 1;
+				const uint32 c = a + rowSize + 1;
+				const uint32 d = a + rowSize;
+
+				// About a fifth of the faces can't be walked on
+				addFace(a, b, c, makeRandom(state, 0.0f, 1.0f) < 0.8f);
+				addFace(a, c, d, makeRandom(state, 0.0f, 1.0f) < 0.8f);
+			}
+		}
+
+		// A big face spanning lots of grid cells, high above the ground
+		const uint32 bridge = _data.vertices.size() / 3;
+
+		addVertex(10.0f, 10.0f, 50.0f);
+		addVertex(50.0f, 15.0f, 50.0f);
+		addVertex(20.0f, 45.0f, 60.0f);
+
+		addFace(bridge, bridge + 1, bridge + 2, true);
+
+		refreshIndexGroups();
+	}
+
+private:
+	void addVertex(float x, float y, float z) {
+		_data.vertices.push_back(x);
+		_data.vertices.push_back(y);
+		_data.vertices.push_back(z);
+	}
+
+	void addFace(uint32 a, uint32 b, uint32 c, bool walkable) {
+		_data.indices.push_back(a);
+		_data.indices.push_back(b);
+		_data.indices.push_back(c);
+
+		_data.faceWalkableMap.push_back(walkable);
+	}
+};
+
+/** A flat grid of kMeshSize * kMeshSize quads, covered by faces reaching out to extent. */
+class HugeFaceWalkmesh : public Engines::Walkmesh {
+public:
+	HugeFaceWalkmesh(uint32 hugeFaceCount, float extent) {
+		const uint32 rowSize = kMeshSize + 1;
+
+		for (uint32 y = 0; y < rowSize; y++)
+			for (uint32 x = 0; x < rowSize; x++)
+				addVertex(x * kCellSize, y * kCellSize, 0.0f);
+
+		for (uint32 y = 0; y < kMeshSize; y++) {
+			for (uint32 x = 0; x < kMeshSize; x++) {
+				const uint32 a = y * rowSize + x;
+
+				addFace(a, a + 1, a + rowSize + 1);
+				addFace(a, a + rowSize + 1, a + rowSize);
+			}
+		}
+
+		for (uint32 i = 0; i < hugeFaceCount; i++) {
+			const uint32 huge = _data.vertices.size() / 3;
+
+			addVertex(-extent, -extent, i + 1.0f);
+			addVertex( extent, -extent, i + 1.0f);
+			addVertex(   0.0f,  extent, i + 1.0f);
+
+			addFace(huge, huge + 1, huge + 2);
+		}
+
+		refreshIndexGroups();
+	}
+
+private:
+	void addVertex(float x, float y, float z) {
+		_data.vertices.push_back(x);
+		_data.vertices.push_back(y);
+		_data.vertices.push_back(z);
+	}
+
+	void addFace(uint32 a, uint32 b, uint32 c) {
+		_data.indices.push_back(a);
+		_data.indices.push_back(b);
+		_data.indices.push_back(c);
+
+		_data.faceWalkableMap.push_back(true);
+	}
+};
+
+/** Return the barycentric coordinates of (x, y) within a walkable face, and the elevation there. */
+static void getBarycentric(const Engines::Walkmesh &walkmesh, uint32 face, float x, float y,
+                           float &l0, float &l1, float &l2, float &z) {
+
+	const std::vector<float>  &vertices = walkmesh.getData().vertices;
+	const std::vector<uint32> &indices  = walkmesh.getIndicesWalkable();
+
+	const float *v0 = &vertices[3 * indices[3 * face + 0]];
+	const float *v1 = &vertices[3 * indices[3 * face + 1]];
+	const float *v2 = &vertices[3 * indices[3 * face + 2]];
+
+	const float d = (v1[1] - v2[1]) * (v0[0] - v2[0]) + (v2[0] - v1[0]) * (v0[1] - v2[1]);
+
+	l0 = ((v1[1] - v2[1]) * (x - v2[0]) + (v2[0] - v1[0]) * (y - v2[1])) / d;
+	l1 = ((v2[1] - v0[1]) * (x - v2[0]) + (v0[0] - v2[0]) * (y - v2[1])) / d;
+	l2 = 1.0f - l0 - l1;
+
+	z = l0 * v0[2] + l1 * v1[2] + l2 * v2[2];
+}
+
+/** Look through all walkable faces for the first one containing the point (x, y).
+ *
+ *  Return false if the point lies so close to the edge of a face that the
+ *  result depends on rounding errors.
+ */
+static bool findFaceBruteForce(const Engines::Walkmesh &walkmesh, float x, float y,
+                               uint32 &face, float &z) {
+
+	face = 0xFFFFFFFF;
+	z    = FLT_MIN;
+
+	const size_t faceCount = walkmesh.getIndicesWalkable().size() / 3;
+	for (uint32 i = 0; i < faceCount; i++) {
+		float l0, l1, l2, elevation;
+		getBarycentric(walkmesh, i, x, y, l0, l1, l2, elevation);
+
+		const float minL = MIN(l0, MIN(l1, l2));
+		if (ABS(minL) <= kEdgeEpsilon)
+			return false;
+
+		if ((minL > 0.0f) && (face == 0xFFFFFFFF)) {
+			face = i;
+			z    = elevation;
+		}
+	}
+
+	return true;
+}
+
+GTEST_TEST(Walkmesh, empty) {
+	Engines::Walkmesh walkmesh;
+
+	const uint32 *faces = 0;
+	size_t count = 1;
+	walkmesh.getWalkableFacesAt(0.0f, 0.0f, faces, count);
+
+	EXPECT_EQ(count, 0U);
+
+	uint32 face;
+	EXPECT_EQ(Engines::WalkmeshElevationEvaluator::getElevationAt(walkmesh, 0.0f, 0.0f, face), FLT_MIN);
+}
+
+GTEST_TEST(Walkmesh, getWalkableFacesAt) {
+	uint32 state = 1;
+	TestWalkmesh walkmesh(state);
+
+	const size_t faceCount = walkmesh.getIndicesWalkable().size() / 3;
+
+	for (size_t i = 0; i < kPointCount; i++) {
+		// Some of the points lie outside the walkmesh
+		const float x = makeRandom(state, -10.0f, kMeshSize * kCellSize + 10.0f);
+		const float y = makeRandom(state, -10.0f, kMeshSize * kCellSize + 10.0f);
+
+		const uint32 *faces;
+		size_t count;
+		walkmesh.getWalkableFacesAt(x, y, faces, count);
+
+		for (size_t j = 1; j < count; j++)
+			ASSERT_LT(faces[j - 1], faces[j]) << "At point " << i;
+
+		// Every face containing the point has to be among the candidates
+		for (uint32 j = 0; j < faceCount; j++) {
+			float l0, l1, l2, z;
+			getBarycentric(walkmesh, j, x, y, l0, l1, l2, z);
+
+			if (MIN(l0, MIN(l1, l2)) > kEdgeEpsilon) {
+				EXPECT_TRUE(std::binary_search(faces, faces + count, j)) << "At point " << i << ", face " << j;
+			}
+		}
+	}
+}
+
+GTEST_TEST(Walkmesh, getElevationsAt) {
+	uint32 state = 2;
+	TestWalkmesh walkmesh(state);
+
+	std::vector<float> x(kPointCount), y(kPointCount), z(kPointCount);
+	std::vector<uint32> faces(kPointCount);
+
+	for (size_t i = 0; i < kPointCount; i++) {
+		x[i] = makeRandom(state, -10.0f, kMeshSize * kCellSize + 10.0f);
+		y[i] = makeRandom(state, -10.0f, kMeshSize * kCellSize + 10.0f);
+	}
+
+	Engines::WalkmeshElevationEvaluator::getElevationsAt(walkmesh, kPointCount, &x[0], &y[0], &z[0], &faces[0]);
+
+	size_t checked = 0, walkable = 0;
+	for (size_t i = 0; i < kPointCount; i++) {
+		uint32 face;
+		float elevation;
+		if (!findFaceBruteForce(walkmesh, x[i], y[i], face, elevation))
+			continue;
+
+		checked++;
+
+		if (face == 0xFFFFFFFF) {
+			EXPECT_EQ(z[i], FLT_MIN) << "At point " << i;
+			continue;
+		}
+
+		walkable++;
+
+		EXPECT_EQ(faces[i], face) << "At point " << i;
+		EXPECT_NEAR(z[i], elevation, 0.001f) << "At point " << i;
+
+		// The single point query has to agree with the batched one
+		uint32 singleFace;
+		EXPECT_EQ(Engines::WalkmeshElevationEvaluator::getElevationAt(walkmesh, x[i], y[i], singleFace), z[i]);
+		EXPECT_EQ(singleFace, faces[i]);
+	}
+
+	// Make sure we actually tested something on and off the walkmesh
+	EXPECT_GT(checked, kPointCount / 2);
+	EXPECT_GT(walkable, checked / 4);
+	EXPECT_LT(walkable, checked);
+}
+
+GTEST_TEST(Walkmesh, invalidCoordinates) {
+	uint32 state = 3;
+	TestWalkmesh walkmesh(state);
+
+	const float nan = std::numeric_limits<float>::quiet_NaN();
+	const float inf = std::numeric_limits<float>::infinity();
+
+	const float coordinates[] = { nan, inf, -inf, FLT_MAX, -FLT_MAX };
+	for (size_t i = 0; i < ARRAYSIZE(coordinates); i++) {
+		for (size_t j = 0; j < ARRAYSIZE(coordinates); j++) {
+			const uint32 *faces = 0;
+			size_t count = 1;
+
+			walkmesh.getWalkableFacesAt(coordinates[i], 10.0f, faces, count);
+			EXPECT_EQ(count, 0U) << "At " << coordinates[i] << ", 10";
+
+			walkmesh.getWalkableFacesAt(10.0f, coordinates[j], faces, count);
+			EXPECT_EQ(count, 0U) << "At 10, " << coordinates[j];
+
+			walkmesh.getWalkableFacesAt(coordinates[i], coordinates[j], faces, count);
+			EXPECT_EQ(count, 0U) << "At " << coordinates[i] << ", " << coordinates[j];
+
+			uint32 face;
+			EXPECT_EQ(Engines::WalkmeshElevationEvaluator::getElevationAt(walkmesh, coordinates[i], coordinates[j], face),
+			          FLT_MIN) << "At " << coordinates[i] << ", " << coordinates[j];
+		}
+	}
+}
+
+GTEST_TEST(Walkmesh, hugeFaces) {
+	static const uint32 kHugeFaceCount = 100;
+
+	// Faces spanning the whole grid, and faces too big to even measure the grid
+	const float extents[] = { 1.0e6f, 1.0e30f };
+
+	uint32 state = 4;
+	for (size_t e = 0; e < ARRAYSIZE(extents); e++) {
+		HugeFaceWalkmesh walkmesh(kHugeFaceCount, extents[e]);
+
+		for (size_t i = 0; i < kPointCount; i++) {
+			const float x = makeRandom(state, 0.0f, kMeshSize * kCellSize);
+			const float y = makeRandom(state, 0.0f, kMeshSize * kCellSize);
+
+			const uint32 *faces;
+			size_t count;
+			walkmesh.getWalkableFacesAt(x, y, faces, count);
+
+			// The huge faces come last, and every one of them contains the point
+			ASSERT_GE(count, kHugeFaceCount) << "At point " << i;
+
+			const uint32 firstHuge = 2 * kMeshSize * kMeshSize;
+			for (uint32 j = 0; j < kHugeFaceCount; j++)
+				EXPECT_EQ(faces[count - kHugeFaceCount + j], firstHuge + j) << "At point " << i;
+
+			uint32 face;
+			EXPECT_EQ(Engines::WalkmeshElevationEvaluator::getElevationAt(walkmesh, x, y, face),
+			          0.0f) << "At point " << i;
+		}
+	}
+}
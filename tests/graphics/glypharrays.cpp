@@ -0,0 +1,239 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for laying out text into glyph arrays.
+ */
+
+#include "gtest/gtest.h"
+
+#include "src/common/ustring.h"
+
+#include "src/graphics/font.h"
+#include "src/graphics/glypharrays.h"
+
+/** A font of 10x20 pixel glyphs, with upper case letters on a second page and no '#'. */
+class TestFont : public Graphics::Font {
+public:
+	float getWidth(uint32 UNUSED(c)) const {
+		return 10.0f;
+	}
+
+	float getHeight() const {
+		return 20.0f;
+	}
+
+	float getLineSpacing() const {
+		return 2.0f;
+	}
+
+	void addGlyph(Graphics::GlyphArrays &glyphs, uint32 c, float &x, float y) const {
+		if (c == '#') {
+			glyphs.addRect(x, y, 9.0f, 20.0f);
+
+			x += 10.0f;
+			return;
+		}
+
+		static const float vX[4] = { 0.0f, 10.0f, 10.0f,  0.0f };
+		static const float vY[4] = { 0.0f,  0.0f, 20.0f, 20.0f };
+
+		// Encode the character into the texture coordinates
+		const float tX[4] = { (float) c, 0.0f, 0.0f, 0.0f };
+		const float tY[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+		glyphs.addQuad(((c >= 'A') && (c <= 'Z')) ? 1 : 0, x, y, vX, vY, tX, tY);
+
+		x += 10.0f;
+	}
+
+	void bindPage(size_t UNUSED(page)) const {
+	}
+};
+
+static Graphics::ColorPosition makeColor(size_t position, bool defaultColor) {
+	Graphics::ColorPosition color;
+
+	color.position     = position;
+	color.defaultColor = defaultColor;
+
+	color.r = color.g = color.b = color.a = 1.0f;
+
+	return color;
+}
+
+GTEST_TEST(GlyphArrays, empty) {
+	Graphics::GlyphArrays glyphs;
+
+	glyphs.finish();
+
+	EXPECT_TRUE(glyphs.empty());
+	EXPECT_TRUE(glyphs.getVertices().empty());
+	EXPECT_TRUE(glyphs.getTexCoords().empty());
+	EXPECT_TRUE(glyphs.getRuns().empty());
+}
+
+GTEST_TEST(GlyphArrays, sortByPage) {
+	const float v[4] = { 0.0f, 1.0f, 2.0f, 3.0f };
+	const float t[4] = { 0.5f, 0.5f, 0.5f, 0.5f };
+
+	Graphics::GlyphArrays glyphs;
+
+	glyphs.addQuad(1, 10.0f, 0.0f, v, v, t, t);
+	glyphs.addQuad(0, 20.0f, 0.0f, v, v, t, t);
+	glyphs.addRect(30.0f, 0.0f, 5.0f, 5.0f);
+	glyphs.addQuad(1, 40.0f, 0.0f, v, v, t, t);
+	glyphs.setColor(3);
+	glyphs.addQuad(1, 50.0f, 0.0f, v, v, t, t);
+
+	glyphs.finish();
+
+	ASSERT_EQ(glyphs.getVertices().size() , 40U);
+	ASSERT_EQ(glyphs.getTexCoords().size(), 40U);
+
+	const std::vector<Graphics::GlyphArrays::Run> &runs = glyphs.getRuns();
+	ASSERT_EQ(runs.size(), 4U);
+
+	EXPECT_EQ(runs[0].page , 0U);
+	EXPECT_EQ(runs[0].color, Graphics::GlyphArrays::kColorDefault);
+	EXPECT_EQ(runs[0].first, 0U);
+	EXPECT_EQ(runs[0].count, 4U);
+
+	EXPECT_EQ(runs[1].page , 1U);
+	EXPECT_EQ(runs[1].color, Graphics::GlyphArrays::kColorDefault);
+	EXPECT_EQ(runs[1].first, 4U);
+	EXPECT_EQ(runs[1].count, 8U);
+
+	EXPECT_EQ(runs[2].page , 1U);
+	EXPECT_EQ(runs[2].color, 3U);
+	EXPECT_EQ(runs[2].first, 12U);
+	EXPECT_EQ(runs[2].count, 4U);
+
+	EXPECT_EQ(runs[3].page , Graphics::GlyphArrays::kPageUntextured);
+	EXPECT_EQ(runs[3].first, 16U);
+	EXPECT_EQ(runs[3].count, 4U);
+
+	// Quads of the same page stay in the order they were added
+	const float kFirstX[5] = { 20.0f, 10.0f, 40.0f, 50.0f, 30.0f };
+	for (size_t i = 0; i < 5; i++)
+		EXPECT_FLOAT_EQ(glyphs.getVertices()[i * 8], kFirstX[i]) << "At quad " << i;
+
+	// The untextured rectangle
+	const float kRect[8] = { 30.0f, 0.0f, 35.0f, 0.0f, 35.0f, 5.0f, 30.0f, 5.0f };
+	for (size_t i = 0; i < 8; i++)
+		EXPECT_FLOAT_EQ(glyphs.getVertices()[32 + i], kRect[i]) << "At index " << i;
+}
+
+GTEST_TEST(GlyphArrays, clear) {
+	Graphics::GlyphArrays glyphs;
+
+	glyphs.setColor(2);
+	glyphs.addRect(0.0f, 0.0f, 1.0f, 1.0f);
+	glyphs.finish();
+
+	EXPECT_FALSE(glyphs.empty());
+
+	glyphs.clear();
+
+	EXPECT_TRUE(glyphs.empty());
+	EXPECT_TRUE(glyphs.getVertices().empty());
+
+	glyphs.addRect(0.0f, 0.0f, 1.0f, 1.0f);
+	glyphs.finish();
+
+	ASSERT_EQ(glyphs.getRuns().size(), 1U);
+	EXPECT_EQ(glyphs.getRuns()[0].color, Graphics::GlyphArrays::kColorDefault);
+}
+
+GTEST_TEST(GlyphArrays, layoutAlign) {
+	TestFont font;
+	Graphics::GlyphArrays glyphs;
+
+	// Two lines in a 100x100 box, centered horizontally and at the bottom
+	font.buildGlyphs(glyphs, "ab\nabcd", Graphics::ColorPositions(), 100.0f, 100.0f, 0.5f, 0.0f);
+
+	const std::vector<float> &vertices  = glyphs.getVertices();
+	const std::vector<float> &texCoords = glyphs.getTexCoords();
+
+	ASSERT_EQ(vertices.size(), 6U * 8U);
+	ASSERT_EQ(glyphs.getRuns().size(), 1U);
+
+	// The lines are 22 pixels apart, with the last line at the bottom
+	const float kX[6] = { 40.0f, 50.0f, 30.0f, 40.0f, 50.0f, 60.0f };
+	const float kY[6] = { 22.0f, 22.0f,  0.0f,  0.0f,  0.0f,  0.0f };
+	const char  kC[6] = { 'a', 'b', 'a', 'b', 'c', 'd' };
+
+	for (size_t i = 0; i < 6; i++) {
+		EXPECT_FLOAT_EQ(vertices[i * 8 + 0], kX[i]) << "At glyph " << i;
+		EXPECT_FLOAT_EQ(vertices[i * 8 + 1], kY[i]) << "At glyph " << i;
+		EXPECT_FLOAT_EQ(vertices[i * 8 + 4], kX[i] + 10.0f) << "At glyph " << i;
+		EXPECT_FLOAT_EQ(vertices[i * 8 + 5], kY[i] + 20.0f) << "At glyph " << i;
+
+		EXPECT_FLOAT_EQ(texCoords[i * 8], kC[i]) << "At glyph " << i;
+	}
+
+	// Top aligned, the first line starts at the top of the box
+	font.buildGlyphs(glyphs, "ab\nabcd", Graphics::ColorPositions(), 100.0f, 100.0f, 0.0f, 1.0f);
+
+	ASSERT_EQ(glyphs.getVertices().size(), 6U * 8U);
+	EXPECT_FLOAT_EQ(glyphs.getVertices()[0], 0.0f);
+	EXPECT_FLOAT_EQ(glyphs.getVertices()[1], 78.0f);
+	EXPECT_FLOAT_EQ(glyphs.getVertices()[2 * 8 + 1], 56.0f);
+}
+
+GTEST_TEST(GlyphArrays, layoutPagesAndColors) {
+	TestFont font;
+	Graphics::GlyphArrays glyphs;
+
+	Graphics::ColorPositions colors;
+	colors.push_back(makeColor(1, false));
+	colors.push_back(makeColor(3, true));
+
+	font.buildGlyphs(glyphs, "aBc#e", colors, 100.0f, 100.0f, 0.0f, 1.0f);
+
+	const std::vector<Graphics::GlyphArrays::Run> &runs = glyphs.getRuns();
+	ASSERT_EQ(runs.size(), 5U);
+
+	// 'a', then 'c' in color 0
+	EXPECT_EQ(runs[0].page , 0U);
+	EXPECT_EQ(runs[0].color, Graphics::GlyphArrays::kColorDefault);
+	EXPECT_EQ(runs[0].count, 4U);
+	EXPECT_EQ(runs[1].page , 0U);
+	EXPECT_EQ(runs[1].color, 0U);
+	EXPECT_EQ(runs[1].count, 4U);
+
+	// 'e', back in the default color
+	EXPECT_EQ(runs[2].page , 0U);
+	EXPECT_EQ(runs[2].color, Graphics::GlyphArrays::kColorDefault);
+	EXPECT_EQ(runs[2].count, 4U);
+
+	// 'B' on the second page
+	EXPECT_EQ(runs[3].page , 1U);
+	EXPECT_EQ(runs[3].color, 0U);
+	EXPECT_EQ(runs[3].count, 4U);
+
+	// The missing '#'
+	EXPECT_EQ(runs[4].page , Graphics::GlyphArrays::kPageUntextured);
+	EXPECT_EQ(runs[4].color, Graphics::GlyphArrays::kColorDefault);
+	EXPECT_EQ(runs[4].count, 4U);
+
+	EXPECT_FLOAT_EQ(glyphs.getVertices()[runs[4].first * 2 + 0], 30.0f);
+	EXPECT_FLOAT_EQ(glyphs.getVertices()[runs[4].first * 2 + 2], 39.0f);
+}
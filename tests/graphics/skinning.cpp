@@ -0,0 +1,111 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for the vertex skinning.
+ */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+#include "src/graphics/aurora/skinning.h"
+
+#include "tests/random.h"
+
+static const uint32 kBoneCount   = 16;
+static const uint32 kVertexCount = 1000;
+
+GTEST_TEST(Skinning, translation) {
+	const float iv[3] = { 1.0f, 2.0f, 3.0f };
+
+	const float  boneWeights[4] = { 0.25f, 0.75f, 1.0f, 1.0f };
+	const int16  boneIds    [4] = { 0, 1, -1, -1 };
+
+	const glm::mat4 boneMatrices[2] = {
+		glm::translate(glm::mat4(), glm::vec3( 4.0f, 0.0f, 0.0f)),
+		glm::translate(glm::mat4(), glm::vec3(-4.0f, 8.0f, 0.0f))
+	};
+
+	float v[3];
+
+	Graphics::Aurora::skinVertices(iv, boneWeights, boneIds, boneMatrices, 1, v);
+	EXPECT_FLOAT_EQ(v[0], -1.0f);
+	EXPECT_FLOAT_EQ(v[1],  8.0f);
+	EXPECT_FLOAT_EQ(v[2],  3.0f);
+
+	Graphics::Aurora::skinVerticesScalar(iv, boneWeights, boneIds, boneMatrices, 1, v);
+	EXPECT_FLOAT_EQ(v[0], -1.0f);
+	EXPECT_FLOAT_EQ(v[1],  8.0f);
+	EXPECT_FLOAT_EQ(v[2],  3.0f);
+}
+
+GTEST_TEST(Skinning, noBones) {
+	const float iv[3] = { 1.0f, 2.0f, 3.0f };
+
+	const float  boneWeights[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+	const int16  boneIds    [4] = { -1, -1, -1, -1 };
+
+	float v[3] = { 5.0f, 5.0f, 5.0f };
+
+	Graphics::Aurora::skinVertices(iv, boneWeights, boneIds, 0, 1, v);
+	EXPECT_EQ(v[0], 0.0f);
+	EXPECT_EQ(v[1], 0.0f);
+	EXPECT_EQ(v[2], 0.0f);
+}
+
+GTEST_TEST(Skinning, matchesScalar) {
+	uint32 state = 1;
+
+	std::vector<glm::mat4> boneMatrices(kBoneCount);
+	for (uint32 i = 0; i < kBoneCount; i++)
+		for (int c = 0; c < 4; c++)
+			for (int r = 0; r < 3; r++)
+				boneMatrices[i][c][r] = makeRandom(state, -2.0f, 2.0f);
+
+	std::vector<float> iv(3 * kVertexCount), boneWeights(4 * kVertexCount);
+	std::vector<int16> boneIds(4 * kVertexCount);
+
+	for (uint32 i = 0; i < kVertexCount; i++) {
+		for (int j = 0; j < 3; j++)
+			iv[3 * i + j] = makeRandom(state, -100.0f, 100.0f);
+
+		// Between 1 and 4 bones per vertex, with the unused ones anywhere
+		for (int j = 0; j < 4; j++) {
+			const bool used = (j == 0) || (makeRandom(state, 0.0f, 1.0f) < 0.6f);
+
+			boneIds    [4 * i + j] = used ? (int16) makeRandom(state, 0.0f, kBoneCount - 0.5f) : -1;
+			boneWeights[4 * i + j] = makeRandom(state, 0.0f, 1.0f);
+		}
+	}
+
+	std::vector<float> v(3 * kVertexCount), vScalar(3 * kVertexCount);
+
+	Graphics::Aurora::skinVertices      (&iv[0], &boneWeights[0], &boneIds[0], &boneMatrices[0],
+	                                     kVertexCount, &v[0]);
+	Graphics::Aurora::skinVerticesScalar(&iv[0], &boneWeights[0], &boneIds[0], &boneMatrices[0],
+	                                     kVertexCount, &vScalar[0]);
+
+	// The SSE path adds up in a different order, so the results might differ in the last bits
+	for (uint32 i = 0; i < 3 * kVertexCount; i++)
+		EXPECT_NEAR(v[i], vScalar[i], 0.001f) << "At coordinate " << i;
+}
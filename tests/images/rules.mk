@@ -41,3 +41,13 @@ check_PROGRAMS                       += tests/images/test_xoreositex
 tests_images_test_xoreositex_SOURCES  = tests/images/xoreositex.cpp
 tests_images_test_xoreositex_LDADD    = $(images_LIBS)
 tests_images_test_xoreositex_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                       += tests/images/test_yuv_to_rgb
+tests_images_test_yuv_to_rgb_SOURCES  = tests/images/yuv_to_rgb.cpp
+tests_images_test_yuv_to_rgb_LDADD    = $(images_LIBS)
+tests_images_test_yuv_to_rgb_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                 += tests/images/test_s3tc
+tests_images_test_s3tc_SOURCES  = tests/images/s3tc.cpp
+tests_images_test_s3tc_LDADD    = $(images_LIBS)
+tests_images_test_s3tc_CXXFLAGS = $(test_CXXFLAGS)
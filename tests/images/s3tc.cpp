@@ -0,0 +1,288 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+/** @file
+ *  Unit tests for our S3TC DXTn decompression.
+ */
+
+#include <cstring>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/common/types.h"
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/memreadstream.h"
+
+#include "src/graphics/images/decoder.h"
+#include "src/graphics/images/s3tc.h"
+
+#include "tests/random.h"
+
+/* The original, stream-based DXTn decompression, as a reference.
+ * The optimized decompression has to produce exactly the same output. */
+
+static inline uint32 convert565To8888(uint16 color) {
+	return ((color & 0x1F) << 11) | ((color & 0x7E0) << 13) | ((color & 0xF800) << 16) | 0xFF;
+}
+
+static inline uint32 interpolate32(double weight, uint32 color_0, uint32 color_1) {
+	byte r[3], g[3], b[3], a[3];
+	r[0] = color_0 >> 24;
+	r[1] = color_1 >> 24;
+	r[2] = (byte)((1.0f - weight) * (double)r[0] + weight * (double)r[1]);
+	g[0] = (color_0 >> 16) & 0xFF;
+	g[1] = (color_1 >> 16) & 0xFF;
+	g[2] = (byte)((1.0f - weight) * (double)g[0] + weight * (double)g[1]);
+	b[0] = (color_0 >> 8) & 0xFF;
+	b[1] = (color_1 >> 8) & 0xFF;
+	b[2] = (byte)((1.0f - weight) * (double)b[0] + weight * (double)b[1]);
+	a[0] = color_0 & 0xFF;
+	a[1] = color_1 & 0xFF;
+	a[2] = (byte)((1.0f - weight) * (double)a[0] + weight * (double)a[1]);
+	return r[2] << 24 | g[2] << 16 | b[2] << 8 | a[2];
+}
+
+enum DXTFormat {
+	kDXT1,
+	kDXT3,
+	kDXT5
+};
+
+static void referenceDXT(DXTFormat format, byte *dest, Common::SeekableReadStream &src,
+                         uint32 width, uint32 height, uint32 pitch) {
+
+	for (int32 ty = height; ty > 0; ty -= 4) {
+		for (uint32 tx = 0; tx < width; tx += 4) {
+			uint16 alpha3[4] = { 0, 0, 0, 0 };
+			byte   alpha5[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+			uint64 alphabl   = 0;
+
+			if (format == kDXT3) {
+				for (int i = 0; i < 4; i++)
+					alpha3[i] = src.readUint16LE();
+			} else if (format == kDXT5) {
+				alpha5[0] = src.readByte();
+				alpha5[1] = src.readByte();
+
+				alphabl = src.readUint32LE();
+				alphabl |= ((uint64) src.readUint16LE()) << 32;
+
+				if (alpha5[0] > alpha5[1]) {
+					for (int i = 1; i < 7; i++)
+						alpha5[i + 1] = (byte)(((7 - i) * (double)alpha5[0] + i * (double)alpha5[1] + 3.0f) / 7.0f);
+				} else {
+					for (int i = 1; i < 5; i++)
+						alpha5[i + 1] = (byte)(((5 - i) * (double)alpha5[0] + i * (double)alpha5[1] + 2.0f) / 5.0f);
+
+					alpha5[6] = 0;
+					alpha5[7] = 255;
+				}
+			}
+
+			const uint16 color_0 = src.readUint16LE();
+			const uint16 color_1 = src.readUint16LE();
+			uint32 cpx = src.readUint32BE();
+
+			uint32 blended[4];
+			if (format == kDXT1) {
+				blended[0] = convert565To8888(color_0);
+				blended[1] = convert565To8888(color_1);
+
+				if (color_0 > color_1) {
+					blended[2] = interpolate32(0.333333f, blended[0], blended[1]);
+					blended[3] = interpolate32(0.666666f, blended[0], blended[1]);
+				} else {
+					blended[2] = interpolate32(0.5f, blended[0], blended[1]);
+					blended[3] = 0;
+				}
+			} else {
+				blended[0] = convert565To8888(color_0) & 0xFFFFFF00;
+				blended[1] = convert565To8888(color_1) & 0xFFFFFF00;
+				blended[2] = interpolate32(0.333333f, blended[0], blended[1]);
+				blended[3] = interpolate32(0.666666f, blended[0], blended[1]);
+			}
+
+			uint32 blockWidth = MIN<uint32>(width, 4);
+			uint32 blockHeight = MIN<uint32>(height, 4);
+
+			for (byte y = 0; y < blockHeight; ++y) {
+				for (byte x = 0; x < blockWidth; ++x) {
+					const uint32 destX = tx + x;
+					const uint32 destY = height - 1 - (ty - blockHeight + y);
+
+					uint32 pixel = blended[cpx & 3];
+					if (format == kDXT3)
+						pixel |= ((alpha3[y] >> (x * 4)) & 0xF) << 4;
+					else if (format == kDXT5)
+						pixel |= alpha5[(alphabl >> (3 * (4 * (3 - y) + x))) & 7];
+
+					cpx >>= 2;
+
+					if ((destX < width) && (destY < height))
+						WRITE_BE_UINT32(dest + destY * pitch + destX * 4, pixel);
+				}
+			}
+		}
+	}
+}
+
+static size_t getDataSize(DXTFormat format, uint32 width, uint32 height) {
+	return ((width + 3) / 4) * ((height + 3) / 4) * ((format == kDXT1) ? 8 : 16);
+}
+
+static void fillRandom(std::vector<byte> &data, uint32 seed) {
+	for (size_t i = 0; i < data.size(); i++)
+		data[i] = makeRandom(seed) >> 8;
+
+	// Make sure both orders of the two colors of a block appear, as well as equal colors
+	for (size_t i = 0; (i + 16) <= data.size(); i += 48)
+		std::memcpy(&data[i + 2], &data[i], 2);
+}
+
+static void decompress(DXTFormat format, byte *dest, const std::vector<byte> &src,
+                       uint32 width, uint32 height, uint32 pitch) {
+
+	if      (format == kDXT1)
+		Graphics::decompressDXT1(dest, &src[0], src.size(), width, height, pitch);
+	else if (format == kDXT3)
+		Graphics::decompressDXT3(dest, &src[0], src.size(), width, height, pitch);
+	else if (format == kDXT5)
+		Graphics::decompressDXT5(dest, &src[0], src.size(), width, height, pitch);
+}
+
+static void compareDXT(DXTFormat format) {
+	// Whole blocks, a single partial block and partial blocks at the edges
+	static const uint32 kSizes[][2] = {
+		{ 4, 4 }, { 16, 8 }, { 64, 64 }, { 1, 1 }, { 2, 2 }, { 3, 1 }, { 2, 8 }, { 8, 2 }, { 6, 10 }, { 13, 7 }
+	};
+
+	for (size_t i = 0; i < ARRAYSIZE(kSizes); i++) {
+		const uint32 width  = kSizes[i][0];
+		const uint32 height = kSizes[i][1];
+		const uint32 pitch  = width * 4 + 8;
+
+		std::vector<byte> src(getDataSize(format, width, height));
+		fillRandom(src, i);
+
+		std::vector<byte> reference(pitch * height, 0x55), result(pitch * height, 0x55);
+
+		Common::MemoryReadStream stream(&src[0], src.size());
+		referenceDXT(format, &reference[0], stream, width, height, pitch);
+
+		decompress(format, &result[0], src, width, height, pitch);
+
+		for (size_t j = 0; j < reference.size(); j++)
+			ASSERT_EQ(result[j], reference[j]) << "At size " << width << "x" << height << ", index " << j;
+	}
+}
+
+GTEST_TEST(S3TC, decompressDXT1) {
+	compareDXT(kDXT1);
+}
+
+GTEST_TEST(S3TC, decompressDXT3) {
+	compareDXT(kDXT3);
+}
+
+GTEST_TEST(S3TC, decompressDXT5) {
+	compareDXT(kDXT5);
+}
+
+GTEST_TEST(S3TC, decompressTooShort) {
+	std::vector<byte> src(getDataSize(kDXT5, 8, 8) - 1);
+	std::vector<byte> dest(8 * 8 * 4);
+
+	EXPECT_THROW(decompress(kDXT5, &dest[0], src, 8, 8, 8 * 4), Common::Exception);
+}
+
+/** A DXTn image with a full chain of mip maps, filled with pseudo-random blocks. */
+class DXTImage : public Graphics::ImageDecoder {
+public:
+	DXTImage(Graphics::PixelFormatRaw format, int width, int height) {
+		_compressed = true;
+		_hasAlpha   = format != Graphics::kPixelFormatDXT1;
+		_format     = Graphics::kPixelFormatBGRA;
+		_formatRaw  = format;
+		_dataType   = Graphics::kPixelDataType8;
+
+		const DXTFormat dxtFormat = (format == Graphics::kPixelFormatDXT1) ? kDXT1 :
+		                            ((format == Graphics::kPixelFormatDXT3) ? kDXT3 : kDXT5);
+
+		while ((width > 0) && (height > 0)) {
+			_mipMaps.push_back(new MipMap(this));
+
+			MipMap &mipMap = *_mipMaps.back();
+
+			mipMap.width  = width;
+			mipMap.height = height;
+			mipMap.size   = getDataSize(dxtFormat, width, height);
+
+			mipMap.data.reset(new byte[mipMap.size]);
+
+			std::vector<byte> data(mipMap.size);
+			fillRandom(data, width);
+
+			std::memcpy(mipMap.data.get(), &data[0], mipMap.size);
+
+			width  /= 2;
+			height /= 2;
+		}
+	}
+};
+
+static void compareImage(Graphics::PixelFormatRaw format, DXTFormat dxtFormat) {
+	// Big enough to be split into several bands, with an incomplete block row at the bottom
+	DXTImage image(format, 512, 1026);
+	DXTImage compressed(format, 512, 1026);
+
+	image.decompress();
+
+	EXPECT_FALSE(image.isCompressed());
+	EXPECT_EQ(image.getFormatRaw(), Graphics::kPixelFormatRGBA8);
+
+	ASSERT_EQ(image.getMipMapCount(), compressed.getMipMapCount());
+
+	for (size_t i = 0; i < image.getMipMapCount(); i++) {
+		const Graphics::ImageDecoder::MipMap &in  = compressed.getMipMap(i);
+		const Graphics::ImageDecoder::MipMap &out = image.getMipMap(i);
+
+		ASSERT_EQ(out.width , in.width);
+		ASSERT_EQ(out.height, in.height);
+		ASSERT_EQ(out.size  , (uint32) (in.width * in.height * 4));
+
+		std::vector<byte> reference(out.size);
+
+		Common::MemoryReadStream stream(in.data.get(), in.size);
+		referenceDXT(dxtFormat, &reference[0], stream, in.width, in.height, in.width * 4);
+
+		for (size_t j = 0; j < reference.size(); j++)
+			ASSERT_EQ(out.data[j], reference[j]) << "At mip map " << i << ", index " << j;
+	}
+}
+
+GTEST_TEST(S3TC, decompressImageDXT1) {
+	compareImage(Graphics::kPixelFormatDXT1, kDXT1);
+}
+
+GTEST_TEST(S3TC, decompressImageDXT5) {
+	compareImage(Graphics::kPixelFormatDXT5, kDXT5);
+}
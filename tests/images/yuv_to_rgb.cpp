@@ -0,0 +1,153 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our YUV to RGB conversion.
+ */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/common/types.h"
+#include "src/common/util.h"
+
+#include "src/graphics/yuv_to_rgb.h"
+
+#include "tests/random.h"
+
+/** A YUV420 image with an alpha plane, filled with pseudo-random values. */
+struct YUVImage {
+	int width, height;
+	int yPitch, uvPitch;
+
+	std::vector<byte> y, u, v, a;
+
+	YUVImage(int w, int h, uint32 seed) : width(w), height(h), yPitch(w + 3), uvPitch(w / 2 + 5) {
+		y.resize(yPitch  *  height);
+		a.resize(yPitch  *  height);
+		u.resize(uvPitch * (height / 2));
+		v.resize(uvPitch * (height / 2));
+
+		fill(y, seed);
+		fill(a, seed + 1);
+		fill(u, seed + 2);
+		fill(v, seed + 3);
+	}
+
+	static void fill(std::vector<byte> &data, uint32 seed) {
+		for (size_t i = 0; i < data.size(); i++)
+			data[i] = makeRandom(seed) >> 8;
+	}
+};
+
+static void convert(const YUVImage &image, Graphics::YUVToRGBManager::LuminanceScale scale,
+                    bool alpha, bool simd, std::vector<byte> &dst) {
+
+	const int dstPitch = image.width * 4 + 8;
+
+	dst.clear();
+	dst.resize(dstPitch * image.height, 0x55);
+
+	YUVToRGBMan.setUseSIMD(simd);
+
+	if (alpha)
+		YUVToRGBMan.convert420(scale, &dst[0], dstPitch, &image.y[0], &image.u[0], &image.v[0], &image.a[0],
+		                       image.width, image.height, image.yPitch, image.uvPitch);
+	else
+		YUVToRGBMan.convert420(scale, &dst[0], dstPitch, &image.y[0], &image.u[0], &image.v[0],
+		                       image.width, image.height, image.yPitch, image.uvPitch);
+
+	YUVToRGBMan.setUseSIMD(true);
+}
+
+static void compareSIMD(const YUVImage &image, Graphics::YUVToRGBManager::LuminanceScale scale, bool alpha) {
+	std::vector<byte> reference, simd;
+	convert(image, scale, alpha, false, reference);
+	convert(image, scale, alpha, true , simd);
+
+	ASSERT_EQ(reference.size(), simd.size());
+	for (size_t i = 0; i < reference.size(); i++)
+		EXPECT_EQ(reference[i], simd[i]) << "At width " << image.width << ", index " << i;
+}
+
+static void compareSIMD(Graphics::YUVToRGBManager::LuminanceScale scale, bool alpha) {
+	// Widths with and without a remainder that doesn't fill a whole SIMD register
+	static const int kWidths[] = { 2, 14, 16, 32, 46, 66 };
+
+	for (size_t i = 0; i < ARRAYSIZE(kWidths); i++)
+		compareSIMD(YUVImage(kWidths[i], 6, i), scale, alpha);
+
+	// Every possible chroma value, once for each component
+	YUVImage image(512, 2, 23);
+	for (int i = 0; i < 256; i++) {
+		image.u[i] = i;
+		image.v[i] = 255 - i;
+	}
+
+	compareSIMD(image, scale, alpha);
+}
+
+GTEST_TEST(YUVToRGB, gray) {
+	const int width = 4, height = 2;
+
+	const byte y[] = { 0, 128, 255, 128, 0, 128, 255, 128 };
+	const byte u[] = { 128, 128 };
+	const byte v[] = { 128, 128 };
+
+	byte dst[width * height * 4];
+
+	YUVToRGBMan.convert420(Graphics::YUVToRGBManager::kScaleFull, dst, width * 4, y, u, v,
+	                       width, height, width, width / 2);
+
+	// Without chroma, the luminance is the gray value. The image is stored bottom-up.
+	for (int i = 0; i < width * height; i++) {
+		const byte gray = y[(height - 1 - i / width) * width + (i % width)];
+
+		EXPECT_EQ(dst[i * 4 + 0], gray) << "At pixel " << i;
+		EXPECT_EQ(dst[i * 4 + 1], gray) << "At pixel " << i;
+		EXPECT_EQ(dst[i * 4 + 2], gray) << "At pixel " << i;
+		EXPECT_EQ(dst[i * 4 + 3], 0xFF) << "At pixel " << i;
+	}
+}
+
+GTEST_TEST(YUVToRGB, setUseSIMD) {
+	YUVToRGBMan.setUseSIMD(false);
+	EXPECT_FALSE(YUVToRGBMan.getUseSIMD());
+
+	YUVToRGBMan.setUseSIMD(true);
+	EXPECT_EQ(YUVToRGBMan.getUseSIMD(), Graphics::YUVToRGBManager::hasSIMD());
+}
+
+GTEST_TEST(YUVToRGB, convert420SIMDFull) {
+	compareSIMD(Graphics::YUVToRGBManager::kScaleFull, false);
+}
+
+GTEST_TEST(YUVToRGB, convert420SIMDITU) {
+	compareSIMD(Graphics::YUVToRGBManager::kScaleITU, false);
+}
+
+GTEST_TEST(YUVToRGB, convert420AlphaSIMDFull) {
+	compareSIMD(Graphics::YUVToRGBManager::kScaleFull, true);
+}
+
+GTEST_TEST(YUVToRGB, convert420AlphaSIMDITU) {
+	compareSIMD(Graphics::YUVToRGBManager::kScaleITU, true);
+}
@@ -0,0 +1,51 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Utility unit test include for generating reproducible
+ *  pseudo-random test data.
+ */
+
+#ifndef TESTS_RANDOM_H
+#define TESTS_RANDOM_H
+
+#include "src/common/types.h"
+
+/** A simple, deterministic pseudo-random number generator.
+ *
+ *  Return a number between 0 and 0xFFFF and advance the state, so
+ *  that the same starting state always produces the same sequence.
+ */
+static inline uint32 makeRandom(uint32 &state) {
+	state = state * 1103515245 + 12345;
+
+	return (state >> 8) & 0xFFFF;
+}
+
+/** A simple, deterministic pseudo-random number generator.
+ *
+ *  Return a number between min and max and advance the state, so
+ *  that the same starting state always produces the same sequence.
+ */
+static inline float makeRandom(uint32 &state, float min, float max) {
+	return min + makeRandom(state) / 65535.0f * (max - min);
+}
+
+#endif // TESTS_RANDOM_H
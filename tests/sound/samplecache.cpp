@@ -0,0 +1,210 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our cache of decoded sounds.
+ */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+#include "src/common/scopedptr.h"
+#include "src/common/ustring.h"
+#include "src/common/strutil.h"
+
+#include "src/sound/audiostream.h"
+#include "src/sound/samplecache.h"
+
+/** A mono stream of count samples, counting up from first. */
+class CountingStream : public Sound::RewindableAudioStream {
+public:
+	CountingStream(size_t count, int16 first = 0, bool knownLength = true) :
+		_count(count), _first(first), _knownLength(knownLength), _pos(0) {
+	}
+
+	size_t readBuffer(int16 *buffer, const size_t numSamples) {
+		const size_t count = MIN(numSamples, _count - _pos);
+
+		for (size_t i = 0; i < count; i++)
+			buffer[i] = _first + (int16) (_pos + i);
+
+		_pos += count;
+		return count;
+	}
+
+	int getChannels() const {
+		return 1;
+	}
+
+	int getRate() const {
+		return 22050;
+	}
+
+	bool endOfData() const {
+		return _pos >= _count;
+	}
+
+	bool rewind() {
+		_pos = 0;
+		return true;
+	}
+
+	uint64 getLength() const {
+		return _knownLength ? _count : kInvalidLength;
+	}
+
+private:
+	size_t _count;
+	int16 _first;
+	bool _knownLength;
+
+	size_t _pos;
+};
+
+/** Read the whole stream and check that it counts up from first. */
+static void checkStream(Sound::AudioStream *audioStream, size_t count, int16 first) {
+	ASSERT_NE(audioStream, static_cast<Sound::AudioStream *>(0));
+
+	Common::ScopedPtr<Sound::AudioStream> stream(audioStream);
+
+	std::vector<int16> samples(count + 16);
+	ASSERT_EQ(stream->readBuffer(&samples[0], samples.size()), count);
+
+	for (size_t i = 0; i < count; i++)
+		EXPECT_EQ(samples[i], (int16) (first + i)) << "At sample " << i;
+
+	EXPECT_TRUE(stream->endOfData());
+}
+
+/** Add a sound of count samples, and play it once. */
+static void addSound(Sound::SampleCache &cache, const Common::UString &name, size_t count, int16 first = 0) {
+	checkStream(cache.add(name, new CountingStream(count, first)), count, first);
+}
+
+// A budget of 64000 bytes lets single sounds take up 8000 bytes, i.e. 4000 samples
+static const size_t kBudget = 64000;
+
+GTEST_TEST(SampleCache, addGet) {
+	Sound::SampleCache cache(kBudget);
+
+	EXPECT_EQ(cache.get("sound"), static_cast<Sound::RewindableAudioStream *>(0));
+
+	addSound(cache, "sound", 1000, 5);
+
+	EXPECT_EQ(cache.getCount(), 1U);
+	EXPECT_EQ(cache.getSize(), 2000U);
+
+	// Played again, from the cache
+	checkStream(cache.get("sound"), 1000, 5);
+
+	// Adding the same sound again keeps the cached samples
+	checkStream(cache.add("sound", new CountingStream(1000, 100)), 1000, 5);
+
+	EXPECT_EQ(cache.getCount(), 1U);
+
+	cache.clear();
+
+	EXPECT_EQ(cache.get("sound"), static_cast<Sound::RewindableAudioStream *>(0));
+	EXPECT_EQ(cache.getCount(), 0U);
+	EXPECT_EQ(cache.getSize(), 0U);
+}
+
+GTEST_TEST(SampleCache, evictLeastRecentlyPlayed) {
+	Sound::SampleCache cache(kBudget);
+
+	// 10 sounds of 6000 bytes each fit into the budget
+	for (int i = 0; i < 10; i++)
+		addSound(cache, Common::composeString(i), 3000, i);
+
+	EXPECT_EQ(cache.getCount(), 10U);
+	EXPECT_EQ(cache.getSize(), 60000U);
+
+	// Play the oldest sound again, so that the second oldest is now the least recently played
+	checkStream(cache.get("0"), 3000, 0);
+
+	addSound(cache, "10", 3000, 10);
+
+	EXPECT_EQ(cache.getCount(), 10U);
+	EXPECT_LE(cache.getSize(), kBudget);
+
+	EXPECT_EQ(cache.get("1"), static_cast<Sound::RewindableAudioStream *>(0));
+
+	checkStream(cache.get("0"), 3000, 0);
+	for (int i = 2; i <= 10; i++)
+		checkStream(cache.get(Common::composeString(i)), 3000, i);
+}
+
+GTEST_TEST(SampleCache, setBudget) {
+	Sound::SampleCache cache(kBudget);
+
+	for (int i = 0; i < 10; i++)
+		addSound(cache, Common::composeString(i), 3000, i);
+
+	// Shrinking the budget drops the least recently played sounds
+	cache.setBudget(kBudget / 2);
+
+	EXPECT_EQ(cache.getBudget(), kBudget / 2);
+	EXPECT_EQ(cache.getCount(), 5U);
+	EXPECT_LE(cache.getSize(), kBudget / 2);
+
+	for (int i = 0; i < 5; i++)
+		EXPECT_EQ(cache.get(Common::composeString(i)), static_cast<Sound::RewindableAudioStream *>(0));
+	for (int i = 5; i < 10; i++)
+		checkStream(cache.get(Common::composeString(i)), 3000, i);
+
+	// A budget of 0 disables the cache
+	cache.setBudget(0);
+
+	EXPECT_EQ(cache.getCount(), 0U);
+
+	addSound(cache, "sound", 100);
+
+	EXPECT_EQ(cache.getCount(), 0U);
+	EXPECT_EQ(cache.get("sound"), static_cast<Sound::RewindableAudioStream *>(0));
+}
+
+GTEST_TEST(SampleCache, tooLong) {
+	Sound::SampleCache cache(kBudget);
+
+	// Exactly as long as a single sound may be
+	addSound(cache, "fits", 4000);
+
+	// Longer, with the length known beforehand
+	addSound(cache, "tooLong", 4001, 7);
+
+	// Longer, with the length only found out while decoding
+	checkStream(cache.add("unknownLength", new CountingStream(5000, 9, false)), 5000, 9);
+
+	EXPECT_EQ(cache.getCount(), 1U);
+	EXPECT_EQ(cache.getSize(), 8000U);
+
+	checkStream(cache.get("fits"), 4000, 0);
+
+	EXPECT_EQ(cache.get("tooLong"), static_cast<Sound::RewindableAudioStream *>(0));
+	EXPECT_EQ(cache.get("unknownLength"), static_cast<Sound::RewindableAudioStream *>(0));
+
+	// A bigger budget allows the sound to be cached
+	cache.setBudget(kBudget * 2);
+
+	addSound(cache, "tooLong", 4001, 7);
+	checkStream(cache.get("tooLong"), 4001, 7);
+}